@@ -0,0 +1,50 @@
+#include "cpu_features.h"
+
+#if defined(_MSC_VER) && (defined(CPU_X64) || defined(CPU_X86))
+#include <intrin.h>
+#endif
+
+namespace CPUFeatures {
+
+bool HasSSE41()
+{
+#if defined(CPU_X64) || defined(CPU_X86)
+#ifdef _MSC_VER
+  int regs[4];
+  __cpuid(regs, 1);
+  return ((regs[2] & (1 << 19)) != 0);
+#else
+  return __builtin_cpu_supports("sse4.1");
+#endif
+#else
+  return false;
+#endif
+}
+
+bool HasAVX2()
+{
+#if defined(CPU_X64) || defined(CPU_X86)
+#ifdef _MSC_VER
+  int regs[4];
+  __cpuid(regs, 0);
+  if (regs[0] < 7)
+    return false;
+
+  // OS has to save the upper halves of the ymm registers
+  __cpuid(regs, 1);
+  const bool osxsave = ((regs[2] & (1 << 27)) != 0);
+  const bool avx = ((regs[2] & (1 << 28)) != 0);
+  if (!osxsave || !avx || (_xgetbv(0) & 0x6) != 0x6)
+    return false;
+
+  __cpuidex(regs, 7, 0);
+  return ((regs[1] & (1 << 5)) != 0);
+#else
+  return __builtin_cpu_supports("avx2");
+#endif
+#else
+  return false;
+#endif
+}
+
+} // namespace CPUFeatures
@@ -0,0 +1,19 @@
+#pragma once
+#include "platform.h"
+
+// Allows a function to use instructions from the specified ISA. Callers must check that the host supports it first.
+#if defined(_MSC_VER) && !defined(__clang__)
+#define CPU_TARGET(isa)
+#else
+#define CPU_TARGET(isa) __attribute__((target(isa)))
+#endif
+
+namespace CPUFeatures {
+
+/// Returns true if the host supports SSE4.1. Always false on non-x86 hosts.
+bool HasSSE41();
+
+/// Returns true if the host supports AVX2, and the OS saves the upper halves of the ymm registers.
+bool HasAVX2();
+
+} // namespace CPUFeatures
@@ -0,0 +1,85 @@
+#include "file_lock.h"
+
+#if defined(_WIN32)
+#include "windows_headers.h"
+#include <cstdlib>
+#include <encodings/utf.h>
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__FreeBSD__)
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <unistd.h>
+#endif
+
+namespace Common {
+
+FileLock::FileLock() = default;
+
+FileLock::~FileLock()
+{
+  Unlock();
+}
+
+bool FileLock::Lock(const char* filename)
+{
+  Unlock();
+
+#if defined(_WIN32)
+  wchar_t* wfilename = utf8_to_utf16_string_alloc(filename);
+  HANDLE file_handle = wfilename ? CreateFileW(wfilename, GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE,
+                                               nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr) :
+                                   INVALID_HANDLE_VALUE;
+  free(wfilename);
+  if (file_handle == INVALID_HANDLE_VALUE)
+    return false;
+
+  OVERLAPPED overlapped = {};
+  if (!LockFileEx(file_handle, LOCKFILE_EXCLUSIVE_LOCK, 0, MAXDWORD, MAXDWORD, &overlapped))
+  {
+    CloseHandle(file_handle);
+    return false;
+  }
+
+  m_file_handle = file_handle;
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__FreeBSD__)
+  const int fd = open(filename, O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0)
+    return false;
+
+  int res;
+  while ((res = flock(fd, LOCK_EX)) != 0 && errno == EINTR)
+    ;
+
+  if (res != 0)
+  {
+    close(fd);
+    return false;
+  }
+
+  m_fd = fd;
+#endif
+
+  m_locked = true;
+  return true;
+}
+
+void FileLock::Unlock()
+{
+  if (!m_locked)
+    return;
+
+#if defined(_WIN32)
+  OVERLAPPED overlapped = {};
+  UnlockFileEx(static_cast<HANDLE>(m_file_handle), 0, MAXDWORD, MAXDWORD, &overlapped);
+  CloseHandle(static_cast<HANDLE>(m_file_handle));
+  m_file_handle = nullptr;
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__FreeBSD__)
+  // closing the descriptor releases the lock
+  close(m_fd);
+  m_fd = -1;
+#endif
+
+  m_locked = false;
+}
+
+} // namespace Common
@@ -0,0 +1,32 @@
+#pragma once
+#include "types.h"
+
+namespace Common {
+
+/// Exclusive lock held on a file, which is shared between processes. Used to serialize appends to files which other
+/// instances can have open at the same time. On platforms without file locking, locking always succeeds.
+class FileLock
+{
+public:
+  FileLock();
+  FileLock(const FileLock&) = delete;
+  ~FileLock();
+
+  FileLock& operator=(const FileLock&) = delete;
+
+  ALWAYS_INLINE bool IsLocked() const { return m_locked; }
+
+  /// Creates the file if it doesn't exist, and blocks until the lock is acquired.
+  bool Lock(const char* filename);
+  void Unlock();
+
+private:
+#if defined(_WIN32)
+  void* m_file_handle = nullptr;
+#else
+  int m_fd = -1;
+#endif
+  bool m_locked = false;
+};
+
+} // namespace Common
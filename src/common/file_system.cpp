@@ -30,6 +30,7 @@
 #include <dirent.h>
 #include <errno.h>
 #include <limits.h>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <unistd.h>
 #endif
@@ -641,6 +642,7 @@ static u32 RecursiveFindFiles(const char* OriginPath, const char* ParentPath, co
     }
 
     outData.Size = (u64)wfd.nFileSizeHigh << 32 | (u64)wfd.nFileSizeLow;
+    outData.ModificationTime = (u64)wfd.ftLastWriteTime.dwHighDateTime << 32 | (u64)wfd.ftLastWriteTime.dwLowDateTime;
 
     nFiles++;
     pResults->push_back(std::move(outData));
@@ -743,6 +745,9 @@ static u32 RecursiveFindFiles(const char* OriginPath, const char* ParentPath, co
 
     outData.Size = static_cast<u64>(sdir_size);
 
+    struct stat st;
+    outData.ModificationTime = (stat(full_path, &st) == 0) ? static_cast<u64>(st.st_mtime) : 0;
+
     // match the filename
     if (hasWildCards)
     {
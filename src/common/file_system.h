@@ -32,6 +32,7 @@ struct FILESYSTEM_FIND_DATA
   std::string FileName;
   u32 Attributes;
   u64 Size;
+  u64 ModificationTime;
 };
 
 namespace FileSystem {
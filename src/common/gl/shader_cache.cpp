@@ -1,8 +1,12 @@
 #include "shader_cache.h"
+#include "../file_lock.h"
 #include "../file_system.h"
 #include "../log.h"
 #include "../md5_digest.h"
 #include "../string_util.h"
+#include "zstd.h"
+#include <algorithm>
+#include <cstring>
 
 #include <file/file_path.h>
 
@@ -25,9 +29,12 @@ struct CacheIndexEntry
   u32 file_offset;
   u32 blob_size;
   u32 blob_format;
+  u32 uncompressed_size;
 };
 #pragma pack(pop)
 
+static constexpr int COMPRESSION_LEVEL = 3;
+
 ShaderCache::ShaderCache() = default;
 
 ShaderCache::~ShaderCache()
@@ -81,7 +88,9 @@ void ShaderCache::Open(bool is_gles, std::string_view base_path, u32 version)
     const std::string index_filename = GetIndexFileName();
     const std::string blob_filename = GetBlobFileName();
 
-    if (!ReadExisting(index_filename, blob_filename))
+    if (ReadExisting(index_filename, blob_filename))
+      StartWarmupThread();
+    else
       CreateNew(index_filename, blob_filename);
   }
 }
@@ -99,7 +108,7 @@ bool ShaderCache::CreateNew(const std::string& index_filename, const std::string
     filestream_delete(blob_filename.c_str());
   }
 
-  m_index_file = FileSystem::OpenRFile(index_filename.c_str(), "wb");
+  m_index_file = FileSystem::OpenRFile(index_filename.c_str(), "w+b");
   if (!m_index_file)
   {
     Log_ErrorPrintf("Failed to open index file '%s' for writing", index_filename.c_str());
@@ -117,6 +126,8 @@ bool ShaderCache::CreateNew(const std::string& index_filename, const std::string
     return false;
   }
 
+  m_index_file_size = sizeof(index_version) + sizeof(m_version);
+
   m_blob_file = FileSystem::OpenRFile(blob_filename.c_str(), "w+b");
   if (!m_blob_file)
   {
@@ -132,70 +143,136 @@ bool ShaderCache::CreateNew(const std::string& index_filename, const std::string
 
 bool ShaderCache::ReadExisting(const std::string& index_filename, const std::string& blob_filename)
 {
-  m_index_file = FileSystem::OpenRFile(index_filename.c_str(), "r+b");
-  if (!m_index_file)
+  Common::MappedFile index_mapping;
+  if (!index_mapping.Open(index_filename.c_str()))
     return false;
 
   u32 file_version = 0;
   u32 data_version = 0;
-  if (rfread(&file_version, sizeof(file_version), 1, m_index_file) != 1 || file_version != FILE_VERSION ||
-      rfread(&data_version, sizeof(data_version), 1, m_index_file) != 1 || data_version != m_version)
+  const size_t index_size = index_mapping.GetSize();
+  if (index_size >= (sizeof(file_version) + sizeof(data_version)))
   {
-    Log_ErrorPrintf("Bad file/data version in '%s'", index_filename.c_str());
-    rfclose(m_index_file);
-    m_index_file = nullptr;
-    return false;
+    std::memcpy(&file_version, index_mapping.GetData(), sizeof(file_version));
+    std::memcpy(&data_version, index_mapping.GetData() + sizeof(file_version), sizeof(data_version));
   }
-
-  m_blob_file = FileSystem::OpenRFile(blob_filename.c_str(), "a+b");
-  if (!m_blob_file)
+  if (file_version != FILE_VERSION || data_version != m_version)
   {
-    Log_ErrorPrintf("Blob file '%s' is missing", blob_filename.c_str());
-    rfclose(m_index_file);
-    m_index_file = nullptr;
+    Log_ErrorPrintf("Bad file/data version in '%s'", index_filename.c_str());
     return false;
   }
 
-  rfseek(m_blob_file, 0, SEEK_END);
-  const u32 blob_file_size = static_cast<u32>(rftell(m_blob_file));
+  // The blob file is empty until the first program is added, in which case it can't be mapped.
+  m_blob_mapping.Open(blob_filename.c_str());
+  const size_t blob_file_size = m_blob_mapping.GetSize();
 
-  for (;;)
+  const size_t entries_size = index_size - (sizeof(file_version) + sizeof(data_version));
+  const size_t entry_count = entries_size / sizeof(CacheIndexEntry);
+  const u8* entry_ptr = index_mapping.GetData() + (sizeof(file_version) + sizeof(data_version));
+  for (size_t i = 0; i < entry_count; i++)
   {
     CacheIndexEntry entry;
-    if (rfread(&entry, sizeof(entry), 1, m_index_file) != 1 ||
-        (entry.file_offset + entry.blob_size) > blob_file_size)
+    std::memcpy(&entry, entry_ptr + i * sizeof(CacheIndexEntry), sizeof(entry));
+    if ((static_cast<size_t>(entry.file_offset) + entry.blob_size) > blob_file_size)
     {
-      if (rfeof(m_index_file))
-        break;
-
       Log_ErrorPrintf("Failed to read entry from '%s', corrupt file?", index_filename.c_str());
       m_index.clear();
-      rfclose(m_blob_file);
-      m_blob_file = nullptr;
-      rfclose(m_index_file);
-      m_index_file = nullptr;
+      m_blob_mapping.Close();
       return false;
     }
+  }
+
+  AddIndexEntries(entry_ptr, entry_count);
+
+  // A partially written entry would misalign everything appended after it.
+  if ((entries_size % sizeof(CacheIndexEntry)) != 0)
+  {
+    Log_ErrorPrintf("Index file '%s' is truncated", index_filename.c_str());
+    m_index.clear();
+    m_blob_mapping.Close();
+    return false;
+  }
+
+  Log_InfoPrintf("Read %zu entries from '%s'", m_index.size(), index_filename.c_str());
+  m_index_file_size = index_size;
+
+  // New programs are only ever appended, so the existing entries stay valid for anything else which has them mapped.
+  // If the files aren't writable, the cache is still usable, new programs just aren't saved.
+  m_index_file = FileSystem::OpenRFile(index_filename.c_str(), "a+b");
+  m_blob_file = FileSystem::OpenRFile(blob_filename.c_str(), "a+b");
+  if (!m_index_file || !m_blob_file)
+  {
+    Log_WarningPrintf("Shader cache '%s' is read-only, new programs will not be saved", blob_filename.c_str());
+    if (m_index_file)
+      rfclose(m_index_file);
+    if (m_blob_file)
+      rfclose(m_blob_file);
+    m_index_file = nullptr;
+    m_blob_file = nullptr;
+  }
+
+  return true;
+}
+
+void ShaderCache::AddIndexEntries(const u8* entry_data, size_t count)
+{
+  for (size_t i = 0; i < count; i++)
+  {
+    CacheIndexEntry entry;
+    std::memcpy(&entry, entry_data + i * sizeof(CacheIndexEntry), sizeof(entry));
 
     const CacheIndexKey key{
       entry.vertex_source_hash_low,   entry.vertex_source_hash_high,   entry.vertex_source_length,
       entry.geometry_source_hash_low, entry.geometry_source_hash_high, entry.geometry_source_length,
       entry.fragment_source_hash_low, entry.fragment_source_hash_high, entry.fragment_source_length};
-    const CacheIndexData data{entry.file_offset, entry.blob_size, entry.blob_format};
+    const CacheIndexData data{entry.file_offset, entry.blob_size, entry.blob_format, entry.uncompressed_size};
     m_index.emplace(key, data);
   }
+}
 
-  Log_InfoPrintf("Read %zu entries from '%s'", m_index.size(), index_filename.c_str());
+bool ShaderCache::ReadNewIndexEntries()
+{
+  const s64 index_size = FileSystem::FSize64(m_index_file);
+  if (index_size < 0 || static_cast<u64>(index_size) < m_index_file_size)
+    return false;
+
+  // Entries are only written with the lock held, so anything other than whole entries means the file is damaged.
+  const u64 new_size = static_cast<u64>(index_size) - m_index_file_size;
+  if ((new_size % sizeof(CacheIndexEntry)) != 0)
+  {
+    Log_ErrorPrintf("Index file has a partial entry, not adding programs");
+    return false;
+  }
+  else if (new_size == 0)
+  {
+    return true;
+  }
+
+  std::vector<u8> entry_data(static_cast<size_t>(new_size));
+  if (rfseek(m_index_file, static_cast<s64>(m_index_file_size), SEEK_SET) != 0 ||
+      rfread(entry_data.data(), 1, entry_data.size(), m_index_file) != static_cast<s64>(entry_data.size()))
+  {
+    return false;
+  }
+
+  AddIndexEntries(entry_data.data(), entry_data.size() / sizeof(CacheIndexEntry));
+  m_index_file_size += new_size;
+  Log_InfoPrintf("Read %u entries added by another instance", static_cast<u32>(new_size / sizeof(CacheIndexEntry)));
   return true;
 }
 
 void ShaderCache::Close()
 {
+  StopWarmupThread();
+
   m_index.clear();
+  m_index_file_size = 0;
   if (m_index_file)
     rfclose(m_index_file);
   if (m_blob_file)
     rfclose(m_blob_file);
+  m_index_file = nullptr;
+  m_blob_file = nullptr;
+  m_blob_mapping.Close();
 }
 
 bool ShaderCache::Recreate()
@@ -262,11 +339,16 @@ std::string ShaderCache::GetBlobFileName() const
   return StringUtil::StdStringFromFormat("%sgl_programs.bin", m_base_path.c_str());
 }
 
+std::string ShaderCache::GetLockFileName() const
+{
+  return StringUtil::StdStringFromFormat("%sgl_programs.lck", m_base_path.c_str());
+}
+
 std::optional<Program> ShaderCache::GetProgram(const std::string_view vertex_shader,
                                                const std::string_view geometry_shader,
                                                const std::string_view fragment_shader, const PreLinkCallback& callback)
 {
-  if (!m_program_binary_supported || !m_blob_file)
+  if (!m_program_binary_supported || (!m_blob_file && !m_blob_mapping.IsOpen()))
     return CompileProgram(vertex_shader, geometry_shader, fragment_shader, callback, false);
 
   const auto key = GetCacheKey(vertex_shader, geometry_shader, fragment_shader);
@@ -274,9 +356,8 @@ std::optional<Program> ShaderCache::GetProgram(const std::string_view vertex_sha
   if (iter == m_index.end())
     return CompileAndAddProgram(key, vertex_shader, geometry_shader, fragment_shader, callback);
 
-  std::vector<u8> data(iter->second.blob_size);
-  if (rfseek(m_blob_file, iter->second.file_offset, SEEK_SET) != 0 ||
-      rfread(data.data(), 1, iter->second.blob_size, m_blob_file) != iter->second.blob_size)
+  std::vector<u8> data;
+  if (!ReadBlob(iter->second, &data))
   {
     Log_ErrorPrintf("Read blob from file failed");
     return {};
@@ -294,6 +375,149 @@ std::optional<Program> ShaderCache::GetProgram(const std::string_view vertex_sha
     return CompileAndAddProgram(key, vertex_shader, geometry_shader, fragment_shader, callback);
 }
 
+bool ShaderCache::ReadBlob(const CacheIndexData& data, std::vector<u8>* out_data)
+{
+  {
+    std::unique_lock<std::mutex> lock(m_warmup_mutex);
+    auto iter = m_warmup_blobs.find(data.file_offset);
+    if (iter != m_warmup_blobs.end())
+    {
+      *out_data = std::move(iter->second);
+      m_warmup_blobs.erase(iter);
+      m_warmup_bytes -= out_data->size();
+      m_warmup_cv.notify_one();
+      return true;
+    }
+
+    // decoding it here, so the warm-up thread shouldn't keep a copy around if it hasn't got to it yet
+    if (m_warmup_thread.joinable())
+      m_warmup_consumed.insert(data.file_offset);
+  }
+
+  return DecodeBlob(data, out_data);
+}
+
+bool ShaderCache::DecodeBlob(const CacheIndexData& data, std::vector<u8>* out_data) const
+{
+  const u8* blob;
+  std::vector<u8> file_data;
+  if ((static_cast<size_t>(data.file_offset) + data.blob_size) <= m_blob_mapping.GetSize())
+  {
+    blob = m_blob_mapping.GetData() + data.file_offset;
+  }
+  else
+  {
+    // Added since the cache was opened, so it's not in the mapping.
+    file_data.resize(data.blob_size);
+    if (!m_blob_file || rfseek(m_blob_file, data.file_offset, SEEK_SET) != 0 ||
+        rfread(file_data.data(), 1, data.blob_size, m_blob_file) != data.blob_size)
+    {
+      return false;
+    }
+
+    blob = file_data.data();
+  }
+
+  if (data.uncompressed_size == 0)
+  {
+    out_data->assign(blob, blob + data.blob_size);
+    return true;
+  }
+
+  out_data->resize(data.uncompressed_size);
+  const size_t size = ZSTD_decompress(out_data->data(), out_data->size(), blob, data.blob_size);
+  if (ZSTD_isError(size) || size != data.uncompressed_size)
+  {
+    Log_ErrorPrintf("Failed to decompress program binary at offset %u", data.file_offset);
+    return false;
+  }
+
+  return true;
+}
+
+void ShaderCache::StartWarmupThread()
+{
+  if (m_index.empty() || !m_blob_mapping.IsOpen())
+    return;
+
+  std::vector<CacheIndexData> entries;
+  entries.reserve(m_index.size());
+  for (const auto& it : m_index)
+    entries.push_back(it.second);
+
+  m_warmup_shutdown = false;
+  m_warmup_thread = std::thread(&ShaderCache::WarmupThreadEntryPoint, this, std::move(entries));
+}
+
+void ShaderCache::StopWarmupThread()
+{
+  if (!m_warmup_thread.joinable())
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(m_warmup_mutex);
+    m_warmup_shutdown = true;
+    m_warmup_cv.notify_all();
+  }
+
+  m_warmup_thread.join();
+  m_warmup_blobs = {};
+  m_warmup_consumed = {};
+  m_warmup_bytes = 0;
+}
+
+void ShaderCache::FinishWarmup()
+{
+  StopWarmupThread();
+}
+
+void ShaderCache::WarmupThreadEntryPoint(std::vector<CacheIndexData> entries)
+{
+  // Going through the file in order keeps the page faults sequential.
+  std::sort(entries.begin(), entries.end(),
+            [](const CacheIndexData& lhs, const CacheIndexData& rhs) { return lhs.file_offset < rhs.file_offset; });
+
+  for (const CacheIndexData& data : entries)
+  {
+    if (data.uncompressed_size == 0)
+    {
+      // Nothing to decompress, touching the pages is enough to make the read on the GL thread cheap.
+      const volatile u8* blob = m_blob_mapping.GetData() + data.file_offset;
+      for (u32 offset = 0; offset < data.blob_size; offset += 4096)
+        static_cast<void>(blob[offset]);
+
+      std::unique_lock<std::mutex> lock(m_warmup_mutex);
+      if (m_warmup_shutdown)
+        return;
+
+      continue;
+    }
+
+    {
+      std::unique_lock<std::mutex> lock(m_warmup_mutex);
+      m_warmup_cv.wait(lock, [this]() { return m_warmup_shutdown || m_warmup_bytes < MAX_WARMUP_BYTES; });
+      if (m_warmup_shutdown)
+        return;
+      else if (m_warmup_consumed.count(data.file_offset) > 0)
+        continue;
+    }
+
+    std::vector<u8> blob;
+    if (!DecodeBlob(data, &blob))
+      continue;
+
+    // the GL thread could have needed it while it was being decoded
+    std::unique_lock<std::mutex> lock(m_warmup_mutex);
+    if (m_warmup_shutdown)
+      return;
+    else if (m_warmup_consumed.count(data.file_offset) > 0)
+      continue;
+
+    m_warmup_bytes += blob.size();
+    m_warmup_blobs.emplace(data.file_offset, std::move(blob));
+  }
+}
+
 std::optional<Program> ShaderCache::CompileProgram(const std::string_view& vertex_shader,
                                                    const std::string_view& geometry_shader,
                                                    const std::string_view& fragment_shader,
@@ -330,13 +554,35 @@ std::optional<Program> ShaderCache::CompileAndAddProgram(const CacheIndexKey& ke
   if (!prog->GetBinary(&prog_data, &prog_format))
     return std::nullopt;
 
-  if (!m_blob_file || rfseek(m_blob_file, 0, SEEK_END) != 0)
+  if (!m_blob_file)
+    return prog;
+
+  // Program binaries compress well, but store them as-is if compression doesn't help.
+  std::vector<u8> compressed_data(ZSTD_compressBound(prog_data.size()));
+  const size_t compressed_size =
+    ZSTD_compress(compressed_data.data(), compressed_data.size(), prog_data.data(), prog_data.size(), COMPRESSION_LEVEL);
+  const bool compressed = (!ZSTD_isError(compressed_size) && compressed_size < prog_data.size());
+  compressed_data.resize(compressed ? compressed_size : 0);
+  const std::vector<u8>& blob = compressed ? compressed_data : prog_data;
+
+  // Other instances can append to the same files. The lock is held from finding the end of the blob file until both
+  // files have been written, so the offset in the index entry always points to our blob.
+  Common::FileLock lock;
+  if (!lock.Lock(GetLockFileName().c_str()))
+  {
+    Log_WarningPrintf("Failed to lock shader cache, program will not be saved");
+    return prog;
+  }
+
+  // Don't add a duplicate if another instance has already added this program.
+  if (!ReadNewIndexEntries() || m_index.find(key) != m_index.end() || rfseek(m_blob_file, 0, SEEK_END) != 0)
     return prog;
 
   CacheIndexData data;
   data.file_offset = static_cast<u32>(rftell(m_blob_file));
-  data.blob_size = static_cast<u32>(prog_data.size());
+  data.blob_size = static_cast<u32>(blob.size());
   data.blob_format = prog_format;
+  data.uncompressed_size = compressed ? static_cast<u32>(prog_data.size()) : 0;
 
   CacheIndexEntry entry = {};
   entry.vertex_source_hash_low = key.vertex_source_hash_low;
@@ -351,16 +597,19 @@ std::optional<Program> ShaderCache::CompileAndAddProgram(const CacheIndexKey& ke
   entry.file_offset = data.file_offset;
   entry.blob_size = data.blob_size;
   entry.blob_format = data.blob_format;
+  entry.uncompressed_size = data.uncompressed_size;
 
-  if (rfwrite(prog_data.data(), 1, entry.blob_size, m_blob_file) != entry.blob_size ||
-      filestream_flush(m_blob_file) != 0 || rfwrite(&entry, sizeof(entry), 1, m_index_file) != 1 ||
-      filestream_flush(m_index_file) != 0)
+  if (rfwrite(blob.data(), 1, entry.blob_size, m_blob_file) != entry.blob_size ||
+      filestream_flush(m_blob_file) != 0 ||
+      rfseek(m_index_file, static_cast<s64>(m_index_file_size), SEEK_SET) != 0 ||
+      rfwrite(&entry, sizeof(entry), 1, m_index_file) != 1 || filestream_flush(m_index_file) != 0)
   {
     Log_ErrorPrintf("Failed to write shader blob to file");
     return prog;
   }
 
   m_index.emplace(key, data);
+  m_index_file_size += sizeof(entry);
   return prog;
 }
 
@@ -1,14 +1,19 @@
 #pragma once
 #include "../file_system.h"
 #include "../hash_combine.h"
+#include "../mapped_file.h"
 #include "../types.h"
 #include "program.h"
+#include <condition_variable>
 #include <cstdio>
 #include <functional>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
+#include <thread>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 namespace GL {
@@ -26,8 +31,15 @@ public:
   std::optional<Program> GetProgram(const std::string_view vertex_shader, const std::string_view geometry_shader,
                                     const std::string_view fragment_shader, const PreLinkCallback& callback = {});
 
+  /// Stops the warm-up thread and frees any binaries it decoded which weren't used. Call once the renderer has
+  /// created its programs, the remaining binaries are for other settings.
+  void FinishWarmup();
+
 private:
-  static constexpr u32 FILE_VERSION = 3;
+  static constexpr u32 FILE_VERSION = 4;
+
+  // Don't let the warm-up thread get too far ahead of the renderer, the cache can hold programs for other settings.
+  static constexpr size_t MAX_WARMUP_BYTES = 64 * 1024 * 1024;
 
   struct CacheIndexKey
   {
@@ -62,6 +74,7 @@ private:
     u32 file_offset;
     u32 blob_size;
     u32 blob_format;
+    u32 uncompressed_size; // zero if the blob is stored uncompressed
   };
 
   using CacheIndex = std::unordered_map<CacheIndexKey, CacheIndexData, CacheIndexEntryHasher>;
@@ -71,12 +84,26 @@ private:
 
   std::string GetIndexFileName() const;
   std::string GetBlobFileName() const;
+  std::string GetLockFileName() const;
 
   bool CreateNew(const std::string& index_filename, const std::string& blob_filename);
   bool ReadExisting(const std::string& index_filename, const std::string& blob_filename);
+  void AddIndexEntries(const u8* entry_data, size_t count);
+
+  /// Reads entries which other instances appended to the index since it was last read. Only call with the lock held.
+  bool ReadNewIndexEntries();
   void Close();
   bool Recreate();
 
+  /// Returns the uncompressed program binary for an index entry, from the warm-up thread if it got there first.
+  bool ReadBlob(const CacheIndexData& data, std::vector<u8>* out_data);
+  bool DecodeBlob(const CacheIndexData& data, std::vector<u8>* out_data) const;
+
+  /// Decompresses the cached binaries, and pages them in, while the renderer is generating shaders.
+  void StartWarmupThread();
+  void StopWarmupThread();
+  void WarmupThreadEntryPoint(std::vector<CacheIndexData> entries);
+
   std::optional<Program> CompileProgram(const std::string_view& vertex_shader, const std::string_view& geometry_shader,
                                         const std::string_view& fragment_shader, const PreLinkCallback& callback,
                                         bool set_retrievable);
@@ -87,6 +114,18 @@ private:
   std::string m_base_path;
   RFILE* m_index_file = nullptr;
   RFILE* m_blob_file = nullptr;
+  u64 m_index_file_size = 0; // how much of the index file has been read
+
+  // Blobs written before the cache was opened. The files are only appended to, so other instances can share them.
+  Common::MappedFile m_blob_mapping;
+
+  std::mutex m_warmup_mutex;
+  std::condition_variable m_warmup_cv;
+  std::unordered_map<u32, std::vector<u8>> m_warmup_blobs; // keyed by file offset
+  std::unordered_set<u32> m_warmup_consumed;               // offsets the GL thread has already read
+  std::thread m_warmup_thread;
+  size_t m_warmup_bytes = 0;
+  bool m_warmup_shutdown = false;
 
   CacheIndex m_index;
   u32 m_version = 0;
@@ -0,0 +1,111 @@
+#include "mapped_file.h"
+#include "file_system.h"
+
+#if defined(_WIN32)
+#include "windows_headers.h"
+#include <encodings/utf.h>
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__FreeBSD__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace Common {
+
+MappedFile::MappedFile() = default;
+
+MappedFile::~MappedFile()
+{
+  Close();
+}
+
+bool MappedFile::Open(const char* filename)
+{
+  Close();
+
+#if defined(_WIN32)
+  wchar_t* wfilename = utf8_to_utf16_string_alloc(filename);
+  HANDLE file_handle = wfilename ? CreateFileW(wfilename, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                                               FILE_ATTRIBUTE_NORMAL, nullptr) :
+                                   INVALID_HANDLE_VALUE;
+  free(wfilename);
+  if (file_handle != INVALID_HANDLE_VALUE)
+  {
+    LARGE_INTEGER size;
+    HANDLE mapping_handle = nullptr;
+    if (GetFileSizeEx(file_handle, &size) && size.QuadPart > 0 &&
+        (mapping_handle = CreateFileMappingW(file_handle, nullptr, PAGE_READONLY, 0, 0, nullptr)) != nullptr)
+    {
+      const void* data = MapViewOfFile(mapping_handle, FILE_MAP_READ, 0, 0, 0);
+      if (data)
+      {
+        m_file_handle = file_handle;
+        m_mapping_handle = mapping_handle;
+        m_data = static_cast<const u8*>(data);
+        m_size = static_cast<size_t>(size.QuadPart);
+        m_mapped = true;
+        return true;
+      }
+
+      CloseHandle(mapping_handle);
+    }
+
+    CloseHandle(file_handle);
+  }
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__FreeBSD__)
+  const int fd = open(filename, O_RDONLY);
+  if (fd >= 0)
+  {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size > 0)
+    {
+      void* data = mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+      if (data != MAP_FAILED)
+      {
+        // The mapping keeps the file alive, we don't need the descriptor.
+        close(fd);
+        m_data = static_cast<const u8*>(data);
+        m_size = static_cast<size_t>(st.st_size);
+        m_mapped = true;
+        return true;
+      }
+    }
+
+    close(fd);
+  }
+#endif
+
+  // Paths which only exist through the frontend's VFS, or platforms without mapping support.
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(filename);
+  if (!data.has_value() || data->empty())
+    return false;
+
+  m_fallback_data = std::move(data.value());
+  m_data = m_fallback_data.data();
+  m_size = m_fallback_data.size();
+  return true;
+}
+
+void MappedFile::Close()
+{
+  if (m_mapped)
+  {
+#if defined(_WIN32)
+    UnmapViewOfFile(m_data);
+    CloseHandle(static_cast<HANDLE>(m_mapping_handle));
+    CloseHandle(static_cast<HANDLE>(m_file_handle));
+    m_mapping_handle = nullptr;
+    m_file_handle = nullptr;
+#elif defined(__linux__) || defined(__ANDROID__) || defined(__APPLE__) || defined(__FreeBSD__)
+    munmap(const_cast<u8*>(m_data), m_size);
+#endif
+    m_mapped = false;
+  }
+
+  m_fallback_data = std::vector<u8>();
+  m_data = nullptr;
+  m_size = 0;
+}
+
+} // namespace Common
@@ -0,0 +1,38 @@
+#pragma once
+#include "types.h"
+#include <vector>
+
+namespace Common {
+
+/// Read-only view of a whole file. The file is memory mapped where the platform supports it, otherwise it's read into
+/// memory, so callers don't need to care which one happened.
+class MappedFile
+{
+public:
+  MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  ~MappedFile();
+
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  ALWAYS_INLINE bool IsOpen() const { return (m_data != nullptr); }
+  ALWAYS_INLINE const u8* GetData() const { return m_data; }
+  ALWAYS_INLINE size_t GetSize() const { return m_size; }
+
+  bool Open(const char* filename);
+  void Close();
+
+private:
+  const u8* m_data = nullptr;
+  size_t m_size = 0;
+
+#if defined(_WIN32)
+  void* m_file_handle = nullptr;
+  void* m_mapping_handle = nullptr;
+#endif
+  bool m_mapped = false;
+
+  std::vector<u8> m_fallback_data;
+};
+
+} // namespace Common
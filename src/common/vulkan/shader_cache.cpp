@@ -431,19 +431,25 @@ std::optional<ShaderCompiler::SPIRVCodeVector> ShaderCache::GetShaderSPV(ShaderC
                                                                          std::string_view shader_code)
 {
   const auto key = GetCacheKey(type, shader_code);
-  auto iter = m_index.find(key);
-  if (iter == m_index.end())
-    return CompileAndAddShaderSPV(key, shader_code);
-
-  SPIRVCodeVector spv(iter->second.blob_size);
-  if (rfseek(m_blob_file, iter->second.file_offset, SEEK_SET) != 0 ||
-      rfread(spv.data(), sizeof(SPIRVCodeType), iter->second.blob_size, m_blob_file) != iter->second.blob_size)
   {
-    Log_ErrorPrintf("Read blob from file failed, recompiling");
-    return ShaderCompiler::CompileShader(type, shader_code, m_debug);
+    std::unique_lock<std::mutex> lock(m_mutex);
+    auto iter = m_index.find(key);
+    if (iter != m_index.end())
+    {
+      SPIRVCodeVector spv(iter->second.blob_size);
+      if (rfseek(m_blob_file, iter->second.file_offset, SEEK_SET) == 0 &&
+          rfread(spv.data(), sizeof(SPIRVCodeType), iter->second.blob_size, m_blob_file) == iter->second.blob_size)
+      {
+        return spv;
+      }
+
+      lock.unlock();
+      Log_ErrorPrintf("Read blob from file failed, recompiling");
+      return ShaderCompiler::CompileShader(type, shader_code, m_debug);
+    }
   }
 
-  return spv;
+  return CompileAndAddShaderSPV(key, shader_code);
 }
 
 VkShaderModule ShaderCache::GetShaderModule(ShaderCompiler::Type type, std::string_view shader_code)
@@ -483,6 +489,11 @@ std::optional<ShaderCompiler::SPIRVCodeVector> ShaderCache::CompileAndAddShaderS
   if (!spv.has_value())
     return {};
 
+  // Another thread may have compiled the same shader while we were.
+  std::lock_guard<std::mutex> guard(m_mutex);
+  if (m_index.find(key) != m_index.end())
+    return spv;
+
   if (!m_blob_file || rfseek(m_blob_file, 0, SEEK_END) != 0)
     return spv;
 
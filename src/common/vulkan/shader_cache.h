@@ -6,6 +6,7 @@
 #include "vulkan_loader.h"
 #include <cstdio>
 #include <memory>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <string_view>
@@ -28,6 +29,7 @@ public:
   /// Writes pipeline cache to file, saving all newly compiled pipelines.
   bool FlushPipelineCache();
 
+  /// Shaders can be fetched from multiple threads. Compilation happens outside the lock.
   std::optional<ShaderCompiler::SPIRVCodeVector> GetShaderSPV(ShaderCompiler::Type type, std::string_view shader_code);
   VkShaderModule GetShaderModule(ShaderCompiler::Type type, std::string_view shader_code);
 
@@ -90,6 +92,7 @@ private:
   std::string m_pipeline_cache_filename;
 
   CacheIndex m_index;
+  std::mutex m_mutex;
 
   VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
   u32 m_version = 0;
@@ -7,9 +7,11 @@
 #include "../log.h"
 #include "../string_util.h"
 #include "util.h"
+#include <atomic>
 #include <cstring>
 #include <fstream>
 #include <memory>
+#include <mutex>
 Log_SetChannel(Vulkan::ShaderCompiler);
 
 // glslang includes
@@ -21,8 +23,10 @@ namespace Vulkan::ShaderCompiler {
 // Registers itself for cleanup via atexit
 bool InitializeGlslang();
 
-static unsigned s_next_bad_shader_id = 1;
+static std::atomic<unsigned> s_next_bad_shader_id{1};
 
+// Shaders can be compiled from multiple threads, so initialization has to be serialized.
+static std::mutex glslang_init_mutex;
 static bool glslang_initialized = false;
 
 static std::optional<SPIRVCodeVector> CompileShaderToSPV(EShLanguage stage, const char* stage_filename,
@@ -44,7 +48,7 @@ static std::optional<SPIRVCodeVector> CompileShaderToSPV(EShLanguage stage, cons
   shader->setStringsWithLengths(&pass_source_code, &pass_source_code_length, 1);
 
   auto DumpBadShader = [&](const char* msg) {
-    std::string filename = StringUtil::StdStringFromFormat("bad_shader_%u.txt", s_next_bad_shader_id++);
+    std::string filename = StringUtil::StdStringFromFormat("bad_shader_%u.txt", s_next_bad_shader_id.fetch_add(1));
     Log::Writef("Vulkan", "CompileShaderToSPV", LogLevel::Error, "%s, writing to %s", msg, filename.c_str());
 
     std::ofstream ofs(filename.c_str(), std::ofstream::out | std::ofstream::binary);
@@ -119,6 +123,7 @@ static std::optional<SPIRVCodeVector> CompileShaderToSPV(EShLanguage stage, cons
 
 bool InitializeGlslang()
 {
+  std::lock_guard<std::mutex> guard(glslang_init_mutex);
   if (glslang_initialized)
     return true;
 
@@ -131,6 +136,7 @@ bool InitializeGlslang()
 
 void DeinitializeGlslang()
 {
+  std::lock_guard<std::mutex> guard(glslang_init_mutex);
   if (!glslang_initialized)
     return;
 
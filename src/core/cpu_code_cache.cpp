@@ -21,6 +21,13 @@ static constexpr u32 RECOMPILE_FRAMES_TO_FALL_BACK_TO_INTERPRETER = 100;
 static constexpr u32 RECOMPILE_COUNT_TO_FALL_BACK_TO_INTERPRETER = 20;
 static constexpr u32 INVALIDATE_THRESHOLD_TO_DISABLE_LINKING = 10;
 
+// Limits for superblock formation in optimized blocks, so a chain of jumps doesn't blow up the block size.
+static constexpr u32 MAX_SUPERBLOCK_BRANCHES = 4;
+static constexpr u32 MAX_SUPERBLOCK_PAGE_DISTANCE = 1;
+
+// Idle loops are short, so don't bother analyzing anything bigger.
+static constexpr u32 MAX_IDLE_LOOP_INSTRUCTIONS = 16;
+
 #ifdef WITH_RECOMPILER
 
 // Currently remapping the code buffer doesn't work in macOS or Haiku.
@@ -315,6 +322,13 @@ static void ExecuteImpl()
       next_block_key = GetNextBlockKey();
       if (next_block_key.bits == block->key.bits)
       {
+        // nothing is going to change until the next event, so skip straight to it
+        if (block->is_idle_loop)
+        {
+          g_state.pending_ticks = std::max(g_state.pending_ticks, g_state.downcount);
+          break;
+        }
+
         // we can jump straight to it if there's no pending interrupts
         // ensure it's not a self-modifying block
         if (!block->invalidated || RevalidateBlock(block, true))
@@ -482,6 +496,11 @@ CodeBlock* LookupBlock(CodeBlockKey key, bool allow_flush)
 
   CodeBlock* block = new CodeBlock(key);
   block->recompile_frame_number = System::GetFrameNumber();
+  if (g_settings.IsUsingTieredRecompiler())
+  {
+    block->tier = CodeBlockTier::Quick;
+    block->hot_counter = g_settings.cpu_recompiler_hot_block_threshold;
+  }
 
   if (CompileBlock(block, allow_flush))
   {
@@ -508,21 +527,25 @@ CodeBlock* LookupBlock(CodeBlockKey key, bool allow_flush)
 
 bool RevalidateBlock(CodeBlock* block, bool allow_flush)
 {
-  for (const CodeBlockInstruction& cbi : block->instructions)
+  // blocks pending promotion are recompiled regardless of whether the code has changed
+  if (!block->promotion_pending)
   {
-    u32 new_code = 0;
-    SafeReadInstruction(cbi.pc, &new_code);
-    if (cbi.instruction.bits != new_code)
-      goto recompile;
-  }
+    for (const CodeBlockInstruction& cbi : block->instructions)
+    {
+      u32 new_code = 0;
+      SafeReadInstruction(cbi.pc, &new_code);
+      if (cbi.instruction.bits != new_code)
+        goto recompile;
+    }
 
-  // re-add it to the page map since it's still up-to-date
-  block->invalidated = false;
-  AddBlockToPageMap(block);
+    // re-add it to the page map since it's still up-to-date
+    block->invalidated = false;
+    AddBlockToPageMap(block);
 #ifdef WITH_RECOMPILER
-  SetFastMap(block->GetPC(), block->host_code);
+    SetFastMap(block->GetPC(), block->host_code);
 #endif
-  return true;
+    return true;
+  }
 
 recompile:
   // remove any references to the block from the lookup table.
@@ -534,23 +557,32 @@ recompile:
   RemoveBlockFromHostCodeMap(block);
 #endif
 
-  const u32 frame_number = System::GetFrameNumber();
-  const u32 frame_diff = frame_number - block->recompile_frame_number;
-  if (frame_diff <= RECOMPILE_FRAMES_TO_FALL_BACK_TO_INTERPRETER)
+  if (block->promotion_pending)
   {
-    block->recompile_count++;
-
-    if (block->recompile_count >= RECOMPILE_COUNT_TO_FALL_BACK_TO_INTERPRETER)
-    {
-      FallbackExistingBlockToInterpreter(block);
-      return false;
-    }
+    // Promotion isn't self-modifying code, so it doesn't count towards falling back to the interpreter.
+    block->promotion_pending = false;
+    block->tier = CodeBlockTier::Optimized;
   }
   else
   {
-    // It's been a while since this block was modified, so it's all good.
-    block->recompile_frame_number = frame_number;
-    block->recompile_count = 0;
+    const u32 frame_number = System::GetFrameNumber();
+    const u32 frame_diff = frame_number - block->recompile_frame_number;
+    if (frame_diff <= RECOMPILE_FRAMES_TO_FALL_BACK_TO_INTERPRETER)
+    {
+      block->recompile_count++;
+
+      if (block->recompile_count >= RECOMPILE_COUNT_TO_FALL_BACK_TO_INTERPRETER)
+      {
+        FallbackExistingBlockToInterpreter(block);
+        return false;
+      }
+    }
+    else
+    {
+      // It's been a while since this block was modified, so it's all good.
+      block->recompile_frame_number = frame_number;
+      block->recompile_count = 0;
+    }
   }
 
   block->instructions.clear();
@@ -577,6 +609,250 @@ recompile:
   return true;
 }
 
+static bool CanFormSuperblockWithBranch(const CodeBlock* block, const CodeBlockInstruction& branch_cbi)
+{
+  if (block->tier != CodeBlockTier::Optimized || g_settings.cpu_recompiler_icache || branch_cbi.is_branch_delay_slot)
+    return false;
+
+  // only plain jumps, anything conditional or linking needs a real block exit
+  const Instruction& instruction = branch_cbi.instruction;
+  switch (instruction.op)
+  {
+    case InstructionOp::j:
+      break;
+
+    case InstructionOp::beq:
+    {
+      if (instruction.i.rs != Reg::zero || instruction.i.rt != Reg::zero)
+        return false;
+    }
+    break;
+
+    case InstructionOp::b:
+    {
+      // bgez zero, target
+      if (instruction.i.rs != Reg::zero || instruction.i.rt.GetValue() != static_cast<Reg>(1))
+        return false;
+    }
+    break;
+
+    default:
+      return false;
+  }
+
+  // the target has to be covered by the same page map, and stay close so invalidation doesn't get too broad
+  const u32 target = GetDirectBranchTarget(instruction, branch_cbi.pc);
+  const u32 target_physical = target & PHYSICAL_MEMORY_ADDRESS_MASK;
+  const u32 block_physical = block->key.GetPCPhysicalAddress();
+  if ((target & 3) != 0 || (target_physical < 0x200000) != block->IsInRAM() ||
+      (std::max(target_physical, block_physical) - std::min(target_physical, block_physical)) / HOST_PAGE_SIZE >
+        MAX_SUPERBLOCK_PAGE_DISTANCE)
+  {
+    return false;
+  }
+
+  // don't unroll loops
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    if (cbi.pc == target)
+      return false;
+  }
+
+  return true;
+}
+
+static bool IsIdleLoopInstruction(const CodeBlockInstruction& cbi)
+{
+  if (cbi.can_trap || cbi.is_store_instruction)
+    return false;
+
+  const Instruction& instruction = cbi.instruction;
+  switch (instruction.op)
+  {
+    case InstructionOp::funct:
+    {
+      switch (instruction.r.funct)
+      {
+        case InstructionFunct::sll:
+        case InstructionFunct::srl:
+        case InstructionFunct::sra:
+        case InstructionFunct::sllv:
+        case InstructionFunct::srlv:
+        case InstructionFunct::srav:
+        case InstructionFunct::mfhi:
+        case InstructionFunct::mflo:
+        case InstructionFunct::addu:
+        case InstructionFunct::subu:
+        case InstructionFunct::and_:
+        case InstructionFunct::or_:
+        case InstructionFunct::xor_:
+        case InstructionFunct::nor:
+        case InstructionFunct::slt:
+        case InstructionFunct::sltu:
+          return true;
+
+        default:
+          return false;
+      }
+    }
+
+    // bltzal/bgezal write ra
+    case InstructionOp::b:
+      return ((static_cast<u8>(instruction.i.rt.GetValue()) & u8(0x1E)) != u8(0x10));
+
+    case InstructionOp::j:
+    case InstructionOp::beq:
+    case InstructionOp::bne:
+    case InstructionOp::blez:
+    case InstructionOp::bgtz:
+    case InstructionOp::addiu:
+    case InstructionOp::slti:
+    case InstructionOp::sltiu:
+    case InstructionOp::andi:
+    case InstructionOp::ori:
+    case InstructionOp::xori:
+    case InstructionOp::lui:
+    case InstructionOp::lb:
+    case InstructionOp::lh:
+    case InstructionOp::lwl:
+    case InstructionOp::lw:
+    case InstructionOp::lbu:
+    case InstructionOp::lhu:
+    case InstructionOp::lwr:
+      return true;
+
+    default:
+      return false;
+  }
+}
+
+static bool IsPollableStatusAddress(VirtualMemoryAddress address)
+{
+  // Only status registers which change when an event runs or an interrupt is raised, and have no side effects when
+  // read. Anything derived from the tick count (root counters) can't be skipped over, since the loop could be waiting
+  // for a particular value. FIFOs (CD-ROM response/data, GPUREAD) are popped by the read.
+  const PhysicalMemoryAddress paddr = address & PHYSICAL_MEMORY_ADDRESS_MASK;
+  return (paddr >= Bus::INTERRUPT_CONTROLLER_BASE && paddr < (Bus::INTERRUPT_CONTROLLER_BASE + 8)) || // I_STAT, I_MASK
+         (paddr == Bus::CDROM_BASE) || (paddr == (Bus::CDROM_BASE + 3)) ||                     // index/status, IE/IF
+         (paddr >= (Bus::GPU_BASE + 4) && paddr < (Bus::GPU_BASE + 8)) ||                       // GPUSTAT
+         (paddr >= (Bus::SPU_BASE + 0x1AE) && paddr < (Bus::SPU_BASE + 0x1B0));                 // SPUSTAT
+}
+
+static bool LoadsOnlyFromStatusRegisters(const CodeBlock* block)
+{
+  // Polling RAM isn't safe to skip, the value could be produced by code which runs between events. So the address of
+  // every load has to be known at compile time, which means the base register is built inside the loop (lui/ori/addiu).
+  std::array<std::optional<u32>, 32> const_regs = {};
+  const_regs[0] = 0;
+
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    const Instruction& instruction = cbi.instruction;
+    const Reg rs = instruction.i.rs;
+    const Reg rt = instruction.i.rt;
+    if (cbi.is_load_instruction &&
+        (!const_regs[static_cast<u8>(rs)].has_value() ||
+         !IsPollableStatusAddress(const_regs[static_cast<u8>(rs)].value() + instruction.i.imm_sext32())))
+    {
+      return false;
+    }
+
+    std::optional<u32> value;
+    switch (instruction.op)
+    {
+      case InstructionOp::lui:
+        value = instruction.i.imm_zext32() << 16;
+        break;
+
+      case InstructionOp::ori:
+        if (const_regs[static_cast<u8>(rs)].has_value())
+          value = const_regs[static_cast<u8>(rs)].value() | instruction.i.imm_zext32();
+        break;
+
+      case InstructionOp::addiu:
+        if (const_regs[static_cast<u8>(rs)].has_value())
+          value = const_regs[static_cast<u8>(rs)].value() + instruction.i.imm_sext32();
+        break;
+
+      default:
+        break;
+    }
+
+    for (u8 reg = 1; reg < 32; reg++)
+    {
+      if (InstructionWritesRegister(instruction, static_cast<Reg>(reg)))
+        const_regs[reg] = (static_cast<Reg>(reg) == rt) ? value : std::nullopt;
+    }
+  }
+
+  return true;
+}
+
+static bool IsIdleLoop(const CodeBlock* block)
+{
+  // Looking for a short block which polls hardware registers, and branches back to itself. Anything with side
+  // effects (stores, cop instructions, links) disqualifies it.
+  const u32 num_instructions = static_cast<u32>(block->instructions.size());
+  if (num_instructions < 2 || num_instructions > MAX_IDLE_LOOP_INSTRUCTIONS || block->contains_double_branches)
+    return false;
+
+  const CodeBlockInstruction& branch_cbi = block->instructions[num_instructions - 2];
+  if (!branch_cbi.is_direct_branch_instruction ||
+      GetDirectBranchTarget(branch_cbi.instruction, branch_cbi.pc) != block->GetPC())
+  {
+    return false;
+  }
+
+  u32 written_regs = 0;
+  bool has_load = false;
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    if (!IsIdleLoopInstruction(cbi) || (cbi.is_branch_instruction && &cbi != &branch_cbi))
+      return false;
+
+    has_load |= cbi.is_load_instruction;
+    for (u8 reg = 1; reg < 32; reg++)
+    {
+      if (InstructionWritesRegister(cbi.instruction, static_cast<Reg>(reg)))
+        written_regs |= (1u << reg);
+    }
+  }
+  if (!has_load || !LoadsOnlyFromStatusRegisters(block))
+    return false;
+
+  // The loop has to produce the same result every iteration when memory doesn't change. That means any register it
+  // writes must be written before it's read, otherwise there's a dependency on the previous iteration (e.g. a counter).
+  // Loads only complete after the delay slot, so they're tracked separately.
+  u32 defined_regs = 0;
+  u32 pending_load_regs = 0;
+  for (const CodeBlockInstruction& cbi : block->instructions)
+  {
+    u32 new_load_regs = 0;
+    for (u8 reg = 1; reg < 32; reg++)
+    {
+      const u32 bit = (1u << reg);
+      if ((written_regs & bit) && !(defined_regs & bit) &&
+          InstructionReadsRegister(cbi.instruction, static_cast<Reg>(reg)))
+      {
+        return false;
+      }
+
+      if (InstructionWritesRegister(cbi.instruction, static_cast<Reg>(reg)))
+      {
+        if (cbi.has_load_delay)
+          new_load_regs |= bit;
+        else
+          defined_regs |= bit;
+      }
+    }
+
+    defined_regs |= pending_load_regs;
+    pending_load_regs = new_load_regs;
+  }
+
+  return true;
+}
+
 bool CompileBlock(CodeBlock* block, bool allow_flush)
 {
   u32 pc = block->GetPC();
@@ -587,8 +863,10 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
   block->uncached_fetch_ticks = 0;
   block->contains_double_branches = false;
   block->contains_loadstore_instructions = false;
+  block->contains_superblock_branches = false;
 
   u32 last_cache_line = ICACHE_LINES;
+  u32 superblock_branch_count = 0;
 
   for (;;)
   {
@@ -647,8 +925,25 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
 
     // if we're in a branch delay slot, the block is now done
     // except if this is a branch in a branch delay slot, then we grab the one after that, and so on...
+    // optimized blocks can also continue at the target of an unconditional jump, forming a superblock.
     if (is_branch_delay_slot && !cbi.is_branch_instruction)
-      break;
+    {
+      CodeBlockInstruction& branch_cbi = block->instructions[block->instructions.size() - 2];
+      if (IsExitBlockInstruction(cbi.instruction) || superblock_branch_count >= MAX_SUPERBLOCK_BRANCHES ||
+          !CanFormSuperblockWithBranch(block, branch_cbi))
+      {
+        break;
+      }
+
+      branch_cbi.is_superblock_branch = true;
+      block->contains_superblock_branches = true;
+      superblock_branch_count++;
+
+      pc = GetDirectBranchTarget(branch_cbi.instruction, branch_cbi.pc);
+      is_branch_delay_slot = false;
+      is_load_delay_slot = cbi.has_load_delay;
+      continue;
+    }
 
     // if this is a branch, we grab the next instruction (delay slot), and then exit
     is_branch_delay_slot = cbi.is_branch_instruction;
@@ -666,6 +961,8 @@ bool CompileBlock(CodeBlock* block, bool allow_flush)
   else
     return false;
 
+  block->is_idle_loop = g_settings.cpu_idle_loop_skipping && IsIdleLoop(block);
+
 #ifdef WITH_RECOMPILER
   if (g_settings.IsUsingRecompiler())
   {
@@ -1112,4 +1409,17 @@ void CPU::Recompiler::Thunks::ResolveBranch(CodeBlock* block, void* host_pc, voi
   }
 }
 
+void CPU::Recompiler::Thunks::PromoteBlock(CodeBlock* block)
+{
+  using namespace CPU::CodeCache;
+
+  // We can't recompile here, since a flush would free the code we're returning through. Instead, send the block back
+  // through the compile function, which recompiles it at the optimized tier on the next dispatch.
+  RemoveBlockFromPageMap(block);
+  UnlinkBlock(block);
+  SetFastMap(block->GetPC(), FastCompileBlockFunction);
+  block->invalidated = true;
+  block->promotion_pending = true;
+}
+
 #endif // WITH_RECOMPILER
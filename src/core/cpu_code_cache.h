@@ -4,6 +4,7 @@
 #include "common/jit_code_buffer.h"
 #include "common/page_fault_handler.h"
 #include "cpu_types.h"
+#include <algorithm>
 #include <array>
 #include <map>
 #include <memory>
@@ -42,6 +43,13 @@ union CodeBlockKey
   ALWAYS_INLINE bool operator<(const CodeBlockKey& rhs) const { return bits < rhs.bits; }
 };
 
+enum class CodeBlockTier : u8
+{
+  Normal,   // Tiered compilation disabled, everything is compiled with the default analysis.
+  Quick,    // First pass, minimal analysis, counts executions until the block is hot.
+  Optimized // Hot block, recompiled with the more expensive optimizations.
+};
+
 struct CodeBlockInstruction
 {
   Instruction instruction;
@@ -57,6 +65,7 @@ struct CodeBlockInstruction
   bool is_last_instruction : 1;
   bool has_load_delay : 1;
   bool can_trap : 1;
+  bool is_superblock_branch : 1;
 };
 
 struct CodeBlock
@@ -90,8 +99,14 @@ struct CodeBlock
 
   bool contains_loadstore_instructions = false;
   bool contains_double_branches = false;
+  bool contains_superblock_branches = false;
+  bool is_idle_loop = false;
   bool invalidated = false;
   bool can_link = true;
+  bool promotion_pending = false;
+
+  CodeBlockTier tier = CodeBlockTier::Normal;
+  u32 hot_counter = 0;
 
   u32 recompile_frame_number = 0;
   u32 recompile_count = 0;
@@ -99,8 +114,27 @@ struct CodeBlock
 
   u32 GetPC() const { return key.GetPC(); }
   u32 GetSizeInBytes() const { return static_cast<u32>(instructions.size()) * sizeof(Instruction); }
-  u32 GetStartPageIndex() const { return (key.GetPCPhysicalAddress() / HOST_PAGE_SIZE); }
-  u32 GetEndPageIndex() const { return ((key.GetPCPhysicalAddress() + GetSizeInBytes()) / HOST_PAGE_SIZE); }
+  u32 GetStartPageIndex() const
+  {
+    if (!contains_superblock_branches)
+      return (key.GetPCPhysicalAddress() / HOST_PAGE_SIZE);
+
+    // branch targets can be before the start of the block
+    u32 page = key.GetPCPhysicalAddress() / HOST_PAGE_SIZE;
+    for (const CodeBlockInstruction& cbi : instructions)
+      page = std::min<u32>(page, (cbi.pc & PHYSICAL_MEMORY_ADDRESS_MASK) / HOST_PAGE_SIZE);
+    return page;
+  }
+  u32 GetEndPageIndex() const
+  {
+    if (!contains_superblock_branches)
+      return ((key.GetPCPhysicalAddress() + GetSizeInBytes()) / HOST_PAGE_SIZE);
+
+    u32 page = key.GetPCPhysicalAddress() / HOST_PAGE_SIZE;
+    for (const CodeBlockInstruction& cbi : instructions)
+      page = std::max<u32>(page, ((cbi.pc & PHYSICAL_MEMORY_ADDRESS_MASK) + sizeof(Instruction)) / HOST_PAGE_SIZE);
+    return page;
+  }
   bool IsInRAM() const
   {
     // TODO: Constant
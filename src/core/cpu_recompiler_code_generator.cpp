@@ -927,7 +927,14 @@ void CodeGenerator::GenerateExceptionExit(const CodeBlockInstruction& cbi, Excep
 
 void CodeGenerator::BlockPrologue()
 {
-  InitSpeculativeRegs();
+  // quick blocks skip constant propagation, it's not worth the compile time for code which may only run once
+  if (m_block->tier != CodeBlockTier::Quick)
+    InitSpeculativeRegs();
+  else
+    InvalidateSpeculativeValues();
+
+  if (m_block->tier == CodeBlockTier::Quick)
+    EmitHotBlockCheck();
 
   EmitStoreCPUStructField(offsetof(State, exception_raised), Value::FromConstantU8(0));
 
@@ -943,6 +950,43 @@ void CodeGenerator::BlockPrologue()
   m_gte_busy_cycles_dirty = true;
 }
 
+void CodeGenerator::EmitHotBlockCheck()
+{
+  // if (--block->hot_counter == 0) PromoteBlock(block), return to dispatcher
+  LabelType not_hot;
+  {
+    Value counter = m_register_cache.AllocateScratch(RegSize_32);
+    EmitLoadGlobal(counter.GetHostRegister(), RegSize_32, &m_block->hot_counter);
+    EmitSub(counter.GetHostRegister(), counter.GetHostRegister(), Value::FromConstantU32(1), false);
+    EmitStoreGlobal(&m_block->hot_counter, counter);
+    EmitConditionalBranch(Condition::NotZero, false, counter.GetHostRegister(), RegSize_32, &not_hot);
+  }
+
+  m_register_cache.PushState();
+
+  EmitBranch(GetCurrentFarCodePointer());
+
+  // nothing has executed yet, so pc still points to the start of this block
+  SwitchToFarCode();
+  EmitFunctionCall(nullptr, &CPU::Recompiler::Thunks::PromoteBlock, Value::FromConstantPtr(m_block));
+  EmitEndBlock(true, true);
+  SwitchToNearCode();
+
+  m_register_cache.PopState();
+
+  EmitBindLabel(&not_hot);
+}
+
+void CodeGenerator::EmitSkipToNextEvent(Value& pending_ticks, const Value& downcount)
+{
+  // pending_ticks = max(pending_ticks, downcount), the loop can't make progress until the next event runs
+  LabelType already_due;
+  EmitConditionalBranch(Condition::GreaterEqual, false, pending_ticks.GetHostRegister(), downcount, &already_due);
+  EmitCopyValue(pending_ticks.GetHostRegister(), downcount);
+  EmitStoreCPUStructField(offsetof(State, pending_ticks), pending_ticks);
+  EmitBindLabel(&already_due);
+}
+
 void CodeGenerator::BlockEpilogue()
 {
 #if defined(_DEBUG) && defined(CPU_X64)
@@ -1439,13 +1483,34 @@ bool CodeGenerator::Compile_Load(const CodeBlockInstruction& cbi)
       break;
   }
 
-  m_register_cache.WriteGuestRegisterDelayed(cbi.instruction.i.rt, std::move(result));
+  if (CanEliminateLoadDelay(cbi))
+  {
+    EmitCancelInterpreterLoadDelayForReg(cbi.instruction.i.rt);
+    m_register_cache.WriteGuestRegister(cbi.instruction.i.rt, std::move(result));
+  }
+  else
+  {
+    m_register_cache.WriteGuestRegisterDelayed(cbi.instruction.i.rt, std::move(result));
+  }
   SpeculativeWriteReg(cbi.instruction.i.rt, value_spec);
 
   InstructionEpilogue(cbi);
   return true;
 }
 
+bool CodeGenerator::CanEliminateLoadDelay(const CodeBlockInstruction& cbi) const
+{
+  // Only done for optimized blocks. If the instruction in the load delay slot doesn't touch the loaded register, the
+  // value can be written immediately, instead of going through the load delay. Exceptions in the delay slot flush the
+  // load delay anyway, so the result is the same.
+  if (m_block->tier != CodeBlockTier::Optimized || (m_current_instruction + 1) == m_block_end)
+    return false;
+
+  const Reg rt = cbi.instruction.i.rt;
+  const Instruction& next_instruction = (m_current_instruction + 1)->instruction;
+  return (!InstructionReadsRegister(next_instruction, rt) && !InstructionWritesRegister(next_instruction, rt));
+}
+
 bool CodeGenerator::Compile_Store(const CodeBlockInstruction& cbi)
 {
   InstructionPrologue(cbi, 1);
@@ -2143,6 +2208,19 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
 {
   InstructionPrologue(cbi, 1);
 
+  if (cbi.is_superblock_branch)
+  {
+    // The target was decoded straight after the delay slot, so there's no need to leave the block.
+    InstructionEpilogue(cbi);
+    m_current_instruction++;
+    if (!CompileInstruction(*m_current_instruction))
+      return false;
+
+    m_pc = GetDirectBranchTarget(cbi.instruction, cbi.pc);
+    m_pc_valid = true;
+    return true;
+  }
+
   auto DoBranch = [this, &cbi](Condition condition, const Value& lhs, const Value& rhs, Reg lr_reg,
                                Value&& branch_target) {
     const bool can_link_block = cbi.is_direct_branch_instruction && g_settings.cpu_recompiler_block_linking;
@@ -2288,6 +2366,9 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
         m_register_cache.PushState();
         {
           WriteNewPC(branch_target, false);
+          if (m_block->is_idle_loop)
+            EmitSkipToNextEvent(pending_ticks, downcount);
+
           EmitConditionalBranch(Condition::GreaterEqual, false, pending_ticks.GetHostRegister(), downcount,
                                 &return_to_dispatcher);
 
@@ -2322,6 +2403,8 @@ bool CodeGenerator::Compile_Branch(const CodeBlockInstruction& cbi)
       else
       {
         WriteNewPC(branch_target, true);
+        if (m_block->is_idle_loop)
+          EmitSkipToNextEvent(pending_ticks, downcount);
       }
 
       EmitConditionalBranch(Condition::GreaterEqual, false, pending_ticks.GetHostRegister(), downcount,
@@ -2836,8 +2919,33 @@ void CodeGenerator::DoGTERegisterWrite(u32 index, const Value& value)
     break;
 
     case 28: // IRGB
-    case 30: // LZCS
+    {
+      // IRGB register, convert 555 to 16-bit
+      EmitStoreCPUStructField(State::GTERegisterOffset(index), AndValues(value, Value::FromConstantU32(0x7FFF)));
+      for (u32 i = 0; i < 3; i++)
+      {
+        Value component = AndValues(ShrValues(value, Value::FromConstantU32(i * 5)), Value::FromConstantU32(0x1F));
+        EmitStoreCPUStructField(State::GTERegisterOffset(9 + i), ShlValues(component, Value::FromConstantU32(7)));
+      }
+      return;
+    }
+
     case 63: // FLAG
+    {
+      // error bit is the OR of bits 30..23, 18..13
+      Value flag = AndValues(value, Value::FromConstantU32(0x7FFFF000));
+      if (flag.IsConstant())
+        flag = GetValueInHostRegister(flag);
+
+      Value error = m_register_cache.AllocateScratch(RegSize_32);
+      EmitTest(flag.GetHostRegister(), Value::FromConstantU32(0x7F87E000));
+      EmitSetConditionResult(error.GetHostRegister(), RegSize_32, Condition::NotZero);
+      EmitStoreCPUStructField(State::GTERegisterOffset(index),
+                              OrValues(flag, ShlValues(error, Value::FromConstantU32(31))));
+      return;
+    }
+
+    case 30: // LZCS
     {
       EmitFunctionCall(nullptr, &GTE::WriteRegister, Value::FromConstantU32(index), value);
       return;
@@ -2963,8 +3071,12 @@ bool CodeGenerator::Compile_cop2(const CodeBlockInstruction& cbi)
     StallUntilGTEComplete();
     InstructionPrologue(cbi, 1);
 
-    Value instruction_bits = Value::FromConstantU32(cbi.instruction.bits & GTE::Instruction::REQUIRED_BITS_MASK);
-    EmitFunctionCall(nullptr, func, instruction_bits);
+    // simple commands are emitted inline, rather than calling out to the GTE
+    if (!EmitInlineGTECommand(cbi.instruction.bits))
+    {
+      Value instruction_bits = Value::FromConstantU32(cbi.instruction.bits & GTE::Instruction::REQUIRED_BITS_MASK);
+      EmitFunctionCall(nullptr, func, instruction_bits);
+    }
     AddGTETicks(func_ticks);
 
     InstructionEpilogue(cbi);
@@ -2994,6 +3106,9 @@ CodeGenerator::SpeculativeValue CodeGenerator::SpeculativeReadReg(Reg reg)
 
 void CodeGenerator::SpeculativeWriteReg(Reg reg, SpeculativeValue value)
 {
+  if (m_block->tier == CodeBlockTier::Quick)
+    return;
+
   m_speculative_constants.regs[static_cast<u8>(reg)] = value;
 }
 
@@ -3025,6 +3140,9 @@ CodeGenerator::SpeculativeValue CodeGenerator::SpeculativeReadMemory(VirtualMemo
 
 void CodeGenerator::SpeculativeWriteMemory(u32 address, SpeculativeValue value)
 {
+  if (m_block->tier == CodeBlockTier::Quick)
+    return;
+
   PhysicalMemoryAddress phys_addr = address & PHYSICAL_MEMORY_ADDRESS_MASK;
 
   auto it = m_speculative_constants.memory.find(address);
@@ -74,6 +74,7 @@ public:
   void EmitCancelInterpreterLoadDelayForReg(Reg reg);
   void EmitICacheCheckAndUpdate();
   void EmitStallUntilGTEComplete();
+  bool EmitInlineGTECommand(u32 inst_bits);
   void EmitLoadCPUStructField(HostReg host_reg, RegSize size, u32 offset);
   void EmitStoreCPUStructField(u32 offset, const Value& value);
   void EmitAddCPUStructField(u32 offset, const Value& value);
@@ -200,6 +201,8 @@ private:
   // branch target, memory address, etc
   void BlockPrologue();
   void BlockEpilogue();
+  void EmitHotBlockCheck();
+  void EmitSkipToNextEvent(Value& pending_ticks, const Value& downcount);
   void InstructionPrologue(const CodeBlockInstruction& cbi, TickCount cycles, bool force_sync = false);
   void InstructionEpilogue(const CodeBlockInstruction& cbi);
   void TruncateBlockAtCurrentInstruction();
@@ -211,6 +214,8 @@ private:
   Value GetCurrentInstructionPC(u32 offset = 0);
   void WriteNewPC(const Value& value, bool commit);
 
+  bool CanEliminateLoadDelay(const CodeBlockInstruction& cbi) const;
+
   Value DoGTERegisterRead(u32 index);
   void DoGTERegisterWrite(u32 index, const Value& value);
 
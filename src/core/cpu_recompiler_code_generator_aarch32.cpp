@@ -1672,6 +1672,12 @@ void CodeGenerator::EmitStallUntilGTEComplete()
   m_emit->str(GetHostReg32(RARG1), a32::MemOperand(GetCPUPtrReg(), offsetof(State, pending_ticks)));
 }
 
+bool CodeGenerator::EmitInlineGTECommand(u32 inst_bits)
+{
+  // No 64-bit registers to hold the MAC0 result, so leave it to the GTE.
+  return false;
+}
+
 void CodeGenerator::EmitBranch(const void* address, bool allow_scratch)
 {
   const s32 displacement = GetPCDisplacement(GetCurrentCodePointer(), address);
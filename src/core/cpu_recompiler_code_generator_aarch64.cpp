@@ -1844,6 +1844,91 @@ void CodeGenerator::EmitStallUntilGTEComplete()
   m_emit->str(GetHostReg32(RARG1), a64::MemOperand(GetCPUPtrReg(), offsetof(State, pending_ticks)));
 }
 
+bool CodeGenerator::EmitInlineGTECommand(u32 inst_bits)
+{
+  // RTPS/RTPT and MVMVA are only emitted inline by the x64 backend so far, they still call the GTE here
+  const GTE::Instruction inst{inst_bits};
+  if (inst.command != 0x06 && inst.command != 0x2D && inst.command != 0x2E)
+    return false;
+
+  // PGXP culling replaces the NCLIP result
+  if (inst.command == 0x06 && g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_culling)
+    return false;
+
+  Value result = m_register_cache.AllocateScratch(RegSize_64);
+  Value temp = m_register_cache.AllocateScratch(RegSize_64);
+  Value temp2 = m_register_cache.AllocateScratch(RegSize_64);
+  Value flag = m_register_cache.AllocateScratch(RegSize_32);
+  const a64::XRegister result64 = GetHostReg64(result);
+  const a64::XRegister temp64 = GetHostReg64(temp);
+  const a64::XRegister temp2_64 = GetHostReg64(temp2);
+  const a64::WRegister result32 = GetHostReg32(result);
+  const a64::WRegister temp32 = GetHostReg32(temp);
+  const a64::WRegister flag32 = GetHostReg32(flag);
+
+  if (inst.command == 0x06)
+  {
+    // MAC0 = SX0*SY1 + SX1*SY2 + SX2*SY0 - SX0*SY2 - SX1*SY0 - SX2*SY1
+    static constexpr std::array<std::array<u32, 2>, 6> terms = {{{0, 1}, {1, 2}, {2, 0}, {0, 2}, {1, 0}, {2, 1}}};
+    for (u32 i = 0; i < static_cast<u32>(terms.size()); i++)
+    {
+      const a64::XRegister dst = (i == 0) ? result64 : temp64;
+      m_emit->Ldrsh(dst, a64::MemOperand(GetCPUPtrReg(), State::GTERegisterOffset(12 + terms[i][0])));
+      m_emit->Ldrsh(temp2_64, a64::MemOperand(GetCPUPtrReg(), State::GTERegisterOffset(12 + terms[i][1]) + 2));
+      m_emit->Mul(dst, dst, temp2_64);
+      if (i > 2)
+        m_emit->Sub(result64, result64, temp64);
+      else if (i > 0)
+        m_emit->Add(result64, result64, temp64);
+    }
+  }
+  else
+  {
+    // MAC0 = ZSF3*(SZ1+SZ2+SZ3) or ZSF4*(SZ0+SZ1+SZ2+SZ3)
+    const u32 first_sz = (inst.command == 0x2D) ? 17 : 16;
+    m_emit->Ldrh(result32, a64::MemOperand(GetCPUPtrReg(), State::GTERegisterOffset(first_sz)));
+    for (u32 i = first_sz + 1; i <= 19; i++)
+    {
+      m_emit->Ldrh(temp32, a64::MemOperand(GetCPUPtrReg(), State::GTERegisterOffset(i)));
+      m_emit->Add(result32, result32, temp32);
+    }
+
+    m_emit->Ldrsh(temp64,
+                  a64::MemOperand(GetCPUPtrReg(), State::GTERegisterOffset((inst.command == 0x2D) ? 61 : 62)));
+    m_emit->Mul(result64, result64, temp64);
+  }
+
+  // MAC0 overflow/underflow, which also set the error bit
+  m_emit->Mov(flag32, UINT32_C(0x80010000));
+  m_emit->Mov(temp32, UINT32_C(0x80008000));
+  m_emit->Cmp(result64, 0);
+  m_emit->Csel(flag32, temp32, flag32, a64::lt);
+  m_emit->Sxtw(temp64, result32);
+  m_emit->Cmp(temp64, result64);
+  m_emit->Csel(flag32, a64::wzr, flag32, a64::eq);
+  m_emit->Str(result32, a64::MemOperand(GetCPUPtrReg(), State::GTERegisterOffset(24)));
+
+  if (inst.command != 0x06)
+  {
+    // OTZ = clamp(s32(MAC0 >> 12), 0, 0xFFFF), which sets the SZ1/OTZ saturation bit when out of range
+    a64::Label otz_in_range;
+    m_emit->Asr(result64, result64, 12);
+    m_emit->Mov(temp32, 0xFFFF);
+    m_emit->Cmp(result32, temp32);
+    m_emit->B(a64::ls, &otz_in_range);
+    m_emit->Mov(temp32, UINT32_C(0x80040000));
+    m_emit->Orr(flag32, flag32, temp32);
+    m_emit->Asr(result32, result32, 31);
+    m_emit->Mvn(result32, result32);
+    m_emit->And(result32, result32, 0xFFFF);
+    m_emit->Bind(&otz_in_range);
+    m_emit->Str(result32, a64::MemOperand(GetCPUPtrReg(), State::GTERegisterOffset(7)));
+  }
+
+  m_emit->Str(flag32, a64::MemOperand(GetCPUPtrReg(), State::GTERegisterOffset(63)));
+  return true;
+}
+
 void CodeGenerator::EmitBranch(const void* address, bool allow_scratch)
 {
   const s64 jump_distance =
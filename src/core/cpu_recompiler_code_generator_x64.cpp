@@ -1,8 +1,10 @@
 #include "common/align.h"
+#include "common/cpu_features.h"
 #include "cpu_core.h"
 #include "cpu_core_private.h"
 #include "cpu_recompiler_code_generator.h"
 #include "cpu_recompiler_thunks.h"
+#include "gte.h"
 #include "settings.h"
 #include "timing_event.h"
 
@@ -2587,6 +2589,465 @@ void CodeGenerator::EmitStallUntilGTEComplete()
   m_emit->mov(m_emit->dword[GetCPUPtrReg() + offsetof(State, pending_ticks)], GetHostReg32(RRETURN));
 }
 
+namespace GTEInline {
+
+// FLAG bits, including the error bit for the ones which set it.
+static constexpr u32 MAC_OVERFLOW[3] = {UINT32_C(0xC0000000), UINT32_C(0xA0000000), UINT32_C(0x90000000)};
+static constexpr u32 MAC_UNDERFLOW[3] = {UINT32_C(0x88000000), UINT32_C(0x84000000), UINT32_C(0x82000000)};
+static constexpr u32 IR_SATURATED[3] = {UINT32_C(0x81000000), UINT32_C(0x80800000), UINT32_C(0x00400000)};
+static constexpr u32 SZ1_OTZ_SATURATED = UINT32_C(0x80040000);
+static constexpr u32 DIVIDE_OVERFLOW = UINT32_C(0x80020000);
+static constexpr u32 MAC0_OVERFLOW = UINT32_C(0x80010000);
+static constexpr u32 MAC0_UNDERFLOW = UINT32_C(0x80008000);
+static constexpr u32 SX2_SATURATED = UINT32_C(0x80004000);
+static constexpr u32 SY2_SATURATED = UINT32_C(0x80002000);
+static constexpr u32 IR0_SATURATED = UINT32_C(0x00001000);
+
+// First register of RT, LLM and LCM.
+static constexpr u32 MATRIX_REGS[3] = {32, 40, 48};
+
+// First register of TR and BK. FC is only used by the buggy MVMVA variant, which is left to the GTE.
+static constexpr u32 TRANSLATION_REGS[2] = {37, 45};
+
+// RAX, RCX and RDX are never given out by the register cache, so they are used as temporaries here. The products use
+// XMM0-5, which are volatile on both ABIs.
+static void CheckMACOverflow(Xbyak::CodeGenerator* e, const Xbyak::Reg64& value, const Xbyak::Reg32& flag, u32 index)
+{
+  // in range if the value sign-extends from 44 bits, i.e. bits 43 and up are all the same
+  Xbyak::Label in_range;
+  e->mov(e->rax, value);
+  e->sar(e->rax, 43);
+  e->add(e->rax, 1);
+  e->cmp(e->rax, 1);
+  e->jbe(in_range);
+  e->mov(e->eax, MAC_OVERFLOW[index - 1]);
+  e->mov(e->edx, MAC_UNDERFLOW[index - 1]);
+  e->test(value, value);
+  e->cmovs(e->eax, e->edx);
+  e->or_(flag, e->eax);
+  e->L(in_range);
+}
+
+static void CheckMAC0Overflow(Xbyak::CodeGenerator* e, const Xbyak::Reg64& value, const Xbyak::Reg32& flag)
+{
+  Xbyak::Label in_range;
+  e->movsxd(e->rax, value.cvt32());
+  e->cmp(e->rax, value);
+  e->je(in_range);
+  e->mov(e->eax, MAC0_OVERFLOW);
+  e->mov(e->edx, MAC0_UNDERFLOW);
+  e->test(value, value);
+  e->cmovs(e->eax, e->edx);
+  e->or_(flag, e->eax);
+  e->L(in_range);
+}
+
+// Clamps value to the IR1-3 range and stores it. flag_bits can be zero for RTPS's IR3, which doesn't set the flag.
+static void SetIR(Xbyak::CodeGenerator* e, const Xbyak::Reg64& cpu, const Xbyak::Reg32& value, const Xbyak::Reg32& flag,
+                  u32 index, bool lm, u32 flag_bits)
+{
+  const s32 min_value = lm ? 0 : -0x8000;
+  Xbyak::Label not_above, done;
+  e->cmp(value, 0x7FFF);
+  e->jle(not_above);
+  e->mov(value, 0x7FFF);
+  if (flag_bits != 0)
+    e->or_(flag, flag_bits);
+  e->jmp(done);
+  e->L(not_above);
+  e->cmp(value, min_value);
+  e->jge(done);
+  e->mov(value, min_value);
+  if (flag_bits != 0)
+    e->or_(flag, flag_bits);
+  e->L(done);
+  e->mov(e->dword[cpu + State::GTERegisterOffset(8 + index)], value);
+}
+
+// Clamps SX2/SY2 to -400h..3FFh.
+static void ClampSXY(Xbyak::CodeGenerator* e, const Xbyak::Reg32& value, const Xbyak::Reg32& flag, u32 flag_bits)
+{
+  Xbyak::Label in_range;
+  e->lea(e->eax, e->ptr[value.cvt64() + 1024]);
+  e->cmp(e->eax, 2047);
+  e->jbe(in_range);
+  e->or_(flag, flag_bits);
+  e->sar(value, 31);
+  e->and_(value, -2047);
+  e->add(value, 1023);
+  e->L(in_range);
+}
+
+// Branches to fallback if T*1000h plus two products could leave the 44-bit MAC range. Below 2^31 - 2^19 they can't, so
+// the partial sums don't need the checks the SIMD kernels do, and sums which do overflow are left to the GTE.
+static void CheckTranslation(Xbyak::CodeGenerator* e, const Xbyak::Reg64& cpu, u32 first_reg, const void* fallback)
+{
+  for (u32 i = 0; i < 3; i++)
+  {
+    e->mov(e->eax, e->dword[cpu + State::GTERegisterOffset(first_reg + i)]);
+    e->add(e->eax, 0x7FF80000);
+    e->cmp(e->eax, UINT32_C(0xFFEFFFFF));
+    e->ja(fallback);
+  }
+}
+
+// Loads the matrix columns as (M[0][n], M[1][n], M[2][n], 0) into XMM0-2, the same layout the SIMD kernels use.
+static void LoadMatrixColumns(Xbyak::CodeGenerator* e, const Xbyak::Reg64& cpu, u32 first_reg)
+{
+  const u32 offset = State::GTERegisterOffset(first_reg);
+  for (u32 col = 0; col < 3; col++)
+  {
+    const Xbyak::Xmm xcol(col);
+    e->movsx(e->eax, e->word[cpu + offset + col * 2]);
+    e->movd(xcol, e->eax);
+    e->movsx(e->eax, e->word[cpu + offset + (3 + col) * 2]);
+    e->pinsrd(xcol, e->eax, 1);
+    e->movsx(e->eax, e->word[cpu + offset + (6 + col) * 2]);
+    e->pinsrd(xcol, e->eax, 2);
+  }
+}
+
+// x/y/z = T*1000h + M*V, with the matrix columns in XMM0-2. Rows 0 and 1 are summed in XMM3, row 2 in z.
+static void MulMatVec(Xbyak::CodeGenerator* e, const Xbyak::Reg64& cpu, const u32 vector_offsets[3],
+                      std::optional<u32> translation_reg, const Xbyak::Reg64& x, const Xbyak::Reg64& y,
+                      const Xbyak::Reg64& z)
+{
+  if (translation_reg.has_value())
+  {
+    e->pmovsxdq(e->xmm3, e->qword[cpu + State::GTERegisterOffset(translation_reg.value())]);
+    e->psllq(e->xmm3, 12);
+    e->movsxd(z, e->dword[cpu + State::GTERegisterOffset(translation_reg.value() + 2)]);
+    e->shl(z, 12);
+  }
+  else
+  {
+    e->pxor(e->xmm3, e->xmm3);
+    e->xor_(z.cvt32(), z.cvt32());
+  }
+
+  for (u32 col = 0; col < 3; col++)
+  {
+    e->movsx(e->eax, e->word[cpu + vector_offsets[col]]);
+    e->movd(e->xmm5, e->eax);
+    e->pshufd(e->xmm5, e->xmm5, 0);
+    e->pmulld(e->xmm5, Xbyak::Xmm(col));
+    e->pmovsxdq(e->xmm4, e->xmm5);
+    e->paddq(e->xmm3, e->xmm4);
+    e->pextrd(e->eax, e->xmm5, 2);
+    e->movsxd(e->rax, e->eax);
+    e->add(z, e->rax);
+  }
+
+  e->movq(x, e->xmm3);
+  e->pextrq(y, e->xmm3, 1);
+}
+
+static void RTPS(Xbyak::CodeGenerator* e, const Xbyak::Reg64& cpu, u32 vertex, bool sf, bool lm, bool last,
+                 const Xbyak::Reg64& x, const Xbyak::Reg64& y, const Xbyak::Reg64& z, const Xbyak::Reg32& flag)
+{
+  const Xbyak::Reg32 x32 = x.cvt32();
+  const Xbyak::Reg32 y32 = y.cvt32();
+  const Xbyak::Reg32 z32 = z.cvt32();
+  const u32 vector_offsets[3] = {State::GTERegisterOffset(vertex * 2), State::GTERegisterOffset(vertex * 2) + 2,
+                                 State::GTERegisterOffset(vertex * 2 + 1)};
+  MulMatVec(e, cpu, vector_offsets, TRANSLATION_REGS[0], x, y, z);
+
+  // MAC1-3 = xyz SAR (sf*12), IR1-2 = MAC1-2
+  CheckMACOverflow(e, x, flag, 1);
+  CheckMACOverflow(e, y, flag, 2);
+  CheckMACOverflow(e, z, flag, 3);
+  if (sf)
+  {
+    e->sar(x, 12);
+    e->sar(y, 12);
+    e->sar(z, 12);
+  }
+  e->mov(e->dword[cpu + State::GTERegisterOffset(25)], x32);
+  e->mov(e->dword[cpu + State::GTERegisterOffset(26)], y32);
+  e->mov(e->dword[cpu + State::GTERegisterOffset(27)], z32);
+  SetIR(e, cpu, x32, flag, 1, lm, IR_SATURATED[0]);
+  SetIR(e, cpu, y32, flag, 2, lm, IR_SATURATED[1]);
+
+  // IR3 is saturated from MAC3, but the flag is only set from MAC3 SAR 12
+  e->mov(x32, z32);
+  SetIR(e, cpu, x32, flag, 3, lm, 0);
+  if (!sf)
+    e->sar(z, 12);
+
+  Xbyak::Label ir3_in_range;
+  e->lea(e->eax, e->ptr[z + 0x8000]);
+  e->cmp(e->eax, 0xFFFF);
+  e->jbe(ir3_in_range);
+  e->or_(flag, IR_SATURATED[2]);
+  e->L(ir3_in_range);
+
+  // SZ3 = clamp(MAC3 SAR 12, 0, 0xFFFF), pushed onto the FIFO
+  Xbyak::Label sz3_in_range;
+  e->cmp(z32, 0xFFFF);
+  e->jbe(sz3_in_range);
+  e->or_(flag, SZ1_OTZ_SATURATED);
+  e->sar(z32, 31);
+  e->not_(z32);
+  e->and_(z32, 0xFFFF);
+  e->L(sz3_in_range);
+  e->mov(e->rax, e->qword[cpu + State::GTERegisterOffset(17)]);
+  e->mov(e->qword[cpu + State::GTERegisterOffset(16)], e->rax);
+  e->mov(e->eax, e->dword[cpu + State::GTERegisterOffset(19)]);
+  e->mov(e->dword[cpu + State::GTERegisterOffset(18)], e->eax);
+  e->mov(e->dword[cpu + State::GTERegisterOffset(19)], z32);
+
+  // x = UNRDivide(H, SZ3)
+  Xbyak::Label no_divide_overflow, divide_done;
+  e->movzx(e->edx, e->word[cpu + State::GTERegisterOffset(58)]);
+  e->lea(e->eax, e->ptr[z + z]);
+  e->cmp(e->eax, e->edx);
+  e->ja(no_divide_overflow);
+  e->mov(x32, 0x1FFFF);
+  e->or_(flag, DIVIDE_OVERFLOW);
+  e->jmp(divide_done, Xbyak::CodeGenerator::T_NEAR);
+  e->L(no_divide_overflow);
+  e->bsr(e->ecx, z32);
+  e->xor_(e->ecx, 15);
+  e->shl(e->edx, e->cl);
+  e->mov(e->eax, z32);
+  e->shl(e->eax, e->cl);
+  e->mov(e->ecx, e->eax);
+  e->and_(e->eax, 0x7FFF);
+  e->add(e->eax, 0x40);
+  e->shr(e->eax, 7);
+  e->mov(x, reinterpret_cast<uintptr_t>(GTE::GetUNRTable()));
+  e->movzx(e->eax, e->byte[x + e->rax]);
+  e->add(e->eax, 0x101);
+  e->imul(e->ecx, e->eax);
+  e->neg(e->ecx);
+  e->add(e->ecx, 0x80);
+  e->sar(e->ecx, 8);
+  e->add(e->ecx, 0x20000);
+  e->imul(e->ecx, e->eax);
+  e->add(e->ecx, 0x80);
+  e->sar(e->ecx, 8);
+  e->mov(x32, e->ecx);
+  e->imul(x, e->rdx);
+  e->add(x, 0x8000);
+  e->shr(x, 16);
+  e->mov(e->eax, 0x1FFFF);
+  e->cmp(x32, e->eax);
+  e->cmova(x32, e->eax);
+  e->L(divide_done);
+
+  // SX2 = (x*IR1 + OFX) SAR 16, SY2 = (x*IR2 + OFY) SAR 16, pushed onto the FIFO
+  e->movsxd(e->rcx, e->dword[cpu + State::GTERegisterOffset(9)]);
+  e->imul(e->rcx, x);
+  e->movsxd(e->rdx, e->dword[cpu + State::GTERegisterOffset(56)]);
+  e->add(e->rcx, e->rdx);
+  CheckMAC0Overflow(e, e->rcx, flag);
+  e->sar(e->rcx, 16);
+  ClampSXY(e, e->ecx, flag, SX2_SATURATED);
+  e->mov(y32, e->ecx);
+
+  e->movsxd(e->rcx, e->dword[cpu + State::GTERegisterOffset(10)]);
+  e->imul(e->rcx, x);
+  e->movsxd(e->rdx, e->dword[cpu + State::GTERegisterOffset(57)]);
+  e->add(e->rcx, e->rdx);
+  CheckMAC0Overflow(e, e->rcx, flag);
+  e->sar(e->rcx, 16);
+  ClampSXY(e, e->ecx, flag, SY2_SATURATED);
+
+  e->and_(y32, 0xFFFF);
+  e->shl(e->ecx, 16);
+  e->or_(y32, e->ecx);
+  e->mov(e->rax, e->qword[cpu + State::GTERegisterOffset(13)]);
+  e->mov(e->qword[cpu + State::GTERegisterOffset(12)], e->rax);
+  e->mov(e->dword[cpu + State::GTERegisterOffset(14)], y32);
+
+  if (last)
+  {
+    // MAC0 = x*DQA + DQB, IR0 = clamp(MAC0 SAR 12, 0, 0x1000)
+    Xbyak::Label ir0_in_range;
+    e->movsx(e->rcx, e->word[cpu + State::GTERegisterOffset(59)]);
+    e->imul(e->rcx, x);
+    e->movsxd(e->rdx, e->dword[cpu + State::GTERegisterOffset(60)]);
+    e->add(e->rcx, e->rdx);
+    CheckMAC0Overflow(e, e->rcx, flag);
+    e->mov(e->dword[cpu + State::GTERegisterOffset(24)], e->ecx);
+    e->sar(e->rcx, 12);
+    e->cmp(e->ecx, 0x1000);
+    e->jbe(ir0_in_range);
+    e->or_(flag, IR0_SATURATED);
+    e->sar(e->ecx, 31);
+    e->not_(e->ecx);
+    e->and_(e->ecx, 0x1000);
+    e->L(ir0_in_range);
+    e->mov(e->dword[cpu + State::GTERegisterOffset(8)], e->ecx);
+  }
+}
+
+} // namespace GTEInline
+
+bool CodeGenerator::EmitInlineGTECommand(u32 inst_bits)
+{
+  const GTE::Instruction inst{inst_bits};
+  if (inst.command == 0x01 || inst.command == 0x30 || inst.command == 0x12)
+  {
+    // The products use SSE4.1, like the GTE's own SIMD path. PGXP and the widescreen hack change the projection, and
+    // the buggy MVMVA matrix/translation combinations are rare enough to leave to the GTE.
+    const bool is_mvmva = (inst.command == 0x12);
+    if (!CPUFeatures::HasSSE41() ||
+        (!is_mvmva && (g_settings.gpu_pgxp_enable || g_settings.gpu_widescreen_hack)) ||
+        (is_mvmva && (inst.mvmva_multiply_matrix == 3 || inst.mvmva_translation_vector == 2)))
+    {
+      return false;
+    }
+
+    Value x = m_register_cache.AllocateScratch(RegSize_64);
+    Value y = m_register_cache.AllocateScratch(RegSize_64);
+    Value z = m_register_cache.AllocateScratch(RegSize_64);
+    Value flag = m_register_cache.AllocateScratch(RegSize_32);
+    const Xbyak::Reg64 x64 = GetHostReg64(x);
+    const Xbyak::Reg64 y64 = GetHostReg64(y);
+    const Xbyak::Reg64 z64 = GetHostReg64(z);
+    const Xbyak::Reg32 flag32 = GetHostReg32(flag);
+
+    // large translations go through the GTE, which is emitted in far code after the inline path
+    const void* fallback = GetCurrentFarCodePointer();
+    const std::optional<u32> translation_reg =
+      (is_mvmva && inst.mvmva_translation_vector == 3) ?
+        std::nullopt :
+        std::optional<u32>(GTEInline::TRANSLATION_REGS[is_mvmva ? inst.mvmva_translation_vector : 0]);
+    if (translation_reg.has_value())
+      GTEInline::CheckTranslation(m_emit, GetCPUPtrReg(), translation_reg.value(), fallback);
+
+    m_emit->xor_(flag32, flag32);
+    GTEInline::LoadMatrixColumns(m_emit, GetCPUPtrReg(),
+                                 GTEInline::MATRIX_REGS[is_mvmva ? inst.mvmva_multiply_matrix : 0]);
+
+    if (is_mvmva)
+    {
+      // V0-2 are packed XY/Z pairs, IR1-3 are one register each
+      const u32 vector = inst.mvmva_multiply_vector;
+      const u32 vector_offsets[3] = {
+        (vector == 3) ? State::GTERegisterOffset(9) : State::GTERegisterOffset(vector * 2),
+        (vector == 3) ? State::GTERegisterOffset(10) : (State::GTERegisterOffset(vector * 2) + 2),
+        (vector == 3) ? State::GTERegisterOffset(11) : State::GTERegisterOffset(vector * 2 + 1)};
+      GTEInline::MulMatVec(m_emit, GetCPUPtrReg(), vector_offsets, translation_reg, x64, y64, z64);
+
+      const Xbyak::Reg64 results[3] = {x64, y64, z64};
+      for (u32 i = 0; i < 3; i++)
+      {
+        GTEInline::CheckMACOverflow(m_emit, results[i], flag32, i + 1);
+        if (inst.sf)
+          m_emit->sar(results[i], 12);
+        m_emit->mov(m_emit->dword[GetCPUPtrReg() + State::GTERegisterOffset(25 + i)], results[i].cvt32());
+        GTEInline::SetIR(m_emit, GetCPUPtrReg(), results[i].cvt32(), flag32, i + 1, inst.lm,
+                         GTEInline::IR_SATURATED[i]);
+      }
+    }
+    else
+    {
+      // RTPT is RTPS on V0-2, with only the last setting MAC0/IR0
+      const u32 last_vertex = (inst.command == 0x30) ? 2 : 0;
+      for (u32 vertex = 0; vertex <= last_vertex; vertex++)
+      {
+        GTEInline::RTPS(m_emit, GetCPUPtrReg(), vertex, inst.sf, inst.lm, vertex == last_vertex, x64, y64, z64,
+                        flag32);
+      }
+    }
+
+    m_emit->mov(m_emit->dword[GetCPUPtrReg() + State::GTERegisterOffset(63)], flag32);
+
+    if (translation_reg.has_value())
+    {
+      const void* resume = GetCurrentNearCodePointer();
+      SwitchToFarCode();
+      TickCount func_ticks;
+      EmitFunctionCall(nullptr, GTE::GetInstructionImpl(inst_bits, &func_ticks),
+                       Value::FromConstantU32(inst_bits & GTE::Instruction::REQUIRED_BITS_MASK));
+      m_emit->jmp(resume);
+      SwitchToNearCode();
+    }
+
+    return true;
+  }
+
+  if (inst.command != 0x06 && inst.command != 0x2D && inst.command != 0x2E)
+    return false;
+
+  // PGXP culling replaces the NCLIP result
+  if (inst.command == 0x06 && g_settings.gpu_pgxp_enable && g_settings.gpu_pgxp_culling)
+    return false;
+
+  Value result = m_register_cache.AllocateScratch(RegSize_64);
+  Value temp = m_register_cache.AllocateScratch(RegSize_64);
+  Value flag = m_register_cache.AllocateScratch(RegSize_32);
+  const Xbyak::Reg64 result64 = GetHostReg64(result);
+  const Xbyak::Reg64 temp64 = GetHostReg64(temp);
+  const Xbyak::Reg32 result32 = GetHostReg32(result);
+  const Xbyak::Reg32 temp32 = GetHostReg32(temp);
+  const Xbyak::Reg32 flag32 = GetHostReg32(flag);
+
+  if (inst.command == 0x06)
+  {
+    // MAC0 = SX0*SY1 + SX1*SY2 + SX2*SY0 - SX0*SY2 - SX1*SY0 - SX2*SY1
+    static constexpr std::array<std::array<u32, 2>, 6> terms = {{{0, 1}, {1, 2}, {2, 0}, {0, 2}, {1, 0}, {2, 1}}};
+    for (u32 i = 0; i < static_cast<u32>(terms.size()); i++)
+    {
+      const Xbyak::Reg64 dst = (i == 0) ? result64 : temp64;
+      m_emit->movsx(dst, m_emit->word[GetCPUPtrReg() + State::GTERegisterOffset(12 + terms[i][0])]);
+      m_emit->movsx(GetHostReg64(flag), m_emit->word[GetCPUPtrReg() + State::GTERegisterOffset(12 + terms[i][1]) + 2]);
+      m_emit->imul(dst, GetHostReg64(flag));
+      if (i > 2)
+        m_emit->sub(result64, temp64);
+      else if (i > 0)
+        m_emit->add(result64, temp64);
+    }
+  }
+  else
+  {
+    // MAC0 = ZSF3*(SZ1+SZ2+SZ3) or ZSF4*(SZ0+SZ1+SZ2+SZ3)
+    const u32 first_sz = (inst.command == 0x2D) ? 17 : 16;
+    m_emit->movzx(result32, m_emit->word[GetCPUPtrReg() + State::GTERegisterOffset(first_sz)]);
+    for (u32 i = first_sz + 1; i <= 19; i++)
+    {
+      m_emit->movzx(temp32, m_emit->word[GetCPUPtrReg() + State::GTERegisterOffset(i)]);
+      m_emit->add(result32, temp32);
+    }
+
+    m_emit->movsx(temp64, m_emit->word[GetCPUPtrReg() + State::GTERegisterOffset((inst.command == 0x2D) ? 61 : 62)]);
+    m_emit->imul(result64, temp64);
+  }
+
+  // MAC0 overflow/underflow, which also set the error bit
+  Xbyak::Label mac0_in_range;
+  m_emit->xor_(flag32, flag32);
+  m_emit->movsxd(temp64, result32);
+  m_emit->cmp(temp64, result64);
+  m_emit->je(mac0_in_range);
+  m_emit->mov(flag32, UINT32_C(0x80010000));
+  m_emit->mov(temp32, UINT32_C(0x80008000));
+  m_emit->test(result64, result64);
+  m_emit->cmovs(flag32, temp32);
+  m_emit->L(mac0_in_range);
+  m_emit->mov(m_emit->dword[GetCPUPtrReg() + State::GTERegisterOffset(24)], result32);
+
+  if (inst.command != 0x06)
+  {
+    // OTZ = clamp(s32(MAC0 >> 12), 0, 0xFFFF), which sets the SZ1/OTZ saturation bit when out of range
+    Xbyak::Label otz_in_range;
+    m_emit->sar(result64, 12);
+    m_emit->cmp(result32, 0xFFFF);
+    m_emit->jbe(otz_in_range);
+    m_emit->or_(flag32, UINT32_C(0x80040000));
+    m_emit->sar(result32, 31);
+    m_emit->not_(result32);
+    m_emit->and_(result32, 0xFFFF);
+    m_emit->L(otz_in_range);
+    m_emit->mov(m_emit->dword[GetCPUPtrReg() + State::GTERegisterOffset(7)], result32);
+  }
+
+  m_emit->mov(m_emit->dword[GetCPUPtrReg() + State::GTERegisterOffset(63)], flag32);
+  return true;
+}
+
 void CodeGenerator::EmitBranch(const void* address, bool allow_scratch)
 {
   const s64 jump_distance =
@@ -34,6 +34,7 @@ void UncheckedWriteMemoryHalfWord(u32 address, u32 value);
 void UncheckedWriteMemoryWord(u32 address, u32 value);
 
 void ResolveBranch(CodeBlock* block, void* host_pc, void* host_resolve_pc, u32 host_pc_size);
+void PromoteBlock(CodeBlock* block);
 
 } // namespace Recompiler::Thunks
 
@@ -359,4 +359,215 @@ bool IsInvalidInstruction(const Instruction& instruction)
   return true;
 }
 
+bool InstructionReadsRegister(const Instruction& instruction, Reg reg)
+{
+  switch (instruction.op)
+  {
+    case InstructionOp::funct:
+    {
+      switch (instruction.r.funct)
+      {
+        case InstructionFunct::sll:
+        case InstructionFunct::srl:
+        case InstructionFunct::sra:
+          return (instruction.r.rt == reg);
+
+        case InstructionFunct::jr:
+        case InstructionFunct::jalr:
+        case InstructionFunct::mthi:
+        case InstructionFunct::mtlo:
+          return (instruction.r.rs == reg);
+
+        case InstructionFunct::sllv:
+        case InstructionFunct::srlv:
+        case InstructionFunct::srav:
+        case InstructionFunct::mult:
+        case InstructionFunct::multu:
+        case InstructionFunct::div:
+        case InstructionFunct::divu:
+        case InstructionFunct::add:
+        case InstructionFunct::addu:
+        case InstructionFunct::sub:
+        case InstructionFunct::subu:
+        case InstructionFunct::and_:
+        case InstructionFunct::or_:
+        case InstructionFunct::xor_:
+        case InstructionFunct::nor:
+        case InstructionFunct::slt:
+        case InstructionFunct::sltu:
+          return (instruction.r.rs == reg || instruction.r.rt == reg);
+
+        case InstructionFunct::mfhi:
+        case InstructionFunct::mflo:
+        case InstructionFunct::syscall:
+        case InstructionFunct::break_:
+          return false;
+
+        default:
+          return true;
+      }
+    }
+
+    case InstructionOp::j:
+    case InstructionOp::jal:
+    case InstructionOp::lui:
+      return false;
+
+    case InstructionOp::b:
+    case InstructionOp::blez:
+    case InstructionOp::bgtz:
+    case InstructionOp::addi:
+    case InstructionOp::addiu:
+    case InstructionOp::slti:
+    case InstructionOp::sltiu:
+    case InstructionOp::andi:
+    case InstructionOp::ori:
+    case InstructionOp::xori:
+    case InstructionOp::lb:
+    case InstructionOp::lh:
+    case InstructionOp::lw:
+    case InstructionOp::lbu:
+    case InstructionOp::lhu:
+    case InstructionOp::lwc2:
+    case InstructionOp::swc2:
+      return (instruction.i.rs == reg);
+
+    // lwl/lwr merge with the old value of rt
+    case InstructionOp::beq:
+    case InstructionOp::bne:
+    case InstructionOp::lwl:
+    case InstructionOp::lwr:
+    case InstructionOp::sb:
+    case InstructionOp::sh:
+    case InstructionOp::sw:
+    case InstructionOp::swl:
+    case InstructionOp::swr:
+      return (instruction.i.rs == reg || instruction.i.rt == reg);
+
+    case InstructionOp::cop0:
+    case InstructionOp::cop2:
+    {
+      if (!instruction.cop.IsCommonInstruction())
+        return false;
+
+      const CopCommonInstruction common_op = instruction.cop.CommonOp();
+      if (common_op == CopCommonInstruction::mtcn || common_op == CopCommonInstruction::ctcn)
+        return (instruction.r.rt == reg);
+      else if (common_op == CopCommonInstruction::mfcn || common_op == CopCommonInstruction::cfcn)
+        return false;
+      else
+        return true;
+    }
+
+    default:
+      return true;
+  }
+}
+
+bool InstructionWritesRegister(const Instruction& instruction, Reg reg)
+{
+  switch (instruction.op)
+  {
+    case InstructionOp::funct:
+    {
+      switch (instruction.r.funct)
+      {
+        case InstructionFunct::jr:
+        case InstructionFunct::mthi:
+        case InstructionFunct::mtlo:
+        case InstructionFunct::mult:
+        case InstructionFunct::multu:
+        case InstructionFunct::div:
+        case InstructionFunct::divu:
+        case InstructionFunct::syscall:
+        case InstructionFunct::break_:
+          return false;
+
+        case InstructionFunct::sll:
+        case InstructionFunct::srl:
+        case InstructionFunct::sra:
+        case InstructionFunct::sllv:
+        case InstructionFunct::srlv:
+        case InstructionFunct::srav:
+        case InstructionFunct::jalr:
+        case InstructionFunct::mfhi:
+        case InstructionFunct::mflo:
+        case InstructionFunct::add:
+        case InstructionFunct::addu:
+        case InstructionFunct::sub:
+        case InstructionFunct::subu:
+        case InstructionFunct::and_:
+        case InstructionFunct::or_:
+        case InstructionFunct::xor_:
+        case InstructionFunct::nor:
+        case InstructionFunct::slt:
+        case InstructionFunct::sltu:
+          return (instruction.r.rd == reg);
+
+        default:
+          return true;
+      }
+    }
+
+    case InstructionOp::j:
+    case InstructionOp::beq:
+    case InstructionOp::bne:
+    case InstructionOp::blez:
+    case InstructionOp::bgtz:
+    case InstructionOp::sb:
+    case InstructionOp::sh:
+    case InstructionOp::sw:
+    case InstructionOp::swl:
+    case InstructionOp::swr:
+    case InstructionOp::lwc2:
+    case InstructionOp::swc2:
+      return false;
+
+    case InstructionOp::jal:
+      return (reg == Reg::ra);
+
+    case InstructionOp::b:
+    {
+      // bltzal/bgezal
+      const u8 rt = static_cast<u8>(instruction.i.rt.GetValue());
+      return ((rt & u8(0x1E)) == u8(0x10) && reg == Reg::ra);
+    }
+
+    case InstructionOp::addi:
+    case InstructionOp::addiu:
+    case InstructionOp::slti:
+    case InstructionOp::sltiu:
+    case InstructionOp::andi:
+    case InstructionOp::ori:
+    case InstructionOp::xori:
+    case InstructionOp::lui:
+    case InstructionOp::lb:
+    case InstructionOp::lh:
+    case InstructionOp::lw:
+    case InstructionOp::lbu:
+    case InstructionOp::lhu:
+    case InstructionOp::lwl:
+    case InstructionOp::lwr:
+      return (instruction.i.rt == reg);
+
+    case InstructionOp::cop0:
+    case InstructionOp::cop2:
+    {
+      if (!instruction.cop.IsCommonInstruction())
+        return false;
+
+      const CopCommonInstruction common_op = instruction.cop.CommonOp();
+      if (common_op == CopCommonInstruction::mfcn || common_op == CopCommonInstruction::cfcn)
+        return (instruction.r.rt == reg);
+      else if (common_op == CopCommonInstruction::mtcn || common_op == CopCommonInstruction::ctcn)
+        return false;
+      else
+        return true;
+    }
+
+    default:
+      return true;
+  }
+}
+
 } // namespace CPU
@@ -226,6 +226,10 @@ bool IsExitBlockInstruction(const Instruction& instruction);
 bool CanInstructionTrap(const Instruction& instruction, bool in_user_mode);
 bool IsInvalidInstruction(const Instruction& instruction);
 
+/// Conservative register dependency checks, unknown instructions are assumed to read/write every register.
+bool InstructionReadsRegister(const Instruction& instruction, Reg reg);
+bool InstructionWritesRegister(const Instruction& instruction, Reg reg);
+
 struct Registers
 {
   union
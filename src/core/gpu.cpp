@@ -70,6 +70,10 @@ void GPU::CPUClockChanged()
 
 void GPU::Reset(bool clear_vram)
 {
+  // resets and state loads aren't part of the command stream, so the dump would no longer replay correctly
+  StopGPUDump();
+  m_frame_skip = {};
+
   m_GPUSTAT.bits = 0x14802000;
   m_set_texture_disable_mask = false;
   m_GPUREAD_latch = 0;
@@ -360,12 +364,18 @@ void GPU::WriteRegister(u32 offset, u32 value)
   switch (offset)
   {
     case 0x00:
+      if (m_gpu_dump)
+        m_gpu_dump->WriteGP0(value);
+
       m_fifo.Push(value);
       ExecuteCommands();
       UpdateCommandTickEvent();
       return;
 
     case 0x04:
+      if (m_gpu_dump)
+        m_gpu_dump->WriteGP1(value);
+
       WriteGP1(value);
       return;
 
@@ -856,7 +866,9 @@ void GPU::CRTCTickEvent(TickCount ticks)
 
         // flush any pending draws and "scan out" the image
         FlushRender();
-        UpdateDisplay();
+        PresentFrame();
+        if (m_gpu_dump && !m_gpu_dump->WriteVSync(m_crtc_state.interlaced_field))
+          StopGPUDump();
         System::FrameDone();
 
         // switch fields early. this is needed so we draw to the correct one.
@@ -998,6 +1010,134 @@ u32 GPU::ReadGPUREAD()
   return value;
 }
 
+Common::Rectangle<u32> GPU::GetDisplayedBufferRect() const
+{
+  return Common::Rectangle<u32>(m_crtc_state.regs.X, m_crtc_state.regs.Y,
+                                m_crtc_state.display_vram_left + m_crtc_state.display_vram_width,
+                                m_crtc_state.display_vram_top + m_crtc_state.display_vram_height);
+}
+
+void GPU::UpdateFrameSkip(const Common::Rectangle<u32>& previous_buffer)
+{
+  m_frame_skip.vblanks_since_flip = 0;
+  m_frame_skip.next_buffer = previous_buffer;
+
+  // the buffer we just flipped to is missing the skipped draws, so it shouldn't be shown
+  m_frame_skip.hold_display = m_frame_skip.skip_draws;
+  m_frame_skip.skipped_frames = m_frame_skip.skip_draws ? (m_frame_skip.skipped_frames + 1) : 0;
+
+  // decide whether to skip the next buffer
+  // if the buffers overlap, e.g. a scrolling single buffer, draws for the next frame could be visible now
+  const Common::Rectangle<u32> current_buffer = GetDisplayedBufferRect();
+  m_frame_skip.skip_draws = (previous_buffer.Valid() && current_buffer.Valid() &&
+                             !previous_buffer.Intersects(current_buffer) &&
+                             m_frame_skip.skipped_frames < g_settings.display_frame_skip && System::ShouldSkipFrame());
+}
+
+void GPU::PresentFrame()
+{
+  if (!m_frame_skip.hold_display)
+    UpdateDisplay();
+
+  // Stop skipping if the game stops flipping, e.g. it switched to single buffering. Otherwise we'd never present.
+  static constexpr u8 MAX_VBLANKS_WITHOUT_FLIP = 4;
+  if ((m_frame_skip.skip_draws || m_frame_skip.hold_display) &&
+      ++m_frame_skip.vblanks_since_flip >= MAX_VBLANKS_WITHOUT_FLIP)
+  {
+    m_frame_skip = {};
+  }
+}
+
+bool GPU::StartGPUDump(const char* path, u32 num_frames)
+{
+  StopGPUDump();
+
+  // pending draws are part of the snapshot
+  FlushRender();
+
+  m_gpu_dump = GPUDump::Recorder::Create(path, num_frames, this, m_console_is_pal);
+  return static_cast<bool>(m_gpu_dump);
+}
+
+void GPU::StopGPUDump()
+{
+  m_gpu_dump.reset();
+}
+
+void GPU::ResetStats()
+{
+  m_last_frame_stats = m_stats;
+  m_stats = {};
+}
+
+void GPU::ProcessGPUDumpPacket(GPUDump::PacketType type, const u32* data, u32 word_count)
+{
+  switch (type)
+  {
+    case GPUDump::PacketType::GP0Data:
+    {
+      while (word_count > 0)
+      {
+        const u32 count = std::min(word_count, m_fifo.GetSpace());
+        for (u32 i = 0; i < count; i++)
+          m_fifo.Push(ZeroExtend64(data[i]));
+        data += count;
+        word_count -= count;
+
+        for (;;)
+        {
+          const u32 fifo_size = m_fifo.GetSize();
+          m_pending_command_ticks = 0;
+          ExecuteCommands();
+
+          // VRAM reads by the CPU aren't captured, so complete them here.
+          while (m_blitter_state == BlitterState::ReadingVRAM)
+            ReadGPUREAD();
+
+          // stop when the FIFO is empty, or the command at the head needs more words
+          if (m_fifo.IsEmpty() || m_fifo.GetSize() == fifo_size)
+            break;
+        }
+      }
+
+      m_pending_command_ticks = 0;
+    }
+    break;
+
+    case GPUDump::PacketType::GP1Data:
+    {
+      for (u32 i = 0; i < word_count; i++)
+        WriteGP1(data[i]);
+    }
+    break;
+
+    case GPUDump::PacketType::VSync:
+    {
+      // same as the start of vblank in CRTCTickEvent()
+      m_crtc_state.interlaced_field = (word_count > 0) ? Truncate8(data[0] & 1u) : 0;
+      FlushRender();
+      PresentFrame();
+      System::FrameDone();
+
+      if (m_GPUSTAT.InInterleaved480iMode())
+      {
+        m_crtc_state.interlaced_display_field = m_crtc_state.interlaced_field ^ 1u;
+        m_crtc_state.active_line_lsb =
+          Truncate8((m_crtc_state.regs.Y + BoolToUInt32(m_crtc_state.interlaced_display_field)) & u32(1));
+      }
+      else
+      {
+        m_crtc_state.interlaced_display_field = 0;
+        m_crtc_state.active_line_lsb = 0;
+      }
+    }
+    break;
+
+    default:
+      break;
+  }
+}
+
 void GPU::WriteGP1(u32 value)
 {
   const u32 command = (value >> 24) & 0x3Fu;
@@ -1069,8 +1209,11 @@ void GPU::WriteGP1(u32 value)
       if (m_crtc_state.regs.display_address_start != new_value)
       {
         SynchronizeCRTC();
+
+        const Common::Rectangle<u32> previous_buffer = GetDisplayedBufferRect();
         m_crtc_state.regs.display_address_start = new_value;
         UpdateCRTCDisplayParameters();
+        UpdateFrameSkip(previous_buffer);
       }
     }
     break;
@@ -2,6 +2,7 @@
 #include "common/bitfield.h"
 #include "common/fifo_queue.h"
 #include "common/rectangle.h"
+#include "gpu_dump.h"
 #include "gpu_types.h"
 #include "timers.h"
 #include "types.h"
@@ -78,9 +79,25 @@ public:
   ALWAYS_INLINE void DMAWrite(u32 address, u32 value)
   {
     m_fifo.Push((ZeroExtend64(address) << 32) | ZeroExtend64(value));
+    if (m_gpu_dump)
+      m_gpu_dump->WriteGP0(value);
   }
   void EndDMAWrite();
 
+  /// Starts capturing GP0/GP1 writes to the specified file, stopping after num_frames vblanks.
+  bool StartGPUDump(const char* path, u32 num_frames);
+  void StopGPUDump();
+  ALWAYS_INLINE bool IsRecordingGPUDump() const { return static_cast<bool>(m_gpu_dump); }
+
+  /// Returns the counters for the last complete frame.
+  ALWAYS_INLINE const GPUStats& GetLastFrameStats() const { return m_last_frame_stats; }
+
+  /// Ends the frame for the statistics, the counters gathered so far become the last frame's.
+  virtual void ResetStats();
+
+  /// Replays a packet from a GPU dump. Command timing is ignored, the FIFO is executed until it runs dry.
+  void ProcessGPUDumpPacket(GPUDump::PacketType type, const u32* data, u32 word_count);
+
   /// Returns true if no data is being sent from VRAM to the DAC or that no portion of VRAM would be visible on screen.
   ALWAYS_INLINE bool IsDisplayDisabled() const
   {
@@ -226,6 +243,30 @@ protected:
 
   void AddCommandTicks(TickCount ticks);
 
+  /// Returns true if the current draw can be dropped because the frame it's part of won't be presented. Only draws
+  /// confined to the buffer which the next flip will show are dropped. Anything else, e.g. a render-to-texture pass,
+  /// can be sampled by later frames or read back by the CPU, so it has to be kept.
+  ALWAYS_INLINE bool ShouldSkipDraw() const
+  {
+    if (!m_frame_skip.skip_draws)
+      return false;
+
+    const Common::Rectangle<u32>& buffer = m_frame_skip.next_buffer;
+    return (m_drawing_area.left >= buffer.left && m_drawing_area.right < buffer.right &&
+            m_drawing_area.top >= buffer.top && m_drawing_area.bottom < buffer.bottom);
+  }
+
+  /// Returns the VRAM rectangle of the displayed buffer, from the display start address to the end of the visible
+  /// area. Invalid if the display wraps around VRAM.
+  Common::Rectangle<u32> GetDisplayedBufferRect() const;
+
+  /// Called when the display start address changes, i.e. the game flipped buffers. Assuming double buffering, the
+  /// previously displayed buffer is where the next frame will be rendered.
+  void UpdateFrameSkip(const Common::Rectangle<u32>& previous_buffer);
+
+  /// Scans out the display at the start of vblank, unless the displayed buffer was rendered with skipped draws.
+  void PresentFrame();
+
   void WriteGP1(u32 value);
   void EndCommand();
   void ExecuteCommands();
@@ -506,6 +547,20 @@ protected:
   TickCount m_max_run_ahead = 128;
   u32 m_fifo_size = 128;
 
+  std::unique_ptr<GPUDump::Recorder> m_gpu_dump;
+
+  GPUStats m_stats = {};
+  GPUStats m_last_frame_stats = {};
+
+  struct FrameSkipState
+  {
+    bool skip_draws;   // draws to next_buffer are being dropped
+    bool hold_display; // the displayed buffer is missing skipped draws, keep presenting the previous one
+    u8 skipped_frames; // consecutive buffers rendered with skipped draws
+    u8 vblanks_since_flip;
+    Common::Rectangle<u32> next_buffer; // buffer which the next flip will show
+  } m_frame_skip = {};
+
 private:
   using GP0CommandHandler = bool (GPU::*)();
   using GP0CommandHandlerTable = std::array<GP0CommandHandler, 256>;
@@ -1,14 +1,23 @@
 #include "gpu_backend.h"
 #include "common/align.h"
+#include "common/log.h"
 #include "common/state_wrapper.h"
 #include "common/timer.h"
 #include "settings.h"
+Log_SetChannel(GPUBackend);
 
 std::unique_ptr<GPUBackend> g_gpu_backend;
 
 GPUBackend::GPUBackend() = default;
 
-GPUBackend::~GPUBackend() = default;
+GPUBackend::~GPUBackend()
+{
+  if (m_current_chunk)
+    ReleaseCommandChunk(m_current_chunk);
+
+  for (CommandChunk* chunk : m_free_chunks)
+    delete chunk;
+}
 
 bool GPUBackend::Initialize(bool force_thread)
 {
@@ -92,71 +101,172 @@ GPUBackendDrawLineCommand* GPUBackend::NewDrawLineCommand(u32 num_vertices)
   return cmd;
 }
 
+GPUBackendUpdateDisplayCommand* GPUBackend::NewUpdateDisplayCommand()
+{
+  return static_cast<GPUBackendUpdateDisplayCommand*>(
+    AllocateCommand(GPUBackendCommandType::UpdateDisplay, sizeof(GPUBackendUpdateDisplayCommand)));
+}
+
 void* GPUBackend::AllocateCommand(GPUBackendCommandType command, u32 size)
 {
   // Ensure size is a multiple of 4 so we don't end up with an unaligned command.
   size = Common::AlignUpPow2(size, 4);
 
-  for (;;)
+  if (!m_current_chunk || (m_current_chunk->capacity - m_current_chunk->size) < size)
   {
-    u32 read_ptr = m_command_fifo_read_ptr.load();
-    u32 write_ptr = m_command_fifo_write_ptr.load();
-    if (read_ptr > write_ptr)
-    {
-      u32 available_size = read_ptr - write_ptr;
-      while (available_size < (size + sizeof(GPUBackendCommandType)))
-      {
-        WakeGPUThread();
-        read_ptr = m_command_fifo_read_ptr.load();
-        available_size = (read_ptr > write_ptr) ? (read_ptr - write_ptr) : (COMMAND_QUEUE_SIZE - write_ptr);
-      }
-    }
-    else
-    {
-      const u32 available_size = COMMAND_QUEUE_SIZE - write_ptr;
-      if ((size + sizeof(GPUBackendCommand)) > available_size)
-      {
-        // allocate a dummy command to wrap the buffer around
-        GPUBackendCommand* dummy_cmd = reinterpret_cast<GPUBackendCommand*>(&m_command_fifo_data[write_ptr]);
-        dummy_cmd->type = GPUBackendCommandType::Wraparound;
-        dummy_cmd->size = available_size;
-        dummy_cmd->params.bits = 0;
-        m_command_fifo_write_ptr.store(0);
-        continue;
-      }
-    }
-
-    GPUBackendCommand* cmd = reinterpret_cast<GPUBackendCommand*>(&m_command_fifo_data[write_ptr]);
-    cmd->type = command;
-    cmd->size = size;
-    return cmd;
+    SubmitCommandChunk();
+    m_current_chunk = AcquireCommandChunk(size);
   }
+
+  GPUBackendCommand* cmd = reinterpret_cast<GPUBackendCommand*>(&m_current_chunk->data[m_current_chunk->size]);
+  cmd->type = command;
+  cmd->size = size;
+  return cmd;
 }
 
 u32 GPUBackend::GetPendingCommandSize() const
 {
-  const u32 read_ptr = m_command_fifo_read_ptr.load();
-  const u32 write_ptr = m_command_fifo_write_ptr.load();
-  return (write_ptr >= read_ptr) ? (write_ptr - read_ptr) : (COMMAND_QUEUE_SIZE - read_ptr + write_ptr);
+  return m_pending_command_size.load();
 }
 
 void GPUBackend::PushCommand(GPUBackendCommand* cmd)
 {
+  m_current_chunk->size += cmd->size;
+
   if (!m_use_gpu_thread)
   {
     // single-thread mode
     if (cmd->type != GPUBackendCommandType::Sync)
+    {
+      m_executing_chunk = m_current_chunk;
       HandleCommand(cmd);
+      m_executing_chunk = nullptr;
+    }
   }
   else
   {
-    const u32 new_write_ptr = m_command_fifo_write_ptr.fetch_add(cmd->size) + cmd->size;
-    UNREFERENCED_VARIABLE(new_write_ptr);
-    if (GetPendingCommandSize() >= THRESHOLD_TO_WAKE_GPU)
-      WakeGPUThread();
+    // Keep filling the chunk while the GPU thread is busy, otherwise hand over what we have. The end of a frame has to
+    // go through straight away, since nothing might follow it for a while.
+    if (cmd->type == GPUBackendCommandType::Sync || cmd->type == GPUBackendCommandType::UpdateDisplay ||
+        (m_current_chunk->size >= THRESHOLD_TO_WAKE_GPU && m_pending_chunk_count.load() == 0))
+    {
+      SubmitCommandChunk();
+    }
   }
 }
 
+void GPUBackend::SubmitCommandChunk()
+{
+  CommandChunk* chunk = m_current_chunk;
+  if (!chunk)
+    return;
+
+  m_current_chunk = nullptr;
+  if (!m_use_gpu_thread || chunk->size == 0)
+  {
+    // The commands were handled when they were pushed.
+    ReleaseCommandChunk(chunk);
+    return;
+  }
+
+  u32 pending_chunks, pending_size;
+  {
+    std::unique_lock<std::mutex> lock(m_sync_mutex);
+    m_submitted_chunks.push_back(chunk);
+    pending_chunks = m_pending_chunk_count.fetch_add(1) + 1;
+    pending_size = m_pending_command_size.fetch_add(chunk->size) + chunk->size;
+    if (m_gpu_thread_sleeping.load())
+      m_wake_gpu_thread_cv.notify_one();
+  }
+
+  m_queue_stats.chunks_submitted++;
+  m_queue_stats.max_pending_chunks = std::max(m_queue_stats.max_pending_chunks, pending_chunks);
+  m_queue_stats.max_pending_size = std::max(m_queue_stats.max_pending_size, pending_size);
+
+  if (pending_size > MAX_PENDING_COMMAND_SIZE)
+    WaitForCommandQueueSpace();
+}
+
+void GPUBackend::WaitForCommandQueueSpace()
+{
+  const Common::Timer::Value start_time = Common::Timer::GetValue();
+  {
+    std::unique_lock<std::mutex> lock(m_sync_mutex);
+    m_waiting_for_queue_space.store(true);
+    m_queue_space_cv.wait(lock, [this]() { return m_pending_command_size.load() <= MAX_PENDING_COMMAND_SIZE; });
+    m_waiting_for_queue_space.store(false);
+  }
+
+  m_queue_stats.num_stalls++;
+  m_queue_stats.stall_time_ms += Common::Timer::ConvertValueToMilliseconds(Common::Timer::GetValue() - start_time);
+}
+
+void GPUBackend::ResetCommandQueueStats()
+{
+  m_queue_stats = {};
+}
+
+GPUStats GPUBackend::TakeRenderStats()
+{
+  std::unique_lock<std::mutex> lock(m_render_stats_mutex);
+  const GPUStats stats = m_published_render_stats;
+  m_published_render_stats = {};
+  return stats;
+}
+
+void GPUBackend::PublishRenderStats()
+{
+  std::unique_lock<std::mutex> lock(m_render_stats_mutex);
+  m_published_render_stats.Add(m_render_stats);
+  m_render_stats = {};
+}
+
+GPUBackend::CommandChunk* GPUBackend::AcquireCommandChunk(u32 min_size)
+{
+  CommandChunk* chunk = nullptr;
+  if (min_size <= COMMAND_CHUNK_SIZE)
+  {
+    std::unique_lock<std::mutex> lock(m_chunk_pool_mutex);
+    if (!m_free_chunks.empty())
+    {
+      chunk = m_free_chunks.back();
+      m_free_chunks.pop_back();
+    }
+  }
+
+  if (!chunk)
+  {
+    chunk = new CommandChunk();
+    chunk->capacity = std::max(min_size, COMMAND_CHUNK_SIZE);
+    chunk->data = std::make_unique<u8[]>(chunk->capacity);
+  }
+
+  chunk->size = 0;
+  chunk->ref_count.store(1);
+  return chunk;
+}
+
+void GPUBackend::AddCommandChunkReference(CommandChunk* chunk)
+{
+  chunk->ref_count.fetch_add(1);
+}
+
+void GPUBackend::ReleaseCommandChunk(CommandChunk* chunk)
+{
+  if (chunk->ref_count.fetch_sub(1) != 1)
+    return;
+
+  // Chunks for oversized commands, e.g. VRAM uploads, aren't worth keeping around.
+  if (chunk->capacity != COMMAND_CHUNK_SIZE)
+  {
+    delete chunk;
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(m_chunk_pool_mutex);
+  m_free_chunks.push_back(chunk);
+}
+
 void GPUBackend::WakeGPUThread()
 {
   std::unique_lock<std::mutex> lock(m_sync_mutex);
@@ -168,6 +278,13 @@ void GPUBackend::WakeGPUThread()
 
 void GPUBackend::StartGPUThread()
 {
+  // Anything in the current chunk has already been handled.
+  if (m_current_chunk)
+  {
+    ReleaseCommandChunk(m_current_chunk);
+    m_current_chunk = nullptr;
+  }
+
   m_gpu_loop_done.store(false);
   m_use_gpu_thread = true;
   m_gpu_thread = std::thread(&GPUBackend::RunGPULoop, this);
@@ -178,22 +295,32 @@ void GPUBackend::StopGPUThread()
   if (!m_use_gpu_thread)
     return;
 
+  SubmitCommandChunk();
   m_gpu_loop_done.store(true);
   WakeGPUThread();
   m_gpu_thread.join();
   m_use_gpu_thread = false;
+
+  if (m_queue_stats.chunks_submitted > 0)
+  {
+    Log_InfoPrintf("GPU command queue: %u chunks, max depth %u chunks/%u KB, %u stalls totalling %.2f ms",
+                   m_queue_stats.chunks_submitted, m_queue_stats.max_pending_chunks,
+                   m_queue_stats.max_pending_size / 1024, m_queue_stats.num_stalls, m_queue_stats.stall_time_ms);
+  }
 }
 
 void GPUBackend::Sync(bool allow_sleep)
 {
   if (!m_use_gpu_thread)
+  {
+    FlushRender();
     return;
+  }
 
   GPUBackendSyncCommand* cmd =
     static_cast<GPUBackendSyncCommand*>(AllocateCommand(GPUBackendCommandType::Sync, sizeof(GPUBackendSyncCommand)));
   cmd->allow_sleep = allow_sleep;
   PushCommand(cmd);
-  WakeGPUThread();
 
   m_sync_event.Wait();
   m_sync_event.Reset();
@@ -206,9 +333,7 @@ void GPUBackend::RunGPULoop()
 
   for (;;)
   {
-    u32 write_ptr = m_command_fifo_write_ptr.load();
-    u32 read_ptr = m_command_fifo_read_ptr.load();
-    if (read_ptr == write_ptr)
+    if (m_pending_chunk_count.load() == 0)
     {
       const Common::Timer::Value current_time = Common::Timer::GetValue();
       if (Common::Timer::ConvertValueToNanoseconds(current_time - last_command_time) < SPIN_TIME_NS)
@@ -216,34 +341,33 @@ void GPUBackend::RunGPULoop()
 
       std::unique_lock<std::mutex> lock(m_sync_mutex);
       m_gpu_thread_sleeping.store(true);
-      m_wake_gpu_thread_cv.wait(lock, [this]() { return m_gpu_loop_done.load() || GetPendingCommandSize() > 0; });
+      m_wake_gpu_thread_cv.wait(lock, [this]() { return m_gpu_loop_done.load() || !m_submitted_chunks.empty(); });
       m_gpu_thread_sleeping.store(false);
 
-      if (!m_gpu_loop_done.load())
+      if (!m_gpu_loop_done.load() || !m_submitted_chunks.empty())
         continue;
       break;
     }
 
-    if (write_ptr < read_ptr)
-      write_ptr = COMMAND_QUEUE_SIZE;
+    CommandChunk* chunk;
+    {
+      std::unique_lock<std::mutex> lock(m_sync_mutex);
+      chunk = m_submitted_chunks.front();
+      m_submitted_chunks.pop_front();
+    }
 
     bool allow_sleep = false;
-    while (read_ptr < write_ptr)
+    m_executing_chunk = chunk;
+    for (u32 offset = 0; offset < chunk->size;)
     {
-      const GPUBackendCommand* cmd = reinterpret_cast<const GPUBackendCommand*>(&m_command_fifo_data[read_ptr]);
-      read_ptr += cmd->size;
+      const GPUBackendCommand* cmd = reinterpret_cast<const GPUBackendCommand*>(&chunk->data[offset]);
+      offset += cmd->size;
 
       switch (cmd->type)
       {
-        case GPUBackendCommandType::Wraparound:
-        {
-          write_ptr = m_command_fifo_write_ptr.load();
-          read_ptr = 0;
-        }
-        break;
-
         case GPUBackendCommandType::Sync:
         {
+          FlushRender();
           m_sync_event.Signal();
           allow_sleep = static_cast<const GPUBackendSyncCommand*>(cmd)->allow_sleep;
         }
@@ -254,9 +378,18 @@ void GPUBackend::RunGPULoop()
           break;
       }
     }
+    m_executing_chunk = nullptr;
 
     last_command_time = allow_sleep ? 0 : Common::Timer::GetValue();
-    m_command_fifo_read_ptr.store(read_ptr);
+    m_pending_command_size.fetch_sub(chunk->size);
+    m_pending_chunk_count.fetch_sub(1);
+    ReleaseCommandChunk(chunk);
+
+    if (m_waiting_for_queue_space.load())
+    {
+      std::unique_lock<std::mutex> lock(m_sync_mutex);
+      m_queue_space_cv.notify_one();
+    }
   }
 }
 
@@ -316,6 +449,13 @@ void GPUBackend::HandleCommand(const GPUBackendCommand* cmd)
     }
     break;
 
+    case GPUBackendCommandType::UpdateDisplay:
+    {
+      FlushRender();
+      UpdateDisplay(static_cast<const GPUBackendUpdateDisplayCommand*>(cmd));
+    }
+    break;
+
     default:
       break;
   }
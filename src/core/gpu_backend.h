@@ -1,12 +1,13 @@
 #pragma once
 #include "common/event.h"
-#include "common/heap_array.h"
 #include "gpu_types.h"
 #include <atomic>
 #include <condition_variable>
+#include <deque>
 #include <memory>
 #include <mutex>
 #include <thread>
+#include <vector>
 
 #ifdef _MSC_VER
 #pragma warning(push)
@@ -16,6 +17,25 @@
 class GPUBackend
 {
 public:
+  /// Block of commands which is handed to the GPU thread as a whole. Chunks go back to the pool once every reference
+  /// has been released, so consumers can hold on to commands after they've been handled.
+  struct CommandChunk
+  {
+    std::unique_ptr<u8[]> data;
+    u32 capacity;
+    u32 size;
+    std::atomic<u32> ref_count;
+  };
+
+  struct CommandQueueStats
+  {
+    u32 chunks_submitted;
+    u32 max_pending_chunks;
+    u32 max_pending_size;
+    u32 num_stalls;
+    double stall_time_ms;
+  };
+
   GPUBackend();
   virtual ~GPUBackend();
 
@@ -33,16 +53,25 @@ public:
   GPUBackendDrawPolygonCommand* NewDrawPolygonCommand(u32 num_vertices);
   GPUBackendDrawRectangleCommand* NewDrawRectangleCommand();
   GPUBackendDrawLineCommand* NewDrawLineCommand(u32 num_vertices);
+  GPUBackendUpdateDisplayCommand* NewUpdateDisplayCommand();
 
   void PushCommand(GPUBackendCommand* cmd);
   void Sync(bool allow_sleep);
 
+  ALWAYS_INLINE const CommandQueueStats& GetCommandQueueStats() const { return m_queue_stats; }
+  void ResetCommandQueueStats();
+
+  /// Returns the render statistics for the frames scanned out since the last call, and clears them.
+  GPUStats TakeRenderStats();
+
   /// Processes all pending GPU commands.
   void RunGPULoop();
 
 protected:
   void* AllocateCommand(GPUBackendCommandType command, u32 size);
   u32 GetPendingCommandSize() const;
+  void SubmitCommandChunk();
+  void WaitForCommandQueueSpace();
   void WakeGPUThread();
   void StartGPUThread();
   void StopGPUThread();
@@ -55,9 +84,17 @@ protected:
   virtual void DrawPolygon(const GPUBackendDrawPolygonCommand* cmd) = 0;
   virtual void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd) = 0;
   virtual void DrawLine(const GPUBackendDrawLineCommand* cmd) = 0;
+  virtual void UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd) = 0;
   virtual void FlushRender() = 0;
 
-  void HandleCommand(const GPUBackendCommand* cmd);
+  virtual void HandleCommand(const GPUBackendCommand* cmd);
+
+  CommandChunk* AcquireCommandChunk(u32 min_size);
+  void AddCommandChunkReference(CommandChunk* chunk);
+  void ReleaseCommandChunk(CommandChunk* chunk);
+
+  /// Hands the render statistics gathered on the GPU thread over to TakeRenderStats().
+  void PublishRenderStats();
 
   u16* m_vram_ptr = nullptr;
 
@@ -72,11 +109,36 @@ protected:
   std::mutex m_sync_mutex;
   std::condition_variable m_wake_gpu_thread_cv;
 
-  static constexpr u32 COMMAND_QUEUE_SIZE = 4 * 1024 * 1024, THRESHOLD_TO_WAKE_GPU = 256;
+  // Chunks are normally this large, commands which don't fit get a chunk of their own. The emulation thread waits for
+  // the GPU thread when it gets more than MAX_PENDING_COMMAND_SIZE bytes ahead.
+  static constexpr u32 COMMAND_CHUNK_SIZE = 64 * 1024;
+  static constexpr u32 MAX_PENDING_COMMAND_SIZE = 4 * 1024 * 1024;
+
+  // A partially filled chunk is handed over once it has this many bytes in it and the GPU thread has run out of work.
+  static constexpr u32 THRESHOLD_TO_WAKE_GPU = 256;
+
+  // Chunk which commands are being allocated from, owned by the emulation thread.
+  CommandChunk* m_current_chunk = nullptr;
+
+  // Chunk which the command being handled lives in.
+  CommandChunk* m_executing_chunk = nullptr;
+
+  // Chunks waiting for the GPU thread, protected by m_sync_mutex.
+  std::deque<CommandChunk*> m_submitted_chunks;
+  std::condition_variable m_queue_space_cv;
+  std::atomic_bool m_waiting_for_queue_space{false};
+  alignas(64) std::atomic<u32> m_pending_command_size{0};
+  alignas(64) std::atomic<u32> m_pending_chunk_count{0};
+
+  std::mutex m_chunk_pool_mutex;
+  std::vector<CommandChunk*> m_free_chunks;
+
+  CommandQueueStats m_queue_stats = {};
 
-  HeapArray<u8, COMMAND_QUEUE_SIZE> m_command_fifo_data;
-  alignas(64) std::atomic<u32> m_command_fifo_read_ptr{0};
-  alignas(64) std::atomic<u32> m_command_fifo_write_ptr{0};
+  // Owned by the GPU thread, published once per frame.
+  GPUStats m_render_stats = {};
+  GPUStats m_published_render_stats = {};
+  std::mutex m_render_stats_mutex;
 };
 
 #ifdef _MSC_VER
@@ -81,6 +81,8 @@ void GPU::ExecuteCommands()
           {
             // drop terminator
             m_fifo.RemoveOne();
+            m_stats.num_primitives++;
+            m_stats.num_vertices += GetPolyLineVertexCount();
             DispatchRenderCommand();
             m_blit_buffer.clear();
             EndCommand();
@@ -319,6 +321,8 @@ bool GPU::HandleRenderPolygonCommand()
   m_render_command.bits = rc.bits;
   m_fifo.RemoveOne();
 
+  m_stats.num_primitives++;
+  m_stats.num_vertices += num_vertices;
   DispatchRenderCommand();
   EndCommand();
   return true;
@@ -344,6 +348,8 @@ bool GPU::HandleRenderRectangleCommand()
   m_render_command.bits = rc.bits;
   m_fifo.RemoveOne();
 
+  m_stats.num_primitives++;
+  m_stats.num_vertices++;
   DispatchRenderCommand();
   EndCommand();
   return true;
@@ -361,6 +367,8 @@ bool GPU::HandleRenderLineCommand()
   m_render_command.bits = rc.bits;
   m_fifo.RemoveOne();
 
+  m_stats.num_primitives++;
+  m_stats.num_vertices += 2;
   DispatchRenderCommand();
   EndCommand();
   return true;
@@ -411,7 +419,10 @@ bool GPU::HandleFillRectangleCommand()
   const u32 height = (FifoPop() >> 16) & VRAM_HEIGHT_MASK;
 
   if (width > 0 && height > 0)
+  {
+    m_stats.num_vram_fills++;
     FillVRAM(dst_x, dst_y, width, height, color);
+  }
 
   AddCommandTicks(46 + ((width / 8) + 9) * height);
   EndCommand();
@@ -448,6 +459,7 @@ void GPU::FinishVRAMWrite()
     SynchronizeCRTC();
 
   FlushRender();
+  m_stats.num_vram_writes++;
 
   if (m_blit_remaining_words == 0)
   {
@@ -501,6 +513,7 @@ bool GPU::HandleCopyRectangleVRAMToCPUCommand()
   FlushRender();
 
   // ensure VRAM shadow is up to date
+  m_stats.num_vram_reads++;
   ReadVRAM(m_vram_transfer.x, m_vram_transfer.y, m_vram_transfer.width, m_vram_transfer.height);
 
   // switch to pixel-by-pixel read state
@@ -526,6 +539,7 @@ bool GPU::HandleCopyRectangleVRAMToVRAMCommand()
   if (!skip_copy)
   {
     FlushRender();
+    m_stats.num_vram_copies++;
     CopyVRAM(src_x, src_y, dst_x, dst_y, width, height);
   }
 
@@ -0,0 +1,235 @@
+#include "gpu_dump.h"
+#include "common/byte_stream.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "common/state_wrapper.h"
+#include "common/timer.h"
+#include "gpu.h"
+#include "save_state_version.h"
+#include <algorithm>
+#include <cstring>
+Log_SetChannel(GPUDump);
+
+namespace GPUDump {
+
+Recorder::Recorder(RFILE* fp, const FileHeader& header, u32 num_frames)
+  : m_fp(fp), m_header(header), m_frames_remaining(num_frames)
+{
+}
+
+Recorder::~Recorder()
+{
+  // Any commands after the last vsync are an incomplete frame, and are dropped.
+  m_header.frame_count = m_frames_written;
+  if (FileSystem::FSeek64(m_fp, 0, SEEK_SET) != 0 || rfwrite(&m_header, sizeof(m_header), 1, m_fp) != 1)
+    Log_ErrorPrintf("Failed to update GPU dump header");
+
+  rfclose(m_fp);
+  Log_InfoPrintf("Finished GPU dump, %u frames written", m_frames_written);
+}
+
+std::unique_ptr<Recorder> Recorder::Create(const char* path, u32 num_frames, GPU* gpu, bool console_is_pal)
+{
+  std::unique_ptr<GrowableMemoryByteStream> state_stream = ByteStream_CreateGrowableMemoryStream();
+  StateWrapper sw(state_stream.get(), StateWrapper::Mode::Write, SAVE_STATE_VERSION);
+  if (!gpu->DoState(sw, nullptr, false))
+  {
+    Log_ErrorPrintf("Failed to save GPU state for dump");
+    return {};
+  }
+
+  std::vector<u8> state(static_cast<size_t>(state_stream->GetSize()));
+  if (!state_stream->SeekAbsolute(0) || state_stream->Read(state.data(), static_cast<u32>(state.size())) != state.size())
+    return {};
+
+  RFILE* fp = FileSystem::OpenRFile(path, "wb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open GPU dump '%s' for writing", path);
+    return {};
+  }
+
+  FileHeader header = {};
+  header.magic = FILE_MAGIC;
+  header.version = FILE_VERSION;
+  header.state_version = SAVE_STATE_VERSION;
+  header.state_size = static_cast<u32>(state.size());
+  header.console_is_pal = console_is_pal;
+  if (rfwrite(&header, sizeof(header), 1, fp) != 1 || rfwrite(state.data(), state.size(), 1, fp) != 1)
+  {
+    Log_ErrorPrintf("Failed to write GPU dump header to '%s'", path);
+    rfclose(fp);
+    return {};
+  }
+
+  Log_InfoPrintf("Writing %u frame GPU dump to '%s'", num_frames, path);
+  return std::unique_ptr<Recorder>(new Recorder(fp, header, num_frames));
+}
+
+void Recorder::BeginPacket(PacketType type)
+{
+  EndPacket();
+
+  m_packet_start = m_buffer.size();
+  m_last_packet_type = type;
+  m_buffer.push_back(static_cast<u32>(type) << PACKET_TYPE_SHIFT);
+}
+
+void Recorder::EndPacket()
+{
+  if (m_last_packet_type == PacketType::Count)
+    return;
+
+  // Split runs of GP0 words which don't fit in a single packet.
+  const size_t data_start = m_packet_start + 1;
+  size_t remaining = m_buffer.size() - data_start;
+  if (remaining > PACKET_SIZE_MASK)
+  {
+    std::vector<u32> data(m_buffer.begin() + data_start, m_buffer.end());
+    m_buffer.resize(m_packet_start);
+
+    const u32 type_bits = static_cast<u32>(m_last_packet_type) << PACKET_TYPE_SHIFT;
+    for (size_t pos = 0; remaining > 0;)
+    {
+      const u32 count = static_cast<u32>(std::min<size_t>(remaining, PACKET_SIZE_MASK));
+      m_buffer.push_back(type_bits | count);
+      m_buffer.insert(m_buffer.end(), data.begin() + pos, data.begin() + pos + count);
+      pos += count;
+      remaining -= count;
+    }
+  }
+  else
+  {
+    m_buffer[m_packet_start] |= static_cast<u32>(remaining);
+  }
+
+  m_last_packet_type = PacketType::Count;
+}
+
+bool Recorder::WriteVSync(u32 interlaced_field)
+{
+  BeginPacket(PacketType::VSync);
+  m_buffer.push_back(interlaced_field);
+  EndPacket();
+
+  if (rfwrite(m_buffer.data(), sizeof(u32) * m_buffer.size(), 1, m_fp) != 1)
+  {
+    Log_ErrorPrintf("Failed to write GPU dump frame");
+    m_buffer.clear();
+    return false;
+  }
+
+  m_buffer.clear();
+  m_frames_written++;
+  return (--m_frames_remaining > 0);
+}
+
+Player::Player() = default;
+
+Player::~Player() = default;
+
+bool Player::Open(const char* path)
+{
+  RFILE* fp = FileSystem::OpenRFile(path, "rb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open GPU dump '%s'", path);
+    return false;
+  }
+
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(fp);
+  rfclose(fp);
+  if (!data.has_value() || data->size() < sizeof(FileHeader))
+  {
+    Log_ErrorPrintf("Failed to read GPU dump '%s'", path);
+    return false;
+  }
+
+  std::memcpy(&m_header, data->data(), sizeof(m_header));
+  if (m_header.magic != FILE_MAGIC || m_header.version != FILE_VERSION)
+  {
+    Log_ErrorPrintf("'%s' is not a valid GPU dump", path);
+    return false;
+  }
+
+  if (m_header.state_version != SAVE_STATE_VERSION ||
+      (data->size() - sizeof(FileHeader)) < static_cast<size_t>(m_header.state_size))
+  {
+    Log_ErrorPrintf("GPU dump '%s' has state version %u (expected %u) or is truncated", path, m_header.state_version,
+                    SAVE_STATE_VERSION);
+    return false;
+  }
+
+  m_data = std::move(data.value());
+  m_packets_start = sizeof(FileHeader) + m_header.state_size;
+  m_position = m_packets_start;
+  Log_InfoPrintf("Opened %u frame GPU dump '%s'", m_header.frame_count, path);
+  return true;
+}
+
+bool Player::LoadInitialState(GPU* gpu)
+{
+  std::unique_ptr<ReadOnlyMemoryByteStream> stream =
+    ByteStream_CreateReadOnlyMemoryStream(m_data.data() + sizeof(FileHeader), m_header.state_size);
+  StateWrapper sw(stream.get(), StateWrapper::Mode::Read, m_header.state_version);
+  if (!gpu->DoState(sw, nullptr, true))
+  {
+    Log_ErrorPrintf("Failed to load GPU dump state");
+    return false;
+  }
+
+  m_position = m_packets_start;
+  return true;
+}
+
+bool Player::ProcessFrame(GPU* gpu)
+{
+  if (m_loop_count == 0 && m_position == m_packets_start)
+    m_loop_start_time = Common::Timer::GetValue();
+
+  for (;;)
+  {
+    if ((m_data.size() - m_position) < sizeof(u32))
+    {
+      // End of the dump, report the time taken and go back to the start.
+      const double elapsed_ms =
+        Common::Timer::ConvertValueToMilliseconds(Common::Timer::GetValue() - m_loop_start_time);
+      m_loop_count++;
+      Log_InfoPrintf("GPU dump loop %u: %u frames in %.2f ms (%.2f FPS)", m_loop_count, m_header.frame_count,
+                     elapsed_ms, (elapsed_ms > 0.0) ? (m_header.frame_count * 1000.0 / elapsed_ms) : 0.0);
+
+      if (m_header.frame_count == 0 || !LoadInitialState(gpu))
+      {
+        m_error = true;
+        return false;
+      }
+
+      m_loop_start_time = Common::Timer::GetValue();
+      continue;
+    }
+
+    u32 packet_header;
+    std::memcpy(&packet_header, &m_data[m_position], sizeof(packet_header));
+    m_position += sizeof(packet_header);
+
+    const PacketType type = static_cast<PacketType>(packet_header >> PACKET_TYPE_SHIFT);
+    const u32 word_count = packet_header & PACKET_SIZE_MASK;
+    if (type >= PacketType::Count || (m_data.size() - m_position) < (word_count * sizeof(u32)))
+    {
+      Log_ErrorPrintf("Corrupted GPU dump packet at offset %zu", m_position - sizeof(packet_header));
+      m_error = true;
+      return false;
+    }
+
+    // The packet data is not guaranteed to be aligned after the state.
+    m_packet_data.resize(word_count);
+    std::memcpy(m_packet_data.data(), &m_data[m_position], word_count * sizeof(u32));
+    m_position += word_count * sizeof(u32);
+
+    gpu->ProcessGPUDumpPacket(type, m_packet_data.data(), word_count);
+    if (type == PacketType::VSync)
+      return true;
+  }
+}
+
+} // namespace GPUDump
@@ -0,0 +1,112 @@
+#pragma once
+#include "types.h"
+#include <memory>
+#include <vector>
+
+struct RFILE;
+
+class GPU;
+
+namespace GPUDump {
+
+// File layout: FileHeader, the GPU save state (including VRAM) at the start of the capture, then a stream of packets.
+// Each packet is a u32 header of (type << 24) | word_count, followed by word_count u32s of data.
+static constexpr u32 FILE_MAGIC = 0x55504750; // PGPU
+static constexpr u32 FILE_VERSION = 1;
+static constexpr u32 PACKET_TYPE_SHIFT = 24;
+static constexpr u32 PACKET_SIZE_MASK = (1u << PACKET_TYPE_SHIFT) - 1u;
+
+enum class PacketType : u8
+{
+  GP0Data, // Words written to GP0, either through MMIO or DMA.
+  GP1Data, // Words written to GP1.
+  VSync,   // Start of vblank, the display is scanned out. Data is the interlaced field.
+  Count
+};
+
+#pragma pack(push, 1)
+struct FileHeader
+{
+  u32 magic;
+  u32 version;
+  u32 state_version;
+  u32 state_size;
+  u32 frame_count;
+  u8 console_is_pal;
+  u8 reserved[3];
+};
+#pragma pack(pop)
+
+class Recorder
+{
+public:
+  ~Recorder();
+
+  /// Opens the dump file, and writes the header and the current state of the GPU.
+  static std::unique_ptr<Recorder> Create(const char* path, u32 num_frames, GPU* gpu, bool console_is_pal);
+
+  ALWAYS_INLINE void WriteGP0(u32 value)
+  {
+    if (m_last_packet_type != PacketType::GP0Data)
+      BeginPacket(PacketType::GP0Data);
+
+    m_buffer.push_back(value);
+  }
+
+  ALWAYS_INLINE void WriteGP1(u32 value)
+  {
+    BeginPacket(PacketType::GP1Data);
+    m_buffer.push_back(value);
+  }
+
+  /// Writes the buffered packets for the frame out to the file. Returns false once the requested number of frames has
+  /// been captured, or the write failed, at which point the recorder should be destroyed.
+  bool WriteVSync(u32 interlaced_field);
+
+private:
+  Recorder(RFILE* fp, const FileHeader& header, u32 num_frames);
+
+  void BeginPacket(PacketType type);
+  void EndPacket();
+
+  RFILE* m_fp;
+  FileHeader m_header;
+  std::vector<u32> m_buffer;
+  size_t m_packet_start = 0;
+  PacketType m_last_packet_type = PacketType::Count;
+  u32 m_frames_remaining;
+  u32 m_frames_written = 0;
+};
+
+class Player
+{
+public:
+  Player();
+  ~Player();
+
+  ALWAYS_INLINE bool IsConsolePAL() const { return m_header.console_is_pal != 0; }
+  ALWAYS_INLINE u32 GetFrameCount() const { return m_header.frame_count; }
+  ALWAYS_INLINE bool HasError() const { return m_error; }
+
+  bool Open(const char* path);
+
+  /// Restores the GPU state from the start of the capture.
+  bool LoadInitialState(GPU* gpu);
+
+  /// Replays packets up to and including the next vsync. Wraps around to the start of the capture at the end of the
+  /// file, logging the time taken to replay the whole dump.
+  bool ProcessFrame(GPU* gpu);
+
+private:
+  FileHeader m_header = {};
+  std::vector<u8> m_data;
+  std::vector<u32> m_packet_data;
+  size_t m_packets_start = 0;
+  size_t m_position = 0;
+
+  u64 m_loop_start_time = 0;
+  u32 m_loop_count = 0;
+  bool m_error = false;
+};
+
+} // namespace GPUDump
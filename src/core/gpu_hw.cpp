@@ -1,4 +1,5 @@
 #include "gpu_hw.h"
+#include "common/align.h"
 #include "common/state_wrapper.h"
 #include "cpu_core.h"
 #include "gpu_sw_backend.h"
@@ -34,6 +35,12 @@ ALWAYS_INLINE static bool ShouldDisableColorPerspective()
 GPU_HW::GPU_HW() : GPU()
 {
   m_vram_ptr = m_vram_shadow.data();
+
+  m_batch_staging_vertices.resize(MAX_BATCH_VERTEX_COUNT);
+  m_batch_start_vertex_ptr = m_batch_staging_vertices.data();
+  m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + MAX_BATCH_VERTEX_COUNT;
+  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
+  m_pending_batches.reserve(MAX_PENDING_BATCHES);
 }
 
 GPU_HW::~GPU_HW()
@@ -61,6 +68,9 @@ bool GPU_HW::Initialize(HostDisplay* host_display)
   m_chroma_smoothing = g_settings.gpu_24bit_chroma_smoothing;
   m_downsample_mode = GetDownsampleMode(m_resolution_scale);
   m_disable_color_perspective = m_supports_disable_color_perspective && ShouldDisableColorPerspective();
+  m_using_ubershader = g_settings.gpu_ubershader;
+  m_async_readbacks = g_settings.gpu_async_readbacks;
+  SetFullVRAMShadowDirty();
 
   if (m_multisamples != g_settings.gpu_multisamples)
   {
@@ -97,18 +107,24 @@ void GPU_HW::Reset(bool clear_vram)
 {
   GPU::Reset(clear_vram);
 
-  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
+  DiscardBatchVertices();
 
   m_vram_shadow.fill(0);
   if (m_sw_renderer)
     m_sw_renderer->Reset(clear_vram);
 
   m_batch = {};
+  m_last_drawn_batch = {};
   m_batch_ubo_data = {};
   m_batch_ubo_dirty = true;
   m_current_depth = 1;
 
   SetFullVRAMDirtyRectangle();
+
+  // The VRAM texture isn't necessarily cleared, so don't trust the zeroed shadow.
+  m_vram_readback_rect = {};
+  m_vram_async_readback_rect = {};
+  SetFullVRAMShadowDirty();
 }
 
 bool GPU_HW::DoState(StateWrapper& sw, HostDisplayTexture** host_texture, bool update_display)
@@ -119,9 +135,12 @@ bool GPU_HW::DoState(StateWrapper& sw, HostDisplayTexture** host_texture, bool u
   // invalidate the whole VRAM read texture when loading state
   if (sw.IsReading())
   {
-    m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
+    DiscardBatchVertices();
     SetFullVRAMDirtyRectangle();
     ResetBatchVertexDepth();
+    m_vram_readback_rect = {};
+    m_vram_async_readback_rect = {};
+    SetFullVRAMShadowDirty();
   }
 
   return true;
@@ -144,7 +163,7 @@ void GPU_HW::UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed)
      m_scaled_dithering != g_settings.gpu_scaled_dithering || m_texture_filtering != g_settings.gpu_texture_filter ||
      m_using_uv_limits != use_uv_limits || m_chroma_smoothing != g_settings.gpu_24bit_chroma_smoothing ||
      m_downsample_mode != downsample_mode || m_pgxp_depth_buffer != g_settings.UsingPGXPDepthBuffer() ||
-     m_disable_color_perspective != disable_color_perspective);
+     m_disable_color_perspective != disable_color_perspective || m_using_ubershader != g_settings.gpu_ubershader);
 
   m_resolution_scale = resolution_scale;
   m_multisamples = multisamples;
@@ -156,6 +175,16 @@ void GPU_HW::UpdateHWSettings(bool* framebuffer_changed, bool* shaders_changed)
   m_chroma_smoothing = g_settings.gpu_24bit_chroma_smoothing;
   m_downsample_mode = downsample_mode;
   m_disable_color_perspective = disable_color_perspective;
+  m_using_ubershader = g_settings.gpu_ubershader;
+
+  if (m_async_readbacks != g_settings.gpu_async_readbacks)
+  {
+    // Dirty blocks aren't tracked while async readbacks are off.
+    m_async_readbacks = g_settings.gpu_async_readbacks;
+    m_vram_readback_rect = {};
+    m_vram_async_readback_rect = {};
+    SetFullVRAMShadowDirty();
+  }
 
   if (!m_supports_dual_source_blend && TextureFilterRequiresDualSourceBlend(m_texture_filtering))
     m_texture_filtering = GPUTextureFilter::Nearest;
@@ -392,7 +421,7 @@ GPU_HW::SmoothingUBOData GPU_HW::GetSmoothingUBO(u32 level, u32 left, u32 top, u
   return data;
 }
 
-void GPU_HW::DrawLine(float x0, float y0, u32 col0, float x1, float y1, u32 col1, float depth)
+void GPU_HW::DrawLine(float x0, float y0, u32 col0, float x1, float y1, u32 col1, float depth, u32 texpage)
 {
   const float dx = x1 - x0;
   const float dy = y1 - y0;
@@ -400,10 +429,10 @@ void GPU_HW::DrawLine(float x0, float y0, u32 col0, float x1, float y1, u32 col1
   if (dx == 0.0f && dy == 0.0f)
   {
     // Degenerate, render a point.
-    output[0].Set(x0, y0, depth, 1.0f, col0, 0, 0, 0);
-    output[1].Set(x0 + 1.0f, y0, depth, 1.0f, col0, 0, 0, 0);
-    output[2].Set(x1, y1 + 1.0f, depth, 1.0f, col0, 0, 0, 0);
-    output[3].Set(x1 + 1.0f, y1 + 1.0f, depth, 1.0f, col0, 0, 0, 0);
+    output[0].Set(x0, y0, depth, 1.0f, col0, texpage, 0, 0);
+    output[1].Set(x0 + 1.0f, y0, depth, 1.0f, col0, texpage, 0, 0);
+    output[2].Set(x1, y1 + 1.0f, depth, 1.0f, col0, texpage, 0, 0);
+    output[3].Set(x1 + 1.0f, y1 + 1.0f, depth, 1.0f, col0, texpage, 0, 0);
   }
   else
   {
@@ -467,10 +496,10 @@ void GPU_HW::DrawLine(float x0, float y0, u32 col0, float x1, float y1, u32 col1
     const float ox1 = x1 + pad_x1;
     const float oy1 = y1 + pad_y1;
 
-    output[0].Set(ox0, oy0, depth, 1.0f, col0, 0, 0, 0);
-    output[1].Set(ox0 + fill_dx, oy0 + fill_dy, depth, 1.0f, col0, 0, 0, 0);
-    output[2].Set(ox1, oy1, depth, 1.0f, col1, 0, 0, 0);
-    output[3].Set(ox1 + fill_dx, oy1 + fill_dy, depth, 1.0f, col1, 0, 0, 0);
+    output[0].Set(ox0, oy0, depth, 1.0f, col0, texpage, 0, 0);
+    output[1].Set(ox0 + fill_dx, oy0 + fill_dy, depth, 1.0f, col0, texpage, 0, 0);
+    output[2].Set(ox1, oy1, depth, 1.0f, col1, texpage, 0, 0);
+    output[3].Set(ox1 + fill_dx, oy1 + fill_dy, depth, 1.0f, col1, texpage, 0, 0);
   }
 
   AddVertex(output[0]);
@@ -481,13 +510,14 @@ void GPU_HW::DrawLine(float x0, float y0, u32 col0, float x1, float y1, u32 col1
   AddVertex(output[1]);
 }
 
-void GPU_HW::LoadVertices()
+void GPU_HW::LoadVertices(u32 texpage_flags)
 {
   if (m_GPUSTAT.check_mask_before_draw)
     m_current_depth++;
 
   const GPURenderCommand rc{m_render_command.bits};
-  const u32 texpage = ZeroExtend32(m_draw_mode.mode_reg.bits) | (ZeroExtend32(m_draw_mode.palette_reg) << 16);
+  const u32 texpage =
+    ZeroExtend32(m_draw_mode.mode_reg.bits) | texpage_flags | (ZeroExtend32(m_draw_mode.palette_reg) << 16);
   const float depth = GetCurrentNormalizedVertexDepth();
 
   switch (rc.primitive)
@@ -572,7 +602,7 @@ void GPU_HW::LoadVertices()
         const u32 clip_bottom =
           static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-        m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+        IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
         AddDrawTriangleTicks(native_vertex_positions[0][0], native_vertex_positions[0][1],
                              native_vertex_positions[1][0], native_vertex_positions[1][1],
                              native_vertex_positions[2][0], native_vertex_positions[2][1], rc.shading_enable,
@@ -603,7 +633,7 @@ void GPU_HW::LoadVertices()
           const u32 clip_bottom =
             static_cast<u32>(std::clamp<s32>(max_y_123, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-          m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+          IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
           AddDrawTriangleTicks(native_vertex_positions[2][0], native_vertex_positions[2][1],
                                native_vertex_positions[1][0], native_vertex_positions[1][1],
                                native_vertex_positions[3][0], native_vertex_positions[3][1], rc.shading_enable,
@@ -720,7 +750,7 @@ void GPU_HW::LoadVertices()
       const u32 clip_bottom =
         static_cast<u32>(std::clamp<s32>(pos_y + rectangle_height, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-      m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+      IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
       AddDrawRectangleTicks(clip_right - clip_left, clip_bottom - clip_top, rc.texture_enable, rc.transparency_enable);
 
       if (m_sw_renderer)
@@ -779,12 +809,12 @@ void GPU_HW::LoadVertices()
         const u32 clip_bottom =
           static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-        m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+        IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
         AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, rc.shading_enable);
 
         // TODO: Should we do a PGXP lookup here? Most lines are 2D.
         DrawLine(static_cast<float>(start_x), static_cast<float>(start_y), start_color, static_cast<float>(end_x),
-                 static_cast<float>(end_y), end_color, depth);
+                 static_cast<float>(end_y), end_color, depth, texpage);
 
         if (m_sw_renderer)
         {
@@ -844,12 +874,12 @@ void GPU_HW::LoadVertices()
             const u32 clip_bottom =
               static_cast<u32>(std::clamp<s32>(max_y, m_drawing_area.top, m_drawing_area.bottom)) + 1u;
 
-            m_vram_dirty_rect.Include(clip_left, clip_right, clip_top, clip_bottom);
+            IncludeDrawnVRAMRectangle(clip_left, clip_right, clip_top, clip_bottom);
             AddDrawLineTicks(clip_right - clip_left, clip_bottom - clip_top, rc.shading_enable);
 
             // TODO: Should we do a PGXP lookup here? Most lines are 2D.
             DrawLine(static_cast<float>(start_x), static_cast<float>(start_y), start_color, static_cast<float>(end_x),
-                     static_cast<float>(end_y), end_color, depth);
+                     static_cast<float>(end_y), end_color, depth, texpage);
           }
 
           start_x = end_x;
@@ -963,17 +993,129 @@ void GPU_HW::IncludeVRAMDirtyRectangle(const Common::Rectangle<u32>& rect)
   }
 }
 
-void GPU_HW::EnsureVertexBufferSpace(u32 required_vertices)
+u64 GPU_HW::GetVRAMShadowBlockMask(u32 left, u32 right)
+{
+  const u32 first_block = left / VRAM_SHADOW_BLOCK_WIDTH;
+  const u32 last_block = (right - 1) / VRAM_SHADOW_BLOCK_WIDTH;
+  return (UINT64_C(0xFFFFFFFFFFFFFFFF) >> (63 - (last_block - first_block))) << first_block;
+}
+
+Common::Rectangle<u32> GPU_HW::GetVRAMShadowBlockBounds(const Common::Rectangle<u32>& rect)
+{
+  return Common::Rectangle<u32>(rect.left & ~(VRAM_SHADOW_BLOCK_WIDTH - 1), rect.top & ~(VRAM_SHADOW_BLOCK_HEIGHT - 1),
+                                Common::AlignUpPow2(rect.right, VRAM_SHADOW_BLOCK_WIDTH),
+                                Common::AlignUpPow2(rect.bottom, VRAM_SHADOW_BLOCK_HEIGHT));
+}
+
+void GPU_HW::MarkVRAMShadowDirty(const Common::Rectangle<u32>& rect)
 {
-  if (m_batch_current_vertex_ptr)
+  if (rect.left >= rect.right || rect.top >= rect.bottom)
+    return;
+
+  const u64 mask = GetVRAMShadowBlockMask(rect.left, rect.right);
+  const u32 last_row = (rect.bottom - 1) / VRAM_SHADOW_BLOCK_HEIGHT;
+  for (u32 row = rect.top / VRAM_SHADOW_BLOCK_HEIGHT; row <= last_row; row++)
+    m_vram_shadow_dirty_blocks[row] |= mask;
+}
+
+void GPU_HW::MarkVRAMShadowClean(const Common::Rectangle<u32>& block_rect)
+{
+  const u64 mask = ~GetVRAMShadowBlockMask(block_rect.left, block_rect.right);
+  const u32 end_row = block_rect.bottom / VRAM_SHADOW_BLOCK_HEIGHT;
+  for (u32 row = block_rect.top / VRAM_SHADOW_BLOCK_HEIGHT; row < end_row; row++)
+    m_vram_shadow_dirty_blocks[row] &= mask;
+}
+
+void GPU_HW::SetFullVRAMShadowDirty()
+{
+  m_vram_shadow_dirty_blocks.fill(UINT64_C(0xFFFFFFFFFFFFFFFF));
+}
+
+bool GPU_HW::IsVRAMShadowDirty(const Common::Rectangle<u32>& rect) const
+{
+  const u64 mask = GetVRAMShadowBlockMask(rect.left, rect.right);
+  const u32 last_row = (rect.bottom - 1) / VRAM_SHADOW_BLOCK_HEIGHT;
+  for (u32 row = rect.top / VRAM_SHADOW_BLOCK_HEIGHT; row <= last_row; row++)
   {
-    if (GetBatchVertexSpace() >= required_vertices)
-      return;
+    if (m_vram_shadow_dirty_blocks[row] & mask)
+      return true;
+  }
 
-    FlushRender();
+  return false;
+}
+
+Common::Rectangle<u32> GPU_HW::GetVRAMReadbackBounds(u32 x, u32 y, u32 width, u32 height)
+{
+  const Common::Rectangle<u32> rect = GetVRAMTransferBounds(x, y, width, height);
+  if (!m_async_readbacks)
+  {
+    m_stats.num_vram_readbacks++;
+    return rect;
   }
 
-  MapBatchVertexPointer(required_vertices);
+  // Full VRAM reads are from save states and settings changes, don't base the next frame's readback on them.
+  if (rect.GetWidth() != VRAM_WIDTH || rect.GetHeight() != VRAM_HEIGHT)
+    m_vram_readback_rect.Include(rect);
+
+  // The background copy is older than anything we read now, so it has to land in the shadow first. Reads elsewhere
+  // can't see it, and leave it in flight. Copies are block-aligned, so this also covers the blocks we read below.
+  if (m_vram_async_readback_rect.Intersects(rect))
+    FinishPendingVRAMReadback();
+
+  if (!IsVRAMShadowDirty(rect))
+    return {};
+
+  // Read whole blocks, otherwise the partially-covered blocks would stay dirty and stall every time.
+  const Common::Rectangle<u32> block_rect = GetVRAMShadowBlockBounds(rect);
+  MarkVRAMShadowClean(block_rect);
+  m_stats.num_vram_readbacks++;
+  return block_rect;
+}
+
+void GPU_HW::QueueSpeculativeVRAMReadback()
+{
+  // Games which read back VRAM generally read the same area every frame, so start copying it now. If it isn't drawn
+  // to again before the game reads it, the data will already be on the CPU by then.
+  const Common::Rectangle<u32> rect = m_vram_readback_rect;
+  m_vram_readback_rect = {};
+  if (!rect.Valid())
+    return;
+
+  // A copy from the last frame which nothing has read yet has long completed, so this doesn't stall.
+  FinishPendingVRAMReadback();
+  if (!IsVRAMShadowDirty(rect))
+    return;
+
+  const Common::Rectangle<u32> block_rect = GetVRAMShadowBlockBounds(rect);
+  FlushRender();
+  if (!QueueAsyncVRAMReadback(block_rect))
+    return;
+
+  MarkVRAMShadowClean(block_rect);
+  m_vram_async_readback_rect = block_rect;
+  m_stats.num_vram_readbacks++;
+}
+
+void GPU_HW::FinishPendingVRAMReadback()
+{
+  if (!m_vram_async_readback_rect.Valid())
+    return;
+
+  FinishAsyncVRAMReadback(m_vram_async_readback_rect);
+  m_vram_async_readback_rect = {};
+}
+
+bool GPU_HW::QueueAsyncVRAMReadback(const Common::Rectangle<u32>& rect)
+{
+  return false;
+}
+
+void GPU_HW::FinishAsyncVRAMReadback(const Common::Rectangle<u32>& rect) {}
+
+void GPU_HW::EnsureVertexBufferSpace(u32 required_vertices)
+{
+  if (GetBatchVertexSpace() < required_vertices || m_pending_batches.size() == MAX_PENDING_BATCHES)
+    FlushRender();
 }
 
 void GPU_HW::EnsureVertexBufferSpaceForCurrentCommand()
@@ -996,18 +1138,12 @@ void GPU_HW::EnsureVertexBufferSpaceForCurrentCommand()
   // can we fit these vertices in the current depth buffer range?
   if ((m_current_depth + required_vertices) > MAX_BATCH_VERTEX_COUNTER_IDS)
   {
-    // implies FlushRender()
+    // flushes, unless the PGXP depth buffer is in use
     ResetBatchVertexDepth();
   }
-  else if (m_batch_current_vertex_ptr)
-  {
-    if (GetBatchVertexSpace() >= required_vertices)
-      return;
 
-    FlushRender();
-  }
-
-  MapBatchVertexPointer(required_vertices);
+  // the primitive could need a new batch
+  EnsureVertexBufferSpace(required_vertices);
 }
 
 void GPU_HW::ResetBatchVertexDepth()
@@ -1127,11 +1263,15 @@ void GPU_HW::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
 {
   IncludeVRAMDirtyRectangle(
     Common::Rectangle<u32>::FromExtents(x, y, width, height).Clamped(0, 0, VRAM_WIDTH, VRAM_HEIGHT));
+  if (m_async_readbacks)
+    MarkVRAMShadowDirty(GetVRAMTransferBounds(x, y, width, height));
 }
 
 void GPU_HW::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask)
 {
   IncludeVRAMDirtyRectangle(Common::Rectangle<u32>::FromExtents(x, y, width, height));
+  if (m_async_readbacks)
+    MarkVRAMShadowDirty(GetVRAMTransferBounds(x, y, width, height));
 
   if (check_mask)
   {
@@ -1144,6 +1284,8 @@ void GPU_HW::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32
 {
   IncludeVRAMDirtyRectangle(
     Common::Rectangle<u32>::FromExtents(dst_x, dst_y, width, height).Clamped(0, 0, VRAM_WIDTH, VRAM_HEIGHT));
+  if (m_async_readbacks)
+    MarkVRAMShadowDirty(GetVRAMTransferBounds(dst_x, dst_y, width, height));
 
   if (m_GPUSTAT.check_mask_before_draw)
   {
@@ -1186,18 +1328,18 @@ void GPU_HW::DispatchRenderCommand()
     texture_mode = GPUTextureMode::Disabled;
   }
 
-  // has any state changed which requires a new batch?
+  // State changes don't flush, the primitive is sorted into a pending batch once its vertices are known.
   const GPUTransparencyMode transparency_mode =
     rc.transparency_enable ? m_draw_mode.mode_reg.transparency_mode : GPUTransparencyMode::Disabled;
   const bool dithering_enable = (!m_true_color && rc.IsDitheringEnabled()) ? m_GPUSTAT.dither_enable : false;
-  if (texture_mode != m_batch.texture_mode || transparency_mode != m_batch.transparency_mode ||
-      transparency_mode == GPUTransparencyMode::BackgroundMinusForeground || dithering_enable != m_batch.dithering)
-  {
-    FlushRender();
-  }
 
   EnsureVertexBufferSpaceForCurrentCommand();
 
+  // The ubershader reads the texture mode and dithering from the vertices instead.
+  const u32 texpage_flags = ((texture_mode != GPUTextureMode::Disabled) ? TEXPAGE_TEXTURED_BIT : 0u) |
+                            (rc.raw_texture_enable ? TEXPAGE_RAW_TEXTURE_BIT : 0u) |
+                            (dithering_enable ? TEXPAGE_DITHERING_BIT : 0u);
+
   // transparency mode change
   if (m_batch.transparency_mode != transparency_mode && transparency_mode != GPUTransparencyMode::Disabled)
   {
@@ -1223,9 +1365,10 @@ void GPU_HW::DispatchRenderCommand()
   }
 
   m_batch.interlacing = IsInterlacedRenderingEnabled();
-  if (m_batch.interlacing)
+  if (m_batch.interlacing || m_using_ubershader)
   {
-    const u32 displayed_field = GetActiveLineLSB();
+    // The ubershader always tests the field, so use one which never matches when not interlacing.
+    const u32 displayed_field = m_batch.interlacing ? GetActiveLineLSB() : 2u;
     m_batch_ubo_dirty |= (m_batch_ubo_data.u_interlaced_displayed_field != displayed_field);
     m_batch_ubo_data.u_interlaced_displayed_field = displayed_field;
   }
@@ -1262,33 +1405,197 @@ void GPU_HW::DispatchRenderCommand()
     }
   }
 
-  LoadVertices();
+  if (ShouldSkipDraw())
+  {
+    // The command still has to be consumed and its time accounted for, but the vertices are discarded.
+    LoadVertices(texpage_flags);
+    m_batch_current_vertex_ptr = m_batch_start_vertex_ptr + m_batch_submitted_vertex_count;
+    return;
+  }
+
+  LoadVertices(texpage_flags);
+  SubmitBatchPrimitive();
+}
+
+bool GPU_HW::CanMergeIntoPendingBatch(const PendingBatch& batch) const
+{
+  // Background minus foreground is drawn in two passes, so overlapping primitives within the batch would be wrong.
+  const BatchConfig& config = batch.config;
+  if (config.transparency_mode != m_batch.transparency_mode ||
+      m_batch.transparency_mode == GPUTransparencyMode::BackgroundMinusForeground ||
+      config.interlacing != m_batch.interlacing || config.set_mask_while_drawing != m_batch.set_mask_while_drawing ||
+      config.check_mask_before_draw != m_batch.check_mask_before_draw ||
+      config.use_depth_buffer != m_batch.use_depth_buffer)
+  {
+    return false;
+  }
+
+  // The ubershader reads the texture mode and dithering from the vertices.
+  if (!m_using_ubershader && (config.texture_mode != m_batch.texture_mode || config.dithering != m_batch.dithering))
+    return false;
+
+  // The alpha factors are left over from the last transparent primitive, and don't matter when opaque.
+  BatchUBOData ubo_data = m_batch_ubo_data;
+  if (m_batch.transparency_mode == GPUTransparencyMode::Disabled)
+  {
+    ubo_data.u_src_alpha_factor = batch.ubo_data.u_src_alpha_factor;
+    ubo_data.u_dst_alpha_factor = batch.ubo_data.u_dst_alpha_factor;
+  }
+
+  return (std::memcmp(&ubo_data, &batch.ubo_data, sizeof(ubo_data)) == 0);
+}
+
+void GPU_HW::SubmitBatchPrimitive()
+{
+  const u32 first_vertex = m_batch_submitted_vertex_count;
+  const u32 num_vertices = GetBatchVertexCount() - first_vertex;
+  if (num_vertices == 0)
+    return;
+
+  m_batch_submitted_vertex_count += num_vertices;
+
+  // Use the positions which are actually drawn, so PGXP and the half-pixel offsets of lines are covered. Nothing is
+  // drawn outside the drawing area, and one pixel of padding covers rounding when rasterizing at higher resolutions.
+  const BatchVertex* vertices = m_batch_start_vertex_ptr + first_vertex;
+  float min_x = vertices[0].x, max_x = vertices[0].x, min_y = vertices[0].y, max_y = vertices[0].y;
+  for (u32 i = 1; i < num_vertices; i++)
+  {
+    min_x = std::min(min_x, vertices[i].x);
+    max_x = std::max(max_x, vertices[i].x);
+    min_y = std::min(min_y, vertices[i].y);
+    max_y = std::max(max_y, vertices[i].y);
+  }
+
+  const float area_left = static_cast<float>(m_drawing_area.left);
+  const float area_top = static_cast<float>(m_drawing_area.top);
+  const float area_right = static_cast<float>(m_drawing_area.right + 1);
+  const float area_bottom = static_cast<float>(m_drawing_area.bottom + 1);
+  const Common::Rectangle<u32> bounds(
+    static_cast<u32>(std::clamp(std::floor(min_x) - 1.0f, area_left, area_right)),
+    static_cast<u32>(std::clamp(std::floor(min_y) - 1.0f, area_top, area_bottom)),
+    static_cast<u32>(std::clamp(std::ceil(max_x) + 1.0f, area_left, area_right)),
+    static_cast<u32>(std::clamp(std::ceil(max_y) + 1.0f, area_top, area_bottom)));
+
+  // Find the most recent batch with the same state. The primitive can only be moved before the batches following it
+  // if it doesn't overlap any of them, since it'd be drawn in a different order relative to those.
+  u32 batch_index = static_cast<u32>(m_pending_batches.size());
+  for (u32 i = batch_index; i > 0; i--)
+  {
+    const PendingBatch& batch = m_pending_batches[i - 1];
+    if (CanMergeIntoPendingBatch(batch))
+    {
+      batch_index = i - 1;
+      break;
+    }
+
+    if (batch.bounds.Intersects(bounds))
+      break;
+  }
+
+  if (batch_index == m_pending_batches.size())
+  {
+    m_pending_batches.push_back(PendingBatch{m_batch, m_batch_ubo_data, bounds, num_vertices});
+  }
+  else
+  {
+    PendingBatch& batch = m_pending_batches[batch_index];
+    batch.bounds.Include(bounds);
+    batch.num_vertices += num_vertices;
+
+    // With the ubershader, the batch is textured if any primitive in it is, which decides on two-pass rendering.
+    if (m_using_ubershader && m_batch.texture_mode != GPUTextureMode::Disabled)
+      batch.config.texture_mode = m_batch.texture_mode;
+  }
+
+  if (!m_pending_batch_ranges.empty() && m_pending_batch_ranges.back().batch_index == batch_index)
+    m_pending_batch_ranges.back().num_vertices += num_vertices;
+  else
+    m_pending_batch_ranges.push_back(PendingBatchRange{first_vertex, num_vertices, batch_index});
+}
+
+void GPU_HW::DiscardBatchVertices()
+{
+  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
+  m_batch_submitted_vertex_count = 0;
+  m_pending_batches.clear();
+  m_pending_batch_ranges.clear();
 }
 
 void GPU_HW::FlushRender()
 {
-  if (!m_batch_current_vertex_ptr)
-    return;
+  SubmitBatchPrimitive();
 
   const u32 vertex_count = GetBatchVertexCount();
-  UnmapBatchVertexPointer(vertex_count);
-
   if (vertex_count == 0)
     return;
 
-  if (m_batch_ubo_dirty)
+  // Copy the vertices to the GPU so that each batch is contiguous.
+  std::array<u32, MAX_PENDING_BATCHES> batch_offsets;
+  u32 offset = 0;
+  for (size_t i = 0; i < m_pending_batches.size(); i++)
   {
-    UploadUniformBuffer(&m_batch_ubo_data, sizeof(m_batch_ubo_data));
-    m_batch_ubo_dirty = false;
+    batch_offsets[i] = offset;
+    offset += m_pending_batches[i].num_vertices;
   }
 
-  if (NeedsTwoPassRendering())
+  m_stats.num_flushes++;
+  m_stats.num_batches += static_cast<u32>(m_pending_batches.size());
+
+  BatchVertex* const vertices = MapBatchVertexPointer(vertex_count);
+  for (const PendingBatchRange& range : m_pending_batch_ranges)
   {
-    DrawBatchVertices(BatchRenderMode::OnlyOpaque, m_batch_base_vertex, vertex_count);
-    DrawBatchVertices(BatchRenderMode::OnlyTransparent, m_batch_base_vertex, vertex_count);
+    std::memcpy(vertices + batch_offsets[range.batch_index], m_batch_start_vertex_ptr + range.first_vertex,
+                sizeof(BatchVertex) * range.num_vertices);
+    batch_offsets[range.batch_index] += range.num_vertices;
   }
-  else
-    DrawBatchVertices(m_batch.GetRenderMode(), m_batch_base_vertex, vertex_count);
+  UnmapBatchVertexPointer(vertex_count);
+
+  // The backends draw with the state in m_batch, which already belongs to the next primitive.
+  const BatchConfig next_batch = m_batch;
+  u32 base_vertex = m_batch_base_vertex;
+  for (const PendingBatch& batch : m_pending_batches)
+  {
+    m_batch = batch.config;
+    if (std::memcmp(&m_batch, &m_last_drawn_batch, sizeof(m_batch)) != 0)
+    {
+      m_last_drawn_batch = m_batch;
+      m_stats.num_pipeline_switches++;
+    }
+
+    if (m_batch_ubo_dirty ||
+        std::memcmp(&m_uploaded_batch_ubo_data, &batch.ubo_data, sizeof(m_uploaded_batch_ubo_data)) != 0)
+    {
+      UploadUniformBuffer(&batch.ubo_data, sizeof(batch.ubo_data));
+      m_uploaded_batch_ubo_data = batch.ubo_data;
+      m_batch_ubo_dirty = false;
+      m_stats.num_uniform_buffer_updates++;
+    }
+
+    if (NeedsTwoPassRendering())
+    {
+      DrawBatchVertices(BatchRenderMode::OnlyOpaque, base_vertex, batch.num_vertices);
+      DrawBatchVertices(BatchRenderMode::OnlyTransparent, base_vertex, batch.num_vertices);
+      m_stats.num_draw_calls += 2;
+    }
+    else
+    {
+      DrawBatchVertices(m_batch.GetRenderMode(), base_vertex, batch.num_vertices);
+      m_stats.num_draw_calls++;
+    }
+
+    base_vertex += batch.num_vertices;
+  }
+
+  m_batch = next_batch;
+  DiscardBatchVertices();
+}
+
+void GPU_HW::UpdateDisplay()
+{
+  GPU::UpdateDisplay();
+
+  if (m_async_readbacks)
+    QueueSpeculativeVRAMReadback();
 }
 
 GPU_HW::ShaderCompileProgressTracker::ShaderCompileProgressTracker(std::string title, u32 total)
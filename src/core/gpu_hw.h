@@ -2,6 +2,7 @@
 #include "common/heap_array.h"
 #include "gpu.h"
 #include "host_display.h"
+#include <array>
 #include <sstream>
 #include <string>
 #include <tuple>
@@ -44,6 +45,19 @@ protected:
                          6 * (((MAX_PRIMITIVE_WIDTH + (TEXTURE_PAGE_WIDTH - 1)) / TEXTURE_PAGE_WIDTH) + 1u) *
                          (((MAX_PRIMITIVE_HEIGHT + (TEXTURE_PAGE_HEIGHT - 1)) / TEXTURE_PAGE_HEIGHT) + 1u);
 
+  // Per-primitive state for the ubershader, packed into the texpage bits above the draw mode register.
+  static constexpr u32 TEXPAGE_TEXTURED_BIT = 1u << 13, TEXPAGE_RAW_TEXTURE_BIT = 1u << 14,
+                       TEXPAGE_DITHERING_BIT = 1u << 15;
+
+  // The ubershader handles every texture mode, so batches use the shaders for this one.
+  static constexpr GPUTextureMode UBERSHADER_TEXTURE_MODE = GPUTextureMode::Palette4Bit;
+
+  // For async readbacks, VRAM is split into blocks which track whether the shadow copy is out of date. Each row of
+  // blocks is a single u64.
+  static constexpr u32 VRAM_SHADOW_BLOCK_WIDTH = 16, VRAM_SHADOW_BLOCK_HEIGHT = 8,
+                       VRAM_SHADOW_BLOCK_ROWS = VRAM_HEIGHT / VRAM_SHADOW_BLOCK_HEIGHT;
+  static_assert((VRAM_WIDTH / VRAM_SHADOW_BLOCK_WIDTH) == 64);
+
   struct BatchVertex
   {
     float x;
@@ -118,6 +132,23 @@ protected:
     u32 u_set_mask_while_drawing;
   };
 
+  /// Primitives which share the same state and haven't been drawn yet.
+  struct PendingBatch
+  {
+    BatchConfig config;
+    BatchUBOData ubo_data;
+    Common::Rectangle<u32> bounds;
+    u32 num_vertices;
+  };
+
+  /// Consecutive staged vertices belonging to one pending batch.
+  struct PendingBatchRange
+  {
+    u32 first_vertex;
+    u32 num_vertices;
+    u32 batch_index;
+  };
+
   struct VRAMFillUBOData
   {
     u32 u_dst_x;
@@ -186,11 +217,18 @@ protected:
   virtual void UpdateDepthBufferFromMaskBit() = 0;
   virtual void ClearDepthBuffer() = 0;
   virtual void SetScissorFromDrawingArea() = 0;
-  virtual void MapBatchVertexPointer(u32 required_vertices) = 0;
+  /// Returns a pointer to space for the vertices of a flush in the GPU vertex buffer, and sets m_batch_base_vertex.
+  virtual BatchVertex* MapBatchVertexPointer(u32 required_vertices) = 0;
   virtual void UnmapBatchVertexPointer(u32 used_vertices) = 0;
   virtual void UploadUniformBuffer(const void* uniforms, u32 uniforms_size) = 0;
   virtual void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) = 0;
 
+  /// Starts copying a block-aligned area of VRAM to the CPU in the background. Returns false if not supported.
+  virtual bool QueueAsyncVRAMReadback(const Common::Rectangle<u32>& rect);
+
+  /// Waits for the copy started by QueueAsyncVRAMReadback() to complete, and writes it to the VRAM shadow.
+  virtual void FinishAsyncVRAMReadback(const Common::Rectangle<u32>& rect);
+
   u32 CalculateResolutionScale() const;
   GPUDownsampleMode GetDownsampleMode(u32 resolution_scale) const;
 
@@ -212,12 +250,44 @@ protected:
   }
   void IncludeVRAMDirtyRectangle(const Common::Rectangle<u32>& rect);
 
+  /// Expands the dirty rectangle by the area covered by a primitive.
+  ALWAYS_INLINE void IncludeDrawnVRAMRectangle(u32 left, u32 right, u32 top, u32 bottom)
+  {
+    m_vram_dirty_rect.Include(left, right, top, bottom);
+    if (m_async_readbacks)
+      MarkVRAMShadowDirty(Common::Rectangle<u32>(left, top, right, bottom));
+  }
+
+  /// Flags the area of VRAM as changed on the GPU, so the shadow copy has to be refreshed before it is read.
+  void MarkVRAMShadowDirty(const Common::Rectangle<u32>& rect);
+  void MarkVRAMShadowClean(const Common::Rectangle<u32>& block_rect);
+  void SetFullVRAMShadowDirty();
+  bool IsVRAMShadowDirty(const Common::Rectangle<u32>& rect) const;
+
+  /// Returns the mask for the blocks in a row covered by the range, and expands a rectangle to whole blocks.
+  static u64 GetVRAMShadowBlockMask(u32 left, u32 right);
+  static Common::Rectangle<u32> GetVRAMShadowBlockBounds(const Common::Rectangle<u32>& rect);
+
+  /// Returns the area which has to be read back for a VRAM to CPU transfer, or an invalid rectangle if the shadow copy
+  /// is already up to date. Completes any background readback which is in progress.
+  Common::Rectangle<u32> GetVRAMReadbackBounds(u32 x, u32 y, u32 width, u32 height);
+
+  /// Starts a background readback of the area which was read in the last frame, if it has been drawn to since.
+  void QueueSpeculativeVRAMReadback();
+  void FinishPendingVRAMReadback();
+
   u32 GetBatchVertexSpace() const { return static_cast<u32>(m_batch_end_vertex_ptr - m_batch_current_vertex_ptr); }
   u32 GetBatchVertexCount() const { return static_cast<u32>(m_batch_current_vertex_ptr - m_batch_start_vertex_ptr); }
   void EnsureVertexBufferSpace(u32 required_vertices);
   void EnsureVertexBufferSpaceForCurrentCommand();
   void ResetBatchVertexDepth();
 
+  /// Adds the vertices written since the last call to a pending batch, which may be earlier than the last one if the
+  /// primitive doesn't overlap anything drawn in between.
+  void SubmitBatchPrimitive();
+  bool CanMergeIntoPendingBatch(const PendingBatch& batch) const;
+  void DiscardBatchVertices();
+
   /// Returns the value to be written to the depth buffer for the current operation for mask bit emulation.
   ALWAYS_INLINE float GetCurrentNormalizedVertexDepth() const
   {
@@ -260,6 +330,21 @@ protected:
              (!m_supports_dual_source_blend && m_batch.transparency_mode != GPUTransparencyMode::Disabled)));
   }
 
+  /// Returns the texture mode, dithering and interlacing state which selects the shaders for the current batch.
+  /// With the ubershader these are all dynamic, so only the transparency and render mode matter.
+  ALWAYS_INLINE GPUTextureMode GetBatchShaderTextureMode() const
+  {
+    return m_using_ubershader ? UBERSHADER_TEXTURE_MODE : m_batch.texture_mode;
+  }
+  ALWAYS_INLINE bool GetBatchShaderDithering() const { return !m_using_ubershader && m_batch.dithering; }
+  ALWAYS_INLINE bool GetBatchShaderInterlacing() const { return !m_using_ubershader && m_batch.interlacing; }
+
+  /// Returns true if shaders/pipelines need to be created for the specified batch state.
+  ALWAYS_INLINE bool IsBatchShaderPermutationUsed(GPUTextureMode texture_mode, bool dithering, bool interlacing) const
+  {
+    return !m_using_ubershader || (texture_mode == UBERSHADER_TEXTURE_MODE && !dithering && !interlacing);
+  }
+
   /// Returns true if the specified VRAM fill is oversized.
   ALWAYS_INLINE static bool IsVRAMFillOversized(u32 x, u32 y, u32 width, u32 height)
   {
@@ -282,6 +367,7 @@ protected:
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
   void DispatchRenderCommand() override;
   void FlushRender() override;
+  void UpdateDisplay() override;
 
   void CalcScissorRect(int* left, int* top, int* right, int* bottom);
 
@@ -297,7 +383,7 @@ protected:
   VRAMCopyUBOData GetVRAMCopyUBOData(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) const;
 
   /// Expands a line into two triangles.
-  void DrawLine(float x0, float y0, u32 col0, float x1, float y1, u32 col1, float depth);
+  void DrawLine(float x0, float y0, u32 col0, float x1, float y1, u32 col1, float depth, u32 texpage);
 
   /// Handles quads with flipped texture coordinate directions.
   static void HandleFlippedQuadTextureCoordinates(BatchVertex* vertices);
@@ -327,10 +413,15 @@ protected:
   HeapArray<u16, VRAM_WIDTH * VRAM_HEIGHT> m_vram_shadow;
   std::unique_ptr<GPU_SW_Backend> m_sw_renderer;
 
+  // Vertices are staged on the CPU, and copied to the GPU buffer grouped by batch when the batches are drawn.
+  std::vector<BatchVertex> m_batch_staging_vertices;
   BatchVertex* m_batch_start_vertex_ptr = nullptr;
   BatchVertex* m_batch_end_vertex_ptr = nullptr;
   BatchVertex* m_batch_current_vertex_ptr = nullptr;
   u32 m_batch_base_vertex = 0;
+  u32 m_batch_submitted_vertex_count = 0;
+  std::vector<PendingBatch> m_pending_batches;
+  std::vector<PendingBatchRange> m_pending_batch_ranges;
   s32 m_current_depth = 0;
   float m_last_depth_z = 1.0f;
 
@@ -359,20 +450,32 @@ protected:
   GPUDownsampleMode m_downsample_mode = GPUDownsampleMode::Disabled;
   bool m_using_uv_limits = false;
   bool m_pgxp_depth_buffer = false;
+  bool m_using_ubershader = false;
+  bool m_async_readbacks = false;
 
   BatchConfig m_batch;
+  BatchConfig m_last_drawn_batch;
   BatchUBOData m_batch_ubo_data = {};
+  BatchUBOData m_uploaded_batch_ubo_data = {};
 
   // Bounding box of VRAM area that the GPU has drawn into.
   Common::Rectangle<u32> m_vram_dirty_rect;
 
+  // Blocks of VRAM which have been written by the GPU since they were last read back, one bit per block.
+  std::array<u64, VRAM_SHADOW_BLOCK_ROWS> m_vram_shadow_dirty_blocks = {};
+
+  // Area read back by the game in the current frame, and the area being copied in the background.
+  Common::Rectangle<u32> m_vram_readback_rect;
+  Common::Rectangle<u32> m_vram_async_readback_rect;
+
   // Changed state
   bool m_batch_ubo_dirty = true;
 
 private:
-  static constexpr u32 MIN_BATCH_VERTEX_COUNT = 6, MAX_BATCH_VERTEX_COUNT = VERTEX_BUFFER_SIZE / sizeof(BatchVertex);
+  static constexpr u32 MIN_BATCH_VERTEX_COUNT = 6, MAX_BATCH_VERTEX_COUNT = VERTEX_BUFFER_SIZE / sizeof(BatchVertex),
+                       MAX_PENDING_BATCHES = 16;
 
-  void LoadVertices();
+  void LoadVertices(u32 texpage_flags);
 
   ALWAYS_INLINE void AddVertex(const BatchVertex& v)
   {
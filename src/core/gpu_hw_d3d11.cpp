@@ -607,23 +607,18 @@ void GPU_HW_D3D11::UpdateSettings()
   }
 }
 
-void GPU_HW_D3D11::MapBatchVertexPointer(u32 required_vertices)
+GPU_HW::BatchVertex* GPU_HW_D3D11::MapBatchVertexPointer(u32 required_vertices)
 {
   const D3D11::StreamBuffer::MappingResult res =
     m_vertex_stream_buffer.Map(m_context.Get(), sizeof(BatchVertex), required_vertices * sizeof(BatchVertex));
 
-  m_batch_start_vertex_ptr = static_cast<BatchVertex*>(res.pointer);
-  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
-  m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + res.space_aligned;
   m_batch_base_vertex = res.index_aligned;
+  return static_cast<BatchVertex*>(res.pointer);
 }
 
 void GPU_HW_D3D11::UnmapBatchVertexPointer(u32 used_vertices)
 {
   m_vertex_stream_buffer.Unmap(m_context.Get(), used_vertices * sizeof(BatchVertex));
-  m_batch_start_vertex_ptr = nullptr;
-  m_batch_end_vertex_ptr = nullptr;
-  m_batch_current_vertex_ptr = nullptr;
 }
 
 void GPU_HW_D3D11::SetCapabilities()
@@ -921,7 +916,8 @@ bool GPU_HW_D3D11::CompileShaders()
 
   GPU_HW_ShaderGen shadergen(m_host_display->GetRenderAPI(), m_resolution_scale, m_multisamples, m_per_sample_shading,
                              m_true_color, m_scaled_dithering, m_texture_filtering, m_using_uv_limits,
-                             m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend);
+                             m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend,
+                             m_using_ubershader);
 
   ShaderCompileProgressTracker progress("Compiling Shaders",
                                         1 + 1 + 2 + (4 * 9 * 2 * 2) + 1 + (2 * 2) + 4 + (2 * 3) + 1);
@@ -980,6 +976,13 @@ bool GPU_HW_D3D11::CompileShaders()
       {
         for (u8 interlacing = 0; interlacing < 2; interlacing++)
         {
+          if (!IsBatchShaderPermutationUsed(static_cast<GPUTextureMode>(texture_mode),
+                                            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing)))
+          {
+            progress.Increment();
+            continue;
+          }
+
           const std::string ps = shadergen.GenerateBatchFragmentShader(
             static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
             ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
@@ -1211,12 +1214,14 @@ bool GPU_HW_D3D11::BlitVRAMReplacementTexture(const TextureReplacementTexture* t
 
 void GPU_HW_D3D11::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices)
 {
-  const bool textured = (m_batch.texture_mode != GPUTextureMode::Disabled);
+  const GPUTextureMode texture_mode = GetBatchShaderTextureMode();
+  const bool textured = (texture_mode != GPUTextureMode::Disabled);
 
   m_context->VSSetShader(m_batch_vertex_shaders[BoolToUInt8(textured)].Get(), nullptr, 0);
 
-  m_context->PSSetShader(m_batch_pixel_shaders[static_cast<u8>(render_mode)][static_cast<u8>(m_batch.texture_mode)]
-                                              [BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)]
+  m_context->PSSetShader(m_batch_pixel_shaders[static_cast<u8>(render_mode)][static_cast<u8>(texture_mode)]
+                                              [BoolToUInt8(GetBatchShaderDithering())]
+                                              [BoolToUInt8(GetBatchShaderInterlacing())]
                                                 .Get(),
                          nullptr, 0);
 
@@ -1341,7 +1346,10 @@ void GPU_HW_D3D11::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
   }
 
   // Get bounds with wrap-around handled.
-  const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
+  const Common::Rectangle<u32> copy_rect = GetVRAMReadbackBounds(x, y, width, height);
+  if (!copy_rect.Valid())
+    return;
+
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
   const u32 encoded_height = copy_rect.GetHeight();
 
@@ -166,7 +166,7 @@ void GPU_HW_D3D12::UpdateSettings()
   }
 }
 
-void GPU_HW_D3D12::MapBatchVertexPointer(u32 required_vertices)
+GPU_HW::BatchVertex* GPU_HW_D3D12::MapBatchVertexPointer(u32 required_vertices)
 {
   const u32 required_space = required_vertices * sizeof(BatchVertex);
   if (!m_vertex_stream_buffer.ReserveMemory(required_space, sizeof(BatchVertex)))
@@ -176,20 +176,14 @@ void GPU_HW_D3D12::MapBatchVertexPointer(u32 required_vertices)
     m_vertex_stream_buffer.ReserveMemory(required_space, sizeof(BatchVertex));
   }
 
-  m_batch_start_vertex_ptr = static_cast<BatchVertex*>(m_vertex_stream_buffer.GetCurrentHostPointer());
-  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
-  m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + (m_vertex_stream_buffer.GetCurrentSpace() / sizeof(BatchVertex));
   m_batch_base_vertex = m_vertex_stream_buffer.GetCurrentOffset() / sizeof(BatchVertex);
+  return static_cast<BatchVertex*>(m_vertex_stream_buffer.GetCurrentHostPointer());
 }
 
 void GPU_HW_D3D12::UnmapBatchVertexPointer(u32 used_vertices)
 {
   if (used_vertices > 0)
     m_vertex_stream_buffer.CommitMemory(used_vertices * sizeof(BatchVertex));
-
-  m_batch_start_vertex_ptr = nullptr;
-  m_batch_end_vertex_ptr = nullptr;
-  m_batch_current_vertex_ptr = nullptr;
 }
 
 void GPU_HW_D3D12::UploadUniformBuffer(const void* data, u32 data_size)
@@ -410,7 +404,8 @@ bool GPU_HW_D3D12::CompilePipelines()
 
   GPU_HW_ShaderGen shadergen(m_host_display->GetRenderAPI(), m_resolution_scale, m_multisamples, m_per_sample_shading,
                              m_true_color, m_scaled_dithering, m_texture_filtering, m_using_uv_limits,
-                             m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend);
+                             m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend,
+                             m_using_ubershader);
 
   ShaderCompileProgressTracker progress("Compiling Pipelines", 2 + (4 * 9 * 2 * 2) + (2 * 4 * 5 * 9 * 2 * 2) + 1 +
                                                                  (2 * 2) + 2 + 2 + 1 + 1 + (2 * 3) + 1);
@@ -438,6 +433,13 @@ bool GPU_HW_D3D12::CompilePipelines()
       {
         for (u8 interlacing = 0; interlacing < 2; interlacing++)
         {
+          if (!IsBatchShaderPermutationUsed(static_cast<GPUTextureMode>(texture_mode),
+                                            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing)))
+          {
+            progress.Increment();
+            continue;
+          }
+
           const std::string fs = shadergen.GenerateBatchFragmentShader(
             static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
             ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
@@ -467,6 +469,13 @@ bool GPU_HW_D3D12::CompilePipelines()
           {
             for (u8 interlacing = 0; interlacing < 2; interlacing++)
             {
+              if (!IsBatchShaderPermutationUsed(static_cast<GPUTextureMode>(texture_mode),
+                                                ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing)))
+              {
+                progress.Increment();
+                continue;
+              }
+
               const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
 
               gpbuilder.SetRootSignature(m_batch_root_signature.Get());
@@ -812,8 +821,8 @@ void GPU_HW_D3D12::DrawBatchVertices(BatchRenderMode render_mode, u32 base_verte
   // [primitive][depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
   ID3D12PipelineState* pipeline =
     m_batch_pipelines[BoolToUInt8(m_batch.check_mask_before_draw || m_batch.use_depth_buffer)][static_cast<u8>(
-      render_mode)][static_cast<u8>(m_batch.texture_mode)][static_cast<u8>(m_batch.transparency_mode)]
-                     [BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)]
+      render_mode)][static_cast<u8>(GetBatchShaderTextureMode())][static_cast<u8>(m_batch.transparency_mode)]
+                     [BoolToUInt8(GetBatchShaderDithering())][BoolToUInt8(GetBatchShaderInterlacing())]
                        .Get();
 
   cmdlist->SetPipelineState(pipeline);
@@ -916,7 +925,10 @@ void GPU_HW_D3D12::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
   }
 
   // Get bounds with wrap-around handled.
-  const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
+  const Common::Rectangle<u32> copy_rect = GetVRAMReadbackBounds(x, y, width, height);
+  if (!copy_rect.Valid())
+    return;
+
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
   const u32 encoded_height = copy_rect.GetHeight();
 
@@ -564,6 +564,10 @@ GPU_HW_OpenGL::~GPU_HW_OpenGL()
     glDeleteVertexArrays(1, &m_attributeless_vao_id);
   if (m_texture_buffer_r16ui_texture != 0)
     glDeleteTextures(1, &m_texture_buffer_r16ui_texture);
+  if (m_vram_readback_fence)
+    glDeleteSync(m_vram_readback_fence);
+  if (m_vram_readback_pbo_id != 0)
+    glDeleteBuffers(1, &m_vram_readback_pbo_id);
 
   if (m_host_display)
   {
@@ -807,24 +811,19 @@ void GPU_HW_OpenGL::UpdateSettings()
   }
 }
 
-void GPU_HW_OpenGL::MapBatchVertexPointer(u32 required_vertices)
+GPU_HW::BatchVertex* GPU_HW_OpenGL::MapBatchVertexPointer(u32 required_vertices)
 {
   const GL::StreamBuffer::MappingResult res =
     m_vertex_stream_buffer->Map(sizeof(BatchVertex), required_vertices * sizeof(BatchVertex));
 
-  m_batch_start_vertex_ptr = static_cast<BatchVertex*>(res.pointer);
-  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
-  m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + res.space_aligned;
   m_batch_base_vertex = res.index_aligned;
+  return static_cast<BatchVertex*>(res.pointer);
 }
 
 void GPU_HW_OpenGL::UnmapBatchVertexPointer(u32 used_vertices)
 {
   m_vertex_stream_buffer->Unmap(used_vertices * sizeof(BatchVertex));
   m_vertex_stream_buffer->Bind();
-  m_batch_start_vertex_ptr = nullptr;
-  m_batch_end_vertex_ptr = nullptr;
-  m_batch_current_vertex_ptr = nullptr;
 }
 
 std::tuple<s32, s32> GPU_HW_OpenGL::ConvertToFramebufferCoordinates(s32 x, s32 y)
@@ -857,6 +856,8 @@ void GPU_HW_OpenGL::SetCapabilities()
   if (!GLAD_GL_VERSION_4_3 && !GLAD_GL_EXT_copy_image && !GLAD_GL_ES_VERSION_3_2 && !GLAD_GL_OES_copy_image)
     Log_WarningPrintf("GL_EXT/OES_copy_image missing, this may affect performance.");
 
+  m_supports_async_readbacks = (GLAD_GL_VERSION_3_2 || GLAD_GL_ARB_sync || GLAD_GL_ES_VERSION_3_0);
+
 #ifdef __APPLE__
   // Partial texture buffer uploads appear to be broken in macOS's OpenGL driver.
   m_use_texture_buffer_for_vram_writes = false;
@@ -973,6 +974,14 @@ bool GPU_HW_OpenGL::CreateFramebuffer()
   if (m_state_copy_fbo_id == 0)
     glGenFramebuffers(1, &m_state_copy_fbo_id);
 
+  if (m_supports_async_readbacks && m_vram_readback_pbo_id == 0)
+  {
+    glGenBuffers(1, &m_vram_readback_pbo_id);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, m_vram_readback_pbo_id);
+    glBufferData(GL_PIXEL_PACK_BUFFER, VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16), nullptr, GL_STREAM_READ);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+  }
+
   SetFullVRAMDirtyRectangle();
   return true;
 }
@@ -1056,7 +1065,8 @@ bool GPU_HW_OpenGL::CompilePrograms()
   const bool use_binding_layout = GPU_HW_ShaderGen::UseGLSLBindingLayout();
   GPU_HW_ShaderGen shadergen(m_host_display->GetRenderAPI(), m_resolution_scale, m_multisamples, m_per_sample_shading,
                              m_true_color, m_scaled_dithering, m_texture_filtering, m_using_uv_limits,
-                             m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend);
+                             m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend,
+                             m_using_ubershader);
 
   ShaderCompileProgressTracker progress("Compiling Programs", (4 * 9 * 2 * 2) + (2 * 3) + (2 * 2) + 1 + 1 + 1 + 1 + 1);
 
@@ -1068,6 +1078,13 @@ bool GPU_HW_OpenGL::CompilePrograms()
       {
         for (u8 interlacing = 0; interlacing < 2; interlacing++)
         {
+          if (!IsBatchShaderPermutationUsed(static_cast<GPUTextureMode>(texture_mode),
+                                            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing)))
+          {
+            progress.Increment();
+            continue;
+          }
+
           const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
           const std::string batch_vs = shadergen.GenerateBatchVertexShader(textured);
           const std::string fs = shadergen.GenerateBatchFragmentShader(
@@ -1263,13 +1280,16 @@ bool GPU_HW_OpenGL::CompilePrograms()
   progress.Increment();
 #undef UPDATE_PROGRESS
 
+  // anything the warm-up thread decoded which we didn't use is for other settings
+  shader_cache.FinishWarmup();
   return true;
 }
 
 void GPU_HW_OpenGL::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices)
 {
-  const GL::Program& prog = m_render_programs[static_cast<u8>(render_mode)][static_cast<u8>(m_batch.texture_mode)]
-                                             [BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)];
+  const GL::Program& prog =
+    m_render_programs[static_cast<u8>(render_mode)][static_cast<u8>(GetBatchShaderTextureMode())]
+                     [BoolToUInt8(GetBatchShaderDithering())][BoolToUInt8(GetBatchShaderInterlacing())];
   prog.Bind();
 
   if (m_current_transparency_mode != m_batch.transparency_mode || m_current_render_mode != render_mode)
@@ -1281,7 +1301,7 @@ void GPU_HW_OpenGL::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vert
 
   SetDepthFunc();
 
-  glDrawArrays(GL_TRIANGLES, m_batch_base_vertex, num_vertices);
+  glDrawArrays(GL_TRIANGLES, base_vertex, num_vertices);
 }
 
 void GPU_HW_OpenGL::SetBlendMode()
@@ -1497,7 +1517,89 @@ void GPU_HW_OpenGL::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
   }
 
   // Get bounds with wrap-around handled.
-  const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
+  const Common::Rectangle<u32> copy_rect = GetVRAMReadbackBounds(x, y, width, height);
+  if (!copy_rect.Valid())
+    return;
+
+  const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = copy_rect.GetHeight();
+  EncodeVRAMForReadback(copy_rect);
+
+  // Readback encoded texture.
+  glPixelStorei(GL_PACK_ALIGNMENT, 2);
+  glPixelStorei(GL_PACK_ROW_LENGTH, VRAM_WIDTH / 2);
+  glReadPixels(0, 0, encoded_width, encoded_height, GL_RGBA, GL_UNSIGNED_BYTE,
+               &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left]);
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+  glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+  RestoreGraphicsAPIState();
+}
+
+bool GPU_HW_OpenGL::QueueAsyncVRAMReadback(const Common::Rectangle<u32>& rect)
+{
+  if (m_vram_readback_pbo_id == 0)
+    return false;
+
+  EncodeVRAMForReadback(rect);
+
+  // Read into the same position in the buffer as in the shadow, so the same offset/stride can be used to copy it out.
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, m_vram_readback_pbo_id);
+  glPixelStorei(GL_PACK_ALIGNMENT, 2);
+  glPixelStorei(GL_PACK_ROW_LENGTH, VRAM_WIDTH / 2);
+  glReadPixels(0, 0, rect.GetWidth() / 2, rect.GetHeight(), GL_RGBA, GL_UNSIGNED_BYTE,
+               reinterpret_cast<void*>(static_cast<uintptr_t>((rect.top * VRAM_WIDTH + rect.left) * sizeof(u16))));
+  glPixelStorei(GL_PACK_ALIGNMENT, 4);
+  glPixelStorei(GL_PACK_ROW_LENGTH, 0);
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+  if (m_vram_readback_fence)
+    glDeleteSync(m_vram_readback_fence);
+  m_vram_readback_fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+  RestoreGraphicsAPIState();
+  return true;
+}
+
+void GPU_HW_OpenGL::FinishAsyncVRAMReadback(const Common::Rectangle<u32>& rect)
+{
+  // The fence was usually signaled long before the game reads it, so this only stalls if the GPU is behind.
+  if (m_vram_readback_fence)
+  {
+    while (glClientWaitSync(m_vram_readback_fence, GL_SYNC_FLUSH_COMMANDS_BIT, UINT64_C(1000000000)) ==
+           GL_TIMEOUT_EXPIRED)
+    {
+    }
+
+    glDeleteSync(m_vram_readback_fence);
+    m_vram_readback_fence = nullptr;
+  }
+
+  const u32 offset = (rect.top * VRAM_WIDTH + rect.left) * sizeof(u16);
+  const u32 size = ((rect.bottom - 1) * VRAM_WIDTH + rect.right) * sizeof(u16) - offset;
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, m_vram_readback_pbo_id);
+
+  const u8* data = static_cast<const u8*>(glMapBufferRange(GL_PIXEL_PACK_BUFFER, offset, size, GL_MAP_READ_BIT));
+  if (data)
+  {
+    for (u32 row = 0; row < rect.GetHeight(); row++)
+    {
+      std::memcpy(&m_vram_shadow[(rect.top + row) * VRAM_WIDTH + rect.left], data + (row * VRAM_WIDTH * sizeof(u16)),
+                  rect.GetWidth() * sizeof(u16));
+    }
+
+    glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+  }
+  else
+  {
+    Log_ErrorPrintf("Failed to map VRAM readback buffer");
+    MarkVRAMShadowDirty(rect);
+  }
+
+  glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+void GPU_HW_OpenGL::EncodeVRAMForReadback(const Common::Rectangle<u32>& copy_rect)
+{
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
   const u32 encoded_height = copy_rect.GetHeight();
 
@@ -1514,15 +1616,7 @@ void GPU_HW_OpenGL::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
   glBindVertexArray(m_attributeless_vao_id);
   glDrawArrays(GL_TRIANGLES, 0, 3);
 
-  // Readback encoded texture.
   m_vram_encoding_texture.BindFramebuffer(GL_READ_FRAMEBUFFER);
-  glPixelStorei(GL_PACK_ALIGNMENT, 2);
-  glPixelStorei(GL_PACK_ROW_LENGTH, VRAM_WIDTH / 2);
-  glReadPixels(0, 0, encoded_width, encoded_height, GL_RGBA, GL_UNSIGNED_BYTE,
-               &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left]);
-  glPixelStorei(GL_PACK_ALIGNMENT, 4);
-  glPixelStorei(GL_PACK_ROW_LENGTH, 0);
-  RestoreGraphicsAPIState();
 }
 
 void GPU_HW_OpenGL::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
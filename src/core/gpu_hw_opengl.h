@@ -112,10 +112,12 @@ protected:
   void UpdateDepthBufferFromMaskBit() override;
   void ClearDepthBuffer() override;
   void SetScissorFromDrawingArea() override;
-  void MapBatchVertexPointer(u32 required_vertices) override;
+  BatchVertex* MapBatchVertexPointer(u32 required_vertices) override;
   void UnmapBatchVertexPointer(u32 used_vertices) override;
   void UploadUniformBuffer(const void* data, u32 data_size) override;
   void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) override;
+  bool QueueAsyncVRAMReadback(const Common::Rectangle<u32>& rect) override;
+  void FinishAsyncVRAMReadback(const Common::Rectangle<u32>& rect) override;
 
 private:
   struct GLStats
@@ -132,6 +134,9 @@ private:
 
   std::tuple<s32, s32> ConvertToFramebufferCoordinates(s32 x, s32 y);
 
+  /// Encodes the area of VRAM to 16-bit in the encoding texture, and binds it for reading.
+  void EncodeVRAMForReadback(const Common::Rectangle<u32>& copy_rect);
+
   void SetCapabilities();
   bool CreateFramebuffer();
   void ClearFramebuffer();
@@ -166,6 +171,10 @@ private:
   GLuint m_attributeless_vao_id = 0;
   GLuint m_state_copy_fbo_id = 0;
 
+  // Pixel pack buffer for async readbacks, laid out the same as the VRAM shadow.
+  GLuint m_vram_readback_pbo_id = 0;
+  GLsync m_vram_readback_fence = nullptr;
+
   std::unique_ptr<GL::StreamBuffer> m_uniform_stream_buffer;
 
   std::unique_ptr<GL::StreamBuffer> m_texture_stream_buffer;
@@ -185,6 +194,7 @@ private:
 
   bool m_use_texture_buffer_for_vram_writes = false;
   bool m_use_ssbo_for_vram_writes = false;
+  bool m_supports_async_readbacks = false;
 
   GLenum m_current_depth_test = 0;
   GPUTransparencyMode m_current_transparency_mode = GPUTransparencyMode::Disabled;
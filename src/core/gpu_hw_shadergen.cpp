@@ -5,11 +5,11 @@
 GPU_HW_ShaderGen::GPU_HW_ShaderGen(HostDisplay::RenderAPI render_api, u32 resolution_scale, u32 multisamples,
                                    bool per_sample_shading, bool true_color, bool scaled_dithering,
                                    GPUTextureFilter texture_filtering, bool uv_limits, bool pgxp_depth,
-                                   bool disable_color_perspective, bool supports_dual_source_blend)
+                                   bool disable_color_perspective, bool supports_dual_source_blend, bool ubershader)
   : ShaderGen(render_api, supports_dual_source_blend), m_resolution_scale(resolution_scale),
     m_multisamples(multisamples), m_per_sample_shading(per_sample_shading), m_true_color(true_color),
     m_scaled_dithering(scaled_dithering), m_texture_filter(texture_filtering), m_uv_limits(uv_limits),
-    m_pgxp_depth(pgxp_depth), m_disable_color_perspective(disable_color_perspective)
+    m_pgxp_depth(pgxp_depth), m_disable_color_perspective(disable_color_perspective), m_ubershader(ubershader)
 {
 }
 
@@ -76,9 +76,12 @@ void GPU_HW_ShaderGen::WriteBatchUniformBuffer(std::stringstream& ss)
 
 std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured)
 {
+  textured |= m_ubershader;
+
   std::stringstream ss;
   WriteHeader(ss);
   DefineMacro(ss, "TEXTURED", textured);
+  DefineMacro(ss, "UBERSHADER", m_ubershader);
   DefineMacro(ss, "UV_LIMITS", m_uv_limits);
   DefineMacro(ss, "PGXP_DEPTH", m_pgxp_depth);
 
@@ -169,6 +172,12 @@ std::string GPU_HW_ShaderGen::GenerateBatchVertexShader(bool textured)
     v_texpage.z = ((a_texpage >> 16) & 63u) * 16u * RESOLUTION_SCALE;
     v_texpage.w = ((a_texpage >> 22) & 511u) * RESOLUTION_SCALE;
 
+    #if UBERSHADER
+      // Pass the texture mode (bits 7-8), raw texture (14), dithering (15) and textured (13) bits to the fragment
+      // shader in the upper half of texpage.y.
+      v_texpage.y |= (((a_texpage >> 7) & 3u) | (((a_texpage >> 14) & 3u) << 2) | (((a_texpage >> 13) & 1u) << 4)) << 16;
+    #endif
+
     #if UV_LIMITS
       v_uv_limits = a_uv_limits * float4(255.0, 255.0, 255.0, 255.0);
     #endif
@@ -669,7 +678,8 @@ std::string GPU_HW_ShaderGen::GenerateBatchFragmentShader(GPU_HW::BatchRenderMod
 {
   const GPUTextureMode actual_texture_mode = texture_mode & ~GPUTextureMode::RawTextureBit;
   const bool raw_texture = (texture_mode & GPUTextureMode::RawTextureBit) == GPUTextureMode::RawTextureBit;
-  const bool textured = (texture_mode != GPUTextureMode::Disabled);
+  const bool textured = (texture_mode != GPUTextureMode::Disabled) || m_ubershader;
+  interlacing |= m_ubershader;
   const bool use_dual_source =
     m_supports_dual_source_blend && ((transparency != GPU_HW::BatchRenderMode::TransparencyDisabled &&
                                       transparency != GPU_HW::BatchRenderMode::OnlyOpaque) ||
@@ -681,6 +691,7 @@ std::string GPU_HW_ShaderGen::GenerateBatchFragmentShader(GPU_HW::BatchRenderMod
   DefineMacro(ss, "TRANSPARENCY_ONLY_OPAQUE", transparency == GPU_HW::BatchRenderMode::OnlyOpaque);
   DefineMacro(ss, "TRANSPARENCY_ONLY_TRANSPARENT", transparency == GPU_HW::BatchRenderMode::OnlyTransparent);
   DefineMacro(ss, "TEXTURED", textured);
+  DefineMacro(ss, "UBERSHADER", m_ubershader);
   DefineMacro(ss, "PALETTE",
               actual_texture_mode == GPUTextureMode::Palette4Bit || actual_texture_mode == GPUTextureMode::Palette8Bit);
   DefineMacro(ss, "PALETTE_4_BIT", actual_texture_mode == GPUTextureMode::Palette4Bit);
@@ -731,6 +742,21 @@ uint3 ApplyDithering(uint2 coord, uint3 icol)
   #endif
 }
 
+#if UBERSHADER
+  // The vertex shader stores the per-primitive state in the upper half of texpage.y.
+  #define IS_TEXTURED(texpage) (((texpage.y >> 16) & 16u) != 0u)
+  #define IS_PALETTE(texpage) (((texpage.y >> 16) & 2u) == 0u)
+  #define IS_PALETTE_4_BIT(texpage) (((texpage.y >> 16) & 3u) == 0u)
+  #define IS_RAW_TEXTURE(texpage) (((texpage.y >> 16) & 4u) != 0u)
+  #define IS_DITHERING(texpage) (((texpage.y >> 16) & 8u) != 0u)
+#else
+  #define IS_TEXTURED(texpage) (TEXTURED != 0)
+  #define IS_PALETTE(texpage) (PALETTE != 0)
+  #define IS_PALETTE_4_BIT(texpage) (PALETTE_4_BIT != 0)
+  #define IS_RAW_TEXTURE(texpage) (RAW_TEXTURE != 0)
+  #define IS_DITHERING(texpage) (DITHERING != 0)
+#endif
+
 #if TEXTURED
 CONSTANT float4 TRANSPARENT_PIXEL_COLOR = float4(0.0, 0.0, 0.0, 0.0);
 
@@ -757,40 +783,51 @@ uint2 FloatToIntegerCoords(float2 coords)
 
 float4 SampleFromVRAM(uint4 texpage, float2 coords)
 {
-  #if PALETTE
+  // The texture mode is only known at runtime with the ubershader, so these are explicit-LOD samples, which are
+  // allowed in non-uniform control flow. VRAM has a single level, so the result is the same.
+  bool palette = IS_PALETTE(texpage);
+  bool palette_4_bit = IS_PALETTE_4_BIT(texpage);
+  #if UBERSHADER
+    texpage.y &= 0xFFFFu;
+  #endif
+
+  if (palette)
+  {
     uint2 icoord = ApplyTextureWindow(FloatToIntegerCoords(coords));
     uint2 index_coord = icoord;
-    #if PALETTE_4_BIT
-      index_coord.x /= 4u;
-    #elif PALETTE_8_BIT
-      index_coord.x /= 2u;
-    #endif
+    index_coord.x /= palette_4_bit ? 4u : 2u;
 
     // fixup coords
     uint2 vicoord = uint2(texpage.x + index_coord.x * RESOLUTION_SCALE, fixYCoord(texpage.y + index_coord.y * RESOLUTION_SCALE));
 
     // load colour/palette
-    float4 texel = SAMPLE_TEXTURE(samp0, float2(vicoord) * RCP_VRAM_SIZE);
+    float4 texel = SAMPLE_TEXTURE_LEVEL(samp0, float2(vicoord) * RCP_VRAM_SIZE, 0.0);
     uint vram_value = RGBA8ToRGBA5551(texel);
 
     // apply palette
-    #if PALETTE_4_BIT
+    uint palette_index;
+    if (palette_4_bit)
+    {
       uint subpixel = icoord.x & 3u;
-      uint palette_index = (vram_value >> (subpixel * 4u)) & 0x0Fu;
-    #elif PALETTE_8_BIT
+      palette_index = (vram_value >> (subpixel * 4u)) & 0x0Fu;
+    }
+    else
+    {
       uint subpixel = icoord.x & 1u;
-      uint palette_index = (vram_value >> (subpixel * 8u)) & 0xFFu;
-    #endif
+      palette_index = (vram_value >> (subpixel * 8u)) & 0xFFu;
+    }
 
     // sample palette
     uint2 palette_icoord = uint2(texpage.z + (palette_index * RESOLUTION_SCALE), fixYCoord(texpage.w));
-    return SAMPLE_TEXTURE(samp0, float2(palette_icoord) * RCP_VRAM_SIZE);
-  #else
+    return SAMPLE_TEXTURE_LEVEL(samp0, float2(palette_icoord) * RCP_VRAM_SIZE, 0.0);
+  }
+  else
+  {
     // Direct texturing. Render-to-texture effects. Use upscaled coordinates.
-    uint2 icoord = ApplyUpscaledTextureWindow(FloatToIntegerCoords(coords));    
+    uint2 icoord = ApplyUpscaledTextureWindow(FloatToIntegerCoords(coords));
     uint2 direct_icoord = uint2(texpage.x + icoord.x, fixYCoord(texpage.y + icoord.y));
-    return SAMPLE_TEXTURE(samp0, float2(direct_icoord) * RCP_VRAM_SIZE);
-  #endif
+    return SAMPLE_TEXTURE_LEVEL(samp0, float2(direct_icoord) * RCP_VRAM_SIZE, 0.0);
+  }
 }
 
 #endif
@@ -835,23 +872,25 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
       discard;
   #endif
 
-  #if TEXTURED
-
+#if TEXTURED
+  if (IS_TEXTURED(v_texpage))
+  {
     // We can't currently use upscaled coordinate for palettes because of how they're packed.
     // Not that it would be any benefit anyway, render-to-texture effects don't use palettes.
+    bool palette = IS_PALETTE(v_texpage);
     float2 coords = v_tex0;
-    #if PALETTE
+    if (palette)
       coords /= float2(RESOLUTION_SCALE, RESOLUTION_SCALE);
-    #endif
 
     #if UV_LIMITS
       float4 uv_limits = v_uv_limits;
-      #if !PALETTE
+      if (!palette)
+      {
         // Extend the UV range to all "upscaled" pixels. This means 1-pixel-high polygon-based 
         // framebuffer effects won't be downsampled. (e.g. Mega Man Legends 2 haze effect)
         uv_limits *= float(RESOLUTION_SCALE);
         uv_limits.zw += float(RESOLUTION_SCALE - 1u);
-      #endif
+      }
     #endif
 
     float4 texcol;
@@ -876,45 +915,51 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
     // If not using true color, truncate the framebuffer colors to 5-bit.
     #if !TRUE_COLOR
       icolor = uint3(texcol.rgb * float3(255.0, 255.0, 255.0)) >> 3;
-      #if !RAW_TEXTURE
+      if (!IS_RAW_TEXTURE(v_texpage))
+      {
         icolor = (icolor * vertcol) >> 4;
-        #if DITHERING
+        if (IS_DITHERING(v_texpage))
           icolor = ApplyDithering(uint2(v_pos.xy), icolor);
-        #else
+        else
           icolor = min(icolor >> 3, uint3(31u, 31u, 31u));
-        #endif
-      #endif
+      }
     #else
       icolor = uint3(texcol.rgb * float3(255.0, 255.0, 255.0));
-      #if !RAW_TEXTURE
+      if (!IS_RAW_TEXTURE(v_texpage))
+      {
         icolor = (icolor * vertcol) >> 7;
-        #if DITHERING
+        if (IS_DITHERING(v_texpage))
           icolor = ApplyDithering(uint2(v_pos.xy), icolor);
-        #else
+        else
           icolor = min(icolor, uint3(255u, 255u, 255u));
-        #endif
-      #endif
+      }
     #endif
 
     // Compute output alpha (mask bit)
     oalpha = float(u_set_mask_while_drawing ? 1 : int(semitransparent));
-  #else
+  }
+  else
+#endif
+  {
     // All pixels are semitransparent for untextured polygons.
     semitransparent = true;
     icolor = vertcol;
     ialpha = 1.0;
 
-    #if DITHERING
+    if (IS_DITHERING(v_texpage))
+    {
       icolor = ApplyDithering(uint2(v_pos.xy), icolor);
-    #else
+    }
+    else
+    {
       #if !TRUE_COLOR
         icolor >>= 3;
       #endif
-    #endif
+    }
 
     // However, the mask bit is cleared if set mask bit is false.
     oalpha = float(u_set_mask_while_drawing);
-  #endif
+  }
 
   // Premultiply alpha so we don't need to use a colour output for it.
   float premultiply_alpha = ialpha;
@@ -934,6 +979,8 @@ float4 SampleFromVRAM(uint4 texpage, float2 coords)
 
   #if TRANSPARENCY && TEXTURED
     // Apply semitransparency. If not a semitransparent texel, destination alpha is ignored.
+    // With the ubershader, untextured primitives take this path too, which is equivalent as they're always
+    // semitransparent, and are drawn by the transparent pass when the batch needs two passes.
     if (semitransparent)
     {
       #if USE_DUAL_SOURCE
@@ -1,6 +1,8 @@
 #include "gpu_hw_vulkan.h"
+#include "common/file_system.h"
 #include "common/log.h"
 #include "common/state_wrapper.h"
+#include "common/string_util.h"
 #include "common/timer.h"
 #include "common/vulkan/builders.h"
 #include "common/vulkan/context.h"
@@ -14,6 +16,8 @@
 #include "../libretro/libretro_host_interface.h"
 #include "system.h"
 #include "vulkan_loader.h"
+#include <algorithm>
+#include <cstring>
 Log_SetChannel(GPU_HW_Vulkan);
 
 class LibretroVulkanHostDisplayTexture : public HostDisplayTexture
@@ -813,6 +817,9 @@ void GPU_HW_Vulkan::RestoreGraphicsAPIState()
 
 void GPU_HW_Vulkan::UpdateSettings()
 {
+  // The compiler threads read the settings, so they can't be running while they change.
+  StopPipelineCompilerThreads();
+
   GPU_HW::UpdateSettings();
 
   bool framebuffer_changed, shaders_changed;
@@ -838,6 +845,10 @@ void GPU_HW_Vulkan::UpdateSettings()
     DestroyPipelines();
     CompilePipelines();
   }
+  else
+  {
+    StartPipelineCompilerThreads();
+  }
 
   // this has to be done here, because otherwise we're using destroyed pipelines in the same cmdbuffer
   if (framebuffer_changed)
@@ -850,7 +861,7 @@ void GPU_HW_Vulkan::UpdateSettings()
   }
 }
 
-void GPU_HW_Vulkan::MapBatchVertexPointer(u32 required_vertices)
+GPU_HW::BatchVertex* GPU_HW_Vulkan::MapBatchVertexPointer(u32 required_vertices)
 {
   const u32 required_space = required_vertices * sizeof(BatchVertex);
   if (!m_vertex_stream_buffer.ReserveMemory(required_space, sizeof(BatchVertex)))
@@ -859,20 +870,14 @@ void GPU_HW_Vulkan::MapBatchVertexPointer(u32 required_vertices)
     m_vertex_stream_buffer.ReserveMemory(required_space, sizeof(BatchVertex));
   }
 
-  m_batch_start_vertex_ptr = static_cast<BatchVertex*>(m_vertex_stream_buffer.GetCurrentHostPointer());
-  m_batch_current_vertex_ptr = m_batch_start_vertex_ptr;
-  m_batch_end_vertex_ptr = m_batch_start_vertex_ptr + (m_vertex_stream_buffer.GetCurrentSpace() / sizeof(BatchVertex));
   m_batch_base_vertex = m_vertex_stream_buffer.GetCurrentOffset() / sizeof(BatchVertex);
+  return static_cast<BatchVertex*>(m_vertex_stream_buffer.GetCurrentHostPointer());
 }
 
 void GPU_HW_Vulkan::UnmapBatchVertexPointer(u32 used_vertices)
 {
   if (used_vertices > 0)
     m_vertex_stream_buffer.CommitMemory(used_vertices * sizeof(BatchVertex));
-
-  m_batch_start_vertex_ptr = nullptr;
-  m_batch_end_vertex_ptr = nullptr;
-  m_batch_current_vertex_ptr = nullptr;
 }
 
 void GPU_HW_Vulkan::UploadUniformBuffer(const void* data, u32 data_size)
@@ -1149,7 +1154,9 @@ bool GPU_HW_Vulkan::CreateFramebuffer()
                                       VK_IMAGE_VIEW_TYPE_2D, VK_IMAGE_TILING_OPTIMAL,
                                       VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT) ||
       !m_vram_readback_staging_texture.Create(Vulkan::StagingBuffer::Type::Readback, texture_format, VRAM_WIDTH / 2,
-                                              VRAM_HEIGHT))
+                                              VRAM_HEIGHT) ||
+      !m_vram_async_readback_staging_texture.Create(Vulkan::StagingBuffer::Type::Readback, texture_format,
+                                                    VRAM_WIDTH / 2, VRAM_HEIGHT))
   {
     return false;
   }
@@ -1377,6 +1384,7 @@ void GPU_HW_Vulkan::DestroyFramebuffer()
   m_vram_readback_texture.Destroy(false);
   m_display_texture.Destroy(false);
   m_vram_readback_staging_texture.Destroy(false);
+  m_vram_async_readback_staging_texture.Destroy(false);
 }
 
 bool GPU_HW_Vulkan::CreateVertexBuffer()
@@ -1437,159 +1445,19 @@ bool GPU_HW_Vulkan::CompilePipelines()
 {
   VkDevice device = g_vulkan_context->GetDevice();
   VkPipelineCache pipeline_cache = g_vulkan_shader_cache->GetPipelineCache();
+  m_pipeline_cache = pipeline_cache;
 
-  GPU_HW_ShaderGen shadergen(m_host_display->GetRenderAPI(), m_resolution_scale, m_multisamples, m_per_sample_shading,
-                             m_true_color, m_scaled_dithering, m_texture_filtering, m_using_uv_limits,
-                             m_pgxp_depth_buffer, m_disable_color_perspective, m_supports_dual_source_blend);
-
-  ShaderCompileProgressTracker progress("Compiling Pipelines", 2 + (4 * 9 * 2 * 2) + (3 * 4 * 5 * 9 * 2 * 2) + 1 + 2 +
-                                                                 (2 * 2) + 2 + 1 + 1 + (2 * 3) + 1);
+  m_shadergen = std::make_unique<GPU_HW_ShaderGen>(
+    m_host_display->GetRenderAPI(), m_resolution_scale, m_multisamples, m_per_sample_shading, m_true_color,
+    m_scaled_dithering, m_texture_filtering, m_using_uv_limits, m_pgxp_depth_buffer, m_disable_color_perspective,
+    m_supports_dual_source_blend, m_using_ubershader);
+  GPU_HW_ShaderGen& shadergen = *m_shadergen;
 
-  // vertex shaders - [textured]
-  // fragment shaders - [render_mode][texture_mode][dithering][interlacing]
-  DimensionalArray<VkShaderModule, 2> batch_vertex_shaders{};
-  DimensionalArray<VkShaderModule, 2, 2, 9, 4> batch_fragment_shaders{};
-
-  for (u8 textured = 0; textured < 2; textured++)
-  {
-    const std::string vs = shadergen.GenerateBatchVertexShader(ConvertToBoolUnchecked(textured));
-    VkShaderModule shader = g_vulkan_shader_cache->GetVertexShader(vs);
-    if (shader == VK_NULL_HANDLE)
-    {
-      batch_vertex_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
-      batch_fragment_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
-      return false;
-    }
-
-    batch_vertex_shaders[textured] = shader;
-    progress.Increment();
-  }
-
-  for (u8 render_mode = 0; render_mode < 4; render_mode++)
-  {
-    for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
-    {
-      for (u8 dithering = 0; dithering < 2; dithering++)
-      {
-        for (u8 interlacing = 0; interlacing < 2; interlacing++)
-        {
-          const std::string fs = shadergen.GenerateBatchFragmentShader(
-            static_cast<BatchRenderMode>(render_mode), static_cast<GPUTextureMode>(texture_mode),
-            ConvertToBoolUnchecked(dithering), ConvertToBoolUnchecked(interlacing));
-
-          VkShaderModule shader = g_vulkan_shader_cache->GetFragmentShader(fs);
-          if (shader == VK_NULL_HANDLE)
-	  {
-            batch_vertex_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
-            batch_fragment_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
-            return false;
-	  }
-
-          batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing] = shader;
-          progress.Increment();
-        }
-      }
-    }
-  }
+  // Batch pipelines are compiled on demand, or in the background from the usage list, see GetBatchPipeline().
+  ShaderCompileProgressTracker progress("Compiling Pipelines", 1 + 2 + (2 * 2) + 2 + 1 + 1 + (2 * 3) + 1);
 
   Vulkan::GraphicsPipelineBuilder gpbuilder;
 
-  // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
-  for (u8 depth_test = 0; depth_test < 3; depth_test++)
-  {
-    for (u8 render_mode = 0; render_mode < 4; render_mode++)
-    {
-      for (u8 transparency_mode = 0; transparency_mode < 5; transparency_mode++)
-      {
-        for (u8 texture_mode = 0; texture_mode < 9; texture_mode++)
-        {
-          for (u8 dithering = 0; dithering < 2; dithering++)
-          {
-            for (u8 interlacing = 0; interlacing < 2; interlacing++)
-            {
-              static constexpr std::array<VkCompareOp, 3> depth_test_values = {
-                VK_COMPARE_OP_ALWAYS, VK_COMPARE_OP_GREATER_OR_EQUAL, VK_COMPARE_OP_LESS_OR_EQUAL};
-              const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
-
-              gpbuilder.SetPipelineLayout(m_batch_pipeline_layout);
-              gpbuilder.SetRenderPass(m_vram_render_pass, 0);
-
-              gpbuilder.AddVertexBuffer(0, sizeof(BatchVertex), VK_VERTEX_INPUT_RATE_VERTEX);
-              gpbuilder.AddVertexAttribute(0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(BatchVertex, x));
-              gpbuilder.AddVertexAttribute(1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, color));
-              if (textured)
-              {
-                gpbuilder.AddVertexAttribute(2, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, u));
-                gpbuilder.AddVertexAttribute(3, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, texpage));
-                if (m_using_uv_limits)
-                  gpbuilder.AddVertexAttribute(4, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, uv_limits));
-              }
-
-              gpbuilder.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
-              gpbuilder.SetVertexShader(batch_vertex_shaders[BoolToUInt8(textured)]);
-              gpbuilder.SetFragmentShader(batch_fragment_shaders[render_mode][texture_mode][dithering][interlacing]);
-
-              gpbuilder.SetRasterizationState(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
-              gpbuilder.SetDepthState(true, true, depth_test_values[depth_test]);
-              gpbuilder.SetNoBlendingState();
-              gpbuilder.SetMultisamples(m_multisamples, m_per_sample_shading);
-
-              if ((static_cast<GPUTransparencyMode>(transparency_mode) != GPUTransparencyMode::Disabled &&
-                   (static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                    static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque)) ||
-                  m_texture_filtering != GPUTextureFilter::Nearest)
-              {
-                if (m_supports_dual_source_blend)
-                {
-                  gpbuilder.SetBlendAttachment(
-                    0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_SRC1_ALPHA,
-                    (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                       GPUTransparencyMode::BackgroundMinusForeground &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
-                      VK_BLEND_OP_REVERSE_SUBTRACT :
-                      VK_BLEND_OP_ADD,
-                    VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
-                }
-                else
-                {
-                  const float factor = (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                                        GPUTransparencyMode::HalfBackgroundPlusHalfForeground) ?
-                                         0.5f :
-                                         1.0f;
-                  gpbuilder.SetBlendAttachment(
-                    0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_CONSTANT_ALPHA,
-                    (static_cast<GPUTransparencyMode>(transparency_mode) ==
-                       GPUTransparencyMode::BackgroundMinusForeground &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
-                     static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
-                      VK_BLEND_OP_REVERSE_SUBTRACT :
-                      VK_BLEND_OP_ADD,
-                    VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
-                  gpbuilder.SetBlendConstants(0.0f, 0.0f, 0.0f, factor);
-                }
-              }
-
-              gpbuilder.SetDynamicViewportAndScissorState();
-
-              VkPipeline pipeline = gpbuilder.Create(device, pipeline_cache);
-              if (pipeline == VK_NULL_HANDLE)
-	      {
-                batch_vertex_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
-                batch_fragment_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
-                return false;
-	      }
-
-              m_batch_pipelines[depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing] =
-                pipeline;
-              progress.Increment();
-            }
-          }
-        }
-      }
-    }
-  }
-
   VkShaderModule fullscreen_quad_vertex_shader =
     g_vulkan_shader_cache->GetVertexShader(shadergen.GenerateScreenQuadVertexShader());
   if (fullscreen_quad_vertex_shader == VK_NULL_HANDLE)
@@ -1931,12 +1799,32 @@ bool GPU_HW_Vulkan::CompilePipelines()
 
 #undef UPDATE_PROGRESS
 
+  UpdateBatchPipelineUsageCode();
+  QueueBatchPipelines(m_batch_pipeline_usage);
+  StartPipelineCompilerThreads();
   return true;
 }
 
 void GPU_HW_Vulkan::DestroyPipelines()
 {
-  m_batch_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
+  StopPipelineCompilerThreads();
+  SaveBatchPipelineUsage();
+
+  {
+    std::unique_lock<std::mutex> lock(m_pipeline_compiler_mutex);
+    m_pipeline_compiler_queue.clear();
+    m_queued_batch_pipelines.reset();
+    for (VkPipeline& p : m_compiled_batch_pipelines)
+      Vulkan::Util::SafeDestroyPipeline(p);
+  }
+
+  for (VkPipeline& p : m_batch_pipelines)
+    Vulkan::Util::SafeDestroyPipeline(p);
+
+  for (VkShaderModule& m : m_batch_vertex_shaders)
+    Vulkan::Util::SafeDestroyShaderModule(m);
+  m_batch_fragment_shaders.enumerate(Vulkan::Util::SafeDestroyShaderModule);
+  m_shadergen.reset();
 
   m_vram_fill_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
 
@@ -1957,17 +1845,341 @@ void GPU_HW_Vulkan::DestroyPipelines()
   m_display_pipelines.enumerate(Vulkan::Util::SafeDestroyPipeline);
 }
 
+VkPipeline GPU_HW_Vulkan::GetBatchPipeline(u32 index)
+{
+  VkPipeline pipeline = m_batch_pipelines[index];
+  if (pipeline != VK_NULL_HANDLE)
+    return pipeline;
+
+  if (!m_batch_pipeline_usage[index])
+  {
+    m_batch_pipeline_usage.set(index);
+    m_batch_pipeline_usage_dirty = true;
+  }
+
+  {
+    std::unique_lock<std::mutex> lock(m_pipeline_compiler_mutex);
+    if (m_queued_batch_pipelines[index])
+    {
+      // Not started yet, it's quicker to compile it here than to wait for the workers to get to it.
+      m_pipeline_compiler_queue.erase(
+        std::find(m_pipeline_compiler_queue.begin(), m_pipeline_compiler_queue.end(), index));
+      m_queued_batch_pipelines.reset(index);
+    }
+    else
+    {
+      m_pipeline_compiler_done_cv.wait(lock, [this, index]() { return !m_compiling_batch_pipelines[index]; });
+      pipeline = m_compiled_batch_pipelines[index];
+      m_compiled_batch_pipelines[index] = VK_NULL_HANDLE;
+    }
+  }
+
+  if (pipeline == VK_NULL_HANDLE)
+    pipeline = CreateBatchPipeline(index);
+
+  m_batch_pipelines[index] = pipeline;
+  return pipeline;
+}
+
+VkShaderModule GPU_HW_Vulkan::GetBatchVertexShader(bool textured)
+{
+  std::unique_lock<std::mutex> lock(m_batch_shader_mutex);
+  VkShaderModule& shader = m_batch_vertex_shaders[BoolToUInt8(textured)];
+  if (shader != VK_NULL_HANDLE)
+    return shader;
+
+  // Compile outside the lock, so the other threads can keep going.
+  lock.unlock();
+  VkShaderModule new_shader = g_vulkan_shader_cache->GetVertexShader(m_shadergen->GenerateBatchVertexShader(textured));
+  lock.lock();
+
+  if (shader != VK_NULL_HANDLE)
+    Vulkan::Util::SafeDestroyShaderModule(new_shader);
+  else
+    shader = new_shader;
+
+  return shader;
+}
+
+VkShaderModule GPU_HW_Vulkan::GetBatchFragmentShader(u8 render_mode, u8 texture_mode, bool dithering,
+                                                     bool interlacing)
+{
+  std::unique_lock<std::mutex> lock(m_batch_shader_mutex);
+  VkShaderModule& shader =
+    m_batch_fragment_shaders[render_mode][texture_mode][BoolToUInt8(dithering)][BoolToUInt8(interlacing)];
+  if (shader != VK_NULL_HANDLE)
+    return shader;
+
+  lock.unlock();
+  VkShaderModule new_shader = g_vulkan_shader_cache->GetFragmentShader(
+    m_shadergen->GenerateBatchFragmentShader(static_cast<BatchRenderMode>(render_mode),
+                                             static_cast<GPUTextureMode>(texture_mode), dithering, interlacing));
+  lock.lock();
+
+  if (shader != VK_NULL_HANDLE)
+    Vulkan::Util::SafeDestroyShaderModule(new_shader);
+  else
+    shader = new_shader;
+
+  return shader;
+}
+
+VkPipeline GPU_HW_Vulkan::CreateBatchPipeline(u32 index)
+{
+  // Called from both the main thread and the compiler threads.
+  const bool interlacing = ConvertToBoolUnchecked(index % 2);
+  index /= 2;
+  const bool dithering = ConvertToBoolUnchecked(index % 2);
+  index /= 2;
+  const u8 transparency_mode = static_cast<u8>(index % 5);
+  index /= 5;
+  const u8 texture_mode = static_cast<u8>(index % 9);
+  index /= 9;
+  const u8 render_mode = static_cast<u8>(index % 4);
+  const u8 depth_test = static_cast<u8>(index / 4);
+
+  static constexpr std::array<VkCompareOp, 3> depth_test_values = {
+    VK_COMPARE_OP_ALWAYS, VK_COMPARE_OP_GREATER_OR_EQUAL, VK_COMPARE_OP_LESS_OR_EQUAL};
+  const bool textured = (static_cast<GPUTextureMode>(texture_mode) != GPUTextureMode::Disabled);
+
+  VkShaderModule vs = GetBatchVertexShader(textured);
+  VkShaderModule fs = GetBatchFragmentShader(render_mode, texture_mode, dithering, interlacing);
+  if (vs == VK_NULL_HANDLE || fs == VK_NULL_HANDLE)
+    return VK_NULL_HANDLE;
+
+  Vulkan::GraphicsPipelineBuilder gpbuilder;
+  gpbuilder.SetPipelineLayout(m_batch_pipeline_layout);
+  gpbuilder.SetRenderPass(m_vram_render_pass, 0);
+
+  gpbuilder.AddVertexBuffer(0, sizeof(BatchVertex), VK_VERTEX_INPUT_RATE_VERTEX);
+  gpbuilder.AddVertexAttribute(0, 0, VK_FORMAT_R32G32B32A32_SFLOAT, offsetof(BatchVertex, x));
+  gpbuilder.AddVertexAttribute(1, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, color));
+  if (textured)
+  {
+    gpbuilder.AddVertexAttribute(2, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, u));
+    gpbuilder.AddVertexAttribute(3, 0, VK_FORMAT_R32_UINT, offsetof(BatchVertex, texpage));
+    if (m_using_uv_limits)
+      gpbuilder.AddVertexAttribute(4, 0, VK_FORMAT_R8G8B8A8_UNORM, offsetof(BatchVertex, uv_limits));
+  }
+
+  gpbuilder.SetPrimitiveTopology(VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST);
+  gpbuilder.SetVertexShader(vs);
+  gpbuilder.SetFragmentShader(fs);
+
+  gpbuilder.SetRasterizationState(VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_CLOCKWISE);
+  gpbuilder.SetDepthState(true, true, depth_test_values[depth_test]);
+  gpbuilder.SetNoBlendingState();
+  gpbuilder.SetMultisamples(m_multisamples, m_per_sample_shading);
+
+  if ((static_cast<GPUTransparencyMode>(transparency_mode) != GPUTransparencyMode::Disabled &&
+       (static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+        static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque)) ||
+      m_texture_filtering != GPUTextureFilter::Nearest)
+  {
+    if (m_supports_dual_source_blend)
+    {
+      gpbuilder.SetBlendAttachment(
+        0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_SRC1_ALPHA,
+        (static_cast<GPUTransparencyMode>(transparency_mode) == GPUTransparencyMode::BackgroundMinusForeground &&
+         static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+         static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
+          VK_BLEND_OP_REVERSE_SUBTRACT :
+          VK_BLEND_OP_ADD,
+        VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
+    }
+    else
+    {
+      const float factor =
+        (static_cast<GPUTransparencyMode>(transparency_mode) == GPUTransparencyMode::HalfBackgroundPlusHalfForeground) ?
+          0.5f :
+          1.0f;
+      gpbuilder.SetBlendAttachment(
+        0, true, VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_CONSTANT_ALPHA,
+        (static_cast<GPUTransparencyMode>(transparency_mode) == GPUTransparencyMode::BackgroundMinusForeground &&
+         static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::TransparencyDisabled &&
+         static_cast<BatchRenderMode>(render_mode) != BatchRenderMode::OnlyOpaque) ?
+          VK_BLEND_OP_REVERSE_SUBTRACT :
+          VK_BLEND_OP_ADD,
+        VK_BLEND_FACTOR_ONE, VK_BLEND_FACTOR_ZERO, VK_BLEND_OP_ADD);
+      gpbuilder.SetBlendConstants(0.0f, 0.0f, 0.0f, factor);
+    }
+  }
+
+  gpbuilder.SetDynamicViewportAndScissorState();
+
+  VkPipeline pipeline = gpbuilder.Create(g_vulkan_context->GetDevice(), m_pipeline_cache);
+  if (pipeline == VK_NULL_HANDLE)
+    Log_ErrorPrintf("Failed to create batch pipeline %u/%u/%u/%u/%u/%u", depth_test, render_mode, texture_mode,
+                    transparency_mode, BoolToUInt32(dithering), BoolToUInt32(interlacing));
+
+  return pipeline;
+}
+
+void GPU_HW_Vulkan::QueueBatchPipelines(const BatchPipelineMask& mask)
+{
+  std::unique_lock<std::mutex> lock(m_pipeline_compiler_mutex);
+  for (u32 index = 0; index < NUM_BATCH_PIPELINES; index++)
+  {
+    if (!mask[index] || m_batch_pipelines[index] != VK_NULL_HANDLE || m_queued_batch_pipelines[index] ||
+        m_compiling_batch_pipelines[index] || m_compiled_batch_pipelines[index] != VK_NULL_HANDLE)
+    {
+      continue;
+    }
+
+    m_pipeline_compiler_queue.push_back(index);
+    m_queued_batch_pipelines.set(index);
+  }
+
+  if (!m_pipeline_compiler_queue.empty())
+  {
+    Log_InfoPrintf("Compiling %zu batch pipelines in the background", m_pipeline_compiler_queue.size());
+    m_pipeline_compiler_work_cv.notify_all();
+  }
+}
+
+void GPU_HW_Vulkan::StartPipelineCompilerThreads()
+{
+  if (!m_pipeline_compiler_threads.empty())
+    return;
+
+  // Leave a core for the CPU thread.
+  const u32 num_threads =
+    std::clamp<u32>(std::thread::hardware_concurrency(), 2u, MAX_PIPELINE_COMPILER_THREADS + 1u) - 1u;
+
+  m_pipeline_compiler_shutdown = false;
+  for (u32 i = 0; i < num_threads; i++)
+    m_pipeline_compiler_threads.emplace_back(&GPU_HW_Vulkan::PipelineCompilerThreadEntryPoint, this);
+}
+
+void GPU_HW_Vulkan::StopPipelineCompilerThreads()
+{
+  if (m_pipeline_compiler_threads.empty())
+    return;
+
+  // Pipelines which haven't been started stay in the queue, for when the threads are restarted.
+  {
+    std::unique_lock<std::mutex> lock(m_pipeline_compiler_mutex);
+    m_pipeline_compiler_shutdown = true;
+    m_pipeline_compiler_work_cv.notify_all();
+  }
+
+  for (std::thread& thread : m_pipeline_compiler_threads)
+    thread.join();
+  m_pipeline_compiler_threads.clear();
+}
+
+void GPU_HW_Vulkan::PipelineCompilerThreadEntryPoint()
+{
+  std::unique_lock<std::mutex> lock(m_pipeline_compiler_mutex);
+  for (;;)
+  {
+    m_pipeline_compiler_work_cv.wait(
+      lock, [this]() { return m_pipeline_compiler_shutdown || !m_pipeline_compiler_queue.empty(); });
+    if (m_pipeline_compiler_shutdown)
+      break;
+
+    const u32 index = m_pipeline_compiler_queue.front();
+    m_pipeline_compiler_queue.pop_front();
+    m_queued_batch_pipelines.reset(index);
+    m_compiling_batch_pipelines.set(index);
+    lock.unlock();
+
+    VkPipeline pipeline = CreateBatchPipeline(index);
+
+    lock.lock();
+    m_compiled_batch_pipelines[index] = pipeline;
+    m_compiling_batch_pipelines.reset(index);
+    m_pipeline_compiler_done_cv.notify_all();
+  }
+}
+
+std::string GPU_HW_Vulkan::GetBatchPipelineUsagePath(const std::string& code) const
+{
+  return StringUtil::StdStringFromFormat("%svulkan_pipeline_usage_%s.bin",
+                                         g_host_interface->GetShaderCacheBasePath().c_str(), code.c_str());
+}
+
+void GPU_HW_Vulkan::UpdateBatchPipelineUsageCode()
+{
+  const std::string& code = System::GetRunningCode();
+  if (code == m_batch_pipeline_usage_code)
+    return;
+
+  SaveBatchPipelineUsage();
+
+  // Anything drawn before the game was identified (i.e. the BIOS) is attributed to the game.
+  BatchPipelineMask mask;
+  if (!code.empty() && LoadBatchPipelineUsage(code, &mask))
+    QueueBatchPipelines(mask);
+
+  const BatchPipelineMask new_usage = m_batch_pipeline_usage_code.empty() ? (m_batch_pipeline_usage | mask) : mask;
+  m_batch_pipeline_usage_dirty = (new_usage != mask);
+  m_batch_pipeline_usage = new_usage;
+  m_batch_pipeline_usage_code = code;
+}
+
+bool GPU_HW_Vulkan::LoadBatchPipelineUsage(const std::string& code, BatchPipelineMask* mask)
+{
+  const std::string path = GetBatchPipelineUsagePath(code);
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(path.c_str());
+  if (!data.has_value())
+    return false;
+
+  u32 header[2];
+  if (data->size() != (sizeof(header) + (NUM_BATCH_PIPELINES + 7) / 8))
+  {
+    Log_WarningPrintf("Pipeline usage list '%s' is corrupted", path.c_str());
+    return false;
+  }
+
+  std::memcpy(header, data->data(), sizeof(header));
+  if (header[0] != BATCH_PIPELINE_USAGE_FILE_VERSION || header[1] != NUM_BATCH_PIPELINES)
+    return false;
+
+  const u8* bits = data->data() + sizeof(header);
+  for (u32 index = 0; index < NUM_BATCH_PIPELINES; index++)
+    mask->set(index, (bits[index / 8] & (1u << (index % 8))) != 0);
+
+  Log_InfoPrintf("Loaded %zu pipelines from usage list '%s'", mask->count(), path.c_str());
+  return true;
+}
+
+void GPU_HW_Vulkan::SaveBatchPipelineUsage()
+{
+  if (!m_batch_pipeline_usage_dirty || m_batch_pipeline_usage_code.empty())
+    return;
+
+  const u32 header[2] = {BATCH_PIPELINE_USAGE_FILE_VERSION, NUM_BATCH_PIPELINES};
+  std::vector<u8> data(sizeof(header) + (NUM_BATCH_PIPELINES + 7) / 8);
+  std::memcpy(data.data(), header, sizeof(header));
+  for (u32 index = 0; index < NUM_BATCH_PIPELINES; index++)
+  {
+    if (m_batch_pipeline_usage[index])
+      data[sizeof(header) + index / 8] |= static_cast<u8>(1u << (index % 8));
+  }
+
+  const std::string path = GetBatchPipelineUsagePath(m_batch_pipeline_usage_code);
+  if (!FileSystem::WriteBinaryFile(path.c_str(), data.data(), data.size()))
+  {
+    Log_WarningPrintf("Failed to write pipeline usage list '%s'", path.c_str());
+    return;
+  }
+
+  m_batch_pipeline_usage_dirty = false;
+}
+
 void GPU_HW_Vulkan::DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices)
 {
   BeginVRAMRenderPass();
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
 
-  // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
   const u8 depth_test = m_batch.use_depth_buffer ? static_cast<u8>(2) : BoolToUInt8(m_batch.check_mask_before_draw);
-  VkPipeline pipeline =
-    m_batch_pipelines[depth_test][static_cast<u8>(render_mode)][static_cast<u8>(m_batch.texture_mode)][static_cast<u8>(
-      m_batch.transparency_mode)][BoolToUInt8(m_batch.dithering)][BoolToUInt8(m_batch.interlacing)];
+  VkPipeline pipeline = GetBatchPipeline(GetBatchPipelineIndex(
+    depth_test, static_cast<u8>(render_mode), static_cast<u8>(GetBatchShaderTextureMode()),
+    static_cast<u8>(m_batch.transparency_mode), GetBatchShaderDithering(), GetBatchShaderInterlacing()));
+  if (pipeline == VK_NULL_HANDLE)
+    return;
 
   vkCmdBindPipeline(cmdbuf, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
   vkCmdDraw(cmdbuf, num_vertices, 1, base_vertex, 0);
@@ -1999,6 +2211,7 @@ void GPU_HW_Vulkan::UpdateDisplay()
 {
   GPU_HW::UpdateDisplay();
   EndRenderPass();
+  UpdateBatchPipelineUsageCode();
 
   VkCommandBuffer cmdbuf = g_vulkan_context->GetCurrentCommandBuffer();
 
@@ -2096,7 +2309,49 @@ void GPU_HW_Vulkan::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
   }
 
   // Get bounds with wrap-around handled.
-  const Common::Rectangle<u32> copy_rect = GetVRAMTransferBounds(x, y, width, height);
+  const Common::Rectangle<u32> copy_rect = GetVRAMReadbackBounds(x, y, width, height);
+  if (!copy_rect.Valid())
+    return;
+
+  const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
+  const u32 encoded_height = copy_rect.GetHeight();
+  EncodeVRAMForReadback(copy_rect);
+
+  // Stage the readback.
+  m_vram_readback_staging_texture.CopyFromTexture(m_vram_readback_texture, 0, 0, 0, 0, 0, 0, encoded_width,
+                                                  encoded_height);
+
+  // And copy it into our shadow buffer (will execute command buffer and stall).
+  ExecuteCommandBuffer(true, true);
+  m_vram_readback_staging_texture.ReadTexels(0, 0, encoded_width, encoded_height,
+                                             &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left],
+                                             VRAM_WIDTH * sizeof(u16));
+}
+
+bool GPU_HW_Vulkan::QueueAsyncVRAMReadback(const Common::Rectangle<u32>& rect)
+{
+  EncodeVRAMForReadback(rect);
+  m_vram_async_readback_staging_texture.CopyFromTexture(m_vram_readback_texture, 0, 0, 0, 0, 0, 0,
+                                                        rect.GetWidth() / 2, rect.GetHeight());
+  m_vram_async_readback_fence_counter = g_vulkan_context->GetCurrentFenceCounter();
+  RestoreGraphicsAPIState();
+  return true;
+}
+
+void GPU_HW_Vulkan::FinishAsyncVRAMReadback(const Common::Rectangle<u32>& rect)
+{
+  // The staging texture would submit the command buffer itself if the copy is still in it, but without restoring our
+  // state afterwards. Usually it was submitted at the end of the frame, and this only waits if it hasn't completed.
+  if (g_vulkan_context->GetCurrentFenceCounter() == m_vram_async_readback_fence_counter)
+    ExecuteCommandBuffer(false, true);
+
+  m_vram_async_readback_staging_texture.ReadTexels(0, 0, rect.GetWidth() / 2, rect.GetHeight(),
+                                                   &m_vram_shadow[rect.top * VRAM_WIDTH + rect.left],
+                                                   VRAM_WIDTH * sizeof(u16));
+}
+
+void GPU_HW_Vulkan::EncodeVRAMForReadback(const Common::Rectangle<u32>& copy_rect)
+{
   const u32 encoded_width = (copy_rect.GetWidth() + 1) / 2;
   const u32 encoded_height = copy_rect.GetHeight();
 
@@ -2126,16 +2381,6 @@ void GPU_HW_Vulkan::ReadVRAM(u32 x, u32 y, u32 width, u32 height)
 
   m_vram_readback_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL);
   m_vram_texture.TransitionToLayout(cmdbuf, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL);
-
-  // Stage the readback.
-  m_vram_readback_staging_texture.CopyFromTexture(m_vram_readback_texture, 0, 0, 0, 0, 0, 0, encoded_width,
-                                                  encoded_height);
-
-  // And copy it into our shadow buffer (will execute command buffer and stall).
-  ExecuteCommandBuffer(true, true);
-  m_vram_readback_staging_texture.ReadTexels(0, 0, encoded_width, encoded_height,
-                                             &m_vram_shadow[copy_rect.top * VRAM_WIDTH + copy_rect.left],
-                                             VRAM_WIDTH * sizeof(u16));
 }
 
 void GPU_HW_Vulkan::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color)
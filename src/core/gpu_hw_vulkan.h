@@ -7,8 +7,15 @@
 #include "gpu_hw.h"
 #include "texture_replacements.h"
 #include <array>
+#include <bitset>
+#include <condition_variable>
+#include <deque>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
 #include <tuple>
+#include <vector>
 #include <libretro.h>
 
 #define HAVE_VULKAN
@@ -88,6 +95,8 @@ private:
   VkRenderPass m_frame_render_pass = VK_NULL_HANDLE;
 };
 
+class GPU_HW_ShaderGen;
+
 class GPU_HW_Vulkan : public GPU_HW
 {
 public:
@@ -115,13 +124,29 @@ protected:
   void UpdateDepthBufferFromMaskBit() override;
   void ClearDepthBuffer() override;
   void SetScissorFromDrawingArea() override;
-  void MapBatchVertexPointer(u32 required_vertices) override;
+  BatchVertex* MapBatchVertexPointer(u32 required_vertices) override;
   void UnmapBatchVertexPointer(u32 used_vertices) override;
   void UploadUniformBuffer(const void* data, u32 data_size) override;
   void DrawBatchVertices(BatchRenderMode render_mode, u32 base_vertex, u32 num_vertices) override;
+  bool QueueAsyncVRAMReadback(const Common::Rectangle<u32>& rect) override;
+  void FinishAsyncVRAMReadback(const Common::Rectangle<u32>& rect) override;
 
 private:
   static constexpr u32 MAX_PUSH_CONSTANTS_SIZE = 64, TEXTURE_REPLACEMENT_BUFFER_SIZE = 64 * 1024 * 1024;
+
+  // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
+  static constexpr u32 NUM_BATCH_PIPELINES = 3 * 4 * 9 * 5 * 2 * 2;
+  static constexpr u32 MAX_PIPELINE_COMPILER_THREADS = 4;
+  static constexpr u32 BATCH_PIPELINE_USAGE_FILE_VERSION = 1;
+  using BatchPipelineMask = std::bitset<NUM_BATCH_PIPELINES>;
+
+  static constexpr u32 GetBatchPipelineIndex(u8 depth_test, u8 render_mode, u8 texture_mode, u8 transparency_mode,
+                                             bool dithering, bool interlacing)
+  {
+    const u32 index = ((depth_test * 4u + render_mode) * 9u + texture_mode) * 5u + transparency_mode;
+    return (index * 2u + static_cast<u32>(dithering)) * 2u + static_cast<u32>(interlacing);
+  }
+
   void SetCapabilities();
   void DestroyResources();
 
@@ -132,6 +157,9 @@ private:
   void EndRenderPass();
   void ExecuteCommandBuffer(bool wait_for_completion, bool restore_state);
 
+  /// Encodes the area of VRAM to 16-bit in the readback texture, ready to be copied to a staging texture.
+  void EncodeVRAMForReadback(const Common::Rectangle<u32>& copy_rect);
+
   bool CreatePipelineLayouts();
   bool CreateSamplers();
 
@@ -146,6 +174,22 @@ private:
   bool CompilePipelines();
   void DestroyPipelines();
 
+  /// Batch pipelines are created on first use. Combinations used by the running game in previous sessions are
+  /// compiled ahead of time on worker threads, so that they're usually ready by the time they're needed.
+  VkPipeline GetBatchPipeline(u32 index);
+  VkPipeline CreateBatchPipeline(u32 index);
+  VkShaderModule GetBatchVertexShader(bool textured);
+  VkShaderModule GetBatchFragmentShader(u8 render_mode, u8 texture_mode, bool dithering, bool interlacing);
+  void QueueBatchPipelines(const BatchPipelineMask& mask);
+  void StartPipelineCompilerThreads();
+  void StopPipelineCompilerThreads();
+  void PipelineCompilerThreadEntryPoint();
+
+  std::string GetBatchPipelineUsagePath(const std::string& code) const;
+  void UpdateBatchPipelineUsageCode();
+  bool LoadBatchPipelineUsage(const std::string& code, BatchPipelineMask* mask);
+  void SaveBatchPipelineUsage();
+
   bool CreateTextureReplacementStreamBuffer();
 
   bool BlitVRAMReplacementTexture(const TextureReplacementTexture* tex, u32 dst_x, u32 dst_y, u32 width, u32 height);
@@ -176,6 +220,8 @@ private:
   Vulkan::Texture m_vram_read_texture;
   Vulkan::Texture m_vram_readback_texture;
   Vulkan::StagingTexture m_vram_readback_staging_texture;
+  Vulkan::StagingTexture m_vram_async_readback_staging_texture;
+  u64 m_vram_async_readback_fence_counter = 0;
   Vulkan::Texture m_display_texture;
   bool m_use_ssbos_for_vram_writes = false;
 
@@ -201,8 +247,33 @@ private:
   u32 m_current_uniform_buffer_offset = 0;
   VkBufferView m_texture_stream_buffer_view = VK_NULL_HANDLE;
 
-  // [depth_test][render_mode][texture_mode][transparency_mode][dithering][interlacing]
-  DimensionalArray<VkPipeline, 2, 2, 5, 9, 4, 3> m_batch_pipelines{};
+  std::unique_ptr<GPU_HW_ShaderGen> m_shadergen;
+  VkPipelineCache m_pipeline_cache = VK_NULL_HANDLE;
+
+  // Only accessed by the main thread, see GetBatchPipelineIndex() for the layout.
+  std::array<VkPipeline, NUM_BATCH_PIPELINES> m_batch_pipelines{};
+
+  // vertex shaders - [textured]
+  // fragment shaders - [render_mode][texture_mode][dithering][interlacing]
+  std::mutex m_batch_shader_mutex;
+  std::array<VkShaderModule, 2> m_batch_vertex_shaders{};
+  DimensionalArray<VkShaderModule, 2, 2, 9, 4> m_batch_fragment_shaders{};
+
+  // Background pipeline compilation. Pipelines finished by the workers are picked up by GetBatchPipeline().
+  std::mutex m_pipeline_compiler_mutex;
+  std::condition_variable m_pipeline_compiler_work_cv;
+  std::condition_variable m_pipeline_compiler_done_cv;
+  std::deque<u32> m_pipeline_compiler_queue;
+  std::array<VkPipeline, NUM_BATCH_PIPELINES> m_compiled_batch_pipelines{};
+  BatchPipelineMask m_queued_batch_pipelines;
+  BatchPipelineMask m_compiling_batch_pipelines;
+  std::vector<std::thread> m_pipeline_compiler_threads;
+  bool m_pipeline_compiler_shutdown = false;
+
+  // Batch pipelines used by the running game, persisted between sessions.
+  BatchPipelineMask m_batch_pipeline_usage;
+  std::string m_batch_pipeline_usage_code;
+  bool m_batch_pipeline_usage_dirty = false;
 
   // [wrapped][interlaced]
   DimensionalArray<VkPipeline, 2, 2> m_vram_fill_pipelines{};
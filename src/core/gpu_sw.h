@@ -1,5 +1,4 @@
 #pragma once
-#include "common/heap_array.h"
 #include "gpu.h"
 #include "gpu_sw_backend.h"
 #include "host_display.h"
@@ -21,6 +20,7 @@ public:
   bool DoState(StateWrapper& sw, HostDisplayTexture** host_texture, bool update_display) override;
   void Reset(bool clear_vram) override;
   void UpdateSettings() override;
+  void ResetStats() override;
 
 protected:
   void ReadVRAM(u32 x, u32 y, u32 width, u32 height) override;
@@ -28,17 +28,6 @@ protected:
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, bool set_mask, bool check_mask) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height) override;
 
-  template<HostDisplayPixelFormat display_format>
-  void CopyOut15Bit(u32 src_x, u32 src_y, u32 width, u32 height, u32 field, bool interlaced, bool interleaved);
-  void CopyOut15Bit(HostDisplayPixelFormat display_format, u32 src_x, u32 src_y, u32 width, u32 height, u32 field,
-                    bool interlaced, bool interleaved);
-
-  template<HostDisplayPixelFormat display_format>
-  void CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 field, bool interlaced,
-                    bool interleaved);
-  void CopyOut24Bit(HostDisplayPixelFormat display_format, u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height,
-                    u32 field, bool interlaced, bool interleaved);
-
   void ClearDisplay() override;
   void UpdateDisplay() override;
 
@@ -47,9 +36,9 @@ protected:
   void FillBackendCommandParameters(GPUBackendCommand* cmd) const;
   void FillDrawCommand(GPUBackendDrawCommand* cmd, GPURenderCommand rc) const;
 
-  HeapArray<u8, GPU_MAX_DISPLAY_WIDTH * GPU_MAX_DISPLAY_HEIGHT * sizeof(u32)> m_display_texture_buffer;
   HostDisplayPixelFormat m_16bit_display_format = HostDisplayPixelFormat::RGB565;
   HostDisplayPixelFormat m_24bit_display_format = HostDisplayPixelFormat::RGBA8;
+  bool m_clear_interlaced_display = false;
 
   GPU_SW_Backend m_backend;
 };
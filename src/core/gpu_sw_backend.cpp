@@ -1,8 +1,25 @@
 #include "gpu_sw_backend.h"
-#include "gpu_sw_backend.h"
+#include "common/align.h"
+#include "common/cpu_features.h"
+#include "common/log.h"
+#include "common/platform.h"
 #include "host_display.h"
+#include "settings.h"
 #include "system.h"
 #include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(CPU_X64)
+#include <immintrin.h>
+#elif defined(CPU_AARCH64)
+#ifdef _MSC_VER
+#include <arm64_neon.h>
+#else
+#include <arm_neon.h>
+#endif
+#endif
+Log_SetChannel(GPU_SW_Backend);
 
 GPU_SW_Backend::GPU_SW_Backend() : GPUBackend()
 {
@@ -10,11 +27,48 @@ GPU_SW_Backend::GPU_SW_Backend() : GPUBackend()
   m_vram_ptr = m_vram.data();
 }
 
-GPU_SW_Backend::~GPU_SW_Backend() = default;
+GPU_SW_Backend::~GPU_SW_Backend()
+{
+  StopRenderThreads();
+
+  // Commands which were never rendered still hold their chunks.
+  for (CommandChunk* chunk : m_batch_chunks)
+    ReleaseCommandChunk(chunk);
+}
 
 bool GPU_SW_Backend::Initialize(bool force_thread)
 {
-  return GPUBackend::Initialize(force_thread);
+  if (!GPUBackend::Initialize(force_thread))
+    return false;
+
+  m_shade_span_functions = GPU_SW_SIMD::GetShadeSpanFunctionTable();
+  m_display_filter_functions = GPU_SW_SIMD::GetDisplayFilterFunctionTable();
+  m_display_downsample_mode = g_settings.gpu_downsample_mode;
+  m_display_scale_filter = g_settings.gpu_sw_display_scale_filter;
+  m_display_scale = std::clamp<u32>(g_settings.gpu_sw_display_scale, 1u, MAX_DISPLAY_SCALE);
+  m_display_chroma_smoothing = g_settings.gpu_24bit_chroma_smoothing;
+  m_scaled_dithering = g_settings.gpu_scaled_dithering;
+
+  StartRenderThreads(g_settings.gpu_sw_render_threads);
+  return true;
+}
+
+void GPU_SW_Backend::UpdateSettings()
+{
+  GPUBackend::UpdateSettings();
+
+  m_display_downsample_mode = g_settings.gpu_downsample_mode;
+  m_display_scale_filter = g_settings.gpu_sw_display_scale_filter;
+  m_display_scale = std::clamp<u32>(g_settings.gpu_sw_display_scale, 1u, MAX_DISPLAY_SCALE);
+  m_display_chroma_smoothing = g_settings.gpu_24bit_chroma_smoothing;
+  m_scaled_dithering = g_settings.gpu_scaled_dithering;
+
+  const u32 thread_count = std::max<u32>(g_settings.gpu_sw_render_threads, 1u);
+  if (thread_count != (static_cast<u32>(m_render_threads.size()) + 1u))
+  {
+    StopRenderThreads();
+    StartRenderThreads(thread_count);
+  }
 }
 
 void GPU_SW_Backend::Reset(bool clear_vram)
@@ -22,39 +76,155 @@ void GPU_SW_Backend::Reset(bool clear_vram)
   GPUBackend::Reset(clear_vram);
 
   if (clear_vram)
+  {
     m_vram.fill(0);
+    if (m_scaled_vram)
+      std::fill_n(m_scaled_vram.get(), m_scaled_vram_width * VRAM_HEIGHT * m_resolution_scale, u16(0));
+    ClearTextureCache();
+    for (DisplayBufferSource& source : m_display_buffer_sources)
+      source.valid = false;
+  }
+}
+
+void GPU_SW_Backend::Shutdown()
+{
+  GPUBackend::Shutdown();
+  StopRenderThreads();
+}
+
+void GPU_SW_Backend::SetResolutionScale(u32 scale)
+{
+  scale = std::clamp<u32>(scale, 1u, MAX_RESOLUTION_SCALE);
+  if (scale == m_resolution_scale)
+    return;
+
+  Sync(true);
+
+  m_resolution_scale = scale;
+  m_scaled_vram_width = VRAM_WIDTH * scale;
+  if (scale > 1)
+  {
+    // Start from what's in VRAM now, so changing the scale doesn't lose the current frame.
+    m_scaled_vram = std::make_unique<u16[]>(m_scaled_vram_width * VRAM_HEIGHT * scale);
+    UpscaleVRAM(0, 0, VRAM_WIDTH, VRAM_HEIGHT, GetFullBand());
+    Log_InfoPrintf("Software rendering at %ux resolution scale", scale);
+  }
+  else
+  {
+    m_scaled_vram.reset();
+  }
+
+  // The display buffers are sized for the scale, so they're allocated again by the next scan-out.
+  for (DisplayBuffer& buffer : m_display_buffers)
+  {
+    buffer.pixels.reset();
+    buffer.filtered_pixels = {};
+  }
+  for (DisplayBufferSource& source : m_display_buffer_sources)
+    source.valid = false;
+  m_display_interlaced_buffer.reset();
 }
 
 void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd)
+{
+  DrawPolygon(cmd, m_drawing_area, nullptr);
+}
+
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+{
+  DrawRectangle(cmd, m_drawing_area, nullptr);
+}
+
+void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd)
+{
+  DrawLine(cmd, m_drawing_area);
+}
+
+void GPU_SW_Backend::DrawPolygon(const GPUBackendDrawPolygonCommand* cmd, const Common::Rectangle<u32>& drawing_area,
+                                 const TextureCacheEntry* texture)
 {
   const GPURenderCommand rc{cmd->rc.bits};
   const bool dithering_enable = rc.IsDitheringEnabled() && cmd->draw_mode.dither_enable;
 
-  const DrawTriangleFunction DrawFunction = GetDrawTriangleFunction(
+  // Scaled draws go first, since they texture from native VRAM, which the native draw can overwrite.
+  if (m_resolution_scale > 1)
+  {
+    // The same triangles with the positions scaled up. Colours and texture coordinates are interpolated per scaled
+    // pixel, so edges and gradients get the extra resolution, but texels still come from native VRAM.
+    const DrawTriangleFunction DrawScaledFunction = GetDrawTriangleFunction<true>(
+      rc.shading_enable, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable, dithering_enable);
+    const Common::Rectangle<u32> scaled_drawing_area = GetScaledDrawingArea(drawing_area);
+    const s32 scale = static_cast<s32>(m_resolution_scale);
+
+    std::array<GPUBackendDrawPolygonCommand::Vertex, 4> vertices;
+    const u32 num_vertices = rc.quad_polygon ? 4 : 3;
+    for (u32 i = 0; i < num_vertices; i++)
+    {
+      vertices[i] = cmd->vertices[i];
+      vertices[i].x *= scale;
+      vertices[i].y *= scale;
+    }
+
+    (this->*DrawScaledFunction)(cmd, scaled_drawing_area, texture, &vertices[0], &vertices[1], &vertices[2]);
+    if (rc.quad_polygon)
+      (this->*DrawScaledFunction)(cmd, scaled_drawing_area, texture, &vertices[2], &vertices[1], &vertices[3]);
+  }
+
+  const DrawTriangleFunction DrawFunction = GetDrawTriangleFunction<false>(
     rc.shading_enable, rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable, dithering_enable);
 
-  (this->*DrawFunction)(cmd, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
+  (this->*DrawFunction)(cmd, drawing_area, texture, &cmd->vertices[0], &cmd->vertices[1], &cmd->vertices[2]);
   if (rc.quad_polygon)
-    (this->*DrawFunction)(cmd, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
+    (this->*DrawFunction)(cmd, drawing_area, texture, &cmd->vertices[2], &cmd->vertices[1], &cmd->vertices[3]);
 }
 
-void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd,
+                                   const Common::Rectangle<u32>& drawing_area, const TextureCacheEntry* texture)
 {
   const GPURenderCommand rc{cmd->rc.bits};
 
+  // See DrawPolygon() for why the scaled draw goes first.
+  if (m_resolution_scale > 1)
+  {
+    const DrawRectangleFunction DrawScaledFunction =
+      GetDrawRectangleFunction<true>(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
+    (this->*DrawScaledFunction)(cmd, GetScaledDrawingArea(drawing_area), texture);
+  }
+
   const DrawRectangleFunction DrawFunction =
-    GetDrawRectangleFunction(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
+    GetDrawRectangleFunction<false>(rc.texture_enable, rc.raw_texture_enable, rc.transparency_enable);
 
-  (this->*DrawFunction)(cmd);
+  (this->*DrawFunction)(cmd, drawing_area, texture);
 }
 
-void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd)
+void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const Common::Rectangle<u32>& drawing_area)
 {
   const DrawLineFunction DrawFunction =
-    GetDrawLineFunction(cmd->rc.shading_enable, cmd->rc.transparency_enable, cmd->IsDitheringEnabled());
+    GetDrawLineFunction<false>(cmd->rc.shading_enable, cmd->rc.transparency_enable, cmd->IsDitheringEnabled());
 
   for (u16 i = 1; i < cmd->num_vertices; i++)
-    (this->*DrawFunction)(cmd, &cmd->vertices[i - 1], &cmd->vertices[i]);
+    (this->*DrawFunction)(cmd, drawing_area, &cmd->vertices[i - 1], &cmd->vertices[i]);
+
+  if (m_resolution_scale == 1)
+    return;
+
+  // Lines are stepped at native resolution, and clipped to the native drawing area.
+  const DrawLineFunction DrawScaledFunction =
+    GetDrawLineFunction<true>(cmd->rc.shading_enable, cmd->rc.transparency_enable, cmd->IsDitheringEnabled());
+
+  for (u16 i = 1; i < cmd->num_vertices; i++)
+    (this->*DrawScaledFunction)(cmd, drawing_area, &cmd->vertices[i - 1], &cmd->vertices[i]);
+}
+
+Common::Rectangle<u32> GPU_SW_Backend::GetScaledDrawingArea(const Common::Rectangle<u32>& drawing_area) const
+{
+  // Empty areas stay empty, bands outside the drawing area have the top below the bottom.
+  if (!drawing_area.Valid())
+    return drawing_area;
+
+  const u32 scale = m_resolution_scale;
+  return Common::Rectangle<u32>(drawing_area.left * scale, drawing_area.top * scale,
+                                ((drawing_area.right + 1) * scale) - 1, ((drawing_area.bottom + 1) * scale) - 1);
 }
 
 constexpr GPU_SW_Backend::DitherLUT GPU_SW_Backend::ComputeDitherLUT()
@@ -76,51 +246,74 @@ constexpr GPU_SW_Backend::DitherLUT GPU_SW_Backend::ComputeDitherLUT()
 
 static constexpr GPU_SW_Backend::DitherLUT s_dither_lut = GPU_SW_Backend::ComputeDitherLUT();
 
-template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
-void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r,
-                                                      u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y)
+ALWAYS_INLINE_RELEASE u16 GPU_SW_Backend::FetchTexel(const GPUBackendDrawCommand* cmd,
+                                                     const TextureCacheEntry* texture, u8 texcoord_x,
+                                                     u8 texcoord_y) const
 {
-  VRAMPixel color;
-  if constexpr (texture_enable)
-  {
-    // Apply texture window
-    texcoord_x = (texcoord_x & cmd->window.and_x) | cmd->window.or_x;
-    texcoord_y = (texcoord_y & cmd->window.and_y) | cmd->window.or_y;
+  // Apply texture window
+  texcoord_x = (texcoord_x & cmd->window.and_x) | cmd->window.or_x;
+  texcoord_y = (texcoord_y & cmd->window.and_y) | cmd->window.or_y;
 
-    VRAMPixel texture_color;
-    switch (cmd->draw_mode.texture_mode)
+  if (texture && texture->decoded_rows[texcoord_y])
+    return texture->texels[ZeroExtend32(texcoord_y) * TEXTURE_PAGE_WIDTH + ZeroExtend32(texcoord_x)];
+
+  switch (cmd->draw_mode.texture_mode)
+  {
+    case GPUTextureMode::Palette4Bit:
     {
-      case GPUTextureMode::Palette4Bit:
-      {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
+      const u16 palette_value =
+        GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 4)) % VRAM_WIDTH,
+                 (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+      const u16 palette_index = (palette_value >> ((texcoord_x % 4) * 4)) & 0x0Fu;
 
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
+      return GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
+    }
 
-      case GPUTextureMode::Palette8Bit:
-      {
-        const u16 palette_value =
-          GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
-                   (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-        const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
-        texture_color.bits =
-          GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
-      }
-      break;
+    case GPUTextureMode::Palette8Bit:
+    {
+      const u16 palette_value =
+        GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x / 2)) % VRAM_WIDTH,
+                 (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
+      const u16 palette_index = (palette_value >> ((texcoord_x % 2) * 8)) & 0xFFu;
+      return GetPixel((cmd->palette.GetXBase() + ZeroExtend32(palette_index)) % VRAM_WIDTH, cmd->palette.GetYBase());
+    }
 
-      default:
-      {
-        texture_color.bits = GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
-                                      (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
-      }
-      break;
+    default:
+    {
+      return GetPixel((cmd->draw_mode.GetTexturePageBaseX() + ZeroExtend32(texcoord_x)) % VRAM_WIDTH,
+                      (cmd->draw_mode.GetTexturePageBaseY() + ZeroExtend32(texcoord_y)) % VRAM_HEIGHT);
     }
+  }
+}
 
+void GPU_SW_Backend::InitSpanInput(const GPUBackendDrawCommand* cmd, GPU_SW_SIMD::SpanInput* span,
+                                   bool dithering_enable, u32 x, u32 y, u32 dither_scale /* = 1 */) const
+{
+  // Spans are shaded in blocks of SpanInput::SIZE pixels, which is a multiple of the dither matrix width, so the
+  // offsets are the same for every block in the row. That doesn't hold for a dither scale of 3, callers have to set
+  // the offsets for each block then.
+  const u32 dither_y = (y / dither_scale) & 3u;
+  for (u32 i = 0; i < GPU_SW_SIMD::SpanInput::SIZE; i++)
+  {
+    span->dither[i] = static_cast<s16>(dithering_enable ? DITHER_MATRIX[dither_y][((x + i) / dither_scale) & 3u] :
+                                                          DITHER_MATRIX[2][3]);
+  }
+
+  span->mask_and = cmd->params.GetMaskAND();
+  span->mask_or = cmd->params.GetMaskOR();
+  span->transparency_mode = cmd->draw_mode.transparency_mode;
+}
+
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable, bool scaled>
+void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawCommand* cmd,
+                                                      const TextureCacheEntry* texture, u32 x, u32 y, u8 color_r,
+                                                      u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y)
+{
+  VRAMPixel color;
+  if constexpr (texture_enable)
+  {
+    VRAMPixel texture_color;
+    texture_color.bits = FetchTexel(cmd, texture, texcoord_x, texcoord_y);
     if (texture_color.bits == 0)
       return;
 
@@ -130,8 +323,8 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawComman
     }
     else
     {
-      const u32 dither_y = (dithering_enable) ? (y & 3u) : 2u;
-      const u32 dither_x = (dithering_enable) ? (x & 3u) : 3u;
+      const u32 dither_y = (dithering_enable) ? ((y / GetDitherScale<scaled>()) & 3u) : 2u;
+      const u32 dither_x = (dithering_enable) ? ((x / GetDitherScale<scaled>()) & 3u) : 3u;
 
       color.bits = (ZeroExtend16(s_dither_lut[dither_y][dither_x][(u16(texture_color.r) * u16(color_r)) >> 4]) << 0) |
                    (ZeroExtend16(s_dither_lut[dither_y][dither_x][(u16(texture_color.g) * u16(color_g)) >> 4]) << 5) |
@@ -141,8 +334,8 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawComman
   }
   else
   {
-    const u32 dither_y = (dithering_enable) ? (y & 3u) : 2u;
-    const u32 dither_x = (dithering_enable) ? (x & 3u) : 3u;
+    const u32 dither_y = (dithering_enable) ? ((y / GetDitherScale<scaled>()) & 3u) : 2u;
+    const u32 dither_x = (dithering_enable) ? ((x / GetDitherScale<scaled>()) & 3u) : 3u;
 
     // Non-textured transparent polygons don't set bit 15, but are treated as transparent.
     color.bits = (ZeroExtend16(s_dither_lut[dither_y][dither_x][color_r]) << 0) |
@@ -150,7 +343,8 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawComman
                  (ZeroExtend16(s_dither_lut[dither_y][dither_x][color_b]) << 10) | (transparency_enable ? 0x8000u : 0);
   }
 
-  const VRAMPixel bg_color{GetPixel(static_cast<u32>(x), static_cast<u32>(y))};
+  u16* const pixel_ptr = GetTargetPixelPtr<scaled>(x, y);
+  const VRAMPixel bg_color{*pixel_ptr};
   if constexpr (transparency_enable)
   {
     if (color.bits & 0x8000u || !texture_enable)
@@ -213,38 +407,73 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::ShadePixel(const GPUBackendDrawComman
   if ((bg_color.bits & mask_and) != 0)
     return;
 
-  SetPixel(static_cast<u32>(x), static_cast<u32>(y), color.bits | cmd->params.GetMaskOR());
+  *pixel_ptr = color.bits | cmd->params.GetMaskOR();
 }
 
-template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd)
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool scaled>
+void GPU_SW_Backend::DrawRectangle(const GPUBackendDrawRectangleCommand* cmd,
+                                   const Common::Rectangle<u32>& drawing_area, const TextureCacheEntry* texture)
 {
-  const s32 origin_x = cmd->x;
-  const s32 origin_y = cmd->y;
+  // Scaled rectangles cover scale x scale pixels for each texel, the same as the native rectangle upscaled.
+  const u32 scale = scaled ? m_resolution_scale : 1u;
+  const s32 origin_x = cmd->x * static_cast<s32>(scale);
+  const s32 origin_y = cmd->y * static_cast<s32>(scale);
   const auto [r, g, b] = UnpackColorRGB24(cmd->color);
   const auto [origin_texcoord_x, origin_texcoord_y] = UnpackTexcoord(cmd->texcoord);
 
-  for (u32 offset_y = 0; offset_y < cmd->height; offset_y++)
+  const u32 height = ZeroExtend32(cmd->height) * scale;
+  for (u32 offset_y = 0; offset_y < height; offset_y++)
   {
     const s32 y = origin_y + static_cast<s32>(offset_y);
-    if (y < static_cast<s32>(m_drawing_area.top) || y > static_cast<s32>(m_drawing_area.bottom) ||
-        (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u)))
+    const u32 native_y = static_cast<u32>(cmd->y + static_cast<s32>(offset_y / scale));
+    if (y < static_cast<s32>(drawing_area.top) || y > static_cast<s32>(drawing_area.bottom) ||
+        (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(native_y) & 1u)))
     {
       continue;
     }
 
-    const u8 texcoord_y = Truncate8(ZeroExtend32(origin_texcoord_y) + offset_y);
+    const u8 texcoord_y = Truncate8(ZeroExtend32(origin_texcoord_y) + (offset_y / scale));
+
+    // Clip the row to the drawing area.
+    s32 offset_x = std::max<s32>(static_cast<s32>(drawing_area.left) - origin_x, 0);
+    const s32 end_offset_x = std::min<s32>(static_cast<s32>(drawing_area.right) + 1 - origin_x,
+                                           static_cast<s32>(ZeroExtend32(cmd->width) * scale));
 
-    for (u32 offset_x = 0; offset_x < cmd->width; offset_x++)
+    if (m_shade_span_functions && (end_offset_x - offset_x) >= static_cast<s32>(GPU_SW_SIMD::SpanInput::SIZE))
     {
-      const s32 x = origin_x + static_cast<s32>(offset_x);
-      if (x < static_cast<s32>(m_drawing_area.left) || x > static_cast<s32>(m_drawing_area.right))
-        continue;
+      const GPU_SW_SIMD::ShadeSpanFunction shade_span =
+        m_shade_span_functions->functions[texture_enable][raw_texture_enable][transparency_enable];
+
+      alignas(32) GPU_SW_SIMD::SpanInput span;
+      InitSpanInput(cmd, &span, false, static_cast<u32>(origin_x + offset_x), static_cast<u32>(y));
+      std::fill_n(span.r, GPU_SW_SIMD::SpanInput::SIZE, ZeroExtend16(r));
+      std::fill_n(span.g, GPU_SW_SIMD::SpanInput::SIZE, ZeroExtend16(g));
+      std::fill_n(span.b, GPU_SW_SIMD::SpanInput::SIZE, ZeroExtend16(b));
 
-      const u8 texcoord_x = Truncate8(ZeroExtend32(origin_texcoord_x) + offset_x);
+      do
+      {
+        if constexpr (texture_enable)
+        {
+          for (u32 i = 0; i < GPU_SW_SIMD::SpanInput::SIZE; i++)
+          {
+            span.texels[i] = FetchTexel(
+              cmd, texture, Truncate8(ZeroExtend32(origin_texcoord_x) + ((static_cast<u32>(offset_x) + i) / scale)),
+              texcoord_y);
+          }
+        }
+
+        shade_span(GetTargetPixelPtr<scaled>(static_cast<u32>(origin_x + offset_x), static_cast<u32>(y)), span);
+        offset_x += GPU_SW_SIMD::SpanInput::SIZE;
+      } while ((end_offset_x - offset_x) >= static_cast<s32>(GPU_SW_SIMD::SpanInput::SIZE));
+    }
+
+    for (; offset_x < end_offset_x; offset_x++)
+    {
+      const s32 x = origin_x + offset_x;
+      const u8 texcoord_x = Truncate8(ZeroExtend32(origin_texcoord_x) + (static_cast<u32>(offset_x) / scale));
 
-      ShadePixel<texture_enable, raw_texture_enable, transparency_enable, false>(
-        cmd, static_cast<u32>(x), static_cast<u32>(y), r, g, b, texcoord_x, texcoord_y);
+      ShadePixel<texture_enable, raw_texture_enable, transparency_enable, false, scaled>(
+        cmd, texture, static_cast<u32>(x), static_cast<u32>(y), r, g, b, texcoord_x, texcoord_y);
     }
   }
 }
@@ -288,9 +517,10 @@ bool ALWAYS_INLINE_RELEASE GPU_SW_Backend::CalcIDeltas(i_deltas& idl, const GPUB
                                                        const GPUBackendDrawPolygonCommand::Vertex* B,
                                                        const GPUBackendDrawPolygonCommand::Vertex* C)
 {
-#define CALCIS(x, y) (((B->x - A->x) * (C->y - B->y)) - ((C->x - B->x) * (B->y - A->y)))
+  // Scaled positions are up to four times larger, which overflows 32 bits once multiplied by the fixed point scale.
+#define CALCIS(x, y) ((s64(B->x - A->x) * (C->y - B->y)) - (s64(C->x - B->x) * (B->y - A->y)))
 
-  s32 denom = CALCIS(x, y);
+  s64 denom = CALCIS(x, y);
 
   if (!denom)
     return false;
@@ -356,27 +586,30 @@ void ALWAYS_INLINE_RELEASE GPU_SW_Backend::AddIDeltas_DY(i_group& ig, const i_de
 }
 
 template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
-         bool dithering_enable>
-void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32 x_start, s32 x_bound, i_group ig,
+         bool dithering_enable, bool scaled>
+void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, const Common::Rectangle<u32>& drawing_area,
+                              const TextureCacheEntry* texture, s32 y, s32 x_start, s32 x_bound, i_group ig,
                               const i_deltas& idl)
 {
-  if (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(static_cast<u32>(y)) & 1u))
+  const u32 native_y = scaled ? (static_cast<u32>(y) / m_resolution_scale) : static_cast<u32>(y);
+  if (cmd->params.interlaced_rendering && cmd->params.active_line_lsb == (Truncate8(native_y) & 1u))
     return;
 
+  // Scaled positions are past the range of the vertex registers, and were wrapped at native resolution already.
   s32 x_ig_adjust = x_start;
   s32 w = x_bound - x_start;
-  s32 x = TruncateGPUVertexPosition(x_start);
+  s32 x = scaled ? x_start : TruncateGPUVertexPosition(x_start);
 
-  if (x < static_cast<s32>(m_drawing_area.left))
+  if (x < static_cast<s32>(drawing_area.left))
   {
-    s32 delta = static_cast<s32>(m_drawing_area.left) - x;
+    s32 delta = static_cast<s32>(drawing_area.left) - x;
     x_ig_adjust += delta;
     x += delta;
     w -= delta;
   }
 
-  if ((x + w) > (static_cast<s32>(m_drawing_area.right) + 1))
-    w = static_cast<s32>(m_drawing_area.right) + 1 - x;
+  if ((x + w) > (static_cast<s32>(drawing_area.right) + 1))
+    w = static_cast<s32>(drawing_area.right) + 1 - x;
 
   if (w <= 0)
     return;
@@ -384,7 +617,42 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
   AddIDeltas_DX<shading_enable, texture_enable>(ig, idl, x_ig_adjust);
   AddIDeltas_DY<shading_enable, texture_enable>(ig, idl, y);
 
-  do
+  if (m_shade_span_functions && w >= static_cast<s32>(GPU_SW_SIMD::SpanInput::SIZE))
+  {
+    const GPU_SW_SIMD::ShadeSpanFunction shade_span =
+      m_shade_span_functions->functions[texture_enable][raw_texture_enable][transparency_enable];
+
+    alignas(32) GPU_SW_SIMD::SpanInput span;
+    const u32 dither_scale = GetDitherScale<scaled>();
+    const bool block_dither = dithering_enable && (GPU_SW_SIMD::SpanInput::SIZE % (4u * dither_scale)) != 0;
+    InitSpanInput(cmd, &span, dithering_enable, static_cast<u32>(x), static_cast<u32>(y), dither_scale);
+
+    do
+    {
+      if (block_dither)
+        InitSpanInput(cmd, &span, dithering_enable, static_cast<u32>(x), static_cast<u32>(y), dither_scale);
+
+      for (u32 i = 0; i < GPU_SW_SIMD::SpanInput::SIZE; i++)
+      {
+        if constexpr (texture_enable)
+        {
+          span.texels[i] = FetchTexel(cmd, texture, Truncate8(ig.u >> (COORD_FBS + COORD_POST_PADDING)),
+                                      Truncate8(ig.v >> (COORD_FBS + COORD_POST_PADDING)));
+        }
+
+        span.r[i] = ZeroExtend16(Truncate8(ig.r >> (COORD_FBS + COORD_POST_PADDING)));
+        span.g[i] = ZeroExtend16(Truncate8(ig.g >> (COORD_FBS + COORD_POST_PADDING)));
+        span.b[i] = ZeroExtend16(Truncate8(ig.b >> (COORD_FBS + COORD_POST_PADDING)));
+        AddIDeltas_DX<shading_enable, texture_enable>(ig, idl);
+      }
+
+      shade_span(GetTargetPixelPtr<scaled>(static_cast<u32>(x), static_cast<u32>(y)), span);
+      x += GPU_SW_SIMD::SpanInput::SIZE;
+      w -= GPU_SW_SIMD::SpanInput::SIZE;
+    } while (w >= static_cast<s32>(GPU_SW_SIMD::SpanInput::SIZE));
+  }
+
+  while (w > 0)
   {
     const u32 r = ig.r >> (COORD_FBS + COORD_POST_PADDING);
     const u32 g = ig.g >> (COORD_FBS + COORD_POST_PADDING);
@@ -392,18 +660,20 @@ void GPU_SW_Backend::DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s3
     const u32 u = ig.u >> (COORD_FBS + COORD_POST_PADDING);
     const u32 v = ig.v >> (COORD_FBS + COORD_POST_PADDING);
 
-    ShadePixel<texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-      cmd, static_cast<u32>(x), static_cast<u32>(y), Truncate8(r), Truncate8(g), Truncate8(b), Truncate8(u),
+    ShadePixel<texture_enable, raw_texture_enable, transparency_enable, dithering_enable, scaled>(
+      cmd, texture, static_cast<u32>(x), static_cast<u32>(y), Truncate8(r), Truncate8(g), Truncate8(b), Truncate8(u),
       Truncate8(v));
 
     x++;
+    w--;
     AddIDeltas_DX<shading_enable, texture_enable>(ig, idl);
-  } while (--w > 0);
+  }
 }
 
 template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
-         bool dithering_enable>
+         bool dithering_enable, bool scaled>
 void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
+                                  const Common::Rectangle<u32>& drawing_area, const TextureCacheEntry* texture,
                                   const GPUBackendDrawPolygonCommand::Vertex* v0,
                                   const GPUBackendDrawPolygonCommand::Vertex* v1,
                                   const GPUBackendDrawPolygonCommand::Vertex* v2)
@@ -448,10 +718,11 @@ void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
   if (v0->y == v2->y)
     return;
 
-  if (static_cast<u32>(std::abs(v2->x - v0->x)) >= MAX_PRIMITIVE_WIDTH ||
-      static_cast<u32>(std::abs(v2->x - v1->x)) >= MAX_PRIMITIVE_WIDTH ||
-      static_cast<u32>(std::abs(v1->x - v0->x)) >= MAX_PRIMITIVE_WIDTH ||
-      static_cast<u32>(v2->y - v0->y) >= MAX_PRIMITIVE_HEIGHT)
+  const u32 scale = scaled ? m_resolution_scale : 1u;
+  if (static_cast<u32>(std::abs(v2->x - v0->x)) >= (MAX_PRIMITIVE_WIDTH * scale) ||
+      static_cast<u32>(std::abs(v2->x - v1->x)) >= (MAX_PRIMITIVE_WIDTH * scale) ||
+      static_cast<u32>(std::abs(v1->x - v0->x)) >= (MAX_PRIMITIVE_WIDTH * scale) ||
+      static_cast<u32>(v2->y - v0->y) >= (MAX_PRIMITIVE_HEIGHT * scale))
   {
     return;
   }
@@ -559,32 +830,32 @@ void GPU_SW_Backend::DrawTriangle(const GPUBackendDrawPolygonCommand* cmd,
         lc -= ls;
         rc -= rs;
 
-        s32 y = TruncateGPUVertexPosition(yi);
+        s32 y = scaled ? yi : TruncateGPUVertexPosition(yi);
 
-        if (y < static_cast<s32>(m_drawing_area.top))
+        if (y < static_cast<s32>(drawing_area.top))
           break;
 
-        if (y > static_cast<s32>(m_drawing_area.bottom))
+        if (y > static_cast<s32>(drawing_area.bottom))
           continue;
 
-        DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-          cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
+        DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable, scaled>(
+          cmd, drawing_area, texture, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
       }
     }
     else
     {
       while (yi < yb)
       {
-        s32 y = TruncateGPUVertexPosition(yi);
+        s32 y = scaled ? yi : TruncateGPUVertexPosition(yi);
 
-        if (y > static_cast<s32>(m_drawing_area.bottom))
+        if (y > static_cast<s32>(drawing_area.bottom))
           break;
 
-        if (y >= static_cast<s32>(m_drawing_area.top))
+        if (y >= static_cast<s32>(drawing_area.top))
         {
 
-          DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable>(
-            cmd, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
+          DrawSpan<shading_enable, texture_enable, raw_texture_enable, transparency_enable, dithering_enable, scaled>(
+            cmd, drawing_area, texture, yi, GetPolyXFP_Int(lc), GetPolyXFP_Int(rc), ig, idl);
         }
 
         yi++;
@@ -622,9 +893,9 @@ static ALWAYS_INLINE_RELEASE s64 LineDivide(s64 delta, s32 dk)
   return (delta / dk);
 }
 
-template<bool shading_enable, bool transparency_enable, bool dithering_enable>
-void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBackendDrawLineCommand::Vertex* p0,
-                              const GPUBackendDrawLineCommand::Vertex* p1)
+template<bool shading_enable, bool transparency_enable, bool dithering_enable, bool scaled>
+void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const Common::Rectangle<u32>& drawing_area,
+                              const GPUBackendDrawLineCommand::Vertex* p0, const GPUBackendDrawLineCommand::Vertex* p1)
 {
   const s32 i_dx = std::abs(p1->x - p0->x);
   const s32 i_dy = std::abs(p1->y - p0->y);
@@ -684,15 +955,32 @@ void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBac
     const s32 y = (cur_point.y >> Line_XY_FractBits) & 2047;
 
     if ((!cmd->params.interlaced_rendering || cmd->params.active_line_lsb != (Truncate8(static_cast<u32>(y)) & 1u)) &&
-        x >= static_cast<s32>(m_drawing_area.left) && x <= static_cast<s32>(m_drawing_area.right) &&
-        y >= static_cast<s32>(m_drawing_area.top) && y <= static_cast<s32>(m_drawing_area.bottom))
+        x >= static_cast<s32>(drawing_area.left) && x <= static_cast<s32>(drawing_area.right) &&
+        y >= static_cast<s32>(drawing_area.top) && y <= static_cast<s32>(drawing_area.bottom))
     {
       const u8 r = shading_enable ? static_cast<u8>(cur_point.r >> Line_RGB_FractBits) : p0->r;
       const u8 g = shading_enable ? static_cast<u8>(cur_point.g >> Line_RGB_FractBits) : p0->g;
       const u8 b = shading_enable ? static_cast<u8>(cur_point.b >> Line_RGB_FractBits) : p0->b;
 
-      ShadePixel<false, false, transparency_enable, dithering_enable>(cmd, static_cast<u32>(x), static_cast<u32>(y), r,
-                                                                      g, b, 0, 0);
+      if constexpr (scaled)
+      {
+        // Each native pixel of the line becomes a block at the scaled resolution.
+        const u32 scale = m_resolution_scale;
+        for (u32 block_y = 0; block_y < scale; block_y++)
+        {
+          for (u32 block_x = 0; block_x < scale; block_x++)
+          {
+            ShadePixel<false, false, transparency_enable, dithering_enable, true>(
+              cmd, nullptr, (static_cast<u32>(x) * scale) + block_x, (static_cast<u32>(y) * scale) + block_y, r, g, b,
+              0, 0);
+          }
+        }
+      }
+      else
+      {
+        ShadePixel<false, false, transparency_enable, dithering_enable, false>(cmd, nullptr, static_cast<u32>(x),
+                                                                               static_cast<u32>(y), r, g, b, 0, 0);
+      }
     }
 
     cur_point.x += step.dx_dk;
@@ -707,52 +995,237 @@ void GPU_SW_Backend::DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBac
   }
 }
 
-void GPU_SW_Backend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params)
+#if defined(CPU_X64) || defined(CPU_AARCH64)
+static u32 AlignDownPow2(u32 value, unsigned int alignment)
 {
-  const u16 color16 = VRAMRGBA8888ToRGBA5551(color);
-  if ((x + width) <= VRAM_WIDTH && !params.interlaced_rendering)
+  return value & (~(alignment - 1));
+}
+#endif
+
+// Fills larger than this are written with non-temporal stores, so they don't evict the rest of VRAM from the cache.
+static constexpr u32 NON_TEMPORAL_FILL_SIZE = 128 * 1024;
+
+// The VRAM transfer helpers below work on contiguous spans. Rows which wrap around the right edge of VRAM are split
+// into two spans by the callers, transfers are never wider than VRAM.
+static void FillVRAMSpan(u16* dst_ptr, u32 width, u16 color, bool non_temporal)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  const __m128i value = _mm_set1_epi16(static_cast<s16>(color));
+  if (non_temporal)
   {
-    for (u32 yoffs = 0; yoffs < height; yoffs++)
+    // Streaming stores have to be aligned.
+    for (; col < width && (reinterpret_cast<uintptr_t>(dst_ptr) & 15) != 0; col++)
+      *(dst_ptr++) = color;
+
+    const u32 aligned_width = col + AlignDownPow2(width - col, 8);
+    for (; col < aligned_width; col += 8)
     {
-      const u32 row = (y + yoffs) % VRAM_HEIGHT;
-      std::fill_n(&m_vram_ptr[row * VRAM_WIDTH + x], width, color16);
+      _mm_stream_si128(reinterpret_cast<__m128i*>(dst_ptr), value);
+      dst_ptr += 8;
     }
   }
-  else if (params.interlaced_rendering)
+  else
   {
-    // Hardware tests show that fills seem to break on the first two lines when the offset matches the displayed field.
-    const u32 active_field = params.active_line_lsb;
-    for (u32 yoffs = 0; yoffs < height; yoffs++)
+    const u32 aligned_width = AlignDownPow2(width, 8);
+    for (; col < aligned_width; col += 8)
     {
-      const u32 row = (y + yoffs) % VRAM_HEIGHT;
-      if ((row & u32(1)) == active_field)
-        continue;
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), value);
+      dst_ptr += 8;
+    }
+  }
+#elif defined(CPU_AARCH64)
+  const uint16x8_t value = vdupq_n_u16(color);
+  const u32 aligned_width = AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    vst1q_u16(dst_ptr, value);
+    dst_ptr += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+    *(dst_ptr++) = color;
+}
+
+// if ((dst_pixel & mask_and) == 0) { dst_pixel = src_pixel | mask_or }
+// The source is always read before the destination is written, so when the spans overlap, reverse has to be set if
+// the destination is after the source, as it would be for memmove().
+template<bool reverse>
+static void CopyVRAMSpan(u16* dst_ptr, const u16* src_ptr, u32 width, u16 mask_and, u16 mask_or)
+{
+  if (mask_and == 0 && mask_or == 0)
+  {
+    std::memmove(dst_ptr, src_ptr, width * sizeof(u16));
+    return;
+  }
+
+  u32 remaining = width;
+
+#if defined(CPU_X64)
+  const __m128i vmask_and = _mm_set1_epi16(static_cast<s16>(mask_and));
+  const __m128i vmask_or = _mm_set1_epi16(static_cast<s16>(mask_or));
+  for (; remaining >= 8; remaining -= 8)
+  {
+    const u32 offset = reverse ? (remaining - 8) : (width - remaining);
+    const __m128i src = _mm_or_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr + offset)), vmask_or);
+    const __m128i dst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst_ptr + offset));
+    const __m128i keep = _mm_srai_epi16(_mm_and_si128(dst, vmask_and), 15);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + offset),
+                     _mm_or_si128(_mm_and_si128(keep, dst), _mm_andnot_si128(keep, src)));
+  }
+#elif defined(CPU_AARCH64)
+  const uint16x8_t vmask_and = vdupq_n_u16(mask_and);
+  const uint16x8_t vmask_or = vdupq_n_u16(mask_or);
+  for (; remaining >= 8; remaining -= 8)
+  {
+    const u32 offset = reverse ? (remaining - 8) : (width - remaining);
+    const uint16x8_t src = vorrq_u16(vld1q_u16(src_ptr + offset), vmask_or);
+    const uint16x8_t dst = vld1q_u16(dst_ptr + offset);
+    vst1q_u16(dst_ptr + offset, vbslq_u16(vtstq_u16(dst, vmask_and), dst, src));
+  }
+#endif
+
+  for (; remaining > 0; remaining--)
+  {
+    const u32 offset = reverse ? (remaining - 1) : (width - remaining);
+    const u16 src_pixel = src_ptr[offset];
+    if ((dst_ptr[offset] & mask_and) == 0)
+      dst_ptr[offset] = src_pixel | mask_or;
+  }
+}
+
+// Same as CopyVRAMSpan(), except the source only advances for pixels which are written. Returns the number of source
+// pixels consumed.
+static u32 UpdateVRAMSpan(u16* dst_ptr, const u16* src_ptr, u32 width, u16 mask_and, u16 mask_or)
+{
+  if (mask_and == 0)
+  {
+    CopyVRAMSpan<false>(dst_ptr, src_ptr, width, mask_and, mask_or);
+    return width;
+  }
+
+  const u16* src_start = src_ptr;
+  u32 col = 0;
 
-      u16* row_ptr = &m_vram_ptr[row * VRAM_WIDTH];
-      for (u32 xoffs = 0; xoffs < width; xoffs++)
+  // Masked pixels are usually in large groups, so whole vectors can be skipped or written most of the time.
+#if defined(CPU_X64)
+  const __m128i vmask_and = _mm_set1_epi16(static_cast<s16>(mask_and));
+  const __m128i vmask_or = _mm_set1_epi16(static_cast<s16>(mask_or));
+  const u32 aligned_width = AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const __m128i dst = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst_ptr + col));
+    const int keep_mask = _mm_movemask_epi8(_mm_srai_epi16(_mm_and_si128(dst, vmask_and), 15));
+    if (keep_mask == 0)
+    {
+      const __m128i src = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + col), _mm_or_si128(src, vmask_or));
+      src_ptr += 8;
+    }
+    else if (keep_mask != 0xFFFF)
+    {
+      for (u32 i = 0; i < 8; i++)
       {
-        const u32 col = (x + xoffs) % VRAM_WIDTH;
-        row_ptr[col] = color16;
+        if ((dst_ptr[col + i] & mask_and) == 0)
+          dst_ptr[col + i] = *(src_ptr++) | mask_or;
       }
     }
   }
-  else
+#elif defined(CPU_AARCH64)
+  const uint16x8_t vmask_and = vdupq_n_u16(mask_and);
+  const uint16x8_t vmask_or = vdupq_n_u16(mask_or);
+  const u32 aligned_width = AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
   {
-    for (u32 yoffs = 0; yoffs < height; yoffs++)
+    const uint16x8_t keep = vtstq_u16(vld1q_u16(dst_ptr + col), vmask_and);
+    if (vmaxvq_u16(keep) == 0)
     {
-      const u32 row = (y + yoffs) % VRAM_HEIGHT;
-      u16* row_ptr = &m_vram_ptr[row * VRAM_WIDTH];
-      for (u32 xoffs = 0; xoffs < width; xoffs++)
+      vst1q_u16(dst_ptr + col, vorrq_u16(vld1q_u16(src_ptr), vmask_or));
+      src_ptr += 8;
+    }
+    else if (vminvq_u16(keep) == 0)
+    {
+      for (u32 i = 0; i < 8; i++)
       {
-        const u32 col = (x + xoffs) % VRAM_WIDTH;
-        row_ptr[col] = color16;
+        if ((dst_ptr[col + i] & mask_and) == 0)
+          dst_ptr[col + i] = *(src_ptr++) | mask_or;
       }
     }
   }
+#endif
+
+  for (; col < width; col++)
+  {
+    if ((dst_ptr[col] & mask_and) == 0)
+      dst_ptr[col] = *(src_ptr++) | mask_or;
+  }
+
+  return static_cast<u32>(src_ptr - src_start);
+}
+
+void GPU_SW_Backend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params)
+{
+  FillVRAM(x, y, width, height, color, params, GetFullBand());
 }
 
 void GPU_SW_Backend::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data,
                                 GPUBackendCommandParameters params)
+{
+  UpdateVRAM(x, y, width, height, data, params, GetFullBand());
+}
+
+void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height,
+                              GPUBackendCommandParameters params)
+{
+  CopyVRAM(src_x, src_y, dst_x, dst_y, width, height, params, GetFullBand());
+}
+
+void GPU_SW_Backend::FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params,
+                              const RenderBand& band)
+{
+  const u16 color16 = VRAMRGBA8888ToRGBA5551(color);
+  const u32 first_width = std::min(width, VRAM_WIDTH - x);
+  const u32 second_width = width - first_width;
+  const bool non_temporal = (width * height) >= NON_TEMPORAL_FILL_SIZE;
+
+  // Hardware tests show that fills seem to break on the first two lines when the offset matches the displayed field.
+  const bool interlaced = params.interlaced_rendering;
+  const u32 active_field = params.active_line_lsb;
+  for (u32 yoffs = 0; yoffs < height; yoffs++)
+  {
+    const u32 row = (y + yoffs) % VRAM_HEIGHT;
+    if ((interlaced && (row & u32(1)) == active_field) || row < band.first_row || row > band.last_row)
+      continue;
+
+    u16* row_ptr = &m_vram_ptr[row * VRAM_WIDTH];
+    FillVRAMSpan(row_ptr + x, first_width, color16, non_temporal);
+    if (second_width > 0)
+      FillVRAMSpan(row_ptr, second_width, color16, non_temporal);
+
+    if (m_resolution_scale == 1)
+      continue;
+
+    const u32 scale = m_resolution_scale;
+    for (u32 scaled_row = row * scale; scaled_row < ((row + 1) * scale); scaled_row++)
+    {
+      u16* scaled_row_ptr = &m_scaled_vram[scaled_row * m_scaled_vram_width];
+      FillVRAMSpan(scaled_row_ptr + (x * scale), first_width * scale, color16, non_temporal);
+      if (second_width > 0)
+        FillVRAMSpan(scaled_row_ptr, second_width * scale, color16, non_temporal);
+    }
+  }
+
+#if defined(CPU_X64)
+  // Make the streaming stores visible before the next command, or another thread, reads VRAM.
+  if (non_temporal)
+    _mm_sfence();
+#endif
+}
+
+void GPU_SW_Backend::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data,
+                                GPUBackendCommandParameters params, const RenderBand& band)
 {
   // Fast path when the copy is not oversized.
   if ((x + width) <= VRAM_WIDTH && (y + height) <= VRAM_HEIGHT && !params.IsMaskingEnabled())
@@ -761,34 +1234,71 @@ void GPU_SW_Backend::UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void*
     u16* dst_ptr = &m_vram_ptr[y * VRAM_WIDTH + x];
     for (u32 yoffs = 0; yoffs < height; yoffs++)
     {
-      std::copy_n(src_ptr, width, dst_ptr);
+      const u32 row = y + yoffs;
+      if (row >= band.first_row && row <= band.last_row)
+        std::copy_n(src_ptr, width, dst_ptr);
+
       src_ptr += width;
       dst_ptr += VRAM_WIDTH;
     }
   }
   else
   {
-    // Slow path when we need to handle wrap-around.
+    // Slow path when we need to handle wrap-around. The source only advances for written pixels, so this is never
+    // split into bands.
     const u16* src_ptr = static_cast<const u16*>(data);
     const u16 mask_and = params.GetMaskAND();
     const u16 mask_or = params.GetMaskOR();
+    const u32 first_width = std::min(width, VRAM_WIDTH - x);
+    const u32 second_width = width - first_width;
 
-    for (u32 row = 0; row < height;)
+    for (u32 row = 0; row < height; row++)
     {
-      u16* dst_row_ptr = &m_vram_ptr[((y + row++) % VRAM_HEIGHT) * VRAM_WIDTH];
-      for (u32 col = 0; col < width;)
-      {
-        // TODO: Handle unaligned reads...
-        u16* pixel_ptr = &dst_row_ptr[(x + col++) % VRAM_WIDTH];
-        if (((*pixel_ptr) & mask_and) == 0)
-          *pixel_ptr = *(src_ptr++) | mask_or;
-      }
+      u16* dst_row_ptr = &m_vram_ptr[((y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
+      src_ptr += UpdateVRAMSpan(dst_row_ptr + x, src_ptr, first_width, mask_and, mask_or);
+      if (second_width > 0)
+        src_ptr += UpdateVRAMSpan(dst_row_ptr, src_ptr, second_width, mask_and, mask_or);
+    }
+  }
+
+  // Uploads only have native resolution detail, so the scaled copy is replaced with the result.
+  if (m_resolution_scale > 1)
+    UpscaleVRAM(x, y, width, height, band);
+}
+
+void GPU_SW_Backend::UpscaleVRAM(u32 x, u32 y, u32 width, u32 height, const RenderBand& band)
+{
+  const u32 scale = m_resolution_scale;
+  const u32 first_width = std::min(width, VRAM_WIDTH - x);
+  const u32 second_width = width - first_width;
+
+  for (u32 yoffs = 0; yoffs < height; yoffs++)
+  {
+    const u32 row = (y + yoffs) % VRAM_HEIGHT;
+    if (row < band.first_row || row > band.last_row)
+      continue;
+
+    const u16* src_row_ptr = &m_vram[row * VRAM_WIDTH];
+    u16* dst_row_ptr = &m_scaled_vram[row * scale * m_scaled_vram_width];
+    for (u32 xoffs = 0; xoffs < width; xoffs++)
+    {
+      const u32 col = (x + xoffs) % VRAM_WIDTH;
+      std::fill_n(&dst_row_ptr[col * scale], scale, src_row_ptr[col]);
+    }
+
+    // The rest of the rows in the block are the same as the first.
+    for (u32 i = 1; i < scale; i++)
+    {
+      u16* copy_row_ptr = dst_row_ptr + (i * m_scaled_vram_width);
+      std::memcpy(copy_row_ptr + (x * scale), dst_row_ptr + (x * scale), first_width * scale * sizeof(u16));
+      if (second_width > 0)
+        std::memcpy(copy_row_ptr, dst_row_ptr, second_width * scale * sizeof(u16));
     }
   }
 }
 
 void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height,
-                              GPUBackendCommandParameters params)
+                              GPUBackendCommandParameters params, const RenderBand& band)
 {
   // Break up oversized copies. This behavior has not been verified on console.
   if ((src_x + width) > VRAM_WIDTH || (dst_x + width) > VRAM_WIDTH)
@@ -808,7 +1318,8 @@ void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wi
       {
         const u32 columns_to_copy =
           std::min<u32>(remaining_columns, std::min<u32>(VRAM_WIDTH - current_src_x, VRAM_WIDTH - current_dst_x));
-        CopyVRAM(current_src_x, current_src_y, current_dst_x, current_dst_y, columns_to_copy, rows_to_copy, params);
+        CopyVRAM(current_src_x, current_src_y, current_dst_x, current_dst_y, columns_to_copy, rows_to_copy, params,
+                 band);
         current_src_x = (current_src_x + columns_to_copy) % VRAM_WIDTH;
         current_dst_x = (current_dst_x + columns_to_copy) % VRAM_WIDTH;
         remaining_columns -= columns_to_copy;
@@ -822,109 +1333,1773 @@ void GPU_SW_Backend::CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 wi
     return;
   }
 
-  // This doesn't have a fast path, but do we really need one? It's not common.
   const u16 mask_and = params.GetMaskAND();
   const u16 mask_or = params.GetMaskOR();
 
-  // Copy in reverse when src_x < dst_x, this is verified on console.
-  if (src_x < dst_x || ((src_x + width - 1) % VRAM_WIDTH) < ((dst_x + width - 1) % VRAM_WIDTH))
+  // Copy in reverse when src_x < dst_x, this is verified on console. Oversized copies were split above, so the rows
+  // are contiguous here.
+  const bool reverse = (src_x < dst_x);
+  for (u32 row = 0; row < height; row++)
   {
-    for (u32 row = 0; row < height; row++)
-    {
-      const u16* src_row_ptr = &m_vram_ptr[((src_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
-      u16* dst_row_ptr = &m_vram_ptr[((dst_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
+    const u32 dst_row = (dst_y + row) % VRAM_HEIGHT;
+    if (dst_row < band.first_row || dst_row > band.last_row)
+      continue;
 
-      for (s32 col = static_cast<s32>(width - 1); col >= 0; col--)
-      {
-        const u16 src_pixel = src_row_ptr[(src_x + static_cast<u32>(col)) % VRAM_WIDTH];
-        u16* dst_pixel_ptr = &dst_row_ptr[(dst_x + static_cast<u32>(col)) % VRAM_WIDTH];
-        if ((*dst_pixel_ptr & mask_and) == 0)
-          *dst_pixel_ptr = src_pixel | mask_or;
-      }
-    }
-  }
-  else
-  {
-    for (u32 row = 0; row < height; row++)
-    {
-      const u16* src_row_ptr = &m_vram_ptr[((src_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
-      u16* dst_row_ptr = &m_vram_ptr[((dst_y + row) % VRAM_HEIGHT) * VRAM_WIDTH];
+    const u32 src_row = (src_y + row) % VRAM_HEIGHT;
+    const u16* src_row_ptr = &m_vram_ptr[src_row * VRAM_WIDTH + src_x];
+    u16* dst_row_ptr = &m_vram_ptr[dst_row * VRAM_WIDTH + dst_x];
+    if (reverse)
+      CopyVRAMSpan<true>(dst_row_ptr, src_row_ptr, width, mask_and, mask_or);
+    else
+      CopyVRAMSpan<false>(dst_row_ptr, src_row_ptr, width, mask_and, mask_or);
 
-      for (u32 col = 0; col < width; col++)
-      {
-        const u16 src_pixel = src_row_ptr[(src_x + col) % VRAM_WIDTH];
-        u16* dst_pixel_ptr = &dst_row_ptr[(dst_x + col) % VRAM_WIDTH];
-        if ((*dst_pixel_ptr & mask_and) == 0)
-          *dst_pixel_ptr = src_pixel | mask_or;
-      }
+    if (m_resolution_scale == 1)
+      continue;
+
+    // Copies keep the detail of the scaled image, rows are copied in the same order as above.
+    const u32 scale = m_resolution_scale;
+    for (u32 i = 0; i < scale; i++)
+    {
+      const u16* scaled_src_ptr = &m_scaled_vram[((src_row * scale) + i) * m_scaled_vram_width + (src_x * scale)];
+      u16* scaled_dst_ptr = &m_scaled_vram[((dst_row * scale) + i) * m_scaled_vram_width + (dst_x * scale)];
+      if (reverse)
+        CopyVRAMSpan<true>(scaled_dst_ptr, scaled_src_ptr, width * scale, mask_and, mask_or);
+      else
+        CopyVRAMSpan<false>(scaled_dst_ptr, scaled_src_ptr, width * scale, mask_and, mask_or);
     }
   }
 }
 
-void GPU_SW_Backend::FlushRender() {}
+template<HostDisplayPixelFormat out_format, typename out_type>
+static void CopyOutRow16(const u16* src_ptr, out_type* dst_ptr, u32 width);
+
+template<HostDisplayPixelFormat out_format, typename out_type>
+static out_type VRAM16ToOutput(u16 value);
+
+template<>
+ALWAYS_INLINE u16 VRAM16ToOutput<HostDisplayPixelFormat::RGBA5551, u16>(u16 value)
+{
+  return (value & 0x3E0) | ((value >> 10) & 0x1F) | ((value & 0x1F) << 10);
+}
+
+template<>
+ALWAYS_INLINE u16 VRAM16ToOutput<HostDisplayPixelFormat::RGB565, u16>(u16 value)
+{
+  return ((value & 0x3E0) << 1) | ((value & 0x20) << 1) | ((value >> 10) & 0x1F) | ((value & 0x1F) << 11);
+}
+
+template<>
+ALWAYS_INLINE u32 VRAM16ToOutput<HostDisplayPixelFormat::RGBA8, u32>(u16 value)
+{
+  const u32 value32 = ZeroExtend32(value);
+  const u32 r = (value32 & 31u) << 3;
+  const u32 g = ((value32 >> 5) & 31u) << 3;
+  const u32 b = ((value32 >> 10) & 31u) << 3;
+  const u32 a = ((value >> 15) != 0) ? 255 : 0;
+  return ZeroExtend32(r) | (ZeroExtend32(g) << 8) | (ZeroExtend32(b) << 16) | (ZeroExtend32(a) << 24);
+}
+
+template<>
+ALWAYS_INLINE u32 VRAM16ToOutput<HostDisplayPixelFormat::BGRA8, u32>(u16 value)
+{
+  const u32 value32 = ZeroExtend32(value);
+  const u32 r = (value32 & 31u) << 3;
+  const u32 g = ((value32 >> 5) & 31u) << 3;
+  const u32 b = ((value32 >> 10) & 31u) << 3;
+  return ZeroExtend32(b) | (ZeroExtend32(g) << 8) | (ZeroExtend32(r) << 16) | (0xFF000000u);
+}
+
+template<>
+ALWAYS_INLINE void CopyOutRow16<HostDisplayPixelFormat::RGBA5551, u16>(const u16* src_ptr, u16* dst_ptr, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  const u32 aligned_width = AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const __m128i single_mask = _mm_set1_epi16(0x1F);
+    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+    src_ptr += 8;
+    __m128i a = _mm_and_si128(value, _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0x3E0))));
+    __m128i b = _mm_and_si128(_mm_srli_epi16(value, 10), single_mask);
+    __m128i c = _mm_slli_epi16(_mm_and_si128(value, single_mask), 10);
+    value = _mm_or_si128(_mm_or_si128(a, b), c);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), value);
+    dst_ptr += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint16x8_t single_mask = vdupq_n_u16(0x1F);
+    uint16x8_t value = vld1q_u16(src_ptr);
+    src_ptr += 8;
+    uint16x8_t a = vandq_u16(value, vdupq_n_u16(0x3E0));
+    uint16x8_t b = vandq_u16(vshrq_n_u16(value, 10), single_mask);
+    uint16x8_t c = vshlq_n_u16(vandq_u16(value, single_mask), 10);
+    value = vorrq_u16(vorrq_u16(a, b), c);
+    vst1q_u16(dst_ptr, value);
+    dst_ptr += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+    *(dst_ptr++) = VRAM16ToOutput<HostDisplayPixelFormat::RGBA5551, u16>(*(src_ptr++));
+}
+
+template<>
+ALWAYS_INLINE void CopyOutRow16<HostDisplayPixelFormat::RGB565, u16>(const u16* src_ptr, u16* dst_ptr, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  const u32 aligned_width = AlignDownPow2(width, 8);
+  for (; col < aligned_width; col += 8)
+  {
+    const __m128i single_mask = _mm_set1_epi16(0x1F);
+    __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+    src_ptr += 8;
+    __m128i a = _mm_slli_epi16(_mm_and_si128(value, _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0x3E0)))), 1);
+    __m128i b = _mm_slli_epi16(_mm_and_si128(value, _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0x20)))), 1);
+    __m128i c = _mm_and_si128(_mm_srli_epi16(value, 10), single_mask);
+    __m128i d = _mm_slli_epi16(_mm_and_si128(value, single_mask), 11);
+    value = _mm_or_si128(_mm_or_si128(_mm_or_si128(a, b), c), d);
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), value);
+    dst_ptr += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = AlignDownPow2(width, 8);
+  const uint16x8_t single_mask = vdupq_n_u16(0x1F);
+  for (; col < aligned_width; col += 8)
+  {
+    uint16x8_t value = vld1q_u16(src_ptr);
+    src_ptr += 8;
+    uint16x8_t a = vshlq_n_u16(vandq_u16(value, vdupq_n_u16(0x3E0)), 1); // (value & 0x3E0) << 1
+    uint16x8_t b = vshlq_n_u16(vandq_u16(value, vdupq_n_u16(0x20)), 1);  // (value & 0x20) << 1
+    uint16x8_t c = vandq_u16(vshrq_n_u16(value, 10), single_mask);       // ((value >> 10) & 0x1F)
+    uint16x8_t d = vshlq_n_u16(vandq_u16(value, single_mask), 11);       // ((value & 0x1F) << 11)
+    value = vorrq_u16(vorrq_u16(vorrq_u16(a, b), c), d);
+    vst1q_u16(dst_ptr, value);
+    dst_ptr += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+    *(dst_ptr++) = VRAM16ToOutput<HostDisplayPixelFormat::RGB565, u16>(*(src_ptr++));
+}
+
+template<>
+ALWAYS_INLINE void CopyOutRow16<HostDisplayPixelFormat::RGBA8, u32>(const u16* src_ptr, u32* dst_ptr, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  const u32 aligned_width = AlignDownPow2(width, 8);
+  const __m128i single_mask = _mm_set1_epi16(0x1F);
+  for (; col < aligned_width; col += 8)
+  {
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+    src_ptr += 8;
+    const __m128i r = _mm_slli_epi16(_mm_and_si128(value, single_mask), 3);
+    const __m128i g = _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(value, 5), single_mask), 3);
+    const __m128i b = _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(value, 10), single_mask), 3);
+    const __m128i a = _mm_and_si128(_mm_srai_epi16(value, 15), _mm_set1_epi16(0xFF)); // bit 15 ? 255 : 0
+    const __m128i rg = _mm_or_si128(r, _mm_slli_epi16(g, 8));
+    const __m128i ba = _mm_or_si128(b, _mm_slli_epi16(a, 8));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), _mm_unpacklo_epi16(rg, ba));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + 4), _mm_unpackhi_epi16(rg, ba));
+    dst_ptr += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = AlignDownPow2(width, 8);
+  const uint16x8_t single_mask = vdupq_n_u16(0x1F);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint16x8_t value = vld1q_u16(src_ptr);
+    src_ptr += 8;
+    const uint16x8_t r = vshlq_n_u16(vandq_u16(value, single_mask), 3);
+    const uint16x8_t g = vshlq_n_u16(vandq_u16(vshrq_n_u16(value, 5), single_mask), 3);
+    const uint16x8_t b = vshlq_n_u16(vandq_u16(vshrq_n_u16(value, 10), single_mask), 3);
+    const uint16x8_t a = vandq_u16(vreinterpretq_u16_s16(vshrq_n_s16(vreinterpretq_s16_u16(value), 15)),
+                                   vdupq_n_u16(0xFF)); // bit 15 ? 255 : 0
+    uint16x8x2_t rgba;
+    rgba.val[0] = vorrq_u16(r, vshlq_n_u16(g, 8));
+    rgba.val[1] = vorrq_u16(b, vshlq_n_u16(a, 8));
+    vst2q_u16(reinterpret_cast<u16*>(dst_ptr), rgba);
+    dst_ptr += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+    *(dst_ptr++) = VRAM16ToOutput<HostDisplayPixelFormat::RGBA8, u32>(*(src_ptr++));
+}
+
+template<>
+ALWAYS_INLINE void CopyOutRow16<HostDisplayPixelFormat::BGRA8, u32>(const u16* src_ptr, u32* dst_ptr, u32 width)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  const u32 aligned_width = AlignDownPow2(width, 8);
+  const __m128i single_mask = _mm_set1_epi16(0x1F);
+  for (; col < aligned_width; col += 8)
+  {
+    const __m128i value = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr));
+    src_ptr += 8;
+    const __m128i r = _mm_slli_epi16(_mm_and_si128(value, single_mask), 3);
+    const __m128i g = _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(value, 5), single_mask), 3);
+    const __m128i b = _mm_slli_epi16(_mm_and_si128(_mm_srli_epi16(value, 10), single_mask), 3);
+    const __m128i bg = _mm_or_si128(b, _mm_slli_epi16(g, 8));
+    const __m128i ra = _mm_or_si128(r, _mm_set1_epi16(static_cast<s16>(static_cast<u16>(0xFF00))));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr), _mm_unpacklo_epi16(bg, ra));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr + 4), _mm_unpackhi_epi16(bg, ra));
+    dst_ptr += 8;
+  }
+#elif defined(CPU_AARCH64)
+  const u32 aligned_width = AlignDownPow2(width, 8);
+  const uint16x8_t single_mask = vdupq_n_u16(0x1F);
+  for (; col < aligned_width; col += 8)
+  {
+    const uint16x8_t value = vld1q_u16(src_ptr);
+    src_ptr += 8;
+    const uint16x8_t r = vshlq_n_u16(vandq_u16(value, single_mask), 3);
+    const uint16x8_t g = vshlq_n_u16(vandq_u16(vshrq_n_u16(value, 5), single_mask), 3);
+    const uint16x8_t b = vshlq_n_u16(vandq_u16(vshrq_n_u16(value, 10), single_mask), 3);
+    uint16x8x2_t bgra;
+    bgra.val[0] = vorrq_u16(b, vshlq_n_u16(g, 8));
+    bgra.val[1] = vorrq_u16(r, vdupq_n_u16(0xFF00));
+    vst2q_u16(reinterpret_cast<u16*>(dst_ptr), bgra);
+    dst_ptr += 8;
+  }
+#endif
+
+  for (; col < width; col++)
+    *(dst_ptr++) = VRAM16ToOutput<HostDisplayPixelFormat::BGRA8, u32>(*(src_ptr++));
+}
+
+// The 24-bit copy-out is a straight conversion. When 24-bit chroma smoothing is enabled, it's applied to the whole
+// frame afterwards by SmoothDisplayChroma(), since it needs the neighbouring rows.
+
+#if defined(CPU_X64)
+
+// Converts packed 24-bit pixels four at a time, while a 16-byte load stays before src_end. Returns the number of
+// pixels converted.
+template<HostDisplayPixelFormat out_format>
+CPU_TARGET("sse4.1")
+static u32 CopyOutRow24_SSE41(const u8* src_ptr, u8* dst_ptr, u32 width, const u8* src_end)
+{
+  // RGB888 to 0x00BBGGRR in each 32-bit lane, or 0x00RRGGBB for BGRA8.
+  const __m128i shuffle_mask = (out_format == HostDisplayPixelFormat::BGRA8) ?
+                                 _mm_setr_epi8(2, 1, 0, -1, 5, 4, 3, -1, 8, 7, 6, -1, 11, 10, 9, -1) :
+                                 _mm_setr_epi8(0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11, -1);
+
+  u32 col = 0;
+  for (; (col + 4) <= width && (src_ptr + 16) <= src_end; col += 4)
+  {
+    const __m128i rgb = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src_ptr)), shuffle_mask);
+    src_ptr += 12;
+
+    if constexpr (out_format == HostDisplayPixelFormat::RGBA8 || out_format == HostDisplayPixelFormat::BGRA8)
+    {
+      _mm_storeu_si128(reinterpret_cast<__m128i*>(dst_ptr),
+                       _mm_or_si128(rgb, _mm_set1_epi32(static_cast<s32>(0xFF000000u))));
+      dst_ptr += 16;
+    }
+    else
+    {
+      __m128i value;
+      if constexpr (out_format == HostDisplayPixelFormat::RGB565)
+      {
+        value = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(rgb, _mm_set1_epi32(0xF8)), 8),
+                                          _mm_srli_epi32(_mm_and_si128(rgb, _mm_set1_epi32(0xFC00)), 5)),
+                             _mm_srli_epi32(_mm_and_si128(rgb, _mm_set1_epi32(0xF80000)), 19));
+      }
+      else
+      {
+        value = _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(rgb, _mm_set1_epi32(0xF8)), 7),
+                                          _mm_srli_epi32(_mm_and_si128(rgb, _mm_set1_epi32(0xF800)), 6)),
+                             _mm_srli_epi32(_mm_and_si128(rgb, _mm_set1_epi32(0xF80000)), 19));
+      }
+
+      _mm_storel_epi64(reinterpret_cast<__m128i*>(dst_ptr), _mm_packus_epi32(value, value));
+      dst_ptr += 8;
+    }
+  }
+
+  return col;
+}
+
+#elif defined(CPU_AARCH64)
+
+// Converts packed 24-bit pixels eight at a time, while a 24-byte load stays before src_end. Returns the number of
+// pixels converted.
+template<HostDisplayPixelFormat out_format>
+static u32 CopyOutRow24_NEON(const u8* src_ptr, u8* dst_ptr, u32 width, const u8* src_end)
+{
+  u32 col = 0;
+  for (; (col + 8) <= width && (src_ptr + 24) <= src_end; col += 8)
+  {
+    const uint8x8x3_t rgb = vld3_u8(src_ptr);
+    src_ptr += 24;
+
+    if constexpr (out_format == HostDisplayPixelFormat::RGBA8 || out_format == HostDisplayPixelFormat::BGRA8)
+    {
+      constexpr bool swap_rb = (out_format == HostDisplayPixelFormat::BGRA8);
+      uint8x8x4_t rgba;
+      rgba.val[0] = rgb.val[swap_rb ? 2 : 0];
+      rgba.val[1] = rgb.val[1];
+      rgba.val[2] = rgb.val[swap_rb ? 0 : 2];
+      rgba.val[3] = vdup_n_u8(0xFF);
+      vst4_u8(dst_ptr, rgba);
+      dst_ptr += 32;
+    }
+    else
+    {
+      const uint16x8_t r = vmovl_u8(vshr_n_u8(rgb.val[0], 3));
+      const uint16x8_t b = vmovl_u8(vshr_n_u8(rgb.val[2], 3));
+      uint16x8_t value;
+      if constexpr (out_format == HostDisplayPixelFormat::RGB565)
+      {
+        const uint16x8_t g = vmovl_u8(vshr_n_u8(rgb.val[1], 2));
+        value = vorrq_u16(vorrq_u16(vshlq_n_u16(r, 11), vshlq_n_u16(g, 5)), b);
+      }
+      else
+      {
+        const uint16x8_t g = vmovl_u8(vshr_n_u8(rgb.val[1], 3));
+        value = vorrq_u16(vorrq_u16(vshlq_n_u16(r, 10), vshlq_n_u16(g, 5)), b);
+      }
+
+      vst1q_u16(reinterpret_cast<u16*>(dst_ptr), value);
+      dst_ptr += 16;
+    }
+  }
+
+  return col;
+}
+
+#endif
+
+template<HostDisplayPixelFormat out_format>
+static void CopyOutRow24(const u8* src_ptr, u8* dst_ptr, u32 width, const u8* src_end, bool use_sse41)
+{
+  u32 col = 0;
+
+#if defined(CPU_X64)
+  if (use_sse41)
+    col = CopyOutRow24_SSE41<out_format>(src_ptr, dst_ptr, width, src_end);
+#elif defined(CPU_AARCH64)
+  col = CopyOutRow24_NEON<out_format>(src_ptr, dst_ptr, width, src_end);
+#endif
+
+  src_ptr += col * 3;
+
+  if constexpr (out_format == HostDisplayPixelFormat::RGBA8)
+  {
+    dst_ptr += col * sizeof(u32);
+    for (; col < width; col++)
+    {
+      *(dst_ptr++) = *(src_ptr++);
+      *(dst_ptr++) = *(src_ptr++);
+      *(dst_ptr++) = *(src_ptr++);
+      *(dst_ptr++) = 0xFF;
+    }
+  }
+  else if constexpr (out_format == HostDisplayPixelFormat::BGRA8)
+  {
+    dst_ptr += col * sizeof(u32);
+    for (; col < width; col++)
+    {
+      *(dst_ptr++) = src_ptr[2];
+      *(dst_ptr++) = src_ptr[1];
+      *(dst_ptr++) = src_ptr[0];
+      *(dst_ptr++) = 0xFF;
+      src_ptr += 3;
+    }
+  }
+  else if constexpr (out_format == HostDisplayPixelFormat::RGB565)
+  {
+    u16* dst_row_ptr = reinterpret_cast<u16*>(dst_ptr) + col;
+    for (; col < width; col++)
+    {
+      *(dst_row_ptr++) = ((static_cast<u16>(src_ptr[0]) >> 3) << 11) | ((static_cast<u16>(src_ptr[1]) >> 2) << 5) |
+                         (static_cast<u16>(src_ptr[2]) >> 3);
+      src_ptr += 3;
+    }
+  }
+  else if constexpr (out_format == HostDisplayPixelFormat::RGBA5551)
+  {
+    u16* dst_row_ptr = reinterpret_cast<u16*>(dst_ptr) + col;
+    for (; col < width; col++)
+    {
+      *(dst_row_ptr++) = ((static_cast<u16>(src_ptr[0]) >> 3) << 10) | ((static_cast<u16>(src_ptr[1]) >> 3) << 5) |
+                         (static_cast<u16>(src_ptr[2]) >> 3);
+      src_ptr += 3;
+    }
+  }
+}
+
+template<HostDisplayPixelFormat display_format>
+void GPU_SW_Backend::CopyOut15Bit(u32 src_x, u32 src_y, u32 width, u32 height, u32 field, bool interlaced,
+                                  bool interleaved, const HazardTileRowMask& dirty_rows, DisplayBuffer* buffer)
+{
+  u8* dst_ptr;
+  u32 dst_stride;
+
+  using OutputPixelType = std::conditional_t<
+    display_format == HostDisplayPixelFormat::RGBA8 || display_format == HostDisplayPixelFormat::BGRA8, u32, u16>;
+
+  if (!interlaced)
+  {
+    dst_stride = Common::AlignUpPow2<u32>(width * sizeof(OutputPixelType), 4);
+    dst_ptr = buffer->pixels.get();
+  }
+  else
+  {
+    dst_stride = GPU_MAX_DISPLAY_WIDTH * sizeof(OutputPixelType);
+    dst_ptr = m_display_interlaced_buffer.get() + (field != 0 ? dst_stride : 0);
+  }
+
+  const u32 output_stride = dst_stride;
+  const u8 interlaced_shift = BoolToUInt8(interlaced);
+  const u8 interleaved_shift = BoolToUInt8(interleaved);
+
+  // Fast path when not wrapping around.
+  if ((src_x + width) <= VRAM_WIDTH && (src_y + height) <= VRAM_HEIGHT)
+  {
+    const u32 rows = height >> interlaced_shift;
+    dst_stride <<= interlaced_shift;
+
+    const u16* src_ptr = &m_vram_ptr[src_y * VRAM_WIDTH + src_x];
+    const u32 src_step = VRAM_WIDTH << interleaved_shift;
+    for (u32 row = 0; row < rows; row++)
+    {
+      if (dirty_rows[(src_y + (row << interleaved_shift)) / HAZARD_TILE_HEIGHT])
+        CopyOutRow16<display_format>(src_ptr, reinterpret_cast<OutputPixelType*>(dst_ptr), width);
+
+      src_ptr += src_step;
+      dst_ptr += dst_stride;
+    }
+  }
+  else
+  {
+    const u32 rows = height >> interlaced_shift;
+    dst_stride <<= interlaced_shift;
+
+    const u32 end_x = src_x + width;
+    for (u32 row = 0; row < rows; row++, src_y += (1 << interleaved_shift), dst_ptr += dst_stride)
+    {
+      if (!dirty_rows[(src_y % VRAM_HEIGHT) / HAZARD_TILE_HEIGHT])
+        continue;
+
+      const u16* src_row_ptr = &m_vram_ptr[(src_y % VRAM_HEIGHT) * VRAM_WIDTH];
+      OutputPixelType* dst_row_ptr = reinterpret_cast<OutputPixelType*>(dst_ptr);
+
+      for (u32 col = src_x; col < end_x; col++)
+        *(dst_row_ptr++) = VRAM16ToOutput<display_format, OutputPixelType>(src_row_ptr[col % VRAM_WIDTH]);
+    }
+  }
+
+  SetDisplayBufferPixels(buffer, display_format, width, height, width * sizeof(OutputPixelType), output_stride,
+                         interlaced);
+}
+
+void GPU_SW_Backend::CopyOut15Bit(HostDisplayPixelFormat display_format, u32 src_x, u32 src_y, u32 width, u32 height,
+                                  u32 field, bool interlaced, bool interleaved, const HazardTileRowMask& dirty_rows,
+                                  DisplayBuffer* buffer)
+{
+  switch (display_format)
+  {
+    case HostDisplayPixelFormat::RGBA5551:
+      CopyOut15Bit<HostDisplayPixelFormat::RGBA5551>(src_x, src_y, width, height, field, interlaced, interleaved,
+                                                     dirty_rows, buffer);
+      break;
+    case HostDisplayPixelFormat::RGB565:
+      CopyOut15Bit<HostDisplayPixelFormat::RGB565>(src_x, src_y, width, height, field, interlaced, interleaved,
+                                                   dirty_rows, buffer);
+      break;
+    case HostDisplayPixelFormat::RGBA8:
+      CopyOut15Bit<HostDisplayPixelFormat::RGBA8>(src_x, src_y, width, height, field, interlaced, interleaved,
+                                                  dirty_rows, buffer);
+      break;
+    case HostDisplayPixelFormat::BGRA8:
+      CopyOut15Bit<HostDisplayPixelFormat::BGRA8>(src_x, src_y, width, height, field, interlaced, interleaved,
+                                                  dirty_rows, buffer);
+      break;
+    default:
+      break;
+  }
+}
+
+template<HostDisplayPixelFormat display_format>
+void GPU_SW_Backend::CopyOut15BitScaled(u32 src_x, u32 src_y, u32 width, u32 height, u32 field, bool interlaced,
+                                        bool interleaved, const HazardTileRowMask& dirty_rows, DisplayBuffer* buffer)
+{
+  using OutputPixelType = std::conditional_t<
+    display_format == HostDisplayPixelFormat::RGBA8 || display_format == HostDisplayPixelFormat::BGRA8, u32, u16>;
+
+  // Each line of the display is scale lines of the scaled VRAM, dirty rows are still tracked in native rows.
+  const u32 scale = m_resolution_scale;
+  const u32 scaled_width = width * scale;
+  const u32 row_size = scaled_width * sizeof(OutputPixelType);
+
+  u8* dst_ptr;
+  u32 dst_stride;
+  if (!interlaced)
+  {
+    dst_stride = Common::AlignUpPow2<u32>(row_size, 4);
+    dst_ptr = buffer->pixels.get();
+  }
+  else
+  {
+    dst_stride = GPU_MAX_DISPLAY_WIDTH * scale * sizeof(OutputPixelType);
+    dst_ptr = m_display_interlaced_buffer.get() + (field != 0 ? (dst_stride * scale) : 0);
+  }
+
+  const u32 output_stride = dst_stride;
+  const u8 interlaced_shift = BoolToUInt8(interlaced);
+  const u8 interleaved_shift = BoolToUInt8(interleaved);
+  const u32 rows = height >> interlaced_shift;
+  const u32 line_stride = (dst_stride * scale) << interlaced_shift;
+  const bool wraps = (src_x + width) > VRAM_WIDTH;
+
+  for (u32 row = 0; row < rows; row++, dst_ptr += line_stride)
+  {
+    const u32 vram_row = (src_y + (row << interleaved_shift)) % VRAM_HEIGHT;
+    if (!dirty_rows[vram_row / HAZARD_TILE_HEIGHT])
+      continue;
+
+    for (u32 i = 0; i < scale; i++)
+    {
+      const u16* src_row_ptr = &m_scaled_vram[((vram_row * scale) + i) * m_scaled_vram_width];
+      OutputPixelType* dst_row_ptr = reinterpret_cast<OutputPixelType*>(dst_ptr + (i * dst_stride));
+      if (!wraps)
+      {
+        CopyOutRow16<display_format>(src_row_ptr + (src_x * scale), dst_row_ptr, scaled_width);
+        continue;
+      }
+
+      for (u32 col = src_x * scale; col < ((src_x + width) * scale); col++)
+        *(dst_row_ptr++) = VRAM16ToOutput<display_format, OutputPixelType>(src_row_ptr[col % m_scaled_vram_width]);
+    }
+  }
+
+  SetDisplayBufferPixels(buffer, display_format, scaled_width, height * scale, row_size, output_stride, interlaced);
+}
+
+void GPU_SW_Backend::CopyOut15BitScaled(HostDisplayPixelFormat display_format, u32 src_x, u32 src_y, u32 width,
+                                        u32 height, u32 field, bool interlaced, bool interleaved,
+                                        const HazardTileRowMask& dirty_rows, DisplayBuffer* buffer)
+{
+  switch (display_format)
+  {
+    case HostDisplayPixelFormat::RGBA5551:
+      CopyOut15BitScaled<HostDisplayPixelFormat::RGBA5551>(src_x, src_y, width, height, field, interlaced,
+                                                           interleaved, dirty_rows, buffer);
+      break;
+    case HostDisplayPixelFormat::RGB565:
+      CopyOut15BitScaled<HostDisplayPixelFormat::RGB565>(src_x, src_y, width, height, field, interlaced, interleaved,
+                                                         dirty_rows, buffer);
+      break;
+    case HostDisplayPixelFormat::RGBA8:
+      CopyOut15BitScaled<HostDisplayPixelFormat::RGBA8>(src_x, src_y, width, height, field, interlaced, interleaved,
+                                                        dirty_rows, buffer);
+      break;
+    case HostDisplayPixelFormat::BGRA8:
+      CopyOut15BitScaled<HostDisplayPixelFormat::BGRA8>(src_x, src_y, width, height, field, interlaced, interleaved,
+                                                        dirty_rows, buffer);
+      break;
+    default:
+      break;
+  }
+}
+
+template<HostDisplayPixelFormat display_format>
+void GPU_SW_Backend::CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 field,
+                                  bool interlaced, bool interleaved, const HazardTileRowMask& dirty_rows,
+                                  DisplayBuffer* buffer)
+{
+  u8* dst_ptr;
+  u32 dst_stride;
+
+  using OutputPixelType = std::conditional_t<
+    display_format == HostDisplayPixelFormat::RGBA8 || display_format == HostDisplayPixelFormat::BGRA8, u32, u16>;
+
+  dst_stride = Common::AlignUpPow2<u32>(width * sizeof(OutputPixelType), 4);
+  dst_ptr = interlaced ? (m_display_interlaced_buffer.get() + (field != 0 ? dst_stride : 0)) : buffer->pixels.get();
+
+  const u32 output_stride = dst_stride;
+  const u8 interlaced_shift = BoolToUInt8(interlaced);
+  const u8 interleaved_shift = BoolToUInt8(interleaved);
+  const u32 rows = height >> interlaced_shift;
+  dst_stride <<= interlaced_shift;
+
+  if ((src_x + width) <= VRAM_WIDTH && (src_y + (rows << interleaved_shift)) <= VRAM_HEIGHT)
+  {
+    const u8* src_ptr = reinterpret_cast<const u8*>(&m_vram_ptr[src_y * VRAM_WIDTH + src_x]) + (skip_x * 3);
+    const u8* src_end = reinterpret_cast<const u8*>(&m_vram_ptr[VRAM_WIDTH * VRAM_HEIGHT]);
+    const u32 src_stride = (VRAM_WIDTH << interleaved_shift) * sizeof(u16);
+    const bool use_sse41 = CPUFeatures::HasSSE41();
+    for (u32 row = 0; row < rows; row++)
+    {
+      if (dirty_rows[(src_y + (row << interleaved_shift)) / HAZARD_TILE_HEIGHT])
+        CopyOutRow24<display_format>(src_ptr, dst_ptr, width, src_end, use_sse41);
+
+      src_ptr += src_stride;
+      dst_ptr += dst_stride;
+    }
+  }
+  else
+  {
+    for (u32 row = 0; row < rows; row++, src_y += (1 << interleaved_shift), dst_ptr += dst_stride)
+    {
+      if (!dirty_rows[(src_y % VRAM_HEIGHT) / HAZARD_TILE_HEIGHT])
+        continue;
+
+      const u16* src_row_ptr = &m_vram_ptr[(src_y % VRAM_HEIGHT) * VRAM_WIDTH];
+      OutputPixelType* dst_row_ptr = reinterpret_cast<OutputPixelType*>(dst_ptr);
+
+      for (u32 col = 0; col < width; col++)
+      {
+        const u32 offset = (src_x + (((skip_x + col) * 3) / 2));
+        const u16 s0 = src_row_ptr[offset % VRAM_WIDTH];
+        const u16 s1 = src_row_ptr[(offset + 1) % VRAM_WIDTH];
+        const u8 shift = static_cast<u8>(col & 1u) * 8;
+        const u32 rgb = (((ZeroExtend32(s1) << 16) | ZeroExtend32(s0)) >> shift);
+
+        if constexpr (display_format == HostDisplayPixelFormat::RGBA8)
+        {
+          *(dst_row_ptr++) = rgb | 0xFF000000u;
+        }
+        else if constexpr (display_format == HostDisplayPixelFormat::BGRA8)
+        {
+          *(dst_row_ptr++) = (rgb & 0x00FF00) | ((rgb & 0xFF) << 16) | ((rgb >> 16) & 0xFF) | 0xFF000000u;
+        }
+        else if constexpr (display_format == HostDisplayPixelFormat::RGB565)
+        {
+          *(dst_row_ptr++) = ((rgb >> 3) & 0x1F) | (((rgb >> 10) << 5) & 0x7E0) | (((rgb >> 19) << 11) & 0x3E0000);
+        }
+        else if constexpr (display_format == HostDisplayPixelFormat::RGBA5551)
+        {
+          *(dst_row_ptr++) = ((rgb >> 3) & 0x1F) | (((rgb >> 11) << 5) & 0x3E0) | (((rgb >> 19) << 10) & 0x1F0000);
+        }
+      }
+    }
+  }
+
+  SetDisplayBufferPixels(buffer, display_format, width, height, width * sizeof(OutputPixelType), output_stride,
+                         interlaced);
+}
+
+void GPU_SW_Backend::CopyOut24Bit(HostDisplayPixelFormat display_format, u32 src_x, u32 src_y, u32 skip_x,
+                                  u32 width, u32 height, u32 field, bool interlaced, bool interleaved,
+                                  const HazardTileRowMask& dirty_rows, DisplayBuffer* buffer)
+{
+  switch (display_format)
+  {
+    case HostDisplayPixelFormat::RGBA5551:
+      CopyOut24Bit<HostDisplayPixelFormat::RGBA5551>(src_x, src_y, skip_x, width, height, field, interlaced,
+                                                     interleaved, dirty_rows, buffer);
+      break;
+    case HostDisplayPixelFormat::RGB565:
+      CopyOut24Bit<HostDisplayPixelFormat::RGB565>(src_x, src_y, skip_x, width, height, field, interlaced,
+                                                   interleaved, dirty_rows, buffer);
+      break;
+    case HostDisplayPixelFormat::RGBA8:
+      CopyOut24Bit<HostDisplayPixelFormat::RGBA8>(src_x, src_y, skip_x, width, height, field, interlaced,
+                                                  interleaved, dirty_rows, buffer);
+      break;
+    case HostDisplayPixelFormat::BGRA8:
+      CopyOut24Bit<HostDisplayPixelFormat::BGRA8>(src_x, src_y, skip_x, width, height, field, interlaced,
+                                                  interleaved, dirty_rows, buffer);
+      break;
+    default:
+      break;
+  }
+}
+
+GPU_SW_Backend::HazardTileRowMask GPU_SW_Backend::GetDisplayDirtyRows(const GPUBackendUpdateDisplayCommand* cmd,
+                                                                     DisplayBufferSource* source)
+{
+  HazardTileRowMask dirty_rows;
+
+  // Interlaced frames are assembled in a separate buffer, and copied to the display buffer every time.
+  if (!source->valid || cmd->interlaced || source->format != cmd->format || source->src_x != cmd->src_x ||
+      source->src_y != cmd->src_y || source->skip_x != cmd->skip_x || source->width != cmd->width ||
+      source->height != cmd->height || source->display_24bit != cmd->display_24bit ||
+      source->interleaved != cmd->interleaved)
+  {
+    dirty_rows.set();
+    source->format = cmd->format;
+    source->src_x = cmd->src_x;
+    source->src_y = cmd->src_y;
+    source->skip_x = cmd->skip_x;
+    source->width = cmd->width;
+    source->height = cmd->height;
+    source->display_24bit = cmd->display_24bit;
+    source->interleaved = cmd->interleaved;
+    source->valid = !cmd->interlaced;
+  }
+  else
+  {
+    // Only the displayed columns matter. 24-bit pixels are 1.5 VRAM pixels wide.
+    const u32 vram_width =
+      cmd->display_24bit ? ((((ZeroExtend32(cmd->skip_x) + cmd->width) * 3) / 2) + 1) : ZeroExtend32(cmd->width);
+    HazardTileMask display_tiles;
+    IncludeHazardTiles(&display_tiles, cmd->src_x, 0, vram_width, VRAM_HEIGHT);
+
+    const HazardTileMask dirty_tiles = source->dirty_tiles & display_tiles;
+    for (u32 tile_y = 0; tile_y < HAZARD_TILES_Y; tile_y++)
+    {
+      for (u32 tile_x = 0; tile_x < HAZARD_TILES_X && !dirty_rows[tile_y]; tile_x++)
+        dirty_rows[tile_y] = dirty_tiles[tile_y * HAZARD_TILES_X + tile_x];
+    }
+
+    // The 24-bit fast path reads past the right edge of VRAM into the start of the next row.
+    if (cmd->display_24bit && (cmd->src_x + vram_width) > VRAM_WIDTH)
+      dirty_rows |= (dirty_rows >> 1);
+  }
+
+  source->dirty_tiles.reset();
+  return dirty_rows;
+}
+
+void GPU_SW_Backend::SetDisplayBufferPixels(DisplayBuffer* buffer, HostDisplayPixelFormat format, u32 width,
+                                            u32 height, u32 row_size, u32 stride, bool interlaced)
+{
+  buffer->format = format;
+  buffer->width = width;
+  buffer->height = height;
+
+  if (!interlaced)
+  {
+    buffer->stride = stride;
+    return;
+  }
+
+  // The other field has to stay in the interlaced buffer for the next frame, so take a copy of both.
+  buffer->stride = Common::AlignUpPow2<u32>(row_size, 4);
+
+  const u8* src_ptr = m_display_interlaced_buffer.get();
+  u8* dst_ptr = buffer->pixels.get();
+  for (u32 row = 0; row < height; row++)
+  {
+    std::memcpy(dst_ptr, src_ptr, row_size);
+    src_ptr += stride;
+    dst_ptr += buffer->stride;
+  }
+}
+
+void GPU_SW_Backend::UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd)
+{
+  const u32 buffer_size = DISPLAY_BUFFER_SIZE * m_resolution_scale * m_resolution_scale;
+  if (!m_display_interlaced_buffer)
+    m_display_interlaced_buffer = std::make_unique<u8[]>(buffer_size);
+  if (cmd->clear_interlaced_buffer)
+    std::memset(m_display_interlaced_buffer.get(), 0, buffer_size);
+
+  DisplayBuffer* buffer = &m_display_buffers[m_display_write_index];
+  if (!buffer->pixels)
+    buffer->pixels = std::make_unique<u8[]>(buffer_size);
+
+  buffer->format = cmd->format;
+  buffer->width = cmd->width;
+  buffer->height = cmd->height;
+  buffer->resolution_scale = 1;
+  buffer->display_width = cmd->display_width;
+  buffer->display_height = cmd->display_height;
+  buffer->display_origin_left = cmd->display_origin_left;
+  buffer->display_origin_top = cmd->display_origin_top;
+  buffer->display_aspect_ratio = cmd->display_aspect_ratio;
+  buffer->enabled = !cmd->display_disabled;
+
+  if (buffer->enabled)
+  {
+    const HazardTileRowMask dirty_rows = GetDisplayDirtyRows(cmd, &m_display_buffer_sources[m_display_write_index]);
+    if (cmd->display_24bit)
+    {
+      // 24-bit pixels straddle VRAM pixels, so upscaling VRAM doesn't upscale them. They come from native VRAM.
+      CopyOut24Bit(cmd->format, cmd->src_x, cmd->src_y, cmd->skip_x, cmd->width, cmd->height, cmd->field,
+                   cmd->interlaced, cmd->interleaved, dirty_rows, buffer);
+    }
+    else if (m_resolution_scale > 1)
+    {
+      CopyOut15BitScaled(cmd->format, cmd->src_x, cmd->src_y, cmd->width, cmd->height, cmd->field, cmd->interlaced,
+                         cmd->interleaved, dirty_rows, buffer);
+      buffer->resolution_scale = m_resolution_scale;
+    }
+    else
+    {
+      CopyOut15Bit(cmd->format, cmd->src_x, cmd->src_y, cmd->width, cmd->height, cmd->field, cmd->interlaced,
+                   cmd->interleaved, dirty_rows, buffer);
+    }
+  }
+
+  PostProcessDisplay(buffer, cmd->display_24bit);
+
+  // Publish the frame, and continue with whichever buffer isn't being presented.
+  m_display_write_index =
+    m_display_ready_index.exchange(m_display_write_index | DISPLAY_BUFFER_READY_BIT, std::memory_order_acq_rel) &
+    DISPLAY_BUFFER_INDEX_MASK;
+
+  PublishRenderStats();
+}
+
+const GPU_SW_Backend::DisplayBuffer* GPU_SW_Backend::GetDisplayBuffer()
+{
+  if (m_display_ready_index.load(std::memory_order_relaxed) & DISPLAY_BUFFER_READY_BIT)
+  {
+    m_display_read_index =
+      m_display_ready_index.exchange(m_display_read_index, std::memory_order_acq_rel) & DISPLAY_BUFFER_INDEX_MASK;
+  }
+
+  const DisplayBuffer* buffer = &m_display_buffers[m_display_read_index];
+  return buffer->pixels ? buffer : nullptr;
+}
+
+template<HostDisplayPixelFormat format>
+static void UnpackDisplayRow(const u8* src_ptr, u8* dst_ptr, u32 width)
+{
+  // Expand to the RGBA8 layout, replicating the top bits so that packing it again is lossless.
+  for (u32 col = 0; col < width; col++)
+  {
+    u16 value;
+    std::memcpy(&value, src_ptr, sizeof(value));
+    src_ptr += sizeof(value);
+
+    u32 r, g, b;
+    if constexpr (format == HostDisplayPixelFormat::RGB565)
+    {
+      r = (value >> 11) & 0x1F;
+      g = (value >> 5) & 0x3F;
+      b = value & 0x1F;
+      g = (g << 2) | (g >> 4);
+    }
+    else
+    {
+      r = (value >> 10) & 0x1F;
+      g = (value >> 5) & 0x1F;
+      b = value & 0x1F;
+      g = (g << 3) | (g >> 2);
+    }
+
+    dst_ptr[0] = static_cast<u8>((r << 3) | (r >> 2));
+    dst_ptr[1] = static_cast<u8>(g);
+    dst_ptr[2] = static_cast<u8>((b << 3) | (b >> 2));
+    dst_ptr[3] = 0xFF;
+    dst_ptr += sizeof(u32);
+  }
+}
+
+template<HostDisplayPixelFormat format>
+static void PackDisplayRow(const u8* src_ptr, u8* dst_ptr, u32 width)
+{
+  for (u32 col = 0; col < width; col++)
+  {
+    u16 value;
+    if constexpr (format == HostDisplayPixelFormat::RGB565)
+      value = static_cast<u16>(((src_ptr[0] >> 3) << 11) | ((src_ptr[1] >> 2) << 5) | (src_ptr[2] >> 3));
+    else
+      value = static_cast<u16>(((src_ptr[0] >> 3) << 10) | ((src_ptr[1] >> 3) << 5) | (src_ptr[2] >> 3));
+
+    std::memcpy(dst_ptr, &value, sizeof(value));
+    src_ptr += sizeof(u32);
+    dst_ptr += sizeof(value);
+  }
+}
+
+// The display area is in native pixels, and has to match the image which is presented.
+static void ScaleDisplayArea(GPU_SW_Backend::DisplayBuffer* buffer, u32 scale)
+{
+  buffer->display_width *= static_cast<s32>(scale);
+  buffer->display_height *= static_cast<s32>(scale);
+  buffer->display_origin_left *= static_cast<s32>(scale);
+  buffer->display_origin_top *= static_cast<s32>(scale);
+}
+
+void GPU_SW_Backend::PostProcessDisplay(DisplayBuffer* buffer, bool display_24bit)
+{
+  buffer->output_pixels = buffer->pixels.get();
+  buffer->output_width = buffer->width;
+  buffer->output_height = buffer->height;
+  buffer->output_stride = buffer->stride;
+
+  // Adaptive downsampling relies on the hardware renderers' mip chain to tell 2D and 3D apart, so both modes are a
+  // box filter here.
+  const u32 downsample_factor =
+    (m_display_downsample_mode != GPUDownsampleMode::Disabled) ? buffer->resolution_scale : 1u;
+  const bool chroma_smoothing = m_display_chroma_smoothing && display_24bit;
+  if (!buffer->enabled || buffer->width == 0 || buffer->height == 0 ||
+      (downsample_factor == 1 && !chroma_smoothing && m_display_scale == 1))
+  {
+    ScaleDisplayArea(buffer, buffer->resolution_scale);
+    return;
+  }
+
+  const bool packed_16bit =
+    (buffer->format == HostDisplayPixelFormat::RGB565 || buffer->format == HostDisplayPixelFormat::RGBA5551);
+
+  DisplayFilterImage image = {buffer->pixels.get(), buffer->width, buffer->height, buffer->stride};
+  if (packed_16bit)
+    image = UnpackDisplayImage(image, buffer->format);
+  if (downsample_factor > 1)
+    image = DownsampleDisplayImage(image, downsample_factor);
+  if (chroma_smoothing)
+    image = SmoothDisplayChroma(image, buffer->format == HostDisplayPixelFormat::BGRA8);
+  if (m_display_scale > 1)
+    image = UpscaleDisplayImage(image, m_display_scale, m_display_scale_filter);
+
+  if (packed_16bit)
+  {
+    PackDisplayImage(image, buffer->format, buffer);
+  }
+  else
+  {
+    // The image is in one of the scratch frames, so give that to the display buffer rather than copying it.
+    std::vector<u8>& frame =
+      m_display_filter_frames[(image.pixels == m_display_filter_frames[0].data()) ? 0 : 1];
+    buffer->filtered_pixels.swap(frame);
+    buffer->output_stride = image.stride;
+  }
+
+  buffer->output_pixels = buffer->filtered_pixels.data();
+  buffer->output_width = image.width;
+  buffer->output_height = image.height;
+  ScaleDisplayArea(buffer, (buffer->resolution_scale / downsample_factor) * m_display_scale);
+}
+
+u8* GPU_SW_Backend::GetDisplayFilterFrame(u32 width, u32 height)
+{
+  std::vector<u8>& frame = m_display_filter_frames[m_display_filter_frame_index];
+  m_display_filter_frame_index ^= 1;
+  frame.resize(width * height * sizeof(u32));
+  return frame.data();
+}
+
+GPU_SW_Backend::DisplayFilterImage GPU_SW_Backend::UnpackDisplayImage(const DisplayFilterImage& src,
+                                                                      HostDisplayPixelFormat format)
+{
+  const u32 stride = src.width * sizeof(u32);
+  u8* dst = GetDisplayFilterFrame(src.width, src.height);
+  for (u32 row = 0; row < src.height; row++)
+  {
+    const u8* src_row_ptr = src.pixels + row * src.stride;
+    u8* dst_row_ptr = dst + row * stride;
+    if (format == HostDisplayPixelFormat::RGB565)
+      UnpackDisplayRow<HostDisplayPixelFormat::RGB565>(src_row_ptr, dst_row_ptr, src.width);
+    else
+      UnpackDisplayRow<HostDisplayPixelFormat::RGBA5551>(src_row_ptr, dst_row_ptr, src.width);
+  }
+
+  return DisplayFilterImage{dst, src.width, src.height, stride};
+}
+
+void GPU_SW_Backend::PackDisplayImage(const DisplayFilterImage& src, HostDisplayPixelFormat format,
+                                      DisplayBuffer* buffer)
+{
+  const u32 stride = Common::AlignUpPow2<u32>(src.width * sizeof(u16), 4);
+  buffer->filtered_pixels.resize(stride * src.height);
+  buffer->output_stride = stride;
+
+  u8* dst = buffer->filtered_pixels.data();
+  for (u32 row = 0; row < src.height; row++)
+  {
+    const u8* src_row_ptr = src.pixels + row * src.stride;
+    u8* dst_row_ptr = dst + row * stride;
+    if (format == HostDisplayPixelFormat::RGB565)
+      PackDisplayRow<HostDisplayPixelFormat::RGB565>(src_row_ptr, dst_row_ptr, src.width);
+    else
+      PackDisplayRow<HostDisplayPixelFormat::RGBA5551>(src_row_ptr, dst_row_ptr, src.width);
+  }
+}
+
+GPU_SW_Backend::DisplayFilterImage GPU_SW_Backend::DownsampleDisplayImage(const DisplayFilterImage& src, u32 factor)
+{
+  const u32 width = src.width / factor;
+  const u32 height = src.height / factor;
+  if (width == 0 || height == 0)
+    return src;
+
+  // Rows are summed with the vector code. The sums are at most 255 * factor, and factor * factor * 255 still fits in
+  // 16 bits for any scale we render at.
+  const u32 stride = width * sizeof(u32);
+  const u32 src_row_size = stride * factor;
+  const u32 area = factor * factor;
+  m_display_filter_sums.resize(src_row_size);
+
+  u8* dst = GetDisplayFilterFrame(width, height);
+  for (u32 row = 0; row < height; row++)
+  {
+    std::fill(m_display_filter_sums.begin(), m_display_filter_sums.end(), static_cast<u16>(0));
+    for (u32 i = 0; i < factor; i++)
+    {
+      m_display_filter_functions->accumulate_row(m_display_filter_sums.data(),
+                                                 src.pixels + (row * factor + i) * src.stride, src_row_size);
+    }
+
+    const u16* sum_ptr = m_display_filter_sums.data();
+    u8* dst_row_ptr = dst + row * stride;
+    for (u32 col = 0; col < width; col++)
+    {
+      for (u32 channel = 0; channel < sizeof(u32); channel++)
+      {
+        u32 sum = 0;
+        for (u32 i = 0; i < factor; i++)
+          sum += sum_ptr[i * sizeof(u32) + channel];
+
+        *(dst_row_ptr++) = static_cast<u8>((sum + (area / 2)) / area);
+      }
+
+      sum_ptr += factor * sizeof(u32);
+    }
+  }
+
+  return DisplayFilterImage{dst, width, height, stride};
+}
+
+GPU_SW_Backend::DisplayFilterImage GPU_SW_Backend::SmoothDisplayChroma(const DisplayFilterImage& src, bool bgr)
+{
+  // Same idea as the hardware renderers' shader: chroma is taken from the neighbouring pixels and luma from the pixel
+  // itself. Y has a weight of one in each of R, G and B when converting back, so replacing the luma of the blurred
+  // pixel is the same as adding the difference to each channel.
+  const u32 luma_weights[3] = {bgr ? 29u : 77u, 150u, bgr ? 77u : 29u};
+  const u32 stride = src.width * sizeof(u32);
+  u8* dst = GetDisplayFilterFrame(src.width, src.height);
+
+  // The vertically blurred row has a pixel of padding at each end for the horizontal pass.
+  m_display_filter_rows.resize(stride + sizeof(u32) * 2);
+  u8* blurred_row_ptr = m_display_filter_rows.data() + sizeof(u32);
+
+  for (u32 row = 0; row < src.height; row++)
+  {
+    const u8* src_row_ptr = src.pixels + row * src.stride;
+    const u8* above_row_ptr = src.pixels + ((row > 0) ? (row - 1) : row) * src.stride;
+    const u8* below_row_ptr = src.pixels + std::min(row + 1, src.height - 1) * src.stride;
+    u8* dst_row_ptr = dst + row * stride;
+
+    m_display_filter_functions->blur_rows(blurred_row_ptr, above_row_ptr, src_row_ptr, below_row_ptr, stride);
+    std::memcpy(blurred_row_ptr - sizeof(u32), blurred_row_ptr, sizeof(u32));
+    std::memcpy(blurred_row_ptr + stride, blurred_row_ptr + stride - sizeof(u32), sizeof(u32));
+    m_display_filter_functions->blur_columns(dst_row_ptr, blurred_row_ptr, stride);
+
+    for (u32 col = 0; col < src.width; col++)
+    {
+      s32 luma_delta = 128;
+      for (u32 channel = 0; channel < 3; channel++)
+        luma_delta += static_cast<s32>(luma_weights[channel]) * (src_row_ptr[channel] - dst_row_ptr[channel]);
+      luma_delta >>= 8;
+
+      for (u32 channel = 0; channel < 3; channel++)
+        dst_row_ptr[channel] = static_cast<u8>(std::clamp<s32>(dst_row_ptr[channel] + luma_delta, 0, 255));
+
+      src_row_ptr += sizeof(u32);
+      dst_row_ptr += sizeof(u32);
+    }
+  }
+
+  return DisplayFilterImage{dst, src.width, src.height, stride};
+}
+
+GPU_SW_Backend::DisplayFilterImage GPU_SW_Backend::UpscaleDisplayImage(const DisplayFilterImage& src, u32 factor,
+                                                                       GPUDisplayScaleFilter filter)
+{
+  // Each output pixel within a source pixel blends the source pixel at tap_offsets with the next one. Sharp bilinear
+  // only blends over the outermost output pixel at each edge, and uses the nearest source pixel for the rest.
+  std::array<s32, MAX_DISPLAY_SCALE> tap_offsets;
+  std::array<u8, MAX_DISPLAY_SCALE> tap_weights;
+  bool blend = false;
+  for (u32 i = 0; i < factor; i++)
+  {
+    const float position = ((static_cast<float>(i) + 0.5f) / static_cast<float>(factor)) - 0.5f;
+    float sample_position;
+    switch (filter)
+    {
+      case GPUDisplayScaleFilter::Bilinear:
+        sample_position = position;
+        break;
+
+      case GPUDisplayScaleFilter::SharpBilinear:
+      {
+        const float region = std::max(0.5f - (1.0f / static_cast<float>(factor)), 0.0f);
+        sample_position = (position - std::clamp(position, -region, region)) * static_cast<float>(factor);
+      }
+      break;
+
+      case GPUDisplayScaleFilter::Nearest:
+      default:
+        sample_position = 0.0f;
+        break;
+    }
+
+    static constexpr float weight_scale = static_cast<float>(GPU_SW_SIMD::DISPLAY_FILTER_WEIGHT_ONE);
+    s32 offset = static_cast<s32>(std::floor(sample_position));
+    u32 weight = static_cast<u32>(std::lround((sample_position - static_cast<float>(offset)) * weight_scale));
+    if (weight >= GPU_SW_SIMD::DISPLAY_FILTER_WEIGHT_ONE)
+    {
+      offset++;
+      weight = 0;
+    }
+
+    tap_offsets[i] = offset;
+    tap_weights[i] = static_cast<u8>(weight);
+    blend |= (weight != 0);
+  }
+
+  const u32 width = src.width * factor;
+  const u32 height = src.height * factor;
+  const u32 stride = width * sizeof(u32);
+  const s32 last_col = static_cast<s32>(src.width) - 1;
+  const s32 last_row = static_cast<s32>(src.height) - 1;
+
+  // Scale horizontally first, so the vertical pass can blend whole rows. The left and right rows hold the two pixels
+  // which are blended for each output pixel, and the weight row the weight of the right one for each byte.
+  m_display_filter_rows.resize(stride * 3);
+  u32* left_row_ptr = reinterpret_cast<u32*>(m_display_filter_rows.data());
+  u32* right_row_ptr = left_row_ptr + width;
+  u8* weight_row_ptr = reinterpret_cast<u8*>(right_row_ptr + width);
+  for (u32 col = 0; col < width; col++)
+    std::memset(&weight_row_ptr[col * sizeof(u32)], tap_weights[col % factor], sizeof(u32));
+
+  u8* expanded = GetDisplayFilterFrame(width, src.height);
+  for (u32 row = 0; row < src.height; row++)
+  {
+    const u32* src_row_ptr = reinterpret_cast<const u32*>(src.pixels + row * src.stride);
+    u8* expanded_row_ptr = expanded + row * stride;
+    u32* dst_ptr = blend ? left_row_ptr : reinterpret_cast<u32*>(expanded_row_ptr);
+    for (u32 col = 0; col < src.width; col++)
+    {
+      for (u32 i = 0; i < factor; i++)
+      {
+        const s32 tap_col = static_cast<s32>(col) + tap_offsets[i];
+        dst_ptr[col * factor + i] = src_row_ptr[std::clamp(tap_col, 0, last_col)];
+        if (blend)
+          right_row_ptr[col * factor + i] = src_row_ptr[std::clamp(tap_col + 1, 0, last_col)];
+      }
+    }
+
+    if (blend)
+    {
+      m_display_filter_functions->lerp_columns(expanded_row_ptr, reinterpret_cast<const u8*>(left_row_ptr),
+                                               reinterpret_cast<const u8*>(right_row_ptr), weight_row_ptr, stride);
+    }
+  }
+
+  // The source image isn't read after this, so the output can go in its frame.
+  u8* dst = GetDisplayFilterFrame(width, height);
+  for (u32 row = 0; row < src.height; row++)
+  {
+    for (u32 i = 0; i < factor; i++)
+    {
+      const s32 tap_row = static_cast<s32>(row) + tap_offsets[i];
+      const u8* top_row_ptr = expanded + std::clamp(tap_row, 0, last_row) * stride;
+      u8* dst_row_ptr = dst + (row * factor + i) * stride;
+      if (tap_weights[i] == 0)
+      {
+        std::memcpy(dst_row_ptr, top_row_ptr, stride);
+      }
+      else
+      {
+        const u8* bottom_row_ptr = expanded + std::clamp(tap_row + 1, 0, last_row) * stride;
+        m_display_filter_functions->lerp_rows(dst_row_ptr, top_row_ptr, bottom_row_ptr, stride, tap_weights[i]);
+      }
+    }
+  }
+
+  return DisplayFilterImage{dst, width, height, stride};
+}
+
+GPU_SW_Backend::RenderBand GPU_SW_Backend::GetFullBand() const
+{
+  return RenderBand{m_drawing_area, 0, VRAM_HEIGHT - 1};
+}
+
+void GPU_SW_Backend::StartRenderThreads(u32 count)
+{
+  count = std::max<u32>(count, 1u);
+  m_render_bands.resize(count);
+  m_render_generation = 0;
+  m_render_threads_busy = 0;
+  m_render_threads_shutdown = false;
+
+  // The backend thread renders the first band itself.
+  for (u32 i = 1; i < count; i++)
+    m_render_threads.emplace_back(&GPU_SW_Backend::RenderThreadEntryPoint, this, i);
+
+  if (count > 1)
+    Log_InfoPrintf("Using %u threads for software rendering", count);
+}
+
+void GPU_SW_Backend::StopRenderThreads()
+{
+  if (m_render_threads.empty())
+    return;
+
+  FlushRender();
+
+  {
+    std::unique_lock<std::mutex> lock(m_render_mutex);
+    m_render_threads_shutdown = true;
+  }
+  m_render_start_cv.notify_all();
+
+  for (std::thread& thread : m_render_threads)
+    thread.join();
+
+  m_render_threads.clear();
+  m_render_bands.resize(1);
+}
+
+void GPU_SW_Backend::RenderThreadEntryPoint(u32 band_index)
+{
+  std::unique_lock<std::mutex> lock(m_render_mutex);
+  u32 last_generation = 0;
+
+  for (;;)
+  {
+    m_render_start_cv.wait(
+      lock, [this, last_generation]() { return m_render_threads_shutdown || m_render_generation != last_generation; });
+    if (m_render_threads_shutdown)
+      break;
+
+    last_generation = m_render_generation;
+    lock.unlock();
+
+    RenderBatch(m_render_bands[band_index]);
+
+    lock.lock();
+    if ((--m_render_threads_busy) == 0)
+      m_render_done_cv.notify_one();
+  }
+}
+
+void GPU_SW_Backend::ComputeRenderBands()
+{
+  // The draws in a batch are all inside the drawing area, so split its rows evenly. Rows above and below it only
+  // receive transfers, and belong to the first and last bands. Every band needs at least one row.
+  const u32 count = static_cast<u32>(m_render_bands.size());
+  u32 split_top = 0;
+  u32 split_height = VRAM_HEIGHT;
+  if (m_drawing_area.Valid() && m_drawing_area.bottom < VRAM_HEIGHT &&
+      (m_drawing_area.bottom - m_drawing_area.top + 1) >= count)
+  {
+    split_top = m_drawing_area.top;
+    split_height = m_drawing_area.bottom - m_drawing_area.top + 1;
+  }
+
+  for (u32 i = 0; i < count; i++)
+  {
+    RenderBand& band = m_render_bands[i];
+    band.first_row = (i == 0) ? 0 : (split_top + ((split_height * i) / count));
+    band.last_row = (i == (count - 1)) ? (VRAM_HEIGHT - 1) : (split_top + ((split_height * (i + 1)) / count) - 1);
+    band.drawing_area = m_drawing_area;
+    band.drawing_area.top = std::max(m_drawing_area.top, band.first_row);
+    band.drawing_area.bottom = std::min(m_drawing_area.bottom, band.last_row);
+  }
+}
+
+void GPU_SW_Backend::RenderBatch(const RenderBand& band)
+{
+  const size_t count = m_batch_commands.size();
+  for (size_t i = 0; i < count; i++)
+    ExecuteCommand(m_batch_commands[i], band, m_batch_textures[i]);
+}
+
+void GPU_SW_Backend::ExecuteCommand(const GPUBackendCommand* cmd, const RenderBand& band,
+                                    const TextureCacheEntry* texture)
+{
+  switch (cmd->type)
+  {
+    case GPUBackendCommandType::FillVRAM:
+    {
+      const GPUBackendFillVRAMCommand* ccmd = static_cast<const GPUBackendFillVRAMCommand*>(cmd);
+      FillVRAM(ZeroExtend32(ccmd->x), ZeroExtend32(ccmd->y), ZeroExtend32(ccmd->width), ZeroExtend32(ccmd->height),
+               ccmd->color, ccmd->params, band);
+    }
+    break;
+
+    case GPUBackendCommandType::UpdateVRAM:
+    {
+      const GPUBackendUpdateVRAMCommand* ccmd = static_cast<const GPUBackendUpdateVRAMCommand*>(cmd);
+      UpdateVRAM(ZeroExtend32(ccmd->x), ZeroExtend32(ccmd->y), ZeroExtend32(ccmd->width), ZeroExtend32(ccmd->height),
+                 ccmd->data, ccmd->params, band);
+    }
+    break;
+
+    case GPUBackendCommandType::CopyVRAM:
+    {
+      const GPUBackendCopyVRAMCommand* ccmd = static_cast<const GPUBackendCopyVRAMCommand*>(cmd);
+      CopyVRAM(ZeroExtend32(ccmd->src_x), ZeroExtend32(ccmd->src_y), ZeroExtend32(ccmd->dst_x),
+               ZeroExtend32(ccmd->dst_y), ZeroExtend32(ccmd->width), ZeroExtend32(ccmd->height), ccmd->params, band);
+    }
+    break;
+
+    case GPUBackendCommandType::DrawPolygon:
+      DrawPolygon(static_cast<const GPUBackendDrawPolygonCommand*>(cmd), band.drawing_area, texture);
+      break;
+
+    case GPUBackendCommandType::DrawRectangle:
+      DrawRectangle(static_cast<const GPUBackendDrawRectangleCommand*>(cmd), band.drawing_area, texture);
+      break;
+
+    case GPUBackendCommandType::DrawLine:
+      DrawLine(static_cast<const GPUBackendDrawLineCommand*>(cmd), band.drawing_area);
+      break;
+
+    default:
+      break;
+  }
+}
+
+void GPU_SW_Backend::IncludeHazardTiles(HazardTileMask* mask, u32 x, u32 y, u32 width, u32 height)
+{
+  if (width == 0 || height == 0)
+    return;
+
+  // Transfers and texture lookups wrap around at the edges of VRAM.
+  x %= VRAM_WIDTH;
+  y %= VRAM_HEIGHT;
+
+  const u32 first_tile_x = x / HAZARD_TILE_WIDTH;
+  const u32 first_tile_y = y / HAZARD_TILE_HEIGHT;
+  const u32 num_tiles_x = std::min<u32>(((x + width - 1) / HAZARD_TILE_WIDTH) - first_tile_x + 1, HAZARD_TILES_X);
+  const u32 num_tiles_y = std::min<u32>(((y + height - 1) / HAZARD_TILE_HEIGHT) - first_tile_y + 1, HAZARD_TILES_Y);
+  for (u32 tile_y = 0; tile_y < num_tiles_y; tile_y++)
+  {
+    const u32 row_index = ((first_tile_y + tile_y) % HAZARD_TILES_Y) * HAZARD_TILES_X;
+    for (u32 tile_x = 0; tile_x < num_tiles_x; tile_x++)
+      mask->set(row_index + ((first_tile_x + tile_x) % HAZARD_TILES_X));
+  }
+}
+
+template<typename T>
+static bool GetVertexBounds(const T* vertices, u32 num_vertices, s32* min_x, s32* min_y, s32* max_x, s32* max_y)
+{
+  *min_x = *max_x = vertices[0].x;
+  *min_y = *max_y = vertices[0].y;
+  for (u32 i = 1; i < num_vertices; i++)
+  {
+    *min_x = std::min(*min_x, vertices[i].x);
+    *max_x = std::max(*max_x, vertices[i].x);
+    *min_y = std::min(*min_y, vertices[i].y);
+    *max_y = std::max(*max_y, vertices[i].y);
+  }
+
+  // Coordinates outside this range wrap around when rasterizing.
+  return (*min_x >= -1024 && *max_x < 1024 && *min_y >= -1024 && *max_y < 1024);
+}
+
+bool GPU_SW_Backend::GetCommandHazardTiles(const GPUBackendCommand* cmd, HazardTileMask* read_tiles,
+                                           HazardTileMask* write_tiles)
+{
+  switch (cmd->type)
+  {
+    case GPUBackendCommandType::FillVRAM:
+    {
+      const GPUBackendFillVRAMCommand* ccmd = static_cast<const GPUBackendFillVRAMCommand*>(cmd);
+      IncludeHazardTiles(write_tiles, ccmd->x, ccmd->y, ccmd->width, ccmd->height);
+      return true;
+    }
+
+    case GPUBackendCommandType::UpdateVRAM:
+    {
+      // Masked and wrapped updates can't be split, see UpdateVRAM().
+      const GPUBackendUpdateVRAMCommand* ccmd = static_cast<const GPUBackendUpdateVRAMCommand*>(cmd);
+      IncludeHazardTiles(write_tiles, ccmd->x, ccmd->y, ccmd->width, ccmd->height);
+      return ((ccmd->x + ccmd->width) <= VRAM_WIDTH && (ccmd->y + ccmd->height) <= VRAM_HEIGHT &&
+              !ccmd->params.IsMaskingEnabled());
+    }
+
+    case GPUBackendCommandType::CopyVRAM:
+    {
+      const GPUBackendCopyVRAMCommand* ccmd = static_cast<const GPUBackendCopyVRAMCommand*>(cmd);
+      IncludeHazardTiles(read_tiles, ccmd->src_x, ccmd->src_y, ccmd->width, ccmd->height);
+      IncludeHazardTiles(write_tiles, ccmd->dst_x, ccmd->dst_y, ccmd->width, ccmd->height);
+      return (*read_tiles & *write_tiles).none();
+    }
+
+    case GPUBackendCommandType::DrawPolygon:
+    case GPUBackendCommandType::DrawRectangle:
+    case GPUBackendCommandType::DrawLine:
+    {
+      const GPUBackendDrawCommand* ccmd = static_cast<const GPUBackendDrawCommand*>(cmd);
+      if (!m_drawing_area.Valid())
+        return true;
+
+      s32 min_x, min_y, max_x, max_y;
+      bool bounds_valid;
+      if (cmd->type == GPUBackendCommandType::DrawPolygon)
+      {
+        const GPUBackendDrawPolygonCommand* pcmd = static_cast<const GPUBackendDrawPolygonCommand*>(cmd);
+        bounds_valid = GetVertexBounds(pcmd->vertices, pcmd->num_vertices, &min_x, &min_y, &max_x, &max_y);
+      }
+      else if (cmd->type == GPUBackendCommandType::DrawLine)
+      {
+        const GPUBackendDrawLineCommand* lcmd = static_cast<const GPUBackendDrawLineCommand*>(cmd);
+        bounds_valid = GetVertexBounds(lcmd->vertices, lcmd->num_vertices, &min_x, &min_y, &max_x, &max_y);
+      }
+      else
+      {
+        const GPUBackendDrawRectangleCommand* rcmd = static_cast<const GPUBackendDrawRectangleCommand*>(cmd);
+        min_x = rcmd->x;
+        min_y = rcmd->y;
+        max_x = rcmd->x + static_cast<s32>(ZeroExtend32(rcmd->width)) - 1;
+        max_y = rcmd->y + static_cast<s32>(ZeroExtend32(rcmd->height)) - 1;
+        bounds_valid = true;
+      }
+
+      // Everything is clipped to the drawing area.
+      const s32 left = bounds_valid ? std::max(min_x, static_cast<s32>(m_drawing_area.left)) :
+                                      static_cast<s32>(m_drawing_area.left);
+      const s32 top = bounds_valid ? std::max(min_y, static_cast<s32>(m_drawing_area.top)) :
+                                     static_cast<s32>(m_drawing_area.top);
+      const s32 right = bounds_valid ? std::min(max_x, static_cast<s32>(m_drawing_area.right)) :
+                                       static_cast<s32>(m_drawing_area.right);
+      const s32 bottom = bounds_valid ? std::min(max_y, static_cast<s32>(m_drawing_area.bottom)) :
+                                        static_cast<s32>(m_drawing_area.bottom);
+      if (left > right || top > bottom)
+        return true;
+
+      IncludeHazardTiles(write_tiles, static_cast<u32>(left), static_cast<u32>(top), static_cast<u32>(right - left + 1),
+                         static_cast<u32>(bottom - top + 1));
+
+      // Textures can be anywhere in VRAM, and can be written by other bands.
+      if (cmd->type != GPUBackendCommandType::DrawLine && ccmd->rc.texture_enable)
+      {
+        const Common::Rectangle<u32> page_rect = ccmd->draw_mode.GetTexturePageRectangle();
+        IncludeHazardTiles(read_tiles, page_rect.left, page_rect.top, page_rect.GetWidth(), page_rect.GetHeight());
+
+        if (ccmd->draw_mode.texture_mode == GPUTextureMode::Palette4Bit)
+          IncludeHazardTiles(read_tiles, ccmd->palette.GetXBase(), ccmd->palette.GetYBase(), 16, 1);
+        else if (ccmd->draw_mode.texture_mode == GPUTextureMode::Palette8Bit)
+          IncludeHazardTiles(read_tiles, ccmd->palette.GetXBase(), ccmd->palette.GetYBase(), 256, 1);
+      }
+
+      return (*read_tiles & *write_tiles).none();
+    }
+
+    default:
+      return true;
+  }
+}
+
+void GPU_SW_Backend::HandleCommand(const GPUBackendCommand* cmd)
+{
+  // Changing the drawing area flushes the batch, so all draws in a batch share the same bands. Scan-out flushes it too,
+  // since it reads the whole display area.
+  if (cmd->type == GPUBackendCommandType::SetDrawingArea || cmd->type == GPUBackendCommandType::UpdateDisplay)
+  {
+    GPUBackend::HandleCommand(cmd);
+    return;
+  }
+
+  QueueCommand(cmd);
+}
+
+void GPU_SW_Backend::QueueCommand(const GPUBackendCommand* cmd)
+{
+  HazardTileMask read_tiles, write_tiles;
+  const bool can_batch = GetCommandHazardTiles(cmd, &read_tiles, &write_tiles);
+
+  // Scan-out only has to convert the rows which have changed since each display buffer was written.
+  for (DisplayBufferSource& source : m_display_buffer_sources)
+    source.dirty_tiles |= write_tiles;
+
+  if (!can_batch)
+  {
+    // The command reads what it writes, so it has to be rendered in order on its own, and can't use the texture
+    // cache either.
+    FlushRender();
+    InvalidateTextureCache(write_tiles);
+    ExecuteCommand(cmd, GetFullBand(), nullptr);
+    m_render_stats.num_draw_calls++;
+    return;
+  }
+
+  // Nothing in VRAM changes, e.g. a draw which is completely outside the drawing area.
+  if (write_tiles.none())
+    return;
+
+  m_render_stats.num_draw_calls++;
+
+  // Reads have to come after earlier writes, and writes after earlier reads. Writes to the same area are ordered by
+  // the bands already.
+  if ((read_tiles & m_batch_write_tiles).any() || (write_tiles & m_batch_read_tiles).any() ||
+      (m_batch_size + cmd->size) > MAX_BATCH_SIZE)
+  {
+    FlushRender();
+  }
+
+  // Nothing in the batch writes to the texture, so it can be decoded now. The cache entries which this command
+  // overwrites can't be used by the batch either, since that would have flushed it above.
+  const TextureCacheEntry* texture = nullptr;
+  if (cmd->type == GPUBackendCommandType::DrawPolygon || cmd->type == GPUBackendCommandType::DrawRectangle)
+    texture = GetTextureCacheEntry(static_cast<const GPUBackendDrawCommand*>(cmd), read_tiles);
+  InvalidateTextureCache(write_tiles);
+
+  if (m_render_threads.empty())
+  {
+    ExecuteCommand(cmd, GetFullBand(), texture);
+    return;
+  }
+
+  m_batch_read_tiles |= read_tiles;
+  m_batch_write_tiles |= write_tiles;
+
+  // The command is rendered straight out of its chunk, so keep it around until the batch is done.
+  if (m_batch_chunks.empty() || m_batch_chunks.back() != m_executing_chunk)
+  {
+    AddCommandChunkReference(m_executing_chunk);
+    m_batch_chunks.push_back(m_executing_chunk);
+  }
+
+  m_batch_commands.push_back(cmd);
+  m_batch_textures.push_back(texture);
+  m_batch_size += cmd->size;
+}
+
+void GPU_SW_Backend::FlushRender()
+{
+  if (m_batch_commands.empty())
+    return;
+
+  m_render_stats.num_flushes++;
+  m_render_stats.num_batches++;
+  ComputeRenderBands();
+
+  {
+    std::unique_lock<std::mutex> lock(m_render_mutex);
+    m_render_threads_busy = static_cast<u32>(m_render_threads.size());
+    m_render_generation++;
+  }
+  m_render_start_cv.notify_all();
+
+  RenderBatch(m_render_bands[0]);
+
+  {
+    std::unique_lock<std::mutex> lock(m_render_mutex);
+    m_render_done_cv.wait(lock, [this]() { return m_render_threads_busy == 0; });
+  }
+
+  for (CommandChunk* chunk : m_batch_chunks)
+    ReleaseCommandChunk(chunk);
+
+  m_batch_commands.clear();
+  m_batch_textures.clear();
+  m_batch_chunks.clear();
+  m_batch_size = 0;
+  m_batch_read_tiles.reset();
+  m_batch_write_tiles.reset();
+  m_batch_number++;
+}
+
+const GPU_SW_Backend::TextureCacheEntry* GPU_SW_Backend::GetTextureCacheEntry(const GPUBackendDrawCommand* cmd,
+                                                                              const HazardTileMask& read_tiles)
+{
+  // Direct textures are a single read per texel already.
+  if (!cmd->rc.texture_enable || !cmd->draw_mode.IsUsingPalette())
+    return nullptr;
+
+  // Entries are keyed on the page position, texture mode and CLUT. The texture window is applied when fetching.
+  static constexpr u16 DRAW_MODE_KEY_MASK = GPUDrawModeReg::TEXTURE_PAGE_MASK | (UINT16_C(0b11) << 7);
+  const u16 draw_mode_bits = cmd->draw_mode.bits & DRAW_MODE_KEY_MASK;
+  const u16 palette_bits = cmd->palette.bits;
+
+  TextureCacheEntry* entry = nullptr;
+  for (TextureCacheEntry& it : m_texture_cache)
+  {
+    if (it.valid && it.draw_mode_bits == draw_mode_bits && it.palette_bits == palette_bits)
+    {
+      entry = &it;
+      break;
+    }
+  }
+
+  if (!entry)
+  {
+    // Replace an invalidated entry if there is one, otherwise the least recently used. Entries which are used by the
+    // current batch have to stay, unless it's rendered first.
+    for (;;)
+    {
+      for (TextureCacheEntry& it : m_texture_cache)
+      {
+        if (!m_batch_commands.empty() && it.valid && it.batch_number == m_batch_number)
+          continue;
+
+        if (!entry || (entry->valid && (!it.valid || it.last_used < entry->last_used)))
+          entry = &it;
+      }
+
+      if (entry)
+        break;
+
+      FlushRender();
+    }
+
+    if (!entry->texels)
+      entry->texels = std::make_unique<u16[]>(TEXTURE_PAGE_WIDTH * TEXTURE_PAGE_HEIGHT);
+
+    entry->draw_mode_bits = draw_mode_bits;
+    entry->palette_bits = palette_bits;
+    entry->valid = true;
+    entry->tiles = read_tiles;
+    entry->decoded_rows.reset();
+  }
+
+  entry->last_used = ++m_texture_cache_counter;
+  entry->batch_number = m_batch_number;
+
+  // Decode the rows between the lowest and highest texcoords, anything the rasterizer steps outside of that range is
+  // read from VRAM instead.
+  u32 first_row, num_rows;
+  if (cmd->type == GPUBackendCommandType::DrawRectangle)
+  {
+    const GPUBackendDrawRectangleCommand* rcmd = static_cast<const GPUBackendDrawRectangleCommand*>(cmd);
+    first_row = ZeroExtend32(rcmd->texcoord) >> 8;
+    num_rows = std::min<u32>(ZeroExtend32(rcmd->height), TEXTURE_PAGE_HEIGHT);
+  }
+  else
+  {
+    const GPUBackendDrawPolygonCommand* pcmd = static_cast<const GPUBackendDrawPolygonCommand*>(cmd);
+    u32 min_v = pcmd->vertices[0].v;
+    u32 max_v = min_v;
+    for (u32 i = 1; i < pcmd->num_vertices; i++)
+    {
+      min_v = std::min<u32>(min_v, pcmd->vertices[i].v);
+      max_v = std::max<u32>(max_v, pcmd->vertices[i].v);
+    }
+
+    first_row = min_v;
+    num_rows = max_v - min_v + 1;
+  }
+
+  for (u32 i = 0; i < num_rows; i++)
+  {
+    const u32 row = ((((first_row + i) % TEXTURE_PAGE_HEIGHT) & cmd->window.and_y) | cmd->window.or_y);
+    if (!entry->decoded_rows[row])
+      DecodeTextureRow(entry, row);
+  }
+
+  return entry;
+}
+
+void GPU_SW_Backend::DecodeTextureRow(TextureCacheEntry* entry, u32 row)
+{
+  const GPUDrawModeReg draw_mode{entry->draw_mode_bits};
+  const GPUTexturePaletteReg palette{entry->palette_bits};
+  const u32 page_x = draw_mode.GetTexturePageBaseX();
+  const u32 page_y = (draw_mode.GetTexturePageBaseY() + row) % VRAM_HEIGHT;
+  const u32 palette_x = palette.GetXBase();
+  const u16* palette_row = GetPixelPtr(0, palette.GetYBase());
+  u16* dst = &entry->texels[row * TEXTURE_PAGE_WIDTH];
+
+  if (draw_mode.texture_mode == GPUTextureMode::Palette4Bit)
+  {
+    for (u32 x = 0; x < (TEXTURE_PAGE_WIDTH / 4); x++)
+    {
+      const u16 palette_value = GetPixel((page_x + x) % VRAM_WIDTH, page_y);
+      *(dst++) = palette_row[(palette_x + (palette_value & 0x0Fu)) % VRAM_WIDTH];
+      *(dst++) = palette_row[(palette_x + ((palette_value >> 4) & 0x0Fu)) % VRAM_WIDTH];
+      *(dst++) = palette_row[(palette_x + ((palette_value >> 8) & 0x0Fu)) % VRAM_WIDTH];
+      *(dst++) = palette_row[(palette_x + (palette_value >> 12)) % VRAM_WIDTH];
+    }
+  }
+  else
+  {
+    for (u32 x = 0; x < (TEXTURE_PAGE_WIDTH / 2); x++)
+    {
+      const u16 palette_value = GetPixel((page_x + x) % VRAM_WIDTH, page_y);
+      *(dst++) = palette_row[(palette_x + (palette_value & 0xFFu)) % VRAM_WIDTH];
+      *(dst++) = palette_row[(palette_x + (palette_value >> 8)) % VRAM_WIDTH];
+    }
+  }
+
+  entry->decoded_rows.set(row);
+}
+
+void GPU_SW_Backend::InvalidateTextureCache(const HazardTileMask& write_tiles)
+{
+  for (TextureCacheEntry& entry : m_texture_cache)
+  {
+    if (entry.valid && (entry.tiles & write_tiles).any())
+      entry.valid = false;
+  }
+}
+
+void GPU_SW_Backend::ClearTextureCache()
+{
+  for (TextureCacheEntry& entry : m_texture_cache)
+    entry.valid = false;
+}
 
+template<bool scaled>
 GPU_SW_Backend::DrawLineFunction GPU_SW_Backend::GetDrawLineFunction(bool shading_enable, bool transparency_enable,
                                                                      bool dithering_enable)
 {
   static constexpr DrawLineFunction funcs[2][2][2] = {
-    {{&GPU_SW_Backend::DrawLine<false, false, false>, &GPU_SW_Backend::DrawLine<false, false, true>},
-     {&GPU_SW_Backend::DrawLine<false, true, false>, &GPU_SW_Backend::DrawLine<false, true, true>}},
-    {{&GPU_SW_Backend::DrawLine<true, false, false>, &GPU_SW_Backend::DrawLine<true, false, true>},
-     {&GPU_SW_Backend::DrawLine<true, true, false>, &GPU_SW_Backend::DrawLine<true, true, true>}}};
+    {{&GPU_SW_Backend::DrawLine<false, false, false, scaled>, &GPU_SW_Backend::DrawLine<false, false, true, scaled>},
+     {&GPU_SW_Backend::DrawLine<false, true, false, scaled>, &GPU_SW_Backend::DrawLine<false, true, true, scaled>}},
+    {{&GPU_SW_Backend::DrawLine<true, false, false, scaled>, &GPU_SW_Backend::DrawLine<true, false, true, scaled>},
+     {&GPU_SW_Backend::DrawLine<true, true, false, scaled>, &GPU_SW_Backend::DrawLine<true, true, true, scaled>}}};
 
   return funcs[u8(shading_enable)][u8(transparency_enable)][u8(dithering_enable)];
 }
 
+template<bool scaled>
 GPU_SW_Backend::DrawRectangleFunction
 GPU_SW_Backend::GetDrawRectangleFunction(bool texture_enable, bool raw_texture_enable, bool transparency_enable)
 {
   static constexpr DrawRectangleFunction funcs[2][2][2] = {
-    {{&GPU_SW_Backend::DrawRectangle<false, false, false>, &GPU_SW_Backend::DrawRectangle<false, false, true>},
-     {&GPU_SW_Backend::DrawRectangle<false, false, false>, &GPU_SW_Backend::DrawRectangle<false, false, true>}},
-    {{&GPU_SW_Backend::DrawRectangle<true, false, false>, &GPU_SW_Backend::DrawRectangle<true, false, true>},
-     {&GPU_SW_Backend::DrawRectangle<true, true, false>, &GPU_SW_Backend::DrawRectangle<true, true, true>}}};
+    {{&GPU_SW_Backend::DrawRectangle<false, false, false, scaled>,
+      &GPU_SW_Backend::DrawRectangle<false, false, true, scaled>},
+     {&GPU_SW_Backend::DrawRectangle<false, false, false, scaled>,
+      &GPU_SW_Backend::DrawRectangle<false, false, true, scaled>}},
+    {{&GPU_SW_Backend::DrawRectangle<true, false, false, scaled>,
+      &GPU_SW_Backend::DrawRectangle<true, false, true, scaled>},
+     {&GPU_SW_Backend::DrawRectangle<true, true, false, scaled>,
+      &GPU_SW_Backend::DrawRectangle<true, true, true, scaled>}}};
 
   return funcs[u8(texture_enable)][u8(raw_texture_enable)][u8(transparency_enable)];
 }
 
+template<bool scaled>
 GPU_SW_Backend::DrawTriangleFunction GPU_SW_Backend::GetDrawTriangleFunction(bool shading_enable, bool texture_enable,
                                                                              bool raw_texture_enable,
                                                                              bool transparency_enable,
                                                                              bool dithering_enable)
 {
   static constexpr DrawTriangleFunction funcs[2][2][2][2][2] = {
-    {{{{&GPU_SW_Backend::DrawTriangle<false, false, false, false, false>,
-        &GPU_SW_Backend::DrawTriangle<false, false, false, false, true>},
-       {&GPU_SW_Backend::DrawTriangle<false, false, false, true, false>,
-        &GPU_SW_Backend::DrawTriangle<false, false, false, true, true>}},
-      {{&GPU_SW_Backend::DrawTriangle<false, false, false, false, false>,
-        &GPU_SW_Backend::DrawTriangle<false, false, false, false, false>},
-       {&GPU_SW_Backend::DrawTriangle<false, false, false, true, false>,
-        &GPU_SW_Backend::DrawTriangle<false, false, false, true, false>}}},
-     {{{&GPU_SW_Backend::DrawTriangle<false, true, false, false, false>,
-        &GPU_SW_Backend::DrawTriangle<false, true, false, false, true>},
-       {&GPU_SW_Backend::DrawTriangle<false, true, false, true, false>,
-        &GPU_SW_Backend::DrawTriangle<false, true, false, true, true>}},
-      {{&GPU_SW_Backend::DrawTriangle<false, true, true, false, false>,
-        &GPU_SW_Backend::DrawTriangle<false, true, true, false, false>},
-       {&GPU_SW_Backend::DrawTriangle<false, true, true, true, false>,
-        &GPU_SW_Backend::DrawTriangle<false, true, true, true, false>}}}},
-    {{{{&GPU_SW_Backend::DrawTriangle<true, false, false, false, false>,
-        &GPU_SW_Backend::DrawTriangle<true, false, false, false, true>},
-       {&GPU_SW_Backend::DrawTriangle<true, false, false, true, false>,
-        &GPU_SW_Backend::DrawTriangle<true, false, false, true, true>}},
-      {{&GPU_SW_Backend::DrawTriangle<true, false, false, false, false>,
-        &GPU_SW_Backend::DrawTriangle<true, false, false, false, false>},
-       {&GPU_SW_Backend::DrawTriangle<true, false, false, true, false>,
-        &GPU_SW_Backend::DrawTriangle<true, false, false, true, false>}}},
-     {{{&GPU_SW_Backend::DrawTriangle<true, true, false, false, false>,
-        &GPU_SW_Backend::DrawTriangle<true, true, false, false, true>},
-       {&GPU_SW_Backend::DrawTriangle<true, true, false, true, false>,
-        &GPU_SW_Backend::DrawTriangle<true, true, false, true, true>}},
-      {{&GPU_SW_Backend::DrawTriangle<true, true, true, false, false>,
-        &GPU_SW_Backend::DrawTriangle<true, true, true, false, false>},
-       {&GPU_SW_Backend::DrawTriangle<true, true, true, true, false>,
-        &GPU_SW_Backend::DrawTriangle<true, true, true, true, false>}}}}};
+    {{{{&GPU_SW_Backend::DrawTriangle<false, false, false, false, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<false, false, false, false, true, scaled>},
+       {&GPU_SW_Backend::DrawTriangle<false, false, false, true, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<false, false, false, true, true, scaled>}},
+      {{&GPU_SW_Backend::DrawTriangle<false, false, false, false, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<false, false, false, false, false, scaled>},
+       {&GPU_SW_Backend::DrawTriangle<false, false, false, true, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<false, false, false, true, false, scaled>}}},
+     {{{&GPU_SW_Backend::DrawTriangle<false, true, false, false, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<false, true, false, false, true, scaled>},
+       {&GPU_SW_Backend::DrawTriangle<false, true, false, true, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<false, true, false, true, true, scaled>}},
+      {{&GPU_SW_Backend::DrawTriangle<false, true, true, false, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<false, true, true, false, false, scaled>},
+       {&GPU_SW_Backend::DrawTriangle<false, true, true, true, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<false, true, true, true, false, scaled>}}}},
+    {{{{&GPU_SW_Backend::DrawTriangle<true, false, false, false, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<true, false, false, false, true, scaled>},
+       {&GPU_SW_Backend::DrawTriangle<true, false, false, true, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<true, false, false, true, true, scaled>}},
+      {{&GPU_SW_Backend::DrawTriangle<true, false, false, false, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<true, false, false, false, false, scaled>},
+       {&GPU_SW_Backend::DrawTriangle<true, false, false, true, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<true, false, false, true, false, scaled>}}},
+     {{{&GPU_SW_Backend::DrawTriangle<true, true, false, false, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<true, true, false, false, true, scaled>},
+       {&GPU_SW_Backend::DrawTriangle<true, true, false, true, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<true, true, false, true, true, scaled>}},
+      {{&GPU_SW_Backend::DrawTriangle<true, true, true, false, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<true, true, true, false, false, scaled>},
+       {&GPU_SW_Backend::DrawTriangle<true, true, true, true, false, scaled>,
+        &GPU_SW_Backend::DrawTriangle<true, true, true, true, false, scaled>}}}}};
 
   return funcs[u8(shading_enable)][u8(texture_enable)][u8(raw_texture_enable)][u8(transparency_enable)]
               [u8(dithering_enable)];
@@ -1,7 +1,13 @@
 #pragma once
 #include "gpu_backend.h"
+#include "gpu_sw_backend_simd.h"
 #include <array>
+#include <atomic>
+#include <bitset>
+#include <condition_variable>
 #include <memory>
+#include <mutex>
+#include <thread>
 #include <vector>
 
 class GPU_SW_Backend final : public GPUBackend
@@ -11,13 +17,48 @@ public:
   ~GPU_SW_Backend() override;
 
   bool Initialize(bool force_thread) override;
+  void UpdateSettings() override;
   void Reset(bool clear_vram) override;
+  void Shutdown() override;
 
   ALWAYS_INLINE_RELEASE u16 GetPixel(const u32 x, const u32 y) const { return m_vram[VRAM_WIDTH * y + x]; }
   ALWAYS_INLINE_RELEASE const u16* GetPixelPtr(const u32 x, const u32 y) const { return &m_vram[VRAM_WIDTH * y + x]; }
   ALWAYS_INLINE_RELEASE u16* GetPixelPtr(const u32 x, const u32 y) { return &m_vram[VRAM_WIDTH * y + x]; }
   ALWAYS_INLINE_RELEASE void SetPixel(const u32 x, const u32 y, const u16 value) { m_vram[VRAM_WIDTH * y + x] = value; }
 
+  static constexpr u32 MAX_RESOLUTION_SCALE = 4;
+
+  /// Renders into a copy of VRAM which is scale times larger as well, which is what gets displayed. Native VRAM is
+  /// still written by every command, and is what readbacks and texturing use. Only the GPU's own backend is scaled.
+  void SetResolutionScale(u32 scale);
+
+  /// Displayed part of VRAM, converted to the host format by an UpdateDisplay command. The output fields describe the
+  /// image to present, which is either the pixels themselves or the post-processed copy of them.
+  struct DisplayBuffer
+  {
+    std::unique_ptr<u8[]> pixels;
+    std::vector<u8> filtered_pixels;
+    const u8* output_pixels;
+    HostDisplayPixelFormat format;
+    u32 width;
+    u32 height;
+    u32 stride;
+    u32 output_width;
+    u32 output_height;
+    u32 output_stride;
+    u32 resolution_scale;
+    s32 display_width;
+    s32 display_height;
+    s32 display_origin_left;
+    s32 display_origin_top;
+    float display_aspect_ratio;
+    bool enabled;
+  };
+
+  /// Returns the most recent frame which the backend has finished scanning out, or nullptr if there hasn't been one
+  /// yet. Only valid until the next call.
+  const DisplayBuffer* GetDisplayBuffer();
+
   // this is actually (31 * 255) >> 4) == 494, but to simplify addressing we use the next power of two (512)
   static constexpr u32 DITHER_LUT_SIZE = 512;
   using DitherLUT = std::array<std::array<std::array<u8, 512>, DITHER_MATRIX_SIZE>, DITHER_MATRIX_SIZE>;
@@ -84,6 +125,45 @@ protected:
     return std::make_tuple(static_cast<u8>(rgb24), static_cast<u8>(rgb24 >> 8), static_cast<u8>(rgb24 >> 16));
   }
 
+  /// Part of VRAM which is rendered by one thread. Draws are clipped to the drawing area of the band, and transfers
+  /// only write to rows between first_row and last_row.
+  struct RenderBand
+  {
+    Common::Rectangle<u32> drawing_area;
+    u32 first_row;
+    u32 last_row;
+  };
+
+  // Reads and writes of the commands in a batch are tracked at a granularity of 64x32 tiles.
+  static constexpr u32 HAZARD_TILE_WIDTH = 64;
+  static constexpr u32 HAZARD_TILE_HEIGHT = 32;
+  static constexpr u32 HAZARD_TILES_X = VRAM_WIDTH / HAZARD_TILE_WIDTH;
+  static constexpr u32 HAZARD_TILES_Y = VRAM_HEIGHT / HAZARD_TILE_HEIGHT;
+  using HazardTileMask = std::bitset<HAZARD_TILES_X * HAZARD_TILES_Y>;
+  using HazardTileRowMask = std::bitset<HAZARD_TILES_Y>;
+
+  // Batches are rendered once they get this large, even if nothing forces a flush.
+  static constexpr u32 MAX_BATCH_SIZE = 2 * 1024 * 1024;
+
+  // Number of palettized texture pages which are kept decoded to 16-bit texels.
+  static constexpr u32 TEXTURE_CACHE_SIZE = 16;
+
+  /// Texture page expanded through its CLUT, so texels can be fetched with a single read. Rows are decoded when a draw
+  /// which can sample them is submitted, and the entry is dropped when anything writes to the page or the CLUT.
+  struct TextureCacheEntry
+  {
+    u16 draw_mode_bits;
+    u16 palette_bits;
+    bool valid;
+    u32 last_used;
+    u32 batch_number;
+    HazardTileMask tiles;
+    std::bitset<TEXTURE_PAGE_HEIGHT> decoded_rows;
+    std::unique_ptr<u16[]> texels;
+  };
+
+  void HandleCommand(const GPUBackendCommand* cmd) override;
+
   void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params) override;
   void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, GPUBackendCommandParameters params) override;
   void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height,
@@ -92,19 +172,160 @@ protected:
   void DrawPolygon(const GPUBackendDrawPolygonCommand* cmd) override;
   void DrawLine(const GPUBackendDrawLineCommand* cmd) override;
   void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd) override;
+  void UpdateDisplay(const GPUBackendUpdateDisplayCommand* cmd) override;
   void FlushRender() override;
 
+  void FillVRAM(u32 x, u32 y, u32 width, u32 height, u32 color, GPUBackendCommandParameters params,
+                const RenderBand& band);
+  void UpdateVRAM(u32 x, u32 y, u32 width, u32 height, const void* data, GPUBackendCommandParameters params,
+                  const RenderBand& band);
+  void CopyVRAM(u32 src_x, u32 src_y, u32 dst_x, u32 dst_y, u32 width, u32 height, GPUBackendCommandParameters params,
+                const RenderBand& band);
+  void UpscaleVRAM(u32 x, u32 y, u32 width, u32 height, const RenderBand& band);
+
+  void DrawPolygon(const GPUBackendDrawPolygonCommand* cmd, const Common::Rectangle<u32>& drawing_area,
+                   const TextureCacheEntry* texture);
+  void DrawLine(const GPUBackendDrawLineCommand* cmd, const Common::Rectangle<u32>& drawing_area);
+  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const Common::Rectangle<u32>& drawing_area,
+                     const TextureCacheEntry* texture);
+
+  //////////////////////////////////////////////////////////////////////////
+  // Scaled rendering
+  //////////////////////////////////////////////////////////////////////////
+  template<bool scaled>
+  ALWAYS_INLINE_RELEASE u16* GetTargetPixelPtr(const u32 x, const u32 y)
+  {
+    if constexpr (scaled)
+      return &m_scaled_vram[m_scaled_vram_width * y + x];
+    else
+      return &m_vram[VRAM_WIDTH * y + x];
+  }
+
+  /// Divisor for the coordinates used to look up the dither matrix. Scaled dithering uses the pattern at the rendered
+  /// resolution, otherwise it covers the same area as it would at native resolution.
+  template<bool scaled>
+  ALWAYS_INLINE_RELEASE u32 GetDitherScale() const
+  {
+    return (scaled && !m_scaled_dithering) ? m_resolution_scale : 1u;
+  }
+
+  Common::Rectangle<u32> GetScaledDrawingArea(const Common::Rectangle<u32>& drawing_area) const;
+
+  //////////////////////////////////////////////////////////////////////////
+  // Display scan-out
+  //////////////////////////////////////////////////////////////////////////
+  // Buffers are rotated between the backend writing the next frame, the latest finished frame, and the frame which
+  // the GPU is presenting.
+  static constexpr u32 NUM_DISPLAY_BUFFERS = 3;
+  static constexpr u32 DISPLAY_BUFFER_INDEX_MASK = 0x3;
+  static constexpr u32 DISPLAY_BUFFER_READY_BIT = 0x4;
+  static constexpr u32 DISPLAY_BUFFER_SIZE = GPU_MAX_DISPLAY_WIDTH * GPU_MAX_DISPLAY_HEIGHT * sizeof(u32);
+
+  /// Area of VRAM last converted into a display buffer, and the tiles written since. When a buffer is reused for the
+  /// same area, only the rows which pass through written tiles are converted again.
+  struct DisplayBufferSource
+  {
+    HazardTileMask dirty_tiles;
+    HostDisplayPixelFormat format;
+    u16 src_x;
+    u16 src_y;
+    u16 skip_x;
+    u16 width;
+    u16 height;
+    bool display_24bit;
+    bool interleaved;
+    bool valid;
+  };
+
+  template<HostDisplayPixelFormat display_format>
+  void CopyOut15Bit(u32 src_x, u32 src_y, u32 width, u32 height, u32 field, bool interlaced, bool interleaved,
+                    const HazardTileRowMask& dirty_rows, DisplayBuffer* buffer);
+  void CopyOut15Bit(HostDisplayPixelFormat display_format, u32 src_x, u32 src_y, u32 width, u32 height, u32 field,
+                    bool interlaced, bool interleaved, const HazardTileRowMask& dirty_rows, DisplayBuffer* buffer);
+
+  template<HostDisplayPixelFormat display_format>
+  void CopyOut15BitScaled(u32 src_x, u32 src_y, u32 width, u32 height, u32 field, bool interlaced, bool interleaved,
+                          const HazardTileRowMask& dirty_rows, DisplayBuffer* buffer);
+  void CopyOut15BitScaled(HostDisplayPixelFormat display_format, u32 src_x, u32 src_y, u32 width, u32 height,
+                          u32 field, bool interlaced, bool interleaved, const HazardTileRowMask& dirty_rows,
+                          DisplayBuffer* buffer);
+
+  template<HostDisplayPixelFormat display_format>
+  void CopyOut24Bit(u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height, u32 field, bool interlaced,
+                    bool interleaved, const HazardTileRowMask& dirty_rows, DisplayBuffer* buffer);
+  void CopyOut24Bit(HostDisplayPixelFormat display_format, u32 src_x, u32 src_y, u32 skip_x, u32 width, u32 height,
+                    u32 field, bool interlaced, bool interleaved, const HazardTileRowMask& dirty_rows,
+                    DisplayBuffer* buffer);
+
+  HazardTileRowMask GetDisplayDirtyRows(const GPUBackendUpdateDisplayCommand* cmd, DisplayBufferSource* source);
+  void SetDisplayBufferPixels(DisplayBuffer* buffer, HostDisplayPixelFormat format, u32 width, u32 height,
+                              u32 row_size, u32 stride, bool interlaced);
+
+  //////////////////////////////////////////////////////////////////////////
+  // Display post-processing
+  //////////////////////////////////////////////////////////////////////////
+  static constexpr u32 MAX_DISPLAY_SCALE = 4;
+
+  /// Frame passed between the filters. Everything after unpacking is 32 bits per pixel.
+  struct DisplayFilterImage
+  {
+    const u8* pixels;
+    u32 width;
+    u32 height;
+    u32 stride;
+  };
+
+  void PostProcessDisplay(DisplayBuffer* buffer, bool display_24bit);
+  u8* GetDisplayFilterFrame(u32 width, u32 height);
+  DisplayFilterImage UnpackDisplayImage(const DisplayFilterImage& src, HostDisplayPixelFormat format);
+  void PackDisplayImage(const DisplayFilterImage& src, HostDisplayPixelFormat format, DisplayBuffer* buffer);
+  DisplayFilterImage DownsampleDisplayImage(const DisplayFilterImage& src, u32 factor);
+  DisplayFilterImage SmoothDisplayChroma(const DisplayFilterImage& src, bool bgr);
+  DisplayFilterImage UpscaleDisplayImage(const DisplayFilterImage& src, u32 factor, GPUDisplayScaleFilter filter);
+
+  //////////////////////////////////////////////////////////////////////////
+  // Band-parallel rendering
+  //////////////////////////////////////////////////////////////////////////
+  RenderBand GetFullBand() const;
+  void StartRenderThreads(u32 count);
+  void StopRenderThreads();
+  void RenderThreadEntryPoint(u32 band_index);
+  void ComputeRenderBands();
+  void RenderBatch(const RenderBand& band);
+  void ExecuteCommand(const GPUBackendCommand* cmd, const RenderBand& band, const TextureCacheEntry* texture);
+  void QueueCommand(const GPUBackendCommand* cmd);
+  bool GetCommandHazardTiles(const GPUBackendCommand* cmd, HazardTileMask* read_tiles, HazardTileMask* write_tiles);
+  static void IncludeHazardTiles(HazardTileMask* mask, u32 x, u32 y, u32 width, u32 height);
+
+  //////////////////////////////////////////////////////////////////////////
+  // Texture cache
+  //////////////////////////////////////////////////////////////////////////
+  const TextureCacheEntry* GetTextureCacheEntry(const GPUBackendDrawCommand* cmd, const HazardTileMask& read_tiles);
+  void DecodeTextureRow(TextureCacheEntry* entry, u32 row);
+  void InvalidateTextureCache(const HazardTileMask& write_tiles);
+  void ClearTextureCache();
+
   //////////////////////////////////////////////////////////////////////////
   // Rasterization
   //////////////////////////////////////////////////////////////////////////
-  template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable>
-  void ShadePixel(const GPUBackendDrawCommand* cmd, u32 x, u32 y, u8 color_r, u8 color_g, u8 color_b, u8 texcoord_x,
-                  u8 texcoord_y);
+  u16 FetchTexel(const GPUBackendDrawCommand* cmd, const TextureCacheEntry* texture, u8 texcoord_x,
+                 u8 texcoord_y) const;
 
-  template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
-  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd);
+  void InitSpanInput(const GPUBackendDrawCommand* cmd, GPU_SW_SIMD::SpanInput* span, bool dithering_enable, u32 x,
+                     u32 y, u32 dither_scale = 1) const;
 
-  using DrawRectangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawRectangleCommand* cmd);
+  template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool dithering_enable, bool scaled>
+  void ShadePixel(const GPUBackendDrawCommand* cmd, const TextureCacheEntry* texture, u32 x, u32 y, u8 color_r,
+                  u8 color_g, u8 color_b, u8 texcoord_x, u8 texcoord_y);
+
+  template<bool texture_enable, bool raw_texture_enable, bool transparency_enable, bool scaled>
+  void DrawRectangle(const GPUBackendDrawRectangleCommand* cmd, const Common::Rectangle<u32>& drawing_area,
+                     const TextureCacheEntry* texture);
+
+  using DrawRectangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawRectangleCommand* cmd,
+                                                         const Common::Rectangle<u32>& drawing_area,
+                                                         const TextureCacheEntry* texture);
+  template<bool scaled>
   DrawRectangleFunction GetDrawRectangleFunction(bool texture_enable, bool raw_texture_enable,
                                                  bool transparency_enable);
 
@@ -137,30 +358,86 @@ protected:
   void AddIDeltas_DY(i_group& ig, const i_deltas& idl, u32 count = 1);
 
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
-           bool dithering_enable>
-  void DrawSpan(const GPUBackendDrawPolygonCommand* cmd, s32 y, s32 x_start, s32 x_bound, i_group ig,
-                const i_deltas& idl);
+           bool dithering_enable, bool scaled>
+  void DrawSpan(const GPUBackendDrawPolygonCommand* cmd, const Common::Rectangle<u32>& drawing_area,
+                const TextureCacheEntry* texture, s32 y, s32 x_start, s32 x_bound, i_group ig, const i_deltas& idl);
 
   template<bool shading_enable, bool texture_enable, bool raw_texture_enable, bool transparency_enable,
-           bool dithering_enable>
-  void DrawTriangle(const GPUBackendDrawPolygonCommand* cmd, const GPUBackendDrawPolygonCommand::Vertex* v0,
-                    const GPUBackendDrawPolygonCommand::Vertex* v1, const GPUBackendDrawPolygonCommand::Vertex* v2);
+           bool dithering_enable, bool scaled>
+  void DrawTriangle(const GPUBackendDrawPolygonCommand* cmd, const Common::Rectangle<u32>& drawing_area,
+                    const TextureCacheEntry* texture, const GPUBackendDrawPolygonCommand::Vertex* v0, const GPUBackendDrawPolygonCommand::Vertex* v1,
+                    const GPUBackendDrawPolygonCommand::Vertex* v2);
 
   using DrawTriangleFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawPolygonCommand* cmd,
+                                                        const Common::Rectangle<u32>& drawing_area,
+                                                        const TextureCacheEntry* texture,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v0,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v1,
                                                         const GPUBackendDrawPolygonCommand::Vertex* v2);
+  template<bool scaled>
   DrawTriangleFunction GetDrawTriangleFunction(bool shading_enable, bool texture_enable, bool raw_texture_enable,
                                                bool transparency_enable, bool dithering_enable);
 
-  template<bool shading_enable, bool transparency_enable, bool dithering_enable>
-  void DrawLine(const GPUBackendDrawLineCommand* cmd, const GPUBackendDrawLineCommand::Vertex* p0,
-                const GPUBackendDrawLineCommand::Vertex* p1);
+  template<bool shading_enable, bool transparency_enable, bool dithering_enable, bool scaled>
+  void DrawLine(const GPUBackendDrawLineCommand* cmd, const Common::Rectangle<u32>& drawing_area,
+                const GPUBackendDrawLineCommand::Vertex* p0, const GPUBackendDrawLineCommand::Vertex* p1);
 
   using DrawLineFunction = void (GPU_SW_Backend::*)(const GPUBackendDrawLineCommand* cmd,
+                                                    const Common::Rectangle<u32>& drawing_area,
                                                     const GPUBackendDrawLineCommand::Vertex* p0,
                                                     const GPUBackendDrawLineCommand::Vertex* p1);
+  template<bool scaled>
   DrawLineFunction GetDrawLineFunction(bool shading_enable, bool transparency_enable, bool dithering_enable);
 
   std::array<u16, VRAM_WIDTH * VRAM_HEIGHT> m_vram;
+
+  // VRAM at the resolution scale, null when rendering at native resolution.
+  std::unique_ptr<u16[]> m_scaled_vram;
+  u32 m_scaled_vram_width = VRAM_WIDTH;
+  u32 m_resolution_scale = 1;
+  bool m_scaled_dithering = false;
+
+  // Vector span shading for the host CPU, null if it isn't supported.
+  const GPU_SW_SIMD::ShadeSpanFunctionTable* m_shade_span_functions = nullptr;
+
+  std::array<DisplayBuffer, NUM_DISPLAY_BUFFERS> m_display_buffers = {};
+  std::array<DisplayBufferSource, NUM_DISPLAY_BUFFERS> m_display_buffer_sources = {};
+  std::unique_ptr<u8[]> m_display_interlaced_buffer;
+  std::atomic<u32> m_display_ready_index{1};
+  u32 m_display_write_index = 0;
+  u32 m_display_read_index = 2;
+
+  // Post-processing runs on the backend thread, so these are only updated after a sync.
+  const GPU_SW_SIMD::DisplayFilterFunctionTable* m_display_filter_functions = nullptr;
+  GPUDownsampleMode m_display_downsample_mode = GPUDownsampleMode::Disabled;
+  GPUDisplayScaleFilter m_display_scale_filter = GPUDisplayScaleFilter::Nearest;
+  u32 m_display_scale = 1;
+  bool m_display_chroma_smoothing = false;
+
+  // Scratch frames for the filters, used alternately as source and destination.
+  std::array<std::vector<u8>, 2> m_display_filter_frames;
+  u32 m_display_filter_frame_index = 0;
+  std::vector<u8> m_display_filter_rows;
+  std::vector<u16> m_display_filter_sums;
+
+  std::array<TextureCacheEntry, TEXTURE_CACHE_SIZE> m_texture_cache = {};
+  u32 m_texture_cache_counter = 0;
+
+  // Commands waiting to be rendered by the band threads. The batch holds a reference to the chunks which they're in.
+  std::vector<const GPUBackendCommand*> m_batch_commands;
+  std::vector<const TextureCacheEntry*> m_batch_textures;
+  std::vector<CommandChunk*> m_batch_chunks;
+  u32 m_batch_size = 0;
+  u32 m_batch_number = 0;
+  HazardTileMask m_batch_read_tiles;
+  HazardTileMask m_batch_write_tiles;
+
+  std::vector<RenderBand> m_render_bands;
+  std::vector<std::thread> m_render_threads;
+  std::mutex m_render_mutex;
+  std::condition_variable m_render_start_cv;
+  std::condition_variable m_render_done_cv;
+  u32 m_render_generation = 0;
+  u32 m_render_threads_busy = 0;
+  bool m_render_threads_shutdown = false;
 };
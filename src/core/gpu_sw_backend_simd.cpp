@@ -0,0 +1,301 @@
+#include "gpu_sw_backend_simd.h"
+#include "common/cpu_features.h"
+#include <algorithm>
+
+#if defined(CPU_X64) || defined(CPU_X86)
+#include <immintrin.h>
+#endif
+
+// The kernels are written once in gpu_sw_backend_simd.inl and gpu_sw_backend_simd_display.inl, and compiled for each
+// instruction set by enabling it for everything in between these macros.
+#if defined(__clang__)
+#define BEGIN_CPU_TARGET(isa) _Pragma(isa)
+#define END_CPU_TARGET() _Pragma("clang attribute pop")
+#define SSE41_TARGET_PRAGMA "clang attribute push(__attribute__((target(\"sse4.1\"))), apply_to = function)"
+#define AVX2_TARGET_PRAGMA "clang attribute push(__attribute__((target(\"avx2\"))), apply_to = function)"
+#elif defined(__GNUC__)
+#define BEGIN_CPU_TARGET(isa) _Pragma("GCC push_options") _Pragma(isa)
+#define END_CPU_TARGET() _Pragma("GCC pop_options")
+#define SSE41_TARGET_PRAGMA "GCC target(\"sse4.1\")"
+#define AVX2_TARGET_PRAGMA "GCC target(\"avx2\")"
+#else
+#define BEGIN_CPU_TARGET(isa)
+#define END_CPU_TARGET()
+#endif
+
+namespace GPU_SW_SIMD {
+
+#if defined(CPU_X64) || defined(CPU_X86)
+
+BEGIN_CPU_TARGET(SSE41_TARGET_PRAGMA)
+
+namespace SSE41 {
+
+using Vec = __m128i;
+static constexpr u32 LANES = 8;
+
+ALWAYS_INLINE static Vec Load(const void* ptr)
+{
+  return _mm_loadu_si128(static_cast<const __m128i*>(ptr));
+}
+ALWAYS_INLINE static void Store(void* ptr, Vec v)
+{
+  _mm_storeu_si128(static_cast<__m128i*>(ptr), v);
+}
+ALWAYS_INLINE static Vec Set1(s16 value)
+{
+  return _mm_set1_epi16(value);
+}
+ALWAYS_INLINE static Vec Add(Vec a, Vec b)
+{
+  return _mm_add_epi16(a, b);
+}
+ALWAYS_INLINE static Vec Sub(Vec a, Vec b)
+{
+  return _mm_sub_epi16(a, b);
+}
+ALWAYS_INLINE static Vec Mul(Vec a, Vec b)
+{
+  return _mm_mullo_epi16(a, b);
+}
+ALWAYS_INLINE static Vec And(Vec a, Vec b)
+{
+  return _mm_and_si128(a, b);
+}
+ALWAYS_INLINE static Vec Or(Vec a, Vec b)
+{
+  return _mm_or_si128(a, b);
+}
+ALWAYS_INLINE static Vec AndNot(Vec a, Vec b)
+{
+  return _mm_andnot_si128(a, b);
+}
+template<u32 shift>
+ALWAYS_INLINE static Vec Srl(Vec v)
+{
+  return _mm_srli_epi16(v, shift);
+}
+template<u32 shift>
+ALWAYS_INLINE static Vec Sra(Vec v)
+{
+  return _mm_srai_epi16(v, shift);
+}
+template<u32 shift>
+ALWAYS_INLINE static Vec Sll(Vec v)
+{
+  return _mm_slli_epi16(v, shift);
+}
+ALWAYS_INLINE static Vec MinS16(Vec a, Vec b)
+{
+  return _mm_min_epi16(a, b);
+}
+ALWAYS_INLINE static Vec MaxS16(Vec a, Vec b)
+{
+  return _mm_max_epi16(a, b);
+}
+ALWAYS_INLINE static Vec CmpEq(Vec a, Vec b)
+{
+  return _mm_cmpeq_epi16(a, b);
+}
+ALWAYS_INLINE static Vec Select(Vec mask, Vec a, Vec b)
+{
+  return _mm_blendv_epi8(b, a, mask);
+}
+ALWAYS_INLINE static Vec LoadWiden(const u8* ptr)
+{
+  return _mm_cvtepu8_epi16(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ptr)));
+}
+ALWAYS_INLINE static void StoreNarrow(u8* ptr, Vec v)
+{
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(ptr), _mm_packus_epi16(v, v));
+}
+
+#include "gpu_sw_backend_simd.inl"
+#include "gpu_sw_backend_simd_display.inl"
+
+} // namespace SSE41
+
+END_CPU_TARGET()
+
+BEGIN_CPU_TARGET(AVX2_TARGET_PRAGMA)
+
+namespace AVX2 {
+
+using Vec = __m256i;
+static constexpr u32 LANES = 16;
+
+ALWAYS_INLINE static Vec Load(const void* ptr)
+{
+  return _mm256_loadu_si256(static_cast<const __m256i*>(ptr));
+}
+ALWAYS_INLINE static void Store(void* ptr, Vec v)
+{
+  _mm256_storeu_si256(static_cast<__m256i*>(ptr), v);
+}
+ALWAYS_INLINE static Vec Set1(s16 value)
+{
+  return _mm256_set1_epi16(value);
+}
+ALWAYS_INLINE static Vec Add(Vec a, Vec b)
+{
+  return _mm256_add_epi16(a, b);
+}
+ALWAYS_INLINE static Vec Sub(Vec a, Vec b)
+{
+  return _mm256_sub_epi16(a, b);
+}
+ALWAYS_INLINE static Vec Mul(Vec a, Vec b)
+{
+  return _mm256_mullo_epi16(a, b);
+}
+ALWAYS_INLINE static Vec And(Vec a, Vec b)
+{
+  return _mm256_and_si256(a, b);
+}
+ALWAYS_INLINE static Vec Or(Vec a, Vec b)
+{
+  return _mm256_or_si256(a, b);
+}
+ALWAYS_INLINE static Vec AndNot(Vec a, Vec b)
+{
+  return _mm256_andnot_si256(a, b);
+}
+template<u32 shift>
+ALWAYS_INLINE static Vec Srl(Vec v)
+{
+  return _mm256_srli_epi16(v, shift);
+}
+template<u32 shift>
+ALWAYS_INLINE static Vec Sra(Vec v)
+{
+  return _mm256_srai_epi16(v, shift);
+}
+template<u32 shift>
+ALWAYS_INLINE static Vec Sll(Vec v)
+{
+  return _mm256_slli_epi16(v, shift);
+}
+ALWAYS_INLINE static Vec MinS16(Vec a, Vec b)
+{
+  return _mm256_min_epi16(a, b);
+}
+ALWAYS_INLINE static Vec MaxS16(Vec a, Vec b)
+{
+  return _mm256_max_epi16(a, b);
+}
+ALWAYS_INLINE static Vec CmpEq(Vec a, Vec b)
+{
+  return _mm256_cmpeq_epi16(a, b);
+}
+ALWAYS_INLINE static Vec Select(Vec mask, Vec a, Vec b)
+{
+  return _mm256_blendv_epi8(b, a, mask);
+}
+ALWAYS_INLINE static Vec LoadWiden(const u8* ptr)
+{
+  return _mm256_cvtepu8_epi16(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)));
+}
+ALWAYS_INLINE static void StoreNarrow(u8* ptr, Vec v)
+{
+  // Packing the two halves separately keeps the bytes in order.
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr),
+                   _mm_packus_epi16(_mm256_castsi256_si128(v), _mm256_extracti128_si256(v, 1)));
+}
+
+#include "gpu_sw_backend_simd.inl"
+#include "gpu_sw_backend_simd_display.inl"
+
+} // namespace AVX2
+
+END_CPU_TARGET()
+
+#endif
+
+// Plain C++ for the display filters, one 16-bit lane at a time. The span shading kernel has its own scalar path in
+// the backend, so it isn't built here.
+namespace Generic {
+
+using Vec = u16;
+static constexpr u32 LANES = 1;
+
+ALWAYS_INLINE static Vec Load(const u16* ptr)
+{
+  return *ptr;
+}
+ALWAYS_INLINE static void Store(u16* ptr, Vec v)
+{
+  *ptr = v;
+}
+ALWAYS_INLINE static Vec Set1(s16 value)
+{
+  return static_cast<u16>(value);
+}
+ALWAYS_INLINE static Vec Add(Vec a, Vec b)
+{
+  return static_cast<u16>(a + b);
+}
+ALWAYS_INLINE static Vec Sub(Vec a, Vec b)
+{
+  return static_cast<u16>(a - b);
+}
+ALWAYS_INLINE static Vec Mul(Vec a, Vec b)
+{
+  return static_cast<u16>(a * b);
+}
+template<u32 shift>
+ALWAYS_INLINE static Vec Srl(Vec v)
+{
+  return static_cast<u16>(v >> shift);
+}
+template<u32 shift>
+ALWAYS_INLINE static Vec Sra(Vec v)
+{
+  return static_cast<u16>(static_cast<s16>(v) >> shift);
+}
+template<u32 shift>
+ALWAYS_INLINE static Vec Sll(Vec v)
+{
+  return static_cast<u16>(v << shift);
+}
+ALWAYS_INLINE static Vec LoadWiden(const u8* ptr)
+{
+  return *ptr;
+}
+ALWAYS_INLINE static void StoreNarrow(u8* ptr, Vec v)
+{
+  *ptr = static_cast<u8>(std::clamp<s32>(static_cast<s16>(v), 0, 255));
+}
+
+#include "gpu_sw_backend_simd_display.inl"
+
+} // namespace Generic
+
+const ShadeSpanFunctionTable* GetShadeSpanFunctionTable()
+{
+#if defined(CPU_X64) || defined(CPU_X86)
+  if (CPUFeatures::HasAVX2())
+    return &AVX2::s_shade_span_function_table;
+  else if (CPUFeatures::HasSSE41())
+    return &SSE41::s_shade_span_function_table;
+  else
+    return nullptr;
+#else
+  return nullptr;
+#endif
+}
+
+const DisplayFilterFunctionTable* GetDisplayFilterFunctionTable()
+{
+#if defined(CPU_X64) || defined(CPU_X86)
+  if (CPUFeatures::HasAVX2())
+    return &AVX2::s_display_filter_function_table;
+  else if (CPUFeatures::HasSSE41())
+    return &SSE41::s_display_filter_function_table;
+  else
+    return &Generic::s_display_filter_function_table;
+#else
+  return &Generic::s_display_filter_function_table;
+#endif
+}
+
+} // namespace GPU_SW_SIMD
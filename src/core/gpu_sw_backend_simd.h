@@ -0,0 +1,61 @@
+#pragma once
+#include "gpu_types.h"
+
+namespace GPU_SW_SIMD {
+
+/// Inputs for shading a run of pixels on one row. Texels and colours are fetched and interpolated by the rasterizer,
+/// everything after that (modulation, dithering, blending, mask bits) is done by the vector code.
+struct SpanInput
+{
+  static constexpr u32 SIZE = 16;
+
+  alignas(32) u16 texels[SIZE];
+  alignas(32) u16 r[SIZE];
+  alignas(32) u16 g[SIZE];
+  alignas(32) u16 b[SIZE];
+  alignas(32) s16 dither[SIZE];
+
+  u16 mask_and;
+  u16 mask_or;
+  GPUTransparencyMode transparency_mode;
+};
+
+/// Shades SpanInput::SIZE pixels starting at dst, producing the same result as ShadePixel() for each of them.
+using ShadeSpanFunction = void (*)(u16* dst, const SpanInput& span);
+
+/// Indexed by [texture_enable][raw_texture_enable][transparency_enable].
+struct ShadeSpanFunctionTable
+{
+  ShadeSpanFunction functions[2][2][2];
+};
+
+/// Returns the best kernels for the host CPU, or nullptr if there aren't any.
+const ShadeSpanFunctionTable* GetShadeSpanFunctionTable();
+
+/// Interpolation weights used by the display filters, where this value selects the second input.
+static constexpr u32 DISPLAY_FILTER_WEIGHT_ONE = 128;
+
+/// Row operations for post-processing the display on the CPU. They work on bytes, so any 32-bit pixel layout can be
+/// passed in, and count is the number of bytes rather than pixels.
+struct DisplayFilterFunctionTable
+{
+  /// dst = a + (b - a) * weight, with one weight for the whole row.
+  void (*lerp_rows)(u8* dst, const u8* a, const u8* b, u32 count, u32 weight);
+
+  /// dst = a + (b - a) * weights[i], with a weight for each byte.
+  void (*lerp_columns)(u8* dst, const u8* a, const u8* b, const u8* weights, u32 count);
+
+  /// acc += src, for summing rows in a box filter.
+  void (*accumulate_row)(u16* acc, const u8* src, u32 count);
+
+  /// dst = (above + row * 2 + below) / 4.
+  void (*blur_rows)(u8* dst, const u8* above, const u8* row, const u8* below, u32 count);
+
+  /// dst = (left + centre * 2 + right) / 4 for 32-bit pixels. src[-4] and src[count + 3] must be readable.
+  void (*blur_columns)(u8* dst, const u8* src, u32 count);
+};
+
+/// Returns the best display filters for the host CPU. There is always a (scalar) implementation.
+const DisplayFilterFunctionTable* GetDisplayFilterFunctionTable();
+
+} // namespace GPU_SW_SIMD
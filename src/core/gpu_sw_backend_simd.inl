@@ -0,0 +1,105 @@
+// Span shading kernel, included once per instruction set by gpu_sw_backend_simd.cpp. The including file provides Vec,
+// LANES and the operations on 16-bit lanes used below.
+
+template<u32 shift>
+ALWAYS_INLINE static Vec BlendChannel(GPUTransparencyMode mode, Vec fg, Vec bg)
+{
+  // Per-channel equivalent of the 15bpp pixel math in ShadePixel(), which only blends when bit 15 is set.
+  const Vec channel_mask = Set1(0x1F);
+  const Vec f = And(Srl<shift>(fg), channel_mask);
+  const Vec b = And(Srl<shift>(bg), channel_mask);
+
+  Vec result;
+  switch (mode)
+  {
+    case GPUTransparencyMode::HalfBackgroundPlusHalfForeground:
+      result = Srl<1>(Add(b, f));
+      break;
+
+    case GPUTransparencyMode::BackgroundPlusForeground:
+      result = MinS16(Add(b, f), channel_mask);
+      break;
+
+    case GPUTransparencyMode::BackgroundMinusForeground:
+      result = MaxS16(Sub(b, f), Set1(0));
+      break;
+
+    case GPUTransparencyMode::BackgroundPlusQuarterForeground:
+    default:
+      result = MinS16(Add(b, Srl<2>(f)), channel_mask);
+      break;
+  }
+
+  return Sll<shift>(result);
+}
+
+ALWAYS_INLINE static Vec DitherChannel(Vec value, Vec dither)
+{
+  // Same as s_dither_lut: ((value + offset) >> 3) clamped to 0..31.
+  return MinS16(MaxS16(Sra<3>(Add(value, dither)), Set1(0)), Set1(0x1F));
+}
+
+template<bool texture_enable, bool raw_texture_enable, bool transparency_enable>
+static void ShadeSpan(u16* dst, const SpanInput& span)
+{
+  const Vec zero = Set1(0);
+  const Vec bit15 = Set1(static_cast<s16>(0x8000));
+  const Vec channel_mask = Set1(0x1F);
+  const Vec mask_and = Set1(static_cast<s16>(span.mask_and));
+  const Vec mask_or = Set1(static_cast<s16>(span.mask_or));
+
+  for (u32 i = 0; i < SpanInput::SIZE; i += LANES)
+  {
+    Vec color;
+    Vec skip;
+    if constexpr (texture_enable)
+    {
+      const Vec texel = Load(&span.texels[i]);
+      skip = CmpEq(texel, zero);
+
+      if constexpr (raw_texture_enable)
+      {
+        color = texel;
+      }
+      else
+      {
+        const Vec dither = Load(&span.dither[i]);
+        const Vec r = Srl<4>(Mul(And(texel, channel_mask), Load(&span.r[i])));
+        const Vec g = Srl<4>(Mul(And(Srl<5>(texel), channel_mask), Load(&span.g[i])));
+        const Vec b = Srl<4>(Mul(And(Srl<10>(texel), channel_mask), Load(&span.b[i])));
+        color = Or(Or(DitherChannel(r, dither), Sll<5>(DitherChannel(g, dither))),
+                   Or(Sll<10>(DitherChannel(b, dither)), And(texel, bit15)));
+      }
+    }
+    else
+    {
+      const Vec dither = Load(&span.dither[i]);
+      skip = zero;
+      color = Or(Or(DitherChannel(Load(&span.r[i]), dither), Sll<5>(DitherChannel(Load(&span.g[i]), dither))),
+                 Sll<10>(DitherChannel(Load(&span.b[i]), dither)));
+    }
+
+    const Vec bg = Load(&dst[i]);
+    if constexpr (transparency_enable)
+    {
+      const GPUTransparencyMode mode = span.transparency_mode;
+      const Vec blended =
+        Or(Or(BlendChannel<0>(mode, color, bg), BlendChannel<5>(mode, color, bg)), BlendChannel<10>(mode, color, bg));
+
+      // Non-textured transparent polygons are always blended, and don't set bit 15.
+      if constexpr (texture_enable)
+        color = Select(CmpEq(And(color, bit15), bit15), Or(blended, bit15), color);
+      else
+        color = blended;
+    }
+
+    skip = Or(skip, AndNot(CmpEq(And(bg, mask_and), zero), CmpEq(zero, zero)));
+    Store(&dst[i], Select(skip, bg, Or(color, mask_or)));
+  }
+}
+
+static constexpr ShadeSpanFunctionTable s_shade_span_function_table = {
+  {{{&ShadeSpan<false, false, false>, &ShadeSpan<false, false, true>},
+    {&ShadeSpan<false, false, false>, &ShadeSpan<false, false, true>}},
+   {{&ShadeSpan<true, false, false>, &ShadeSpan<true, false, true>},
+    {&ShadeSpan<true, true, false>, &ShadeSpan<true, true, true>}}}};
@@ -0,0 +1,79 @@
+// Display filter kernels, included once per instruction set by gpu_sw_backend_simd.cpp. Bytes are widened to 16-bit
+// lanes with LoadWiden() and narrowed with saturation by StoreNarrow(), the rest is the same operations as the span
+// shading kernel.
+
+ALWAYS_INLINE static u8 LerpByte(u32 a, u32 b, u32 weight)
+{
+  const s32 delta = static_cast<s32>(b) - static_cast<s32>(a);
+  return static_cast<u8>(static_cast<s32>(a) +
+                         (((delta * static_cast<s32>(weight)) + static_cast<s32>(DISPLAY_FILTER_WEIGHT_ONE / 2)) >> 7));
+}
+
+ALWAYS_INLINE static Vec LerpVec(Vec a, Vec b, Vec weight)
+{
+  // (b - a) * weight is at most 255 * 128, so it doesn't overflow the signed 16-bit lanes.
+  return Add(a, Sra<7>(Add(Mul(Sub(b, a), weight), Set1(static_cast<s16>(DISPLAY_FILTER_WEIGHT_ONE / 2)))));
+}
+
+static void LerpRows(u8* dst, const u8* a, const u8* b, u32 count, u32 weight)
+{
+  const Vec vweight = Set1(static_cast<s16>(weight));
+
+  u32 i = 0;
+  for (; (i + LANES) <= count; i += LANES)
+    StoreNarrow(&dst[i], LerpVec(LoadWiden(&a[i]), LoadWiden(&b[i]), vweight));
+  for (; i < count; i++)
+    dst[i] = LerpByte(a[i], b[i], weight);
+}
+
+static void LerpColumns(u8* dst, const u8* a, const u8* b, const u8* weights, u32 count)
+{
+  u32 i = 0;
+  for (; (i + LANES) <= count; i += LANES)
+    StoreNarrow(&dst[i], LerpVec(LoadWiden(&a[i]), LoadWiden(&b[i]), LoadWiden(&weights[i])));
+  for (; i < count; i++)
+    dst[i] = LerpByte(a[i], b[i], weights[i]);
+}
+
+static void AccumulateRow(u16* acc, const u8* src, u32 count)
+{
+  u32 i = 0;
+  for (; (i + LANES) <= count; i += LANES)
+    Store(&acc[i], Add(Load(&acc[i]), LoadWiden(&src[i])));
+  for (; i < count; i++)
+    acc[i] += src[i];
+}
+
+static void BlurRows(u8* dst, const u8* above, const u8* row, const u8* below, u32 count)
+{
+  const Vec round = Set1(2);
+
+  u32 i = 0;
+  for (; (i + LANES) <= count; i += LANES)
+  {
+    const Vec sum = Add(Add(LoadWiden(&above[i]), LoadWiden(&below[i])), Add(Sll<1>(LoadWiden(&row[i])), round));
+    StoreNarrow(&dst[i], Srl<2>(sum));
+  }
+  for (; i < count; i++)
+    dst[i] = static_cast<u8>((above[i] + (row[i] * 2u) + below[i] + 2u) >> 2);
+}
+
+static void BlurColumns(u8* dst, const u8* src, u32 count)
+{
+  // The neighbouring pixels are the previous and next four bytes.
+  const u8* left = src - 4;
+  const u8* right = src + 4;
+  const Vec round = Set1(2);
+
+  u32 i = 0;
+  for (; (i + LANES) <= count; i += LANES)
+  {
+    const Vec sum = Add(Add(LoadWiden(&left[i]), LoadWiden(&right[i])), Add(Sll<1>(LoadWiden(&src[i])), round));
+    StoreNarrow(&dst[i], Srl<2>(sum));
+  }
+  for (; i < count; i++)
+    dst[i] = static_cast<u8>((left[i] + (src[i] * 2u) + right[i] + 2u) >> 2);
+}
+
+static constexpr DisplayFilterFunctionTable s_display_filter_function_table = {&LerpRows, &LerpColumns, &AccumulateRow,
+                                                                               &BlurRows, &BlurColumns};
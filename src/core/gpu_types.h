@@ -4,6 +4,8 @@
 #include "types.h"
 #include <array>
 
+enum class HostDisplayPixelFormat : u32;
+
 inline constexpr u32 VRAM_WIDTH = 1024, VRAM_HEIGHT = 512, VRAM_SIZE = VRAM_WIDTH * VRAM_HEIGHT * sizeof(u16),
                      VRAM_WIDTH_MASK = VRAM_WIDTH - 1, VRAM_HEIGHT_MASK = VRAM_HEIGHT - 1, TEXTURE_PAGE_WIDTH = 256,
                      TEXTURE_PAGE_HEIGHT = 256,
@@ -201,6 +203,40 @@ struct GPUTextureWindow
   u8 or_y;
 };
 
+// Counters for the work done by the renderer in a frame. Command counts come from the GPU, batching and readbacks from
+// the hardware renderers, and batches/draw calls from the software backend when it's the active renderer.
+struct GPUStats
+{
+  u32 num_primitives;
+  u32 num_vertices;
+  u32 num_batches;
+  u32 num_flushes;
+  u32 num_draw_calls;
+  u32 num_pipeline_switches;
+  u32 num_uniform_buffer_updates;
+  u32 num_vram_fills;
+  u32 num_vram_writes;
+  u32 num_vram_copies;
+  u32 num_vram_reads;
+  u32 num_vram_readbacks;
+
+  void Add(const GPUStats& rhs)
+  {
+    num_primitives += rhs.num_primitives;
+    num_vertices += rhs.num_vertices;
+    num_batches += rhs.num_batches;
+    num_flushes += rhs.num_flushes;
+    num_draw_calls += rhs.num_draw_calls;
+    num_pipeline_switches += rhs.num_pipeline_switches;
+    num_uniform_buffer_updates += rhs.num_uniform_buffer_updates;
+    num_vram_fills += rhs.num_vram_fills;
+    num_vram_writes += rhs.num_vram_writes;
+    num_vram_copies += rhs.num_vram_copies;
+    num_vram_reads += rhs.num_vram_reads;
+    num_vram_readbacks += rhs.num_vram_readbacks;
+  }
+};
+
 // 4x4 dither matrix.
 static constexpr s32 DITHER_MATRIX[DITHER_MATRIX_SIZE][DITHER_MATRIX_SIZE] = {{-4, +0, -3, +1},  // row 0
                                                                               {+2, -2, +3, -1},  // row 1
@@ -214,7 +250,6 @@ static constexpr s32 DITHER_MATRIX[DITHER_MATRIX_SIZE][DITHER_MATRIX_SIZE] = {{-
 
 enum class GPUBackendCommandType : u8
 {
-  Wraparound,
   Sync,
   FillVRAM,
   UpdateVRAM,
@@ -222,7 +257,8 @@ enum class GPUBackendCommandType : u8
   SetDrawingArea,
   DrawPolygon,
   DrawRectangle,
-  DrawLine
+  DrawLine,
+  UpdateDisplay
 };
 
 union GPUBackendCommandParameters
@@ -378,6 +414,27 @@ struct GPUBackendDrawLineCommand : public GPUBackendDrawCommand
   Vertex vertices[0];
 };
 
+struct GPUBackendUpdateDisplayCommand : public GPUBackendCommand
+{
+  HostDisplayPixelFormat format;
+  float display_aspect_ratio;
+  u16 display_width;
+  u16 display_height;
+  u16 display_origin_left;
+  u16 display_origin_top;
+  u16 src_x;
+  u16 src_y;
+  u16 skip_x;
+  u16 width;
+  u16 height;
+  u8 field;
+  bool display_disabled : 1;
+  bool display_24bit : 1;
+  bool interlaced : 1;
+  bool interleaved : 1;
+  bool clear_interlaced_buffer : 1;
+};
+
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
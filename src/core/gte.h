@@ -19,4 +19,7 @@ void ExecuteInstruction(u32 inst_bits);
 using InstructionImpl = void (*)(Instruction);
 InstructionImpl GetInstructionImpl(u32 inst_bits, TickCount* ticks);
 
+// reciprocal table for the RTPS/RTPT divide, for recompilers which emit it inline
+const u8* GetUNRTable();
+
 } // namespace GTE
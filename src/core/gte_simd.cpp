@@ -0,0 +1,133 @@
+#include "gte_simd.h"
+#include "common/cpu_features.h"
+
+#if defined(CPU_X64) || defined(CPU_X86)
+#include <immintrin.h>
+#elif defined(CPU_AARCH64)
+#include <arm_neon.h>
+#endif
+
+namespace GTE::SIMD {
+
+// Adding this bias moves the valid MAC1-3 range of -(1 << 43)..(1 << 43)-1 to 0..(1 << 44)-1, so a value is in range
+// when the biased value has no bits set above bit 43.
+static constexpr s64 MAC_RANGE_BIAS = INT64_C(1) << 43;
+static constexpr int MAC_RANGE_BITS = 44;
+
+#if defined(CPU_X64) || defined(CPU_X86)
+
+CPU_TARGET("sse4.1")
+static bool MulMatVec_SSE41(const s16 M[3][3], const s32 T[3], s16 Vx, s16 Vy, s16 Vz, s64 result[3])
+{
+  // 16x16 products fit in 32 bits, but the sums need 64. Rows 0 and 1 are in lo, row 2 is in hi.
+  const __m128i p0 = _mm_mullo_epi32(_mm_setr_epi32(M[0][0], M[1][0], M[2][0], 0), _mm_set1_epi32(Vx));
+  const __m128i p1 = _mm_mullo_epi32(_mm_setr_epi32(M[0][1], M[1][1], M[2][1], 0), _mm_set1_epi32(Vy));
+  const __m128i p2 = _mm_mullo_epi32(_mm_setr_epi32(M[0][2], M[1][2], M[2][2], 0), _mm_set1_epi32(Vz));
+  const __m128i t = _mm_setr_epi32(T[0], T[1], T[2], 0);
+  const __m128i bias = _mm_set1_epi64x(MAC_RANGE_BIAS);
+
+  __m128i lo = _mm_slli_epi64(_mm_cvtepi32_epi64(t), 12);
+  __m128i hi = _mm_slli_epi64(_mm_cvtepi32_epi64(_mm_srli_si128(t, 8)), 12);
+
+  lo = _mm_add_epi64(lo, _mm_cvtepi32_epi64(p0));
+  hi = _mm_add_epi64(hi, _mm_cvtepi32_epi64(_mm_srli_si128(p0, 8)));
+  __m128i overflow = _mm_or_si128(_mm_srli_epi64(_mm_add_epi64(lo, bias), MAC_RANGE_BITS),
+                                  _mm_srli_epi64(_mm_add_epi64(hi, bias), MAC_RANGE_BITS));
+
+  lo = _mm_add_epi64(lo, _mm_cvtepi32_epi64(p1));
+  hi = _mm_add_epi64(hi, _mm_cvtepi32_epi64(_mm_srli_si128(p1, 8)));
+  overflow = _mm_or_si128(overflow, _mm_srli_epi64(_mm_add_epi64(lo, bias), MAC_RANGE_BITS));
+  overflow = _mm_or_si128(overflow, _mm_srli_epi64(_mm_add_epi64(hi, bias), MAC_RANGE_BITS));
+
+  if (!_mm_testz_si128(overflow, overflow))
+    return false;
+
+  lo = _mm_add_epi64(lo, _mm_cvtepi32_epi64(p2));
+  hi = _mm_add_epi64(hi, _mm_cvtepi32_epi64(_mm_srli_si128(p2, 8)));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&result[0]), lo);
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(&result[2]), hi);
+  return true;
+}
+
+CPU_TARGET("avx2")
+static bool MulMatVec_AVX2(const s16 M[3][3], const s32 T[3], s16 Vx, s16 Vy, s16 Vz, s64 result[3])
+{
+  const __m128i p0 = _mm_mullo_epi32(_mm_setr_epi32(M[0][0], M[1][0], M[2][0], 0), _mm_set1_epi32(Vx));
+  const __m128i p1 = _mm_mullo_epi32(_mm_setr_epi32(M[0][1], M[1][1], M[2][1], 0), _mm_set1_epi32(Vy));
+  const __m128i p2 = _mm_mullo_epi32(_mm_setr_epi32(M[0][2], M[1][2], M[2][2], 0), _mm_set1_epi32(Vz));
+  const __m256i bias = _mm256_set1_epi64x(MAC_RANGE_BIAS);
+
+  __m256i sum = _mm256_slli_epi64(_mm256_cvtepi32_epi64(_mm_setr_epi32(T[0], T[1], T[2], 0)), 12);
+
+  sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(p0));
+  __m256i overflow = _mm256_srli_epi64(_mm256_add_epi64(sum, bias), MAC_RANGE_BITS);
+
+  sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(p1));
+  overflow = _mm256_or_si256(overflow, _mm256_srli_epi64(_mm256_add_epi64(sum, bias), MAC_RANGE_BITS));
+
+  if (!_mm256_testz_si256(overflow, overflow))
+    return false;
+
+  sum = _mm256_add_epi64(sum, _mm256_cvtepi32_epi64(p2));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(&result[0]), _mm256_castsi256_si128(sum));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(&result[2]), _mm256_extracti128_si256(sum, 1));
+  return true;
+}
+
+#elif defined(CPU_AARCH64)
+
+static bool MulMatVec_NEON(const s16 M[3][3], const s32 T[3], s16 Vx, s16 Vy, s16 Vz, s64 result[3])
+{
+  const s16 col0[4] = {M[0][0], M[1][0], M[2][0], 0};
+  const s16 col1[4] = {M[0][1], M[1][1], M[2][1], 0};
+  const s16 col2[4] = {M[0][2], M[1][2], M[2][2], 0};
+  const s32 trans[4] = {T[0], T[1], T[2], 0};
+
+  const int32x4_t p0 = vmull_n_s16(vld1_s16(col0), Vx);
+  const int32x4_t p1 = vmull_n_s16(vld1_s16(col1), Vy);
+  const int32x4_t p2 = vmull_n_s16(vld1_s16(col2), Vz);
+  const int32x4_t t = vld1q_s32(trans);
+  const int64x2_t bias = vdupq_n_s64(MAC_RANGE_BIAS);
+
+  int64x2_t lo = vshll_n_s32(vget_low_s32(t), 12);
+  int64x2_t hi = vshll_n_s32(vget_high_s32(t), 12);
+
+  lo = vaddw_s32(lo, vget_low_s32(p0));
+  hi = vaddw_s32(hi, vget_high_s32(p0));
+  uint64x2_t overflow = vorrq_u64(vshrq_n_u64(vreinterpretq_u64_s64(vaddq_s64(lo, bias)), MAC_RANGE_BITS),
+                                  vshrq_n_u64(vreinterpretq_u64_s64(vaddq_s64(hi, bias)), MAC_RANGE_BITS));
+
+  lo = vaddw_s32(lo, vget_low_s32(p1));
+  hi = vaddw_s32(hi, vget_high_s32(p1));
+  overflow = vorrq_u64(overflow, vshrq_n_u64(vreinterpretq_u64_s64(vaddq_s64(lo, bias)), MAC_RANGE_BITS));
+  overflow = vorrq_u64(overflow, vshrq_n_u64(vreinterpretq_u64_s64(vaddq_s64(hi, bias)), MAC_RANGE_BITS));
+
+  if (vmaxvq_u32(vreinterpretq_u32_u64(overflow)) != 0)
+    return false;
+
+  lo = vaddw_s32(lo, vget_low_s32(p2));
+  hi = vaddw_s32(hi, vget_high_s32(p2));
+  vst1q_s64(&result[0], lo);
+  result[2] = vgetq_lane_s64(hi, 0);
+  return true;
+}
+
+#endif
+
+MulMatVecFunction GetMulMatVecFunction()
+{
+#if defined(CPU_X64) || defined(CPU_X86)
+  if (CPUFeatures::HasAVX2())
+    return MulMatVec_AVX2;
+  else if (CPUFeatures::HasSSE41())
+    return MulMatVec_SSE41;
+  else
+    return nullptr;
+#elif defined(CPU_AARCH64)
+  return MulMatVec_NEON;
+#else
+  return nullptr;
+#endif
+}
+
+} // namespace GTE::SIMD
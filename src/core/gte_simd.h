@@ -0,0 +1,14 @@
+#pragma once
+#include "types.h"
+
+namespace GTE::SIMD {
+
+// Computes (T * 1000h) + (M * V) for all three rows at once. Returns false if any intermediate sum exceeds the 44-bit
+// MAC range, in which case the caller must use the scalar path so that the overflow flags and wrapping are correct.
+// The final sums aren't range checked, that's left to the MAC truncation.
+using MulMatVecFunction = bool (*)(const s16 M[3][3], const s32 T[3], s16 Vx, s16 Vy, s16 Vz, s64 result[3]);
+
+// Returns the best kernel for the host CPU, or nullptr if there isn't one.
+MulMatVecFunction GetMulMatVecFunction();
+
+} // namespace GTE::SIMD
@@ -257,6 +257,7 @@ void HostInterface::FixIncompatibleSettings(bool display_osd_messages)
     g_settings.cpu_overclock_active = false;
     g_settings.enable_8mb_ram = false;
     g_settings.gpu_resolution_scale = 1;
+    g_settings.gpu_sw_resolution_scale = 1;
     g_settings.gpu_multisamples = 1;
     g_settings.gpu_per_sample_shading = false;
     g_settings.gpu_true_color = false;
@@ -340,10 +341,22 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
       CPU::ClearICache();
     }
 
+    // idle loops are detected when blocks are compiled
+    if (g_settings.IsUsingCodeCache() && g_settings.cpu_idle_loop_skipping != old_settings.cpu_idle_loop_skipping)
+      CPU::CodeCache::Flush();
+
+    // the recompiler only emits RTPS/RTPT inline without the widescreen hack
+    if (g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler &&
+        g_settings.gpu_widescreen_hack != old_settings.gpu_widescreen_hack)
+    {
+      CPU::CodeCache::Flush();
+    }
+
     if (g_settings.cpu_execution_mode == CPUExecutionMode::Recompiler &&
         (g_settings.cpu_recompiler_memory_exceptions != old_settings.cpu_recompiler_memory_exceptions ||
          g_settings.cpu_recompiler_block_linking != old_settings.cpu_recompiler_block_linking ||
-         g_settings.cpu_recompiler_icache != old_settings.cpu_recompiler_icache))
+         g_settings.cpu_recompiler_icache != old_settings.cpu_recompiler_icache ||
+         g_settings.cpu_recompiler_hot_block_threshold != old_settings.cpu_recompiler_hot_block_threshold))
     {
       // changing memory exceptions can re-enable fastmem
       if (g_settings.cpu_recompiler_memory_exceptions != old_settings.cpu_recompiler_memory_exceptions)
@@ -359,16 +372,22 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
         g_settings.gpu_multisamples != old_settings.gpu_multisamples ||
         g_settings.gpu_per_sample_shading != old_settings.gpu_per_sample_shading ||
         g_settings.gpu_use_thread != old_settings.gpu_use_thread ||
+        g_settings.gpu_sw_render_threads != old_settings.gpu_sw_render_threads ||
+        g_settings.gpu_sw_resolution_scale != old_settings.gpu_sw_resolution_scale ||
         g_settings.gpu_use_software_renderer_for_readbacks != old_settings.gpu_use_software_renderer_for_readbacks ||
+        g_settings.gpu_async_readbacks != old_settings.gpu_async_readbacks ||
         g_settings.gpu_fifo_size != old_settings.gpu_fifo_size ||
         g_settings.gpu_max_run_ahead != old_settings.gpu_max_run_ahead ||
         g_settings.gpu_true_color != old_settings.gpu_true_color ||
         g_settings.gpu_scaled_dithering != old_settings.gpu_scaled_dithering ||
+        g_settings.gpu_ubershader != old_settings.gpu_ubershader ||
         g_settings.gpu_texture_filter != old_settings.gpu_texture_filter ||
         g_settings.gpu_disable_interlacing != old_settings.gpu_disable_interlacing ||
         g_settings.gpu_force_ntsc_timings != old_settings.gpu_force_ntsc_timings ||
         g_settings.gpu_24bit_chroma_smoothing != old_settings.gpu_24bit_chroma_smoothing ||
         g_settings.gpu_downsample_mode != old_settings.gpu_downsample_mode ||
+        g_settings.gpu_sw_display_scale != old_settings.gpu_sw_display_scale ||
+        g_settings.gpu_sw_display_scale_filter != old_settings.gpu_sw_display_scale_filter ||
         g_settings.display_crop_mode != old_settings.display_crop_mode ||
         g_settings.display_aspect_ratio != old_settings.display_aspect_ratio ||
         g_settings.gpu_pgxp_enable != old_settings.gpu_pgxp_enable ||
@@ -433,11 +452,29 @@ void HostInterface::CheckForSettingsChanges(const Settings& old_settings)
 
     if (g_settings.texture_replacements.enable_vram_write_replacements !=
           old_settings.texture_replacements.enable_vram_write_replacements ||
-        g_settings.texture_replacements.preload_textures != old_settings.texture_replacements.preload_textures)
+        g_settings.texture_replacements.preload_textures != old_settings.texture_replacements.preload_textures ||
+        g_settings.texture_replacements.use_texture_pack != old_settings.texture_replacements.use_texture_pack ||
+        g_settings.texture_replacements.cache_size_mb != old_settings.texture_replacements.cache_size_mb)
     {
       g_texture_replacements.Reload();
     }
 
+    if (g_settings.gpu_dump_frames != old_settings.gpu_dump_frames)
+    {
+      if (g_settings.gpu_dump_frames > 0)
+        System::StartGPUDump(g_settings.gpu_dump_frames);
+      else
+        g_gpu->StopGPUDump();
+    }
+
+    if (g_settings.gpu_log_stats != old_settings.gpu_log_stats)
+    {
+      if (g_settings.gpu_log_stats)
+        System::StartGPUStatsLog();
+      else
+        System::StopGPUStatsLog();
+    }
+
     g_dma.SetMaxSliceTicks(g_settings.dma_max_slice_ticks);
     g_dma.SetHaltTicks(g_settings.dma_halt_ticks);
   }
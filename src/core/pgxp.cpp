@@ -22,9 +22,14 @@
 #include "bus.h"
 #include "cpu_core.h"
 #include "settings.h"
+#include <array>
 #include <climits>
 #include <cmath>
 
+#if defined(CPU_X64)
+#include <emmintrin.h>
+#endif
+
 namespace PGXP {
 
 inline constexpr u32 VERTEX_CACHE_WIDTH = 0x800 * 2, VERTEX_CACHE_HEIGHT = 0x800 * 2,
@@ -58,6 +63,20 @@ typedef struct PGXP_value_Tag
   unsigned int value;
 } PGXP_value;
 
+// Memory is shadowed with 16 byte values instead of PGXP_value, so each word is one vector load or store. The VALID
+// bits of the four components are kept in the low mantissa bits of z, which still leaves it far more precision than
+// the 16-bit SZ3 it comes from.
+struct PGXP_mem_value
+{
+  float x;
+  float y;
+  u32 z_and_flags;
+  u32 value;
+};
+static_assert(sizeof(PGXP_mem_value) == 16);
+
+inline constexpr u32 PGXP_MEM_FLAGS_MASK = 0xF;
+
 typedef union
 {
   struct
@@ -90,8 +109,13 @@ static double f16Sign(double in);
 static double f16Unsign(double in);
 static double f16Overflow(double in);
 
-static PGXP_value* GetPtr(u32 addr);
-static PGXP_value* ReadMem(u32 addr);
+static u32 PackMemFlags(u32 flags);
+static u32 UnpackMemFlags(u32 z_and_flags);
+static void PackMem(PGXP_mem_value* dest, const PGXP_value* src);
+static void UnpackMem(PGXP_value* dest, const PGXP_mem_value* src);
+static PGXP_mem_value* GetPtr(u32 addr);
+static void AllocateMem();
+static void FreeMem();
 
 static const PGXP_value PGXP_value_invalid = {0.f, 0.f, 0.f, {0}, 0};
 static const PGXP_value PGXP_value_zero = {0.f, 0.f, 0.f, {VALID_ALL}, 0};
@@ -105,7 +129,7 @@ static PGXP_value CP0_reg[32];
 static PGXP_value GTE_data_reg[32];
 static PGXP_value GTE_ctrl_reg[32];
 
-static PGXP_value* Mem = nullptr;
+static PGXP_mem_value* Mem = nullptr;
 static PGXP_value* vertexCache = nullptr;
 
 ALWAYS_INLINE_RELEASE void MakeValid(PGXP_value* pV, u32 psxV)
@@ -149,7 +173,57 @@ ALWAYS_INLINE_RELEASE double f16Overflow(double in)
   return out;
 }
 
-ALWAYS_INLINE_RELEASE PGXP_value* GetPtr(u32 addr)
+ALWAYS_INLINE_RELEASE u32 PackMemFlags(u32 flags)
+{
+  // VALID_0..3 (bits 0, 8, 16, 24) to bits 0..3
+  return (((flags & VALID_ALL) * 0x01020408u) >> 24) & PGXP_MEM_FLAGS_MASK;
+}
+
+ALWAYS_INLINE_RELEASE u32 UnpackMemFlags(u32 z_and_flags)
+{
+  return ((z_and_flags & PGXP_MEM_FLAGS_MASK) * 0x00204081u) & VALID_ALL;
+}
+
+ALWAYS_INLINE_RELEASE void PackMem(PGXP_mem_value* dest, const PGXP_value* src)
+{
+  u32 z_bits;
+  std::memcpy(&z_bits, &src->z, sizeof(z_bits));
+  const u32 z_and_flags = (z_bits & ~PGXP_MEM_FLAGS_MASK) | PackMemFlags(src->flags);
+
+#if defined(CPU_X64)
+  const __m128i xy = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src));
+  const __m128i zv = _mm_unpacklo_epi32(_mm_cvtsi32_si128(static_cast<int>(z_and_flags)),
+                                        _mm_cvtsi32_si128(static_cast<int>(src->value)));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest), _mm_unpacklo_epi64(xy, zv));
+#else
+  dest->x = src->x;
+  dest->y = src->y;
+  dest->z_and_flags = z_and_flags;
+  dest->value = src->value;
+#endif
+}
+
+ALWAYS_INLINE_RELEASE void UnpackMem(PGXP_value* dest, const PGXP_mem_value* src)
+{
+#if defined(CPU_X64)
+  // x, y and z are already in place, the flags replace the last lane
+  const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src));
+  const u32 flags = UnpackMemFlags(static_cast<u32>(_mm_cvtsi128_si32(_mm_srli_si128(v, 8))));
+  const __m128i xyz = _mm_and_si128(v, _mm_setr_epi32(-1, -1, ~static_cast<int>(PGXP_MEM_FLAGS_MASK), 0));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(dest),
+                   _mm_or_si128(xyz, _mm_slli_si128(_mm_cvtsi32_si128(static_cast<int>(flags)), 12)));
+  dest->value = src->value;
+#else
+  const u32 z_bits = src->z_and_flags & ~PGXP_MEM_FLAGS_MASK;
+  dest->x = src->x;
+  dest->y = src->y;
+  std::memcpy(&dest->z, &z_bits, sizeof(dest->z));
+  dest->flags = UnpackMemFlags(src->z_and_flags);
+  dest->value = src->value;
+#endif
+}
+
+ALWAYS_INLINE_RELEASE PGXP_mem_value* GetPtr(u32 addr)
 {
   if ((addr & CPU::DCACHE_LOCATION_MASK) == CPU::DCACHE_LOCATION)
     return &Mem[PGXP_MEM_SCRATCH_OFFSET + ((addr & CPU::DCACHE_OFFSET_MASK) >> 2)];
@@ -161,18 +235,34 @@ ALWAYS_INLINE_RELEASE PGXP_value* GetPtr(u32 addr)
     return nullptr;
 }
 
-ALWAYS_INLINE_RELEASE PGXP_value* ReadMem(u32 addr)
+// A zeroed block this size comes straight from the OS, so only the parts of RAM which games store vertices to are
+// ever backed by memory. Reset frees and reallocates it rather than clearing 32MB.
+void AllocateMem()
 {
-  return GetPtr(addr);
+  Mem = static_cast<PGXP_mem_value*>(std::calloc(PGXP_MEM_SIZE, sizeof(PGXP_mem_value)));
+  if (!Mem)
+  {
+    std::fprintf(stderr, "Failed to allocate PGXP memory\n");
+    std::abort();
+  }
+}
+
+void FreeMem()
+{
+  std::free(Mem);
+  Mem = nullptr;
 }
 
 ALWAYS_INLINE_RELEASE void ValidateAndCopyMem(PGXP_value* dest, u32 addr, u32 value)
 {
-  PGXP_value* pMem = GetPtr(addr);
+  PGXP_mem_value* pMem = GetPtr(addr);
   if (pMem != NULL)
   {
-    Validate(pMem, value);
-    *dest = *pMem;
+    // same as Validate(), all of the flags are cleared if the value changed
+    if (pMem->value != value)
+      pMem->z_and_flags &= ~PGXP_MEM_FLAGS_MASK;
+
+    UnpackMem(dest, pMem);
     return;
   }
 
@@ -181,32 +271,20 @@ ALWAYS_INLINE_RELEASE void ValidateAndCopyMem(PGXP_value* dest, u32 addr, u32 va
 
 ALWAYS_INLINE_RELEASE static void ValidateAndCopyMem16(PGXP_value* dest, u32 addr, u32 value, int sign)
 {
-  u32 validMask = 0;
-  psx_value val, mask;
-  PGXP_value* pMem = GetPtr(addr);
+  PGXP_mem_value* pMem = GetPtr(addr);
   if (pMem != NULL)
   {
-    mask.d = val.d = 0;
-    // determine if high or low word
-    if ((addr % 4) == 2)
-    {
-      val.w.h = static_cast<u16>(value);
-      mask.w.h = 0xFFFF;
-      validMask = VALID_1;
-    }
-    else
-    {
-      val.w.l = static_cast<u16>(value);
-      mask.w.l = 0xFFFF;
-      validMask = VALID_0;
-    }
+    // determine if high or low word, and validate that half
+    const bool high = ((addr % 4) == 2);
+    const u32 shift = high ? 16 : 0;
+    if (static_cast<u16>(pMem->value >> shift) != static_cast<u16>(value))
+      pMem->z_and_flags &= ~(high ? 2u : 1u);
 
-    // validate and copy whole value
-    MaskValidate(pMem, val.d, mask.d, validMask);
-    *dest = *pMem;
+    // copy whole value
+    UnpackMem(dest, pMem);
 
     // if high word then shift
-    if ((addr % 4) == 2)
+    if (high)
     {
       dest->x = dest->y;
       dest->compFlags[0] = dest->compFlags[1];
@@ -224,19 +302,31 @@ ALWAYS_INLINE_RELEASE static void ValidateAndCopyMem16(PGXP_value* dest, u32 add
 
 ALWAYS_INLINE_RELEASE void WriteMem(const PGXP_value* value, u32 addr)
 {
-  PGXP_value* pMem = GetPtr(addr);
+  PGXP_mem_value* pMem = GetPtr(addr);
 
   if (pMem)
-    *pMem = *value;
+    PackMem(pMem, value);
+}
+
+ALWAYS_INLINE_RELEASE static void InvalidateMem(u32 addr)
+{
+  PGXP_mem_value* pMem = GetPtr(addr);
+
+  if (pMem)
+    *pMem = {};
 }
 
 ALWAYS_INLINE_RELEASE static void WriteMem16(const PGXP_value* src, u32 addr)
 {
-  PGXP_value* dest = GetPtr(addr);
+  PGXP_mem_value* pMem = GetPtr(addr);
   psx_value* pVal = NULL;
 
-  if (dest)
+  if (pMem)
   {
+    PGXP_value dest_value;
+    PGXP_value* dest = &dest_value;
+    UnpackMem(dest, pMem);
+
     pVal = (psx_value*)&dest->value;
     // determine if high or low word
     if ((addr % 4) == 2)
@@ -260,6 +350,7 @@ ALWAYS_INLINE_RELEASE static void WriteMem16(const PGXP_value* src, u32 addr)
     }
 
     // dest->valid = dest->valid && src->valid;
+    PackMem(pMem, dest);
   }
 }
 
@@ -272,14 +363,7 @@ void Initialize()
   std::memset(GTE_ctrl_reg, 0, sizeof(GTE_ctrl_reg));
 
   if (!Mem)
-  {
-    Mem = static_cast<PGXP_value*>(std::calloc(PGXP_MEM_SIZE, sizeof(PGXP_value)));
-    if (!Mem)
-    {
-      std::fprintf(stderr, "Failed to allocate PGXP memory\n");
-      std::abort();
-    }
-  }
+    AllocateMem();
 
   if (g_settings.gpu_pgxp_vertex_cache && !vertexCache)
   {
@@ -301,7 +385,10 @@ void Reset()
   std::memset(GTE_ctrl_reg, 0, sizeof(GTE_ctrl_reg));
 
   if (Mem)
-    std::memset(Mem, 0, sizeof(PGXP_value) * PGXP_MEM_SIZE);
+  {
+    FreeMem();
+    AllocateMem();
+  }
 
   if (vertexCache)
     std::memset(vertexCache, 0, sizeof(PGXP_value) * VERTEX_CACHE_SIZE);
@@ -314,11 +401,7 @@ void Shutdown()
     std::free(vertexCache);
     vertexCache = nullptr;
   }
-  if (Mem)
-  {
-    std::free(Mem);
-    Mem = nullptr;
-  }
+  FreeMem();
 
   std::memset(GTE_data_reg, 0, sizeof(GTE_data_reg));
   std::memset(GTE_ctrl_reg, 0, sizeof(GTE_ctrl_reg));
@@ -515,7 +598,15 @@ static ALWAYS_INLINE_RELEASE bool IsWithinTolerance(float precise_x, float preci
 
 bool GetPreciseVertex(u32 addr, u32 value, int x, int y, int xOffs, int yOffs, float* out_x, float* out_y, float* out_w)
 {
-  const PGXP_value* vert = ReadMem(addr);
+  const PGXP_mem_value* pMem = GetPtr(addr);
+  PGXP_value mem_value;
+  const PGXP_value* vert = nullptr;
+  if (pMem)
+  {
+    UnpackMem(&mem_value, pMem);
+    vert = &mem_value;
+  }
+
   if (vert && ((vert->flags & VALID_01) == VALID_01) && (vert->value == value))
   {
     // There is a value here with valid X and Y coordinates
@@ -585,7 +676,7 @@ void CPU_LHx(u32 instr, u32 rtVal, u32 addr)
 
 void CPU_SB(u32 instr, u8 rtVal, u32 addr)
 {
-  WriteMem(&PGXP_value_invalid, addr);
+  InvalidateMem(addr);
 }
 
 void CPU_SH(u32 instr, u16 rtVal, u32 addr)
@@ -150,8 +150,11 @@ void Settings::Load(SettingsInterface& si)
       si.GetStringValue("CPU", "ExecutionMode", GetCPUExecutionModeName(DEFAULT_CPU_EXECUTION_MODE)).c_str())
       .value_or(DEFAULT_CPU_EXECUTION_MODE);
 
+  cpu_idle_loop_skipping = si.GetBoolValue("CPU", "IdleLoopSkipping", false);
   cpu_recompiler_block_linking = si.GetBoolValue("CPU", "RecompilerBlockLinking", true);
   cpu_recompiler_icache = si.GetBoolValue("CPU", "RecompilerICache", false);
+  cpu_recompiler_hot_block_threshold =
+    static_cast<u32>(std::max(si.GetIntValue("CPU", "RecompilerHotBlockThreshold", 0), 0));
   cpu_fastmem_mode = ParseCPUFastmemMode(
                        si.GetStringValue("CPU", "FastmemMode", GetCPUFastmemModeName(DEFAULT_CPU_FASTMEM_MODE)).c_str())
                        .value_or(DEFAULT_CPU_FASTMEM_MODE);
@@ -161,9 +164,13 @@ void Settings::Load(SettingsInterface& si)
                    .value_or(DEFAULT_GPU_RENDERER);
   gpu_resolution_scale = static_cast<u32>(si.GetIntValue("GPU", "ResolutionScale", 1));
   gpu_use_thread = si.GetBoolValue("GPU", "UseThread", true);
+  gpu_sw_render_threads = static_cast<u32>(std::clamp(si.GetIntValue("GPU", "SoftwareRenderThreads", 1), 1, 16));
+  gpu_sw_resolution_scale = static_cast<u32>(std::clamp(si.GetIntValue("GPU", "SoftwareResolutionScale", 1), 1, 4));
   gpu_use_software_renderer_for_readbacks = si.GetBoolValue("GPU", "UseSoftwareRendererForReadbacks", false);
+  gpu_async_readbacks = si.GetBoolValue("GPU", "AsyncReadbacks", false);
   gpu_true_color = si.GetBoolValue("GPU", "TrueColor", false);
   gpu_scaled_dithering = si.GetBoolValue("GPU", "ScaledDithering", false);
+  gpu_ubershader = si.GetBoolValue("GPU", "Ubershader", false);
   gpu_texture_filter =
     ParseTextureFilterName(
       si.GetStringValue("GPU", "TextureFilter", GetTextureFilterName(DEFAULT_GPU_TEXTURE_FILTER)).c_str())
@@ -172,6 +179,12 @@ void Settings::Load(SettingsInterface& si)
     ParseDownsampleModeName(
       si.GetStringValue("GPU", "DownsampleMode", GetDownsampleModeName(DEFAULT_GPU_DOWNSAMPLE_MODE)).c_str())
       .value_or(DEFAULT_GPU_DOWNSAMPLE_MODE);
+  gpu_sw_display_scale = static_cast<u32>(std::clamp(si.GetIntValue("GPU", "SoftwareDisplayScale", 1), 1, 4));
+  gpu_sw_display_scale_filter =
+    ParseDisplayScaleFilterName(si.GetStringValue("GPU", "SoftwareDisplayScaleFilter",
+                                                  GetDisplayScaleFilterName(DEFAULT_GPU_SW_DISPLAY_SCALE_FILTER))
+                                  .c_str())
+      .value_or(DEFAULT_GPU_SW_DISPLAY_SCALE_FILTER);
   gpu_disable_interlacing = si.GetBoolValue("GPU", "DisableInterlacing", true);
   gpu_force_ntsc_timings = si.GetBoolValue("GPU", "ForceNTSCTimings", false);
   gpu_widescreen_hack = si.GetBoolValue("GPU", "WidescreenHack", false);
@@ -205,6 +218,7 @@ void Settings::Load(SettingsInterface& si)
   display_line_start_offset = static_cast<s8>(si.GetIntValue("Display", "LineStartOffset", 0));
   display_line_end_offset = static_cast<s8>(si.GetIntValue("Display", "LineEndOffset", 0));
   display_show_osd_messages = si.GetBoolValue("Display", "ShowOSDMessages", true);
+  display_frame_skip = static_cast<u32>(std::clamp(si.GetIntValue("Display", "FrameSkip", 0), 0, 4));
 
   cdrom_readahead_sectors = static_cast<u8>(si.GetIntValue("CDROM", "ReadaheadSectors", DEFAULT_CDROM_READAHEAD_SECTORS));
   cdrom_region_check = si.GetBoolValue("CDROM", "RegionCheck", false);
@@ -244,6 +258,12 @@ void Settings::Load(SettingsInterface& si)
   texture_replacements.enable_vram_write_replacements =
     si.GetBoolValue("TextureReplacements", "EnableVRAMWriteReplacements", false);
   texture_replacements.preload_textures = si.GetBoolValue("TextureReplacements", "PreloadTextures", false);
+  texture_replacements.use_texture_pack = si.GetBoolValue("TextureReplacements", "UseTexturePack", false);
+  texture_replacements.cache_size_mb =
+    static_cast<u32>(std::max(si.GetIntValue("TextureReplacements", "CacheSizeMB", 512), 1));
+
+  gpu_dump_frames = static_cast<u32>(std::max(si.GetIntValue("GPU", "DumpFrames", 0), 0));
+  gpu_log_stats = si.GetBoolValue("GPU", "LogStats", false);
 }
 
 static std::array<const char*, static_cast<std::size_t>(LogLevel::Count)> s_log_level_names = {
@@ -478,6 +498,27 @@ const char* Settings::GetDownsampleModeName(GPUDownsampleMode mode)
   return s_downsample_mode_names[static_cast<int>(mode)];
 }
 
+static constexpr auto s_display_scale_filter_names = make_array("Nearest", "Bilinear", "SharpBilinear");
+
+std::optional<GPUDisplayScaleFilter> Settings::ParseDisplayScaleFilterName(const char* str)
+{
+  int index = 0;
+  for (const char* name : s_display_scale_filter_names)
+  {
+    if (StringUtil::Strcasecmp(name, str) == 0)
+      return static_cast<GPUDisplayScaleFilter>(index);
+
+    index++;
+  }
+
+  return std::nullopt;
+}
+
+const char* Settings::GetDisplayScaleFilterName(GPUDisplayScaleFilter filter)
+{
+  return s_display_scale_filter_names[static_cast<int>(filter)];
+}
+
 static std::array<const char*, 3> s_display_crop_mode_names = {{"None", "Overscan", "Borders"}};
 static std::array<const char*, 3> s_display_crop_mode_display_names = {
   {TRANSLATABLE("DisplayCropMode", "None"), TRANSLATABLE("DisplayCropMode", "Only Overscan Area"),
@@ -65,9 +65,11 @@ struct Settings
   u32 cpu_overclock_denominator = 1;
   bool cpu_overclock_enable = false;
   bool cpu_overclock_active = false;
+  bool cpu_idle_loop_skipping = false;
   bool cpu_recompiler_memory_exceptions = false;
   bool cpu_recompiler_block_linking = true;
   bool cpu_recompiler_icache = false;
+  u32 cpu_recompiler_hot_block_threshold = 0;
   CPUFastmemMode cpu_fastmem_mode = CPUFastmemMode::Disabled;
   bool cpu_fastmem_rewrite = false;
 
@@ -83,12 +85,18 @@ struct Settings
   u32 gpu_resolution_scale = 1;
   u32 gpu_multisamples = 1;
   bool gpu_use_thread = true;
+  u32 gpu_sw_render_threads = 1;
+  u32 gpu_sw_resolution_scale = 1;
   bool gpu_use_software_renderer_for_readbacks = false;
+  bool gpu_async_readbacks = false;
   bool gpu_per_sample_shading = false;
   bool gpu_true_color = false;
   bool gpu_scaled_dithering = false;
+  bool gpu_ubershader = false;
   GPUTextureFilter gpu_texture_filter = GPUTextureFilter::Nearest;
   GPUDownsampleMode gpu_downsample_mode = GPUDownsampleMode::Disabled;
+  u32 gpu_sw_display_scale = 1;
+  GPUDisplayScaleFilter gpu_sw_display_scale_filter = GPUDisplayScaleFilter::Bilinear;
   bool gpu_disable_interlacing = true;
   bool gpu_force_ntsc_timings = false;
   bool gpu_widescreen_hack = false;
@@ -100,6 +108,8 @@ struct Settings
   bool gpu_pgxp_cpu = false;
   bool gpu_pgxp_preserve_proj_fp = false;
   bool gpu_pgxp_depth_buffer = false;
+  u32 gpu_dump_frames = 0;
+  bool gpu_log_stats = false;
   DisplayCropMode display_crop_mode = DisplayCropMode::None;
   DisplayAspectRatio display_aspect_ratio = DisplayAspectRatio::Auto;
   u16 display_aspect_ratio_custom_numerator = 0;
@@ -111,6 +121,7 @@ struct Settings
   bool display_force_4_3_for_24bit = false;
   bool gpu_24bit_chroma_smoothing = false;
   bool display_show_osd_messages = true;
+  u32 display_frame_skip = 0;
   bool display_show_enhancements = false;
   float gpu_pgxp_tolerance = -1.0f;
   float gpu_pgxp_depth_clear_threshold = 300.0f / 4096.0f;
@@ -138,6 +149,8 @@ struct Settings
   {
     bool enable_vram_write_replacements = false;
     bool preload_textures = false;
+    bool use_texture_pack = false;
+    u32 cache_size_mb = 512;
 
     bool dump_vram_writes = false;
     bool dump_vram_write_force_alpha_channel = true;
@@ -178,6 +191,10 @@ struct Settings
   ALWAYS_INLINE bool IsUsingCodeCache() const { return (cpu_execution_mode != CPUExecutionMode::Interpreter); }
   ALWAYS_INLINE bool IsUsingRecompiler() const { return (cpu_execution_mode == CPUExecutionMode::Recompiler); }
   ALWAYS_INLINE bool IsUsingSoftwareRenderer() const { return (gpu_renderer == GPURenderer::Software); }
+  ALWAYS_INLINE bool IsUsingTieredRecompiler() const
+  {
+    return (cpu_execution_mode == CPUExecutionMode::Recompiler && cpu_recompiler_hot_block_threshold > 0);
+  }
   ALWAYS_INLINE bool IsRunaheadEnabled() const { return (runahead_frames > 0); }
 
   ALWAYS_INLINE PGXPMode GetPGXPMode()
@@ -249,6 +266,9 @@ struct Settings
   static const char* GetDownsampleModeName(GPUDownsampleMode mode);
   static const char* GetDownsampleModeDisplayName(GPUDownsampleMode mode);
 
+  static std::optional<GPUDisplayScaleFilter> ParseDisplayScaleFilterName(const char* str);
+  static const char* GetDisplayScaleFilterName(GPUDisplayScaleFilter filter);
+
   static std::optional<DisplayCropMode> ParseDisplayCropMode(const char* str);
   static const char* GetDisplayCropModeName(DisplayCropMode crop_mode);
   static const char* GetDisplayCropModeDisplayName(DisplayCropMode crop_mode);
@@ -273,6 +293,7 @@ struct Settings
 #endif
   static constexpr GPUTextureFilter DEFAULT_GPU_TEXTURE_FILTER = GPUTextureFilter::Nearest;
   static constexpr GPUDownsampleMode DEFAULT_GPU_DOWNSAMPLE_MODE = GPUDownsampleMode::Disabled;
+  static constexpr GPUDisplayScaleFilter DEFAULT_GPU_SW_DISPLAY_SCALE_FILTER = GPUDisplayScaleFilter::Bilinear;
   static constexpr ConsoleRegion DEFAULT_CONSOLE_REGION = ConsoleRegion::Auto;
   static constexpr float DEFAULT_GPU_PGXP_DEPTH_THRESHOLD = 300.0f;
 
@@ -11,11 +11,13 @@
 #include "common/make_array.h"
 #include "common/state_wrapper.h"
 #include "common/string_util.h"
+#include "common/timer.h"
 #include "controller.h"
 #include "cpu_code_cache.h"
 #include "cpu_core.h"
 #include "dma.h"
 #include "gpu.h"
+#include "gpu_dump.h"
 #include "gte.h"
 #include "host_display.h"
 #include "host_interface.h"
@@ -79,6 +81,8 @@ static bool DoLoadState(ByteStream* stream, bool force_software_renderer, bool u
 static bool DoState(StateWrapper& sw, HostDisplayTexture** host_texture, bool update_display, bool is_memory_state);
 static void DoRunFrame();
 static bool CreateGPU(GPURenderer renderer);
+static std::string GetGPUDumpDirectory();
+static void WriteGPUStatsLog();
 
 static bool SaveRewindState();
 static void DoRewind();
@@ -124,6 +128,14 @@ static std::unique_ptr<AudioStream> s_runahead_audio_stream;
 static bool s_runahead_replay_pending = false;
 static u32 s_runahead_frames = 0;
 
+static std::unique_ptr<GPUDump::Player> s_gpu_dump_player;
+
+static RFILE* s_gpu_stats_log = nullptr;
+static u32 s_gpu_stats_log_frames = 0;
+
+/// Milliseconds that emulation is behind the throttle target.
+static double s_frame_skip_debt = 0.0;
+
 State GetState()
 {
   return s_state;
@@ -179,6 +191,30 @@ void FrameDone()
   s_frame_number++;
   CPU::g_state.frame_done = true;
   CPU::g_state.downcount = 0;
+
+  g_gpu->ResetStats();
+  if (s_gpu_stats_log)
+    WriteGPUStatsLog();
+}
+
+bool ShouldSkipFrame()
+{
+  return (s_frame_skip_debt > 0.0);
+}
+
+static void UpdateFrameSkip(Common::Timer::Value frame_start_time)
+{
+  if (g_settings.display_frame_skip == 0 || s_throttle_frequency <= 0.0f)
+  {
+    s_frame_skip_debt = 0.0;
+    return;
+  }
+
+  // Skipped frames are cheaper, so the debt is paid off by skipping. It's capped so that a single long frame (e.g.
+  // a shader compile) doesn't result in a long run of skipped frames afterwards.
+  const double target_ms = 1000.0 / static_cast<double>(s_throttle_frequency);
+  const double frame_ms = Common::Timer::ConvertValueToMilliseconds(Common::Timer::GetValue() - frame_start_time);
+  s_frame_skip_debt = std::clamp(s_frame_skip_debt + (frame_ms - target_ms), 0.0, target_ms * 2.0);
 }
 
 const std::string& GetRunningCode()
@@ -207,6 +243,13 @@ static bool IsPsfFileName(const char* path)
           (StringUtil::Strcasecmp(extension, ".psf") == 0 || StringUtil::Strcasecmp(extension, ".minipsf") == 0));
 }
 
+/// Returns true if the filename is a capture of the GPU command stream.
+static bool IsGPUDumpFileName(const char* path)
+{
+  const char* extension = std::strrchr(path, '.');
+  return (extension && StringUtil::Strcasecmp(extension, ".psxgpu") == 0);
+}
+
 ConsoleRegion GetConsoleRegionForDiscRegion(DiscRegion region)
 {
   switch (region)
@@ -609,11 +652,25 @@ bool Boot(const SystemBootParameters& params)
   std::unique_ptr<CDImage> media;
   bool exe_boot = false;
   bool psf_boot = false;
+  bool gpu_dump_boot = false;
   if (!params.filename.empty())
   {
     exe_boot = IsExeFileName(params.filename.c_str());
     psf_boot = (!exe_boot && IsPsfFileName(params.filename.c_str()));
-    if (exe_boot || psf_boot)
+    gpu_dump_boot = (!exe_boot && !psf_boot && IsGPUDumpFileName(params.filename.c_str()));
+    if (gpu_dump_boot)
+    {
+      s_gpu_dump_player = std::make_unique<GPUDump::Player>();
+      if (!s_gpu_dump_player->Open(params.filename.c_str()))
+      {
+        g_host_interface->ReportFormattedError("Failed to load GPU dump '%s'", params.filename.c_str());
+        Shutdown();
+        return false;
+      }
+
+      s_region = s_gpu_dump_player->IsConsolePAL() ? ConsoleRegion::PAL : ConsoleRegion::NTSC_U;
+    }
+    else if (exe_boot || psf_boot)
     {
       if (s_region == ConsoleRegion::Auto)
       {
@@ -663,9 +720,9 @@ bool Boot(const SystemBootParameters& params)
 
   Log_InfoPrintf("Console Region: %s", Settings::GetConsoleRegionDisplayName(s_region));
 
-  // Load BIOS image.
+  // Load BIOS image. GPU dumps don't execute any code, so they can run without one.
   std::optional<BIOS::Image> bios_image = g_host_interface->GetBIOSImage(s_region);
-  if (!bios_image)
+  if (!bios_image && !gpu_dump_boot)
   {
     g_host_interface->ReportFormattedError(g_host_interface->TranslateString("System", "Failed to load %s BIOS."),
                                            Settings::GetConsoleRegionName(s_region));
@@ -699,12 +756,20 @@ bool Boot(const SystemBootParameters& params)
     return false;
   }
 
-  Bus::SetBIOS(*bios_image);
+  if (bios_image)
+    Bus::SetBIOS(*bios_image);
   UpdateControllers();
   UpdateMemoryCardTypes();
   UpdateMultitaps();
   Reset();
 
+  // Reset() loaded the initial GPU state, nothing else is needed.
+  if (gpu_dump_boot)
+  {
+    s_state = State::Running;
+    return true;
+  }
+
   // Enable tty by patching bios.
   const BIOS::Hash bios_hash = BIOS::GetHash(*bios_image);
   if (g_settings.bios_patch_tty_enable)
@@ -787,6 +852,10 @@ bool Initialize(bool force_software_renderer)
   g_sio.Initialize();
 
   UpdateMemorySaveStateSettings();
+
+  if (g_settings.gpu_log_stats)
+    StartGPUStatsLog();
+
   return true;
 }
 
@@ -797,6 +866,8 @@ void Shutdown()
 
   ClearMemorySaveStates();
   s_runahead_audio_stream.reset();
+  s_gpu_dump_player.reset();
+  StopGPUStatsLog();
 
   g_texture_replacements.Shutdown();
 
@@ -869,6 +940,102 @@ bool CreateGPU(GPURenderer renderer)
   return true;
 }
 
+bool StartGPUDump(u32 num_frames)
+{
+  if (IsShutdown() || s_gpu_dump_player)
+    return false;
+
+  if (s_runahead_frames > 0)
+  {
+    g_host_interface->AddOSDMessage("GPU dumps can't be recorded with runahead enabled.", 10.0f);
+    return false;
+  }
+
+  const std::string dump_directory = GetGPUDumpDirectory();
+  if (dump_directory.empty())
+    return false;
+
+  const std::string path = StringUtil::StdStringFromFormat(
+    "%s" FS_OSPATH_SEPARATOR_STR "%s_%u.psxgpu", dump_directory.c_str(),
+    s_running_game_code.empty() ? "unknown" : s_running_game_code.c_str(), s_frame_number);
+  if (!g_gpu->StartGPUDump(path.c_str(), num_frames))
+  {
+    g_host_interface->AddFormattedOSDMessage(10.0f, "Failed to start GPU dump to '%s'.", path.c_str());
+    return false;
+  }
+
+  g_host_interface->AddFormattedOSDMessage(5.0f, "Recording %u frames of GPU commands to '%s'.", num_frames,
+                                           path.c_str());
+  return true;
+}
+
+std::string GetGPUDumpDirectory()
+{
+  const std::string base_path = g_host_interface->GetShaderCacheBasePath();
+  const std::string dump_directory = g_host_interface->GetUserDirectoryRelativePath(
+    "%s" "dump" FS_OSPATH_SEPARATOR_STR "gpu", base_path.c_str());
+  if (!path_is_directory(dump_directory.c_str()) && !path_mkdir(dump_directory.c_str()))
+  {
+    Log_ErrorPrintf("Failed to create GPU dump directory '%s'", dump_directory.c_str());
+    return {};
+  }
+
+  return dump_directory;
+}
+
+bool StartGPUStatsLog()
+{
+  if (IsShutdown() || s_gpu_stats_log)
+    return false;
+
+  const std::string dump_directory = GetGPUDumpDirectory();
+  if (dump_directory.empty())
+    return false;
+
+  const std::string path = StringUtil::StdStringFromFormat(
+    "%s" FS_OSPATH_SEPARATOR_STR "%s_%u_stats.csv", dump_directory.c_str(),
+    s_running_game_code.empty() ? "unknown" : s_running_game_code.c_str(), s_frame_number);
+  s_gpu_stats_log = FileSystem::OpenRFile(path.c_str(), "wb");
+  if (!s_gpu_stats_log)
+  {
+    g_host_interface->AddFormattedOSDMessage(10.0f, "Failed to open GPU statistics log '%s'.", path.c_str());
+    return false;
+  }
+
+  filestream_printf(s_gpu_stats_log, "frame,primitives,vertices,batches,flushes,draw_calls,pipeline_switches,"
+                                     "uniform_buffer_updates,vram_fills,vram_writes,vram_copies,vram_reads,"
+                                     "vram_readbacks\n");
+  s_gpu_stats_log_frames = 0;
+  Log_InfoPrintf("Logging GPU statistics to '%s'", path.c_str());
+  return true;
+}
+
+void StopGPUStatsLog()
+{
+  if (!s_gpu_stats_log)
+    return;
+
+  rfclose(s_gpu_stats_log);
+  s_gpu_stats_log = nullptr;
+  Log_InfoPrintf("Logged GPU statistics for %u frames", s_gpu_stats_log_frames);
+}
+
+void WriteGPUStatsLog()
+{
+  const GPUStats& stats = g_gpu->GetLastFrameStats();
+  filestream_printf(s_gpu_stats_log, "%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u,%u\n", s_frame_number,
+                    stats.num_primitives, stats.num_vertices, stats.num_batches, stats.num_flushes,
+                    stats.num_draw_calls, stats.num_pipeline_switches, stats.num_uniform_buffer_updates,
+                    stats.num_vram_fills, stats.num_vram_writes, stats.num_vram_copies, stats.num_vram_reads,
+                    stats.num_vram_readbacks);
+  s_gpu_stats_log_frames++;
+}
+
+bool IsReplayingGPUDump()
+{
+  return static_cast<bool>(s_gpu_dump_player);
+}
+
 bool DoState(StateWrapper& sw, HostDisplayTexture** host_texture, bool update_display, bool is_memory_state)
 {
   if (!sw.DoMarker("System"))
@@ -973,8 +1140,13 @@ void Reset()
   g_mdec.Reset();
   g_sio.Reset();
   s_frame_number = 1;
+  s_frame_skip_debt = 0.0;
   TimingEvents::Reset();
 
+  // restart the replay from the beginning
+  if (s_gpu_dump_player)
+    s_gpu_dump_player->LoadInitialState(g_gpu.get());
+
   g_gpu->ResetGraphicsAPIState();
 }
 
@@ -1115,6 +1287,9 @@ bool DoLoadState(ByteStream* state, bool force_software_renderer, bool update_di
   if (!DoState(sw, nullptr, update_display, false))
     return false;
 
+  // the time spent loading shouldn't count towards skipping
+  s_frame_skip_debt = 0.0;
+
   if (s_state == State::Starting)
     s_state = State::Running;
 
@@ -1181,6 +1356,15 @@ void DoRunFrame()
 {
   g_gpu->RestoreGraphicsAPIState();
 
+  if (s_gpu_dump_player)
+  {
+    if (!s_gpu_dump_player->HasError() && !s_gpu_dump_player->ProcessFrame(g_gpu.get()))
+      g_host_interface->ReportError("Failed to replay GPU dump.");
+
+    g_gpu->ResetGraphicsAPIState();
+    return;
+  }
+
   if (CPU::g_state.use_debug_dispatcher)
   {
     CPU::ExecuteDebug();
@@ -1225,6 +1409,8 @@ void RunFrame()
     return;
   }
 
+  const Common::Timer::Value frame_start_time = Common::Timer::GetValue();
+
   if (s_runahead_frames > 0)
     DoRunahead();
 
@@ -1232,6 +1418,8 @@ void RunFrame()
 
   if (s_memory_saves_enabled)
     DoMemorySaveStates();
+
+  UpdateFrameSkip(frame_start_time);
 }
 
 void SetThrottleFrequency(float frequency)
@@ -90,6 +90,9 @@ bool InjectEXEFromBuffer(const void* buffer, u32 buffer_size, bool patch_loader
 u32 GetFrameNumber();
 void FrameDone();
 
+/// Returns true if emulation is running slower than the throttle target, and frames should be skipped to catch up.
+bool ShouldSkipFrame();
+
 const std::string& GetRunningCode();
 float GetThrottleFrequency();
 
@@ -103,6 +106,16 @@ bool SaveState(ByteStream* state);
 /// Recreates the GPU component, saving/loading the state so it is preserved. Call when the GPU renderer changes.
 bool RecreateGPU(GPURenderer renderer, bool update_display = true);
 
+/// Captures the GPU command stream for the specified number of frames to the dump directory.
+bool StartGPUDump(u32 num_frames);
+
+/// Writes the GPU statistics for every frame to a CSV file in the dump directory.
+bool StartGPUStatsLog();
+void StopGPUStatsLog();
+
+/// Returns true if the running content is a GPU dump, which is replayed instead of executing the CPU.
+bool IsReplayingGPUDump();
+
 void RunFrame();
 
 /// Adjusts the throttle frequency, i.e. how many times we should sleep per second.
@@ -0,0 +1,165 @@
+#include "texture_pack.h"
+#include "common/file_system.h"
+#include "common/log.h"
+#include "zstd.h"
+#include <algorithm>
+#include <cinttypes>
+#include <cstring>
+#include <tuple>
+Log_SetChannel(TexturePack);
+
+namespace TexturePack {
+
+Reader::Reader() = default;
+
+Reader::~Reader() = default;
+
+bool Reader::Open(const char* path)
+{
+  Close();
+
+  if (!m_file.Open(path))
+    return false;
+
+  if (m_file.GetSize() < sizeof(FileHeader))
+  {
+    Log_WarningPrintf("Texture pack '%s' is truncated", path);
+    Close();
+    return false;
+  }
+
+  std::memcpy(&m_header, m_file.GetData(), sizeof(m_header));
+  if (m_header.magic != FILE_MAGIC || m_header.version != FILE_VERSION || m_header.index_offset < sizeof(FileHeader) ||
+      m_header.index_offset > m_file.GetSize() ||
+      ((m_file.GetSize() - m_header.index_offset) / sizeof(IndexEntry)) < m_header.texture_count)
+  {
+    Log_WarningPrintf("'%s' is not a valid texture pack", path);
+    Close();
+    return false;
+  }
+
+  m_index = reinterpret_cast<const IndexEntry*>(m_file.GetData() + m_header.index_offset);
+  Log_InfoPrintf("Opened texture pack '%s' with %u textures", path, m_header.texture_count);
+  return true;
+}
+
+void Reader::Close()
+{
+  m_file.Close();
+  m_header = {};
+  m_index = nullptr;
+}
+
+const IndexEntry* Reader::FindTexture(u64 hash_low, u64 hash_high) const
+{
+  const IndexEntry* end = m_index + m_header.texture_count;
+  const IndexEntry* it = std::lower_bound(m_index, end, std::make_tuple(hash_low, hash_high),
+                                          [](const IndexEntry& entry, const std::tuple<u64, u64>& hash) {
+                                            return std::make_tuple(entry.hash_low, entry.hash_high) < hash;
+                                          });
+  return (it != end && it->hash_low == hash_low && it->hash_high == hash_high) ? it : nullptr;
+}
+
+bool Reader::DecodeTexture(const IndexEntry& entry, Common::RGBA8Image* image) const
+{
+  const size_t expected_size = static_cast<size_t>(entry.width) * entry.height * sizeof(u32);
+  if (entry.offset > m_header.index_offset || (m_header.index_offset - entry.offset) < entry.compressed_size ||
+      expected_size == 0)
+  {
+    Log_ErrorPrintf("Texture %016" PRIX64 "%016" PRIX64 " is out of range", entry.hash_high, entry.hash_low);
+    return false;
+  }
+
+  image->SetSize(entry.width, entry.height);
+  const size_t size =
+    ZSTD_decompress(image->GetPixels(), expected_size, m_file.GetData() + entry.offset, entry.compressed_size);
+  if (ZSTD_isError(size) || size != expected_size)
+  {
+    Log_ErrorPrintf("Failed to decompress texture %016" PRIX64 "%016" PRIX64 ": %s", entry.hash_high, entry.hash_low,
+                    ZSTD_isError(size) ? ZSTD_getErrorName(size) : "size mismatch");
+    image->Invalidate();
+    return false;
+  }
+
+  return true;
+}
+
+Writer::Writer(RFILE* fp) : m_fp(fp) {}
+
+Writer::~Writer()
+{
+  if (m_fp)
+    rfclose(m_fp);
+}
+
+std::unique_ptr<Writer> Writer::Create(const char* path)
+{
+  RFILE* fp = FileSystem::OpenRFile(path, "wb");
+  if (!fp)
+  {
+    Log_ErrorPrintf("Failed to open texture pack '%s' for writing", path);
+    return {};
+  }
+
+  const FileHeader header = {};
+  if (rfwrite(&header, sizeof(header), 1, fp) != 1)
+  {
+    Log_ErrorPrintf("Failed to write texture pack header to '%s'", path);
+    rfclose(fp);
+    return {};
+  }
+
+  return std::unique_ptr<Writer>(new Writer(fp));
+}
+
+bool Writer::AddTexture(u64 hash_low, u64 hash_high, const Common::RGBA8Image& image)
+{
+  const size_t size = static_cast<size_t>(image.GetByteStride()) * image.GetHeight();
+  m_compress_buffer.resize(ZSTD_compressBound(size));
+
+  const size_t compressed_size =
+    ZSTD_compress(m_compress_buffer.data(), m_compress_buffer.size(), image.GetPixels(), size, COMPRESSION_LEVEL);
+  if (ZSTD_isError(compressed_size))
+  {
+    Log_ErrorPrintf("Failed to compress texture: %s", ZSTD_getErrorName(compressed_size));
+    return false;
+  }
+
+  if (rfwrite(m_compress_buffer.data(), compressed_size, 1, m_fp) != 1)
+  {
+    Log_ErrorPrintf("Failed to write texture to pack");
+    return false;
+  }
+
+  m_index.push_back(IndexEntry{hash_low, hash_high, m_offset, static_cast<u32>(compressed_size), image.GetWidth(),
+                               image.GetHeight()});
+  m_offset += compressed_size;
+  return true;
+}
+
+bool Writer::Finish(const SourceFingerprint& source)
+{
+  std::sort(m_index.begin(), m_index.end(), [](const IndexEntry& lhs, const IndexEntry& rhs) {
+    return std::make_tuple(lhs.hash_low, lhs.hash_high) < std::make_tuple(rhs.hash_low, rhs.hash_high);
+  });
+
+  FileHeader header = {};
+  header.magic = FILE_MAGIC;
+  header.version = FILE_VERSION;
+  header.texture_count = static_cast<u32>(m_index.size());
+  header.source = source;
+  header.index_offset = m_offset;
+
+  if ((!m_index.empty() && rfwrite(m_index.data(), sizeof(IndexEntry) * m_index.size(), 1, m_fp) != 1) ||
+      FileSystem::FSeek64(m_fp, 0, SEEK_SET) != 0 || rfwrite(&header, sizeof(header), 1, m_fp) != 1)
+  {
+    Log_ErrorPrintf("Failed to write texture pack index");
+    return false;
+  }
+
+  Log_InfoPrintf("Wrote texture pack with %u textures, %" PRIu64 " bytes", header.texture_count,
+                 m_offset + sizeof(IndexEntry) * m_index.size());
+  return true;
+}
+
+} // namespace TexturePack
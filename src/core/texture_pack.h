@@ -0,0 +1,95 @@
+#pragma once
+#include "common/image.h"
+#include "common/mapped_file.h"
+#include "types.h"
+#include <memory>
+#include <vector>
+
+struct RFILE;
+
+namespace TexturePack {
+
+// File layout: FileHeader, the zstd-compressed RGBA8 pixels of each texture, then the index. The index is an array of
+// IndexEntry sorted by hash, so lookups can binary search it directly in the mapped file without building a map.
+static constexpr u32 FILE_MAGIC = 0x50545753; // SWTP
+static constexpr u32 FILE_VERSION = 2;
+static constexpr int COMPRESSION_LEVEL = 3;
+
+#pragma pack(push, 1)
+/// Identifies the loose files a pack was built from, so it can be rebuilt when they're added, replaced or removed.
+struct SourceFingerprint
+{
+  u64 hash; // names, sizes and modification times
+  u32 file_count;
+
+  bool operator==(const SourceFingerprint& rhs) const { return hash == rhs.hash && file_count == rhs.file_count; }
+  bool operator!=(const SourceFingerprint& rhs) const { return !(*this == rhs); }
+};
+
+struct FileHeader
+{
+  u32 magic;
+  u32 version;
+  u32 texture_count;
+  SourceFingerprint source;
+  u64 index_offset;
+};
+
+struct IndexEntry
+{
+  u64 hash_low;
+  u64 hash_high;
+  u64 offset;
+  u32 compressed_size;
+  u32 width;
+  u32 height;
+};
+#pragma pack(pop)
+
+class Reader
+{
+public:
+  Reader();
+  ~Reader();
+
+  ALWAYS_INLINE bool IsOpen() const { return m_file.IsOpen(); }
+  ALWAYS_INLINE u32 GetTextureCount() const { return m_header.texture_count; }
+  ALWAYS_INLINE const SourceFingerprint& GetSourceFingerprint() const { return m_header.source; }
+  ALWAYS_INLINE const IndexEntry& GetEntry(u32 index) const { return m_index[index]; }
+
+  bool Open(const char* path);
+  void Close();
+
+  const IndexEntry* FindTexture(u64 hash_low, u64 hash_high) const;
+
+  /// Decompresses a texture. Safe to call from multiple threads at once.
+  bool DecodeTexture(const IndexEntry& entry, Common::RGBA8Image* image) const;
+
+private:
+  Common::MappedFile m_file;
+  FileHeader m_header = {};
+  const IndexEntry* m_index = nullptr;
+};
+
+class Writer
+{
+public:
+  ~Writer();
+
+  /// Opens the pack for writing. The header is only written by Finish(), so a pack which wasn't completed is rejected
+  /// by the reader.
+  static std::unique_ptr<Writer> Create(const char* path);
+
+  bool AddTexture(u64 hash_low, u64 hash_high, const Common::RGBA8Image& image);
+  bool Finish(const SourceFingerprint& source);
+
+private:
+  Writer(RFILE* fp);
+
+  RFILE* m_fp;
+  std::vector<IndexEntry> m_index;
+  std::vector<u8> m_compress_buffer;
+  u64 m_offset = sizeof(FileHeader);
+};
+
+} // namespace TexturePack
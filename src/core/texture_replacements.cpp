@@ -11,7 +11,10 @@
 #if defined(CPU_X86) || defined(CPU_X64)
 #include "xxh_x86dispatch.h"
 #endif
+#include <algorithm>
+#include <chrono>
 #include <cinttypes>
+#include <cstring>
 #include <file/file_path.h>
 Log_SetChannel(TextureReplacements);
 
@@ -55,26 +58,36 @@ bool TextureReplacementHash::ParseString(const std::string_view& sv)
 
 TextureReplacements::TextureReplacements() = default;
 
-TextureReplacements::~TextureReplacements() = default;
+TextureReplacements::~TextureReplacements()
+{
+  StopLoaderThreads();
+}
 
 void TextureReplacements::SetGameID(std::string game_id)
 {
   if (m_game_id == game_id)
     return;
 
+  SaveTextureUsage();
   m_game_id = game_id;
   Reload();
 }
 
 const TextureReplacementTexture* TextureReplacements::GetVRAMWriteReplacement(u32 width, u32 height, const void* pixels)
 {
+  ProcessCompletedLoads();
+
   const TextureReplacementHash hash = GetVRAMWriteHash(width, height, pixels);
 
-  const auto it = m_vram_write_replacements.find(hash);
-  if (it == m_vram_write_replacements.end())
+  const auto cache_it = m_texture_cache.find(hash);
+  if (cache_it == m_texture_cache.end())
+  {
+    QueueVRAMWriteReplacementLoad(hash);
     return nullptr;
+  }
 
-  return LoadTexture(it->second);
+  m_texture_cache_lru.splice(m_texture_cache_lru.begin(), m_texture_cache_lru, cache_it->second.lru_it);
+  return cache_it->second.texture.IsValid() ? &cache_it->second.texture : nullptr;
 }
 
 void TextureReplacements::DumpVRAMWrite(u32 width, u32 height, const void* pixels)
@@ -113,8 +126,12 @@ void TextureReplacements::DumpVRAMWrite(u32 width, u32 height, const void* pixel
 
 void TextureReplacements::Shutdown()
 {
-  m_texture_cache.clear();
+  SaveTextureUsage();
+  StopLoaderThreads();
+  CancelTextureLoads();
+  ClearTextureCache();
   m_vram_write_replacements.clear();
+  m_texture_pack.Close();
   m_game_id.clear();
 }
 
@@ -157,29 +174,29 @@ std::string TextureReplacements::GetVRAMWriteDumpFilename(u32 width, u32 height,
 
 void TextureReplacements::Reload()
 {
+  // The loader threads can be reading from the pack, so they have to be stopped before it's closed.
+  SaveTextureUsage();
+  StopLoaderThreads();
+  CancelTextureLoads();
+  ClearTextureCache();
   m_vram_write_replacements.clear();
+  m_texture_pack.Close();
 
   if (g_settings.texture_replacements.AnyReplacementsEnabled())
-    FindTextures(GetSourceDirectory());
+  {
+    if (g_settings.texture_replacements.use_texture_pack && !m_game_id.empty())
+      LoadTexturePack();
+    else
+      FindTextures(GetSourceDirectory());
+  }
+
+  if (m_vram_write_replacements.empty() && !m_texture_pack.IsOpen())
+    return;
 
   if (g_settings.texture_replacements.preload_textures)
     PreloadTextures();
-
-  PurgeUnreferencedTexturesFromCache();
-}
-
-void TextureReplacements::PurgeUnreferencedTexturesFromCache()
-{
-  TextureCache old_map = std::move(m_texture_cache);
-  for (const auto& it : m_vram_write_replacements)
-  {
-    auto it2 = old_map.find(it.second);
-    if (it2 != old_map.end())
-    {
-      m_texture_cache[it.second] = std::move(it2->second);
-      old_map.erase(it2);
-    }
-  }
+  else
+    PrefetchTexturesFromLastSession();
 }
 
 bool TextureReplacements::ParseReplacementFilename(const std::string& filename,
@@ -229,11 +246,20 @@ bool TextureReplacements::ParseReplacementFilename(const std::string& filename,
   return valid_extension;
 }
 
-void TextureReplacements::FindTextures(const std::string& dir)
+void TextureReplacements::FindTextures(const std::string& dir, TexturePack::SourceFingerprint* fingerprint)
 {
   FileSystem::FindResultsArray files;
   FileSystem::FindFiles(dir.c_str(), "*", FILESYSTEM_FIND_FILES | FILESYSTEM_FIND_RECURSIVE, &files);
 
+  // Files are returned in filesystem order, sort them so that the fingerprint is stable.
+  std::sort(files.begin(), files.end(), [](const FILESYSTEM_FIND_DATA& lhs, const FILESYSTEM_FIND_DATA& rhs) {
+    return lhs.FileName < rhs.FileName;
+  });
+
+  XXH64_state_t* fingerprint_state = XXH64_createState();
+  XXH64_reset(fingerprint_state, 0);
+  u32 fingerprint_file_count = 0;
+
   for (FILESYSTEM_FIND_DATA& fd : files)
   {
     if (fd.Attributes & FILESYSTEM_FILE_ATTRIBUTE_DIRECTORY)
@@ -244,6 +270,13 @@ void TextureReplacements::FindTextures(const std::string& dir)
     if (!ParseReplacementFilename(fd.FileName, &hash, &type))
       continue;
 
+    // relative to the directory, so moving the whole folder doesn't invalidate the pack
+    const std::string_view name = std::string_view(fd.FileName).substr(std::min(dir.size(), fd.FileName.size()));
+    XXH64_update(fingerprint_state, name.data(), name.size());
+    XXH64_update(fingerprint_state, &fd.Size, sizeof(fd.Size));
+    XXH64_update(fingerprint_state, &fd.ModificationTime, sizeof(fd.ModificationTime));
+    fingerprint_file_count++;
+
     switch (type)
     {
       case ReplacmentType::VRAMWrite:
@@ -261,50 +294,350 @@ void TextureReplacements::FindTextures(const std::string& dir)
     }
   }
 
+  if (fingerprint)
+  {
+    fingerprint->hash = XXH64_digest(fingerprint_state);
+    fingerprint->file_count = fingerprint_file_count;
+  }
+  XXH64_freeState(fingerprint_state);
+
   Log_InfoPrintf("Found %zu replacement VRAM writes for '%s'", m_vram_write_replacements.size(), m_game_id.c_str());
 }
 
-const TextureReplacementTexture* TextureReplacements::LoadTexture(const std::string& filename)
+std::string TextureReplacements::GetTexturePackPath() const
 {
-  auto it = m_texture_cache.find(filename);
-  if (it != m_texture_cache.end())
-    return &it->second;
+  return GetSourceDirectory() + ".swpack";
+}
 
-  Common::RGBA8Image image;
-  if (!Common::LoadImageFromFile(&image, filename.c_str()))
+void TextureReplacements::LoadTexturePack()
+{
+  // Only the file names and attributes are needed to check the pack is up to date, nothing is decoded.
+  const std::string path = GetTexturePackPath();
+  TexturePack::SourceFingerprint fingerprint;
+  FindTextures(GetSourceDirectory(), &fingerprint);
+
+  if (m_texture_pack.Open(path.c_str()))
   {
-    Log_ErrorPrintf("Failed to load '%s'", filename.c_str());
-    return nullptr;
+    // Packs without loose files, e.g. ones which were distributed by themselves, are used as-is.
+    if (m_vram_write_replacements.empty() || m_texture_pack.GetSourceFingerprint() == fingerprint)
+    {
+      m_vram_write_replacements.clear();
+      return;
+    }
+
+    Log_InfoPrintf("Texture pack '%s' doesn't match the texture directory, rebuilding", path.c_str());
+    m_texture_pack.Close();
   }
 
-  Log_InfoPrintf("Loaded '%s': %ux%u", filename.c_str(), image.GetWidth(), image.GetHeight());
-  it = m_texture_cache.emplace(filename, std::move(image)).first;
-  return &it->second;
+  if (m_vram_write_replacements.empty() || !BuildTexturePack(path, fingerprint) || !m_texture_pack.Open(path.c_str()))
+    return;
+
+  m_vram_write_replacements.clear();
 }
 
-void TextureReplacements::PreloadTextures()
+bool TextureReplacements::BuildTexturePack(const std::string& path, const TexturePack::SourceFingerprint& fingerprint)
 {
   static constexpr float UPDATE_INTERVAL = 1.0f;
 
+  std::unique_ptr<TexturePack::Writer> writer = TexturePack::Writer::Create(path.c_str());
+  if (!writer)
+    return false;
+
+  Log_InfoPrintf("Building texture pack '%s' from %zu textures", path.c_str(), m_vram_write_replacements.size());
+
   Common::Timer last_update_time;
-  u32 num_textures_loaded = 0;
   const u32 total_textures = static_cast<u32>(m_vram_write_replacements.size());
+  for (const auto& it : m_vram_write_replacements)
+    QueueTextureLoad(it.first, it.second);
 
-#define UPDATE_PROGRESS()                                                                                              \
-  if (last_update_time.GetTimeSeconds() >= UPDATE_INTERVAL)                                                            \
-  {                                                                                                                    \
-    g_host_interface->DisplayLoadingScreen("Preloading replacement textures...", 0, static_cast<int>(total_textures),  \
-                                           static_cast<int>(num_textures_loaded));                                     \
-    last_update_time.Reset();                                                                                          \
+  // The loader threads decode the images, compression and writing happens here as they complete.
+  bool result = true;
+  while (!m_pending_loads.empty())
+  {
+    for (const LoadResult& load : GetCompletedLoads(true))
+    {
+      if (load.texture.IsValid())
+        result = result && writer->AddTexture(load.hash.low, load.hash.high, load.texture);
+    }
+
+    if (last_update_time.GetTimeSeconds() >= UPDATE_INTERVAL)
+    {
+      g_host_interface->DisplayLoadingScreen("Building replacement texture pack...", 0,
+                                             static_cast<int>(total_textures),
+                                             static_cast<int>(total_textures - m_pending_loads.size()));
+      last_update_time.Reset();
+    }
   }
 
-  for (const auto& it : m_vram_write_replacements)
+  return result && writer->Finish(fingerprint);
+}
+
+bool TextureReplacements::QueueVRAMWriteReplacementLoad(const TextureReplacementHash& hash)
+{
+  if (m_texture_pack.IsOpen())
+  {
+    if (!m_texture_pack.FindTexture(hash.low, hash.high))
+      return false;
+
+    QueueTextureLoad(hash, std::string());
+    return true;
+  }
+
+  const auto it = m_vram_write_replacements.find(hash);
+  if (it == m_vram_write_replacements.end())
+    return false;
+
+  QueueTextureLoad(hash, it->second);
+  return true;
+}
+
+void TextureReplacements::QueueTextureLoad(const TextureReplacementHash& hash, const std::string& filename)
+{
+  if (!m_pending_loads.insert(hash).second)
+    return;
+
+  if (m_loader_threads.empty())
+    StartLoaderThreads();
+
+  std::unique_lock<std::mutex> lock(m_loader_mutex);
+  m_loader_queue.push_back(LoadRequest{hash, filename, m_loader_generation});
+  m_loader_work_cv.notify_one();
+}
+
+std::vector<TextureReplacements::LoadResult> TextureReplacements::GetCompletedLoads(bool wait)
+{
+  std::vector<LoadResult> results;
   {
-    UPDATE_PROGRESS();
+    std::unique_lock<std::mutex> lock(m_loader_mutex);
+    if (wait)
+      m_loader_done_cv.wait_for(lock, std::chrono::milliseconds(100), [this]() { return !m_loader_results.empty(); });
+
+    results.swap(m_loader_results);
+  }
+
+  // Loads which were started before a reload are discarded.
+  results.erase(std::remove_if(results.begin(), results.end(),
+                               [this](const LoadResult& result) { return result.generation != m_loader_generation; }),
+                results.end());
+  for (const LoadResult& result : results)
+    m_pending_loads.erase(result.hash);
+
+  return results;
+}
+
+void TextureReplacements::ProcessCompletedLoads()
+{
+  if (m_pending_loads.empty())
+    return;
+
+  for (LoadResult& result : GetCompletedLoads(false))
+    AddTextureToCache(result.hash, std::move(result.texture));
+}
+
+void TextureReplacements::CancelTextureLoads()
+{
+  // Loads which are already in progress still complete, but are dropped because of the generation change.
+  std::unique_lock<std::mutex> lock(m_loader_mutex);
+  m_loader_queue.clear();
+  m_loader_results.clear();
+  m_loader_generation++;
+  m_pending_loads.clear();
+}
+
+void TextureReplacements::PreloadTextures()
+{
+  static constexpr float UPDATE_INTERVAL = 1.0f;
 
-    LoadTexture(it.second);
-    num_textures_loaded++;
+  Common::Timer last_update_time;
+  u32 total_textures = static_cast<u32>(m_vram_write_replacements.size());
+  if (m_texture_pack.IsOpen())
+  {
+    total_textures = m_texture_pack.GetTextureCount();
+    for (u32 i = 0; i < total_textures; i++)
+    {
+      const TexturePack::IndexEntry& entry = m_texture_pack.GetEntry(i);
+      QueueTextureLoad(TextureReplacementHash{entry.hash_low, entry.hash_high}, std::string());
+    }
+  }
+  else
+  {
+    for (const auto& it : m_vram_write_replacements)
+      QueueTextureLoad(it.first, it.second);
+  }
+
+  // The textures are added to the cache as they complete, so the pack doesn't have to fit in memory at once.
+  while (!m_pending_loads.empty())
+  {
+    for (LoadResult& result : GetCompletedLoads(true))
+      AddTextureToCache(result.hash, std::move(result.texture));
+
+    if (last_update_time.GetTimeSeconds() >= UPDATE_INTERVAL)
+    {
+      g_host_interface->DisplayLoadingScreen("Preloading replacement textures...", 0, static_cast<int>(total_textures),
+                                             static_cast<int>(total_textures - m_pending_loads.size()));
+      last_update_time.Reset();
+    }
+  }
+}
+
+void TextureReplacements::AddTextureToCache(const TextureReplacementHash& hash, TextureReplacementTexture texture)
+{
+  // Failed loads are cached as invalid textures, so they aren't retried every time the VRAM write happens.
+  const size_t size = static_cast<size_t>(texture.GetByteStride()) * texture.GetHeight();
+  m_texture_cache_lru.push_front(hash);
+  if (!m_texture_cache.emplace(hash, CachedTexture{std::move(texture), m_texture_cache_lru.begin()}).second)
+  {
+    m_texture_cache_lru.pop_front();
+    return;
+  }
+
+  m_texture_cache_size += size;
+  m_texture_usage_dirty = true;
+
+  // Evict the least recently used textures until we're back under the budget. The newest texture is always kept.
+  const size_t max_size = static_cast<size_t>(g_settings.texture_replacements.cache_size_mb) * 1024 * 1024;
+  while (m_texture_cache_size > max_size && m_texture_cache_lru.size() > 1)
+  {
+    auto it = m_texture_cache.find(m_texture_cache_lru.back());
+    m_texture_cache_size -= static_cast<size_t>(it->second.texture.GetByteStride()) * it->second.texture.GetHeight();
+    m_texture_cache.erase(it);
+    m_texture_cache_lru.pop_back();
+  }
+}
+
+void TextureReplacements::ClearTextureCache()
+{
+  m_texture_cache.clear();
+  m_texture_cache_lru.clear();
+  m_texture_cache_size = 0;
+  m_texture_usage_dirty = false;
+}
+
+void TextureReplacements::StartLoaderThreads()
+{
+  // Leave a core for the CPU thread.
+  const u32 num_threads = std::clamp<u32>(std::thread::hardware_concurrency(), 2u, MAX_LOADER_THREADS + 1u) - 1u;
+
+  m_loader_shutdown = false;
+  for (u32 i = 0; i < num_threads; i++)
+    m_loader_threads.emplace_back(&TextureReplacements::LoaderThreadEntryPoint, this);
+}
+
+void TextureReplacements::StopLoaderThreads()
+{
+  if (m_loader_threads.empty())
+    return;
+
+  {
+    std::unique_lock<std::mutex> lock(m_loader_mutex);
+    m_loader_shutdown = true;
+    m_loader_work_cv.notify_all();
+  }
+
+  for (std::thread& thread : m_loader_threads)
+    thread.join();
+  m_loader_threads.clear();
+}
+
+void TextureReplacements::LoaderThreadEntryPoint()
+{
+  std::unique_lock<std::mutex> lock(m_loader_mutex);
+  for (;;)
+  {
+    m_loader_work_cv.wait(lock, [this]() { return m_loader_shutdown || !m_loader_queue.empty(); });
+    if (m_loader_shutdown)
+      break;
+
+    LoadRequest request = std::move(m_loader_queue.front());
+    m_loader_queue.pop_front();
+    lock.unlock();
+
+    TextureReplacementTexture image;
+    if (request.filename.empty())
+    {
+      const TexturePack::IndexEntry* entry = m_texture_pack.FindTexture(request.hash.low, request.hash.high);
+      if (!entry || !m_texture_pack.DecodeTexture(*entry, &image))
+        Log_ErrorPrintf("Failed to load %s from texture pack", request.hash.ToString().c_str());
+    }
+    else if (Common::LoadImageFromFile(&image, request.filename.c_str()))
+    {
+      Log_InfoPrintf("Loaded '%s': %ux%u", request.filename.c_str(), image.GetWidth(), image.GetHeight());
+    }
+    else
+    {
+      Log_ErrorPrintf("Failed to load '%s'", request.filename.c_str());
+    }
+
+    lock.lock();
+    m_loader_results.push_back(LoadResult{request.hash, std::move(image), request.generation});
+    m_loader_done_cv.notify_all();
+  }
+}
+
+std::string TextureReplacements::GetUsagePath() const
+{
+  return StringUtil::StdStringFromFormat("%stexture_replacement_usage_%s.bin",
+                                         g_libretro_host_interface.GetShaderCacheBasePath().c_str(), m_game_id.c_str());
+}
+
+void TextureReplacements::PrefetchTexturesFromLastSession()
+{
+  if (m_game_id.empty())
+    return;
+
+  const std::string path = GetUsagePath();
+  std::optional<std::vector<u8>> data = FileSystem::ReadBinaryFile(path.c_str());
+  if (!data.has_value())
+    return;
+
+  u32 header[2];
+  if (data->size() < sizeof(header))
+    return;
+
+  std::memcpy(header, data->data(), sizeof(header));
+  if (header[0] != USAGE_FILE_VERSION || data->size() != (sizeof(header) + header[1] * sizeof(TextureReplacementHash)))
+  {
+    Log_WarningPrintf("Texture replacement usage list '%s' is corrupted", path.c_str());
+    return;
+  }
+
+  // The list is most recently used first. Queue it in reverse, so the most recent textures are also the most recent
+  // in the cache when the loads complete.
+  u32 num_queued = 0;
+  for (u32 i = header[1]; i > 0; i--)
+  {
+    TextureReplacementHash hash;
+    std::memcpy(&hash, data->data() + sizeof(header) + (i - 1) * sizeof(TextureReplacementHash), sizeof(hash));
+
+    if (QueueVRAMWriteReplacementLoad(hash))
+      num_queued++;
+  }
+
+  Log_InfoPrintf("Prefetching %u replacement textures from '%s'", num_queued, path.c_str());
+}
+
+void TextureReplacements::SaveTextureUsage()
+{
+  if (!m_texture_usage_dirty || m_game_id.empty())
+    return;
+
+  const u32 header[2] = {USAGE_FILE_VERSION, static_cast<u32>(m_texture_cache_lru.size())};
+  std::vector<u8> data(sizeof(header) + m_texture_cache_lru.size() * sizeof(TextureReplacementHash));
+  std::memcpy(data.data(), header, sizeof(header));
+
+  u8* ptr = data.data() + sizeof(header);
+  for (const TextureReplacementHash& hash : m_texture_cache_lru)
+  {
+    std::memcpy(ptr, &hash, sizeof(hash));
+    ptr += sizeof(hash);
+  }
+
+  const std::string path = GetUsagePath();
+  if (!FileSystem::WriteBinaryFile(path.c_str(), data.data(), data.size()))
+  {
+    Log_WarningPrintf("Failed to write texture replacement usage list '%s'", path.c_str());
+    return;
   }
 
-#undef UPDATE_PROGRESS
+  m_texture_usage_dirty = false;
 }
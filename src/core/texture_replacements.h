@@ -1,10 +1,17 @@
 #pragma once
 #include "common/hash_combine.h"
 #include "common/image.h"
+#include "texture_pack.h"
 #include "types.h"
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <mutex>
 #include <string>
+#include <thread>
 #include <tuple>
 #include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 struct TextureReplacementHash
@@ -51,19 +58,44 @@ public:
 
   void Reload();
 
+  /// Returns the replacement for a VRAM write, if it has been loaded. Replacements which aren't loaded yet are queued
+  /// for the loader threads, and the original data should be used until they're ready.
   const TextureReplacementTexture* GetVRAMWriteReplacement(u32 width, u32 height, const void* pixels);
   void DumpVRAMWrite(u32 width, u32 height, const void* pixels);
 
   void Shutdown();
 
 private:
+  static constexpr u32 MAX_LOADER_THREADS = 4;
+  static constexpr u32 USAGE_FILE_VERSION = 1;
+
   struct ReplacementHashMapHash
   {
     size_t operator()(const TextureReplacementHash& hash);
   };
 
+  struct CachedTexture
+  {
+    TextureReplacementTexture texture;
+    std::list<TextureReplacementHash>::iterator lru_it;
+  };
+
+  struct LoadRequest
+  {
+    TextureReplacementHash hash;
+    std::string filename;
+    u32 generation;
+  };
+
+  struct LoadResult
+  {
+    TextureReplacementHash hash;
+    TextureReplacementTexture texture;
+    u32 generation;
+  };
+
   using VRAMWriteReplacementMap = std::unordered_map<TextureReplacementHash, std::string>;
-  using TextureCache = std::unordered_map<std::string, TextureReplacementTexture>;
+  using TextureCache = std::unordered_map<TextureReplacementHash, CachedTexture>;
 
   static bool ParseReplacementFilename(const std::string& filename, TextureReplacementHash* replacement_hash,
                                        ReplacmentType* replacement_type);
@@ -73,17 +105,58 @@ private:
   TextureReplacementHash GetVRAMWriteHash(u32 width, u32 height, const void* pixels) const;
   std::string GetVRAMWriteDumpFilename(u32 width, u32 height, const void* pixels) const;
 
-  void FindTextures(const std::string& dir);
+  void FindTextures(const std::string& dir, TexturePack::SourceFingerprint* fingerprint = nullptr);
+
+  /// Packs are built from the loose files the first time a game is started, and used instead of loading them after.
+  /// The pack is rebuilt if the loose files no longer match the ones it was built from.
+  std::string GetTexturePackPath() const;
+  void LoadTexturePack();
+  bool BuildTexturePack(const std::string& path, const TexturePack::SourceFingerprint& fingerprint);
+
+  /// Queues the replacement for the hash from either the pack or the directory. Returns false if there isn't one.
+  bool QueueVRAMWriteReplacementLoad(const TextureReplacementHash& hash);
 
-  const TextureReplacementTexture* LoadTexture(const std::string& filename);
+  /// Textures from the pack are queued with an empty filename.
+  void QueueTextureLoad(const TextureReplacementHash& hash, const std::string& filename);
+  std::vector<LoadResult> GetCompletedLoads(bool wait);
+  void ProcessCompletedLoads();
+  void CancelTextureLoads();
   void PreloadTextures();
-  void PurgeUnreferencedTexturesFromCache();
+
+  void AddTextureToCache(const TextureReplacementHash& hash, TextureReplacementTexture texture);
+  void ClearTextureCache();
+
+  void StartLoaderThreads();
+  void StopLoaderThreads();
+  void LoaderThreadEntryPoint();
+
+  /// The textures in the cache are saved when the game changes, and loaded in the background next time it starts.
+  std::string GetUsagePath() const;
+  void PrefetchTexturesFromLastSession();
+  void SaveTextureUsage();
 
   std::string m_game_id;
 
+  // Decoded textures, and the order they were last used in, most recent first.
   TextureCache m_texture_cache;
+  std::list<TextureReplacementHash> m_texture_cache_lru;
+  size_t m_texture_cache_size = 0;
+  bool m_texture_usage_dirty = false;
 
   VRAMWriteReplacementMap m_vram_write_replacements;
+  TexturePack::Reader m_texture_pack;
+
+  // Textures which have been queued and haven't been added to the cache yet. Only used on the emulation thread.
+  std::unordered_set<TextureReplacementHash> m_pending_loads;
+
+  std::mutex m_loader_mutex;
+  std::condition_variable m_loader_work_cv;
+  std::condition_variable m_loader_done_cv;
+  std::deque<LoadRequest> m_loader_queue;
+  std::vector<LoadResult> m_loader_results;
+  std::vector<std::thread> m_loader_threads;
+  u32 m_loader_generation = 0;
+  bool m_loader_shutdown = false;
 };
 
 extern TextureReplacements g_texture_replacements;
\ No newline at end of file
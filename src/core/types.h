@@ -84,6 +84,14 @@ enum class GPUDownsampleMode : u8
   Count
 };
 
+enum class GPUDisplayScaleFilter : u8
+{
+  Nearest,
+  Bilinear,
+  SharpBilinear,
+  Count
+};
+
 enum class DisplayCropMode : u8
 {
   None,
@@ -332,6 +332,38 @@ struct retro_core_option_v2_definition option_defs_us[] = {
      {NULL, NULL},
    },
    "true"},
+  {"swanstation_GPU_SoftwareRenderThreads",
+   "Rendering Threads (Software)",
+   NULL,
+   "Splits VRAM into horizontal bands which are drawn in parallel by the software renderer. Output is identical to "
+   "single-threaded rendering.",
+   NULL,
+   "enhancement",
+   {
+     {"1", NULL},
+     {"2", NULL},
+     {"3", NULL},
+     {"4", NULL},
+     {"6", NULL},
+     {"8", NULL},
+     {NULL, NULL},
+   },
+   "1"},
+  {"swanstation_GPU_SoftwareResolutionScale",
+   "Internal Resolution Scale (Software)",
+   NULL,
+   "Renders at a multiple of the native resolution with the software renderer, without needing a GPU. Cost grows with "
+   "the square of the scale, so it's best combined with several rendering threads.",
+   NULL,
+   "enhancement",
+   {
+     {"1", "1x (Native)"},
+     {"2", "2x"},
+     {"3", "3x"},
+     {"4", "4x"},
+     {NULL, NULL},
+   },
+   "1"},
   {"swanstation_GPU_UseSoftwareRendererForReadbacks",
    "Use Software Renderer For Readbacks (Restart)",
    NULL,
@@ -346,6 +378,21 @@ struct retro_core_option_v2_definition option_defs_us[] = {
      {NULL, NULL},
    },
    "false"},
+  {"swanstation_GPU_AsyncReadbacks",
+   "Asynchronous VRAM Readbacks",
+   NULL,
+   "Tracks which parts of VRAM have been drawn to, and skips reading back areas which haven't changed. Areas "
+   "which were read back in the previous frame are copied in the background at the end of each frame, so games "
+   "which read back VRAM every frame don't have to wait for the GPU. Has no effect when the software renderer is "
+   "used for readbacks.",
+   NULL,
+   "advanced",
+   {
+     {"true", "Enabled"},
+     {"false", "Disabled"},
+     {NULL, NULL},
+   },
+   "false"},
   {"swanstation_GPU_MSAA",
    "Multisample Antialiasing",
    NULL,
@@ -394,6 +441,20 @@ struct retro_core_option_v2_definition option_defs_us[] = {
      {NULL, NULL},
    },
    "true"},
+  {"swanstation_GPU_Ubershader",
+   "Ubershader",
+   NULL,
+   "Uses a single shader for all texture modes and dithering, so primitives with different modes can be drawn in the "
+   "same batch. Reduces the number of draw calls and pipelines in games which change state often, but each pixel is "
+   "more expensive to shade. Hardware renderers only.",
+   NULL,
+   "advanced",
+   {
+     {"true", "Enabled"},
+     {"false", "Disabled"},
+     {NULL, NULL},
+   },
+   "false"},
   {"swanstation_GPU_DisableInterlacing",
    "Disable Interlacing",
    NULL,
@@ -435,8 +496,8 @@ struct retro_core_option_v2_definition option_defs_us[] = {
   {"swanstation_GPU_ChromaSmoothing24Bit",
    "Chroma Smoothing For 24-Bit Display",
    NULL,
-   "Smooths out blockyness between colour transitions in 24-bit content, usually FMVs. Only applies to the hardware "
-   "renderers.",
+   "Smooths out blockyness between colour transitions in 24-bit content, usually FMVs. The software renderer applies "
+   "it on the CPU when scanning out the frame.",
    NULL,
    "enhancement",
    {
@@ -688,7 +749,8 @@ struct retro_core_option_v2_definition option_defs_us[] = {
    "Downsampling",
    NULL,
    "Downsamples the rendered image prior to displaying it. Can improve overall image quality in mixed 2D/3D games, but "
-   "should be disabled for pure 3D games. Only applies to the hardware renderers.",
+   "should be disabled for pure 3D games. The software renderer only downsamples when its internal resolution scale "
+   "is above 1x.",
    NULL,
    "display",
    {
@@ -698,6 +760,35 @@ struct retro_core_option_v2_definition option_defs_us[] = {
      {NULL, NULL},
    },
    "Disabled"},
+  {"swanstation_GPU_SoftwareDisplayScale",
+   "Output Scale (Software)",
+   NULL,
+   "Upscales the software renderer's output on the CPU before it is passed to the frontend, so it can be filtered "
+   "without a GPU. Only applies to the software renderer.",
+   NULL,
+   "display",
+   {
+     {"1", "1x (Disabled)"},
+     {"2", "2x"},
+     {"3", "3x"},
+     {"4", "4x"},
+     {NULL, NULL},
+   },
+   "1"},
+  {"swanstation_GPU_SoftwareDisplayScaleFilter",
+   "Output Scale Filter (Software)",
+   NULL,
+   "Filter used when upscaling the software renderer's output. Sharp Bilinear only blends the pixels at the edges of "
+   "each source pixel.",
+   NULL,
+   "display",
+   {
+     {"Nearest", "Nearest-Neighbor"},
+     {"Bilinear", NULL},
+     {"SharpBilinear", "Sharp Bilinear"},
+     {NULL, NULL},
+   },
+   "Bilinear"},
   {"swanstation_Display_ShowOSDMessages",
    "Display OSD Messages",
    NULL,
@@ -710,6 +801,23 @@ struct retro_core_option_v2_definition option_defs_us[] = {
      {NULL, NULL},
    },
    "true"},
+  {"swanstation_Display_FrameSkip",
+   "Adaptive Frame Skip",
+   NULL,
+   "When the core takes longer than a frame to emulate a frame, drops the draws for up to the selected number of "
+   "consecutive frames and doesn't present them. VRAM transfers, fills and copies still run, as do draws to the "
+   "displayed area. Only takes effect in games which double buffer.",
+   NULL,
+   "display",
+   {
+     {"0", "Disabled"},
+     {"1", "Up To 1 Frame"},
+     {"2", "Up To 2 Frames"},
+     {"3", "Up To 3 Frames"},
+     {"4", "Up To 4 Frames"},
+     {NULL, NULL},
+   },
+   "0"},
   {"swanstation_Display_ActiveStartOffset",
    "Display Active Start Offset",
    NULL,
@@ -1896,6 +2004,20 @@ struct retro_core_option_v2_definition option_defs_us[] = {
      {NULL, NULL},
    },
    "Info"},
+  {"swanstation_CPU_IdleLoopSkipping",
+   "CPU Idle Loop Skipping",
+   NULL,
+   "Detects loops which wait for hardware state to change, such as waiting for vertical blank, and skips ahead to "
+   "the next scheduled event instead of executing them. Reduces host CPU usage, but may break games which are "
+   "sensitive to timing. Only applies to the cached interpreter and recompiler.",
+   NULL,
+   "advanced",
+   {
+     {"true", "Enabled"},
+     {"false", "Disabled"},
+     {NULL, NULL},
+   },
+   "false"},
   {"swanstation_CPU_RecompilerICache",
    "CPU Recompiler ICache",
    NULL,
@@ -1922,6 +2044,23 @@ struct retro_core_option_v2_definition option_defs_us[] = {
      {NULL, NULL},
    },
    "true"},
+  {"swanstation_CPU_RecompilerHotBlockThreshold",
+   "CPU Recompiler Tiered Compilation",
+   NULL,
+   "Compiles blocks quickly with minimal analysis the first time they are seen, and recompiles them with more "
+   "expensive optimizations once they have executed the selected number of times. Reduces stutter when new code is "
+   "loaded and improves throughput in hot loops.",
+   NULL,
+   "advanced",
+   {
+     {"0", "Disabled"},
+     {"64", "64 Executions"},
+     {"256", "256 Executions"},
+     {"1024", "1024 Executions"},
+     {"4096", "4096 Executions"},
+     {NULL, NULL},
+   },
+   "0"},
   {"swanstation_CPU_FastmemMode",
    "CPU Recompiler Fast Memory Access",
    NULL,
@@ -1977,6 +2116,73 @@ struct retro_core_option_v2_definition option_defs_us[] = {
      {NULL, NULL},
    },
    "false"},
+  {"swanstation_TextureReplacements_UseTexturePack",
+   "Use Packed Texture Replacements",
+   NULL,
+   "Builds a single compressed '.swpack' file next to the game's texture folder the first time the game is started, "
+   "and loads replacements from it instead of the individual image files after that. Startup and loading are much "
+   "faster for large packs. Delete the '.swpack' file after changing the texture folder to rebuild it.",
+   NULL,
+   "advanced",
+   {
+     {"true", "Enabled"},
+     {"false", "Disabled"},
+     {NULL, NULL},
+   },
+   "false"},
+  {"swanstation_TextureReplacements_CacheSizeMB",
+   "Texture Replacement Cache Size",
+   NULL,
+   "Amount of memory used to keep decoded replacement textures. When the cache is full, the textures which haven't "
+   "been used for the longest time are released, and loaded again in the background when they're next needed.",
+   NULL,
+   "advanced",
+   {
+     {"128", "128 MB"},
+     {"256", "256 MB"},
+     {"512", "512 MB"},
+     {"1024", "1024 MB"},
+     {"2048", "2048 MB"},
+     {"4096", "4096 MB"},
+     {NULL, NULL},
+   },
+   "512"},
+  {"swanstation_GPU_DumpFrames",
+   "Record GPU Dump",
+   NULL,
+   "Captures every GPU command for the selected number of frames to the 'swanstation/dump/gpu' folder inside the "
+   "frontend's system directory. Loading the .psxgpu file as content replays it without emulating the rest of the "
+   "console, and logs how long each pass took. Set back to Disabled before recording another dump.",
+   NULL,
+   "advanced",
+   {
+     {"0", "Disabled"},
+     {"1", "1 Frame"},
+     {"2", "2 Frames"},
+     {"5", "5 Frames"},
+     {"10", "10 Frames"},
+     {"30", "30 Frames"},
+     {"60", "60 Frames"},
+     {"120", "120 Frames"},
+     {"300", "300 Frames"},
+     {"600", "600 Frames"},
+     {NULL, NULL},
+   },
+   "0"},
+  {"swanstation_GPU_LogStats",
+   "Log GPU Statistics",
+   NULL,
+   "Writes the number of primitives, batches, draw calls, VRAM transfers and readbacks for every frame to a CSV file in "
+   "the 'swanstation/dump/gpu' folder inside the frontend's system directory. Useful for finding out which scenes are "
+   "expensive to render.",
+   NULL,
+   "advanced",
+   {
+     {"false", "Disabled"},
+     {"true", "Enabled"},
+     {NULL, NULL},
+   },
+   "false"},
   {"swanstation_Main_RunaheadFrameCount",
    "Internal Run-Ahead",
    NULL,
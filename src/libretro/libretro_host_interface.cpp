@@ -70,7 +70,7 @@ RETRO_API void retro_get_system_info(struct retro_system_info* info)
 #define GIT_VERSION "undefined"
 #endif
   info->library_version = "1.0.0 " GIT_VERSION;
-  info->valid_extensions = "exe|psexe|cue|bin|img|iso|chd|pbp|ecm|mds|psf|m3u";
+  info->valid_extensions = "exe|psexe|cue|bin|img|iso|chd|pbp|ecm|mds|psf|m3u|psxgpu";
   info->need_fullpath = true;
   info->block_extract = false;
 }
@@ -485,8 +485,12 @@ void LibretroHostInterface::GetSystemAVInfo(struct retro_system_av_info* info, b
   info->geometry.base_width = (m_display ? m_display->GetDisplayWidth() : GPU_MAX_DISPLAY_WIDTH) * resolution_scale;
   info->geometry.base_height = (m_display ? m_display->GetDisplayHeight() : GPU_MAX_DISPLAY_HEIGHT) * resolution_scale;
   info->geometry.aspect_ratio = (m_display ? m_display->GetDisplayAspectRatio() : (g_gpu ? g_gpu->GetDisplayAspectRatio() : g_settings.GetDisplayAspectRatioValue()));
-  info->geometry.max_width = VRAM_WIDTH * resolution_scale;
-  info->geometry.max_height = VRAM_HEIGHT * resolution_scale;
+
+  // The software renderer scales its output itself, which is already included in the display size.
+  const u32 max_scale = use_resolution_scale ? resolution_scale :
+                                               (g_settings.gpu_sw_resolution_scale * g_settings.gpu_sw_display_scale);
+  info->geometry.max_width = VRAM_WIDTH * max_scale;
+  info->geometry.max_height = VRAM_HEIGHT * max_scale;
 
   info->timing.fps = (System::IsValid()) ? System::GetThrottleFrequency() : 60.0;
   info->timing.sample_rate = static_cast<double>(AUDIO_SAMPLE_RATE);
@@ -869,6 +873,7 @@ bool LibretroHostInterface::UpdateCoreOptionsDisplay(bool controller)
     Settings::ParseCPUFastmemMode(
       si.GetStringValue("CPU", "FastmemMode", Settings::GetCPUFastmemModeName(Settings::DEFAULT_CPU_FASTMEM_MODE)).c_str())
       .value_or(Settings::DEFAULT_CPU_FASTMEM_MODE);
+  const bool cpu_code_cache = (cpu_execution_mode != CPUExecutionMode::Interpreter);
   const bool cpu_recompiler = (cpu_execution_mode == CPUExecutionMode::Recompiler);
   const bool cpu_fastmem_rewrite = (cpu_recompiler && cpu_fastmem_mode == CPUFastmemMode::MMap);
 
@@ -920,11 +925,17 @@ bool LibretroHostInterface::UpdateCoreOptionsDisplay(bool controller)
 
   struct retro_core_option_display option_display;
 
+  option_display.visible = cpu_code_cache;
+  option_display.key = "swanstation_CPU_IdleLoopSkipping";
+  g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
+
   option_display.visible = cpu_recompiler;
   option_display.key = "swanstation_CPU_RecompilerICache";
   g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
   option_display.key = "swanstation_CPU_RecompilerBlockLinking";
   g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
+  option_display.key = "swanstation_CPU_RecompilerHotBlockThreshold";
+  g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
   option_display.key = "swanstation_CPU_FastmemMode";
   g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
 
@@ -935,12 +946,16 @@ bool LibretroHostInterface::UpdateCoreOptionsDisplay(bool controller)
   option_display.visible = hardware_renderer;
   option_display.key = "swanstation_GPU_UseSoftwareRendererForReadbacks";
   g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
+  option_display.key = "swanstation_GPU_AsyncReadbacks";
+  g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
   option_display.key = "swanstation_GPU_MSAA";
   g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
   option_display.key = "swanstation_GPU_TrueColor";
   g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
   option_display.key = "swanstation_GPU_ScaledDithering";
   g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
+  option_display.key = "swanstation_GPU_Ubershader";
+  g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
   option_display.key = "swanstation_GPU_ChromaSmoothing24Bit";
   g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
   option_display.key = "swanstation_GPU_TextureFilter";
@@ -957,6 +972,8 @@ bool LibretroHostInterface::UpdateCoreOptionsDisplay(bool controller)
   option_display.visible = !hardware_renderer;
   option_display.key = "swanstation_GPU_UseThread";
   g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
+  option_display.key = "swanstation_GPU_SoftwareRenderThreads";
+  g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
 
   option_display.visible = pgxp_enable;
   option_display.key = "swanstation_GPU_PGXPCulling";
@@ -981,6 +998,10 @@ bool LibretroHostInterface::UpdateCoreOptionsDisplay(bool controller)
   option_display.visible = vram_rewrite_replacements;
   option_display.key = "swanstation_TextureReplacements_PreloadTextures";
   g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
+  option_display.key = "swanstation_TextureReplacements_UseTexturePack";
+  g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
+  option_display.key = "swanstation_TextureReplacements_CacheSizeMB";
+  g_retro_environment_callback(RETRO_ENVIRONMENT_SET_CORE_OPTIONS_DISPLAY, &option_display);
 
   option_display.visible = !cdrom_preload_enable;
   option_display.key = "swanstation_CDROM_PreCacheCHD";
@@ -1163,6 +1184,12 @@ void LibretroHostInterface::UpdateSettings()
       // Don't let the base class mess with the GPU.
       old_settings.gpu_resolution_scale = g_settings.gpu_resolution_scale;
     }
+    else if ((g_settings.gpu_sw_resolution_scale != old_settings.gpu_sw_resolution_scale ||
+              g_settings.gpu_sw_display_scale != old_settings.gpu_sw_display_scale) &&
+             g_settings.gpu_renderer == GPURenderer::Software)
+    {
+      UpdateSystemAVInfo(false);
+    }
 
     if (g_settings.memory_card_types[0] != old_settings.memory_card_types[0])
     {